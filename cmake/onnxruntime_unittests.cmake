@@ -235,6 +235,13 @@ file(GLOB onnxruntime_test_common_src CONFIGURE_DEPENDS
   "${TEST_SRC_DIR}/common/logging/*.h"
 )
 
+# the perf test runner is a separate executable, its standalone helpers are tested here
+file(GLOB onnxruntime_test_perftest_src CONFIGURE_DEPENDS
+  "${TEST_SRC_DIR}/perftest/test/*.cc"
+  "${TEST_SRC_DIR}/perftest/latency_histogram.cc"
+  "${TEST_SRC_DIR}/perftest/latency_histogram.h"
+)
+
 file(GLOB onnxruntime_test_quantiztion_src CONFIGURE_DEPENDS
   "${TEST_SRC_DIR}/quantization/*.cc"
   "${TEST_SRC_DIR}/quantization/*.h"
@@ -727,7 +734,8 @@ target_include_directories(onnx_test_runner_common PRIVATE ${eigen_INCLUDE_DIRS}
 set_target_properties(onnx_test_runner_common PROPERTIES FOLDER "ONNXRuntimeTest")
 
 set(all_tests ${onnxruntime_test_common_src} ${onnxruntime_test_ir_src} ${onnxruntime_test_optimizer_src}
-        ${onnxruntime_test_framework_src} ${onnxruntime_test_providers_src} ${onnxruntime_test_quantiztion_src})
+        ${onnxruntime_test_framework_src} ${onnxruntime_test_providers_src} ${onnxruntime_test_quantiztion_src}
+        ${onnxruntime_test_perftest_src})
 if(NOT TARGET onnxruntime AND NOT onnxruntime_BUILD_WEBASSEMBLY)
   list(APPEND all_tests ${onnxruntime_shared_lib_test_SRC})
 endif()
@@ -121,6 +121,31 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to use pre-packed buffers persisted by an earlier session
+  // (see kOrtSessionOptionsConfigPrepackedWeightsCacheFile). PrePack() is skipped when the persisted buffers are
+  // used, so the kernel must restore any other state that PrePack() derives from the tensor.
+  // The buffers are read only and owned by the session, like the ones given to UseSharedPrePackedBuffers().
+  // @param tensor: The initialized constant tensor that the buffers were pre-packed from
+  // @param prepacked_buffers: The buffers in the order PrePack() stored them in PrePackedWeights
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param used_persisted_buffers: Boolean flag set by the kernel implementation indicating
+  // that the provided buffers have been used by the kernel.
+  virtual Status UsePersistedPrePackedBuffers(const Tensor& /*tensor*/,
+                                              std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                              int /*input_idx*/,
+                                              /*out*/ bool& used_persisted_buffers) {
+    used_persisted_buffers = false;
+    return Status::OK();
+  }
+
+  // Override this function along with UsePersistedPrePackedBuffers() to return true for the inputs whose
+  // pre-packed buffers the kernel can restore itself from. The session only computes the keys of the persisted
+  // buffers, which hash the constant inputs, for the kernels that return true for one of their inputs.
+  // @param input_idx: The input index of a constant initializer of this kernel
+  virtual bool CanUsePersistedPrePackedBuffers(int /*input_idx*/) const {
+    return false;
+  }
+
   const OrtMemoryInfo& Allocator(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
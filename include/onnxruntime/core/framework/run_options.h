@@ -40,6 +40,11 @@ struct OrtRunOptions {
   // /include/onnxruntime/core/session/onnxruntime_run_options_config_keys.h
   onnxruntime::ConfigOptions config_options;
 
+  // Invoked after each step by the generation ops (BeamSearch, GreedySearch, Sampling) of the main graph.
+  // Set with OrtApis::RunOptionsSetGenerationStreamingCallback.
+  GenerationStreamingCallbackFn generation_streaming_callback = nullptr;
+  void* generation_streaming_callback_user_data = nullptr;
+
   OrtRunOptions() = default;
   ~OrtRunOptions() = default;
 };
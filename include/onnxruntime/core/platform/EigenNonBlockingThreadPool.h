@@ -287,6 +287,43 @@ class ThreadPoolProfiler {
 };
 #endif
 
+// Measured cost of the loops run by ThreadPool::ParallelFor when the pool is created
+// with ThreadOptions::adaptive_block_size_.  Each loop is identified by a key derived
+// from its call site and from its static cost, the table keeps a moving average of the
+// time spent per iteration and the next runs of the same loop use it in place of the
+// static TensorOpCost estimate to select the block size.
+//
+// The table has a fixed size and uses open addressing.  Lookups and updates are
+// lock-free: concurrent updates of the same entry may lose one measurement, which
+// only delays the convergence of the average.  When the probed entries are all used
+// by other keys, the loop keeps using its static cost.
+class ParallelForCostTable {
+ public:
+  ParallelForCostTable() = default;
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelForCostTable);
+
+  // Returns the measured time per iteration in nanoseconds, or a negative value
+  // if the loop has not been measured yet.
+  double Lookup(uint64_t key) const;
+
+  // Records the time spent by all threads to run num_iterations iterations of a loop.
+  void Record(uint64_t key, uint64_t num_iterations, uint64_t nanoseconds);
+
+ private:
+  static constexpr unsigned kNumEntries = 512;  // must be a power of 2
+  static constexpr unsigned kMaxProbes = 8;
+
+  struct Entry {
+    std::atomic<uint64_t> key{0};  // 0 marks an unused entry
+    std::atomic<double> ns_per_iteration{-1};
+  };
+
+  const Entry* Find(uint64_t key) const;
+  Entry* FindOrInsert(uint64_t key);
+
+  Entry entries_[kNumEntries];
+};
+
 // Extended Eigen thread pool interface, avoiding the need to modify
 // the ThreadPoolInterface.h header from the external Eigen
 // repository.
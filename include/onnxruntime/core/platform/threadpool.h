@@ -135,8 +135,29 @@ class ThreadPoolTempl;
 
 class ExtendedThreadPoolInterface;
 class LoopCounter;
+class ParallelForCostTable;
 class ThreadPoolParallelSection;
 
+#if defined(__GNUC__) || defined(__clang__) || (defined(_MSC_VER) && _MSC_VER >= 1926)
+#define ORT_PARALLEL_FOR_CALL_SITE_FILE __builtin_FILE()
+#define ORT_PARALLEL_FOR_CALL_SITE_LINE __builtin_LINE()
+#else
+#define ORT_PARALLEL_FOR_CALL_SITE_FILE nullptr
+#define ORT_PARALLEL_FOR_CALL_SITE_LINE 0
+#endif
+
+// Source location of a call to ThreadPool::TryParallelFor.  It is filled in by the
+// default arguments at the call site, the callers do not pass it.  Thread pools created
+// with ThreadOptions::adaptive_block_size_ keep the measured cost of the loops per call site.
+struct ParallelForCallSite {
+  ParallelForCallSite(const char* file_name = ORT_PARALLEL_FOR_CALL_SITE_FILE,
+                      int line_number = ORT_PARALLEL_FOR_CALL_SITE_LINE) noexcept
+      : file(file_name), line(line_number) {}
+
+  const char* file;
+  int line;
+};
+
 class ThreadPool {
  public:
 #ifdef _WIN32
@@ -214,6 +235,24 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Shares the threads of the pools between num_callers threads which run loops concurrently, e.g. the
+  // streams of a parallel execution plan.  While in scope, the loops started by the calling thread use
+  // at most 1/num_callers of the threads of a pool, including the calling thread itself, so concurrent
+  // callers don't oversubscribe the cores.  The previous share is restored when the scope is exited.
+  //
+  // Like parallel sections, the share is tracked in thread-local state so that code such as MLAS,
+  // which sizes its work with DegreeOfParallelism, follows it without changes.
+
+  class ThreadShareScope {
+  public:
+    explicit ThreadShareScope(int num_callers);
+    ~ThreadShareScope();
+
+  private:
+    int previous_num_callers_;
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadShareScope);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -248,12 +287,14 @@ class ThreadPool {
   // issues and stragglers.
 
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
-    TryParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                             const ParallelForCallSite& call_site = {}) {
+    TryParallelFor(tp, total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn, call_site);
   }
 
   static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                             const ParallelForCallSite& call_site = {});
 
   // Directly schedule the 'total' tasks to the underlying threadpool, without
   // cutting them by halves
@@ -374,6 +415,10 @@ class ThreadPool {
   // value returned by DegreeOfParallelism to code using the pool.
   int NumThreads() const;
 
+  // Returns the number of threads, including the caller, which the loops started by the calling
+  // thread may use.  This is NumThreads() + 1 unless the caller is in a ThreadShareScope.
+  int NumThreadsForCaller() const;
+
   // Returns current thread id between 0 and NumThreads() - 1, if called from a
   // thread in the pool. Returns -1 otherwise.
   int CurrentThreadId() const;
@@ -406,7 +451,16 @@ class ThreadPool {
                    const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
 
   void ParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn);
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn,
+                   const ParallelForCallSite& call_site = {});
+
+  // ParallelFor variant used when thread_options_.adaptive_block_size_ is set: the block
+  // size is derived from the cost measured on the previous runs of the same loop, and
+  // threads which exhausted their own shard of iterations steal smaller blocks from
+  // the other shards.
+  void AdaptiveParallelFor(std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
+                           const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn,
+                           const ParallelForCallSite& call_site);
 
   void SimpleParallelFor(std::ptrdiff_t total, const std::function<void(std::ptrdiff_t)>& fn);
 
@@ -429,6 +483,9 @@ class ThreadPool {
 
   // Force the thread pool to run in hybrid mode on a normal cpu.
   bool force_hybrid_ = false;
+
+  // Measured cost of the loops, only allocated if thread_options_.adaptive_block_size_ is set.
+  std::unique_ptr<ParallelForCostTable> cost_table_;
 };
 
 }  // namespace concurrency
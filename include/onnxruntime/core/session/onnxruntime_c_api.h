@@ -628,6 +628,39 @@ typedef void (*OrtCustomJoinThreadFn)(OrtCustomThreadHandle ort_custom_thread_ha
 
 typedef OrtStatus*(ORT_API_CALL* RegisterCustomOpsFn)(OrtSessionOptions* options, const OrtApiBase* api);
 
+/** \brief Callback invoked when a run started with OrtApi::RunAsync completes
+ *
+ * Called on a thread of the intra-op thread pool of the session.
+ *
+ * \param[in] user_data The user_data passed to OrtApi::RunAsync
+ * \param[in] outputs The outputs array passed to OrtApi::RunAsync. Its nullptr elements were set to new ::OrtValue%s
+ *     that must be released by the caller. They are left unchanged if the run failed.
+ * \param[in] num_outputs Number of elements in the outputs array
+ * \param[in] status nullptr if the run succeeded, otherwise the error of the run. It is released by onnxruntime after
+ *     the callback returns.
+ */
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(_In_opt_ void* user_data, _Inout_updates_all_(num_outputs) OrtValue** outputs,
+                                              size_t num_outputs, _In_opt_ OrtStatusPtr status);
+
+/** \brief Callback invoked by the BeamSearch, GreedySearch and Sampling contrib ops after each generation step
+ *
+ * Set with OrtApi::RunOptionsSetGenerationStreamingCallback. Called on the thread that runs the op.
+ *
+ * \param[in] user_data The user_data passed to OrtApi::RunOptionsSetGenerationStreamingCallback
+ * \param[in] sequence_length Length of the sequences including the tokens of this step
+ * \param[in] next_tokens The tokens just appended to the sequences, batch_beam_size elements. Finished sequences get
+ *     pad_token_id.
+ * \param[in] beam_indices nullptr for GreedySearch and Sampling. For BeamSearch, batch_beam_size elements: beam i
+ *     continues the sequence of beam beam_indices[i] (index into the whole batch), since beams are reordered every step.
+ * \param[in] batch_beam_size Number of sequences
+ *
+ * The pointers are only valid during the call.
+ */
+typedef void(ORT_API_CALL* GenerationStreamingCallbackFn)(_In_opt_ void* user_data, int32_t sequence_length,
+                                                         _In_reads_(batch_beam_size) const int32_t* next_tokens,
+                                                         _In_opt_ const int32_t* beam_indices,
+                                                         int64_t batch_beam_size);
+
 /** \brief The C API
  *
  * All C API functions are defined inside this structure as pointers to functions.
@@ -2678,6 +2711,9 @@ struct OrtApi {
    *  Only relevant if arena strategy is `kNextPowerOfTwo`. Use -1 to allow ORT to choose the default.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_bytes": Capacity of the cache of free chunks kept by each thread using the arena.
+   *  Allocations of up to 64KB are served from and freed to these caches without taking the arena lock,
+   *  which reduces contention when many threads share the allocator. Use 0 or -1 to disable them (default).
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -3962,6 +3998,89 @@ struct OrtApi {
    */
   void(ORT_API_CALL* ReleaseDnnlProviderOptions)(_Frees_ptr_opt_ OrtDnnlProviderOptions* input);
 
+  /// \name OrtSession
+  /// @{
+
+  /** \brief Run the model in an ::OrtSession without waiting for the run to complete
+   *
+   * Queues the run on the intra-op thread pool of the session, which must have at least 2 threads, and returns.
+   * run_async_callback is invoked on a thread of the pool when the run completes, with the outputs or the error of
+   * the run. This lets a caller serve many concurrent runs without blocking one of its threads on each of them.
+   *
+   * The names and the input values are referenced by the queued run, so the caller may release them once this
+   * function returns. The session, run_options and the outputs array must stay alive until run_async_callback is
+   * invoked. run_options can be used to terminate the run with OrtApi::RunOptionsSetTerminate.
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input Array of ::OrtValue%s of the input values
+   * \param[in] input_len Number of elements in the input_names and inputs arrays
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names and outputs array
+   * \param[out] output Array of ::OrtValue%s that the outputs are stored in, as in OrtApi::Run. It is passed to
+   *     run_async_callback.
+   * \param[in] run_async_callback Callback invoked when the run completes. It is not invoked if this function
+   *     returns an error.
+   * \param[in] user_data Passed to run_async_callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output,
+                  _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+
+  /// @}
+  /// \name OrtThreadingOptions
+  /// @{
+
+  /** \brief Set adaptive block sizes for the global intra-op thread pool
+   *
+   * Sets global thread pool options to be used in the call to OrtApi::CreateEnvWithGlobalThreadPools.
+   * The intra-op thread pool measures the time spent per iteration by each parallel loop of the operators and
+   * uses it in place of the cost estimated by the operator to split the next runs of the same loop.
+   * This is the global thread pool equivalent of session option "session.adaptive_block_size".
+   *
+   * \param[in] tp_options
+   * \param[in] adaptive_block_size Valid values are 0 or 1.<br>
+   *   0 = Loops are split using the cost estimated by the operators. The default.<br>
+   *   1 = Loops are split using the cost measured on their previous runs.
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(SetGlobalAdaptiveBlockSize, _Inout_ OrtThreadingOptions* tp_options, int adaptive_block_size);
+
+  /// @}
+  /// \name OrtRunOptions
+  /// @{
+
+  /** \brief Stream the tokens generated by the BeamSearch, GreedySearch and Sampling contrib ops
+   *
+   * callback is invoked after each generation step of the ops run by OrtApi::Run calls using these run options, with
+   * the tokens just appended to the sequences. This lets a caller forward partial results before the generation
+   * finishes. Only the generation ops of the main graph stream their tokens.
+   *
+   * \param[in] options
+   * \param[in] callback Invoked after each generation step, see ::GenerationStreamingCallbackFn. nullptr disables
+   *     the streaming.
+   * \param[in] user_data Passed to callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(RunOptionsSetGenerationStreamingCallback, _Inout_ OrtRunOptions* options,
+                  _In_opt_ GenerationStreamingCallbackFn callback, _In_opt_ void* user_data);
+
+  /// @}
+
 #ifdef __cplusplus
   OrtApi(const OrtApi&) = delete;  // Prevent users from accidentally copying the API structure, it should always be passed as a pointer
 #endif
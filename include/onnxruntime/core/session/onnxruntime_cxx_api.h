@@ -377,6 +377,9 @@ struct ThreadingOptions : detail::Base<OrtThreadingOptions> {
   /// \brief Wraps OrtApi::SetGlobalDenormalAsZero
   ThreadingOptions& SetGlobalDenormalAsZero();
 
+  /// \brief Wraps OrtApi::SetGlobalAdaptiveBlockSize
+  ThreadingOptions& SetGlobalAdaptiveBlockSize(int adaptive_block_size);
+
   /// \brief Wraps OrtApi::SetGlobalCustomCreateThreadFn
   ThreadingOptions& SetGlobalCustomCreateThreadFn(OrtCustomCreateThreadFn ort_custom_create_thread_fn);
 
@@ -450,6 +453,9 @@ struct RunOptions : detail::Base<OrtRunOptions> {
 
   RunOptions& AddConfigEntry(const char* config_key, const char* config_value);  ///< Wraps OrtApi::AddRunConfigEntry
 
+  /// Wraps OrtApi::RunOptionsSetGenerationStreamingCallback
+  RunOptions& SetGenerationStreamingCallback(GenerationStreamingCallbackFn callback, void* user_data);
+
   /** \brief Terminates all currently executing Session::Run calls that were made using this RunOptions instance
    *
    * If a currently executing session needs to be force terminated, this can be called from another thread to force it to fail with an error
@@ -764,6 +770,27 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model without waiting for the run to complete
+   *
+   * Wraps OrtApi::RunAsync
+   *
+   * callback is invoked on a thread of the intra-op thread pool of the session with output_values and the status of
+   * the run. output_values, run_options and the session must stay alive until then. The Value%s of output_values
+   * that are empty are set to the outputs of the run, as in Run.
+   *
+   * \param[in] run_options
+   * \param[in] input_names Array of null terminated strings of length input_count that is the list of input names
+   * \param[in] input_values Array of Value objects of length input_count that is the list of input values
+   * \param[in] input_count Number of inputs (the size of the input_names & input_values arrays)
+   * \param[in] output_names Array of C style strings of length output_count that is the list of output names
+   * \param[out] output_values Array of Value objects of length output_count that receives the outputs
+   * \param[in] output_count Number of outputs (the size of the output_names & output_values arrays)
+   * \param[in] callback Invoked when the run completes, see ::RunAsyncCallbackFn
+   * \param[in] user_data Passed to callback
+   */
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data);
+
   /** \brief End profiling and return a copy of the profiling file name.
    *
    * \param allocator to allocate memory for the copy of the string returned
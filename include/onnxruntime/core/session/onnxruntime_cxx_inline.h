@@ -392,6 +392,11 @@ inline ThreadingOptions& ThreadingOptions::SetGlobalDenormalAsZero() {
   return *this;
 }
 
+inline ThreadingOptions& ThreadingOptions::SetGlobalAdaptiveBlockSize(int adaptive_block_size) {
+  ThrowOnError(GetApi().SetGlobalAdaptiveBlockSize(p_, adaptive_block_size));
+  return *this;
+}
+
 inline ThreadingOptions& ThreadingOptions::SetGlobalCustomCreateThreadFn(OrtCustomCreateThreadFn ort_custom_create_thread_fn) {
   ThrowOnError(GetApi().SetGlobalCustomCreateThreadFn(p_, ort_custom_create_thread_fn));
   return *this;
@@ -524,6 +529,11 @@ inline RunOptions& RunOptions::UnsetTerminate() {
   return *this;
 }
 
+inline RunOptions& RunOptions::SetGenerationStreamingCallback(GenerationStreamingCallbackFn callback, void* user_data) {
+  ThrowOnError(GetApi().RunOptionsSetGenerationStreamingCallback(p_, callback, user_data));
+  return *this;
+}
+
 namespace detail {
 
 template <typename T>
@@ -906,6 +916,15 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values, size_t input_count,
+                                     const char* const* output_names, Value* output_values, size_t output_count, RunAsyncCallbackFn callback, void* user_data) {
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunAsync(this->p_, run_options, input_names, ort_input_values, input_count,
+                                 output_names, output_count, ort_output_values, callback, user_data));
+}
+
 template <typename T>
 inline AllocatedStringPtr SessionImpl<T>::EndProfilingAllocated(OrtAllocator* allocator) {
   char* out = nullptr;
@@ -20,6 +20,36 @@
 // If the config value is set to "1" then the prepacking is disabled, otherwise prepacking is enabled (default value)
 static const char* const kOrtSessionOptionsConfigDisablePrepacking = "session.disable_prepacking";
 
+// Path of a file used to persist pre-packed weights of CPU kernels across processes.
+// If the file exists and was written on a CPU with the same instruction set extensions and the same MLAS packed
+// format, kernels that support it map their pre-packed buffers from the file instead of running PrePack().
+// Otherwise, or if the model has weights that are not in the file, the file is rewritten once the session is
+// initialized. Entries are keyed by the consuming node and the contents of the initializer, so the same file can
+// be reused after the model changes. Weights shared across sessions through a PrepackedWeightsContainer are not
+// persisted. Not set by default.
+static const char* const kOrtSessionOptionsConfigPrepackedWeightsCacheFile = "session.prepacked_weights_cache_file";
+
+// Maximum number of memory patterns cached by a session, one per distinct set of input shapes (or shape bucket, see
+// kOrtSessionOptionsConfigMemoryPatternDimBucketSize). The least recently used pattern is evicted when the cache is
+// full. "0" means unbounded. The default is "128".
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheCapacity = "session.memory_pattern_cache_capacity";
+
+// If set to N > 1, the memory pattern cache rounds every input dim up to a multiple of N, so inputs with e.g.
+// sequence lengths 65 to 128 share one memory pattern planned for the largest of them. Each bucket's buffer is
+// sized for the largest shape seen in it, so this trades memory for fewer pattern misses.
+// "0" means memory patterns are only reused for the exact input shapes they were planned for. The default.
+static const char* const kOrtSessionOptionsConfigMemoryPatternDimBucketSize = "session.memory_pattern_dim_bucket_size";
+
+// Key for enabling the capture of runs, in sessions whose model runs as a single stream of CPU kernels.
+// A run is captured once it succeeds, and later runs with the same input and output names and the same input types,
+// shapes and locations replay it: they skip validating and mapping the inputs and outputs, finding the memory pattern
+// and allocating its buffers, and call the kernels in the recorded order. A run with other arguments runs as usual
+// and replaces the capture. A run that finds the capture replayed by another run runs as usual. Runs with
+// preallocated outputs are not captured.
+// "0": disable. (default)
+// "1": enable.
+static const char* const kOrtSessionOptionsConfigEnableCpuRunCapture = "session.enable_cpu_run_capture";
+
 // A value of "1" means allocators registered in the env will be used. "0" means the allocators created in the session
 // will be used. Use this to override the usage of env allocators on a per session level.
 static const char* const kOrtSessionOptionsConfigUseEnvAllocators = "session.use_env_allocators";
@@ -152,6 +182,16 @@ static const char* const kOrtSessionOptionsConfigNnapiEpPartitioningStopOps = "e
 // Available since version 1.11.
 static const char* const kOrtSessionOptionsConfigDynamicBlockBase = "session.dynamic_block_base";
 
+// Enabling cost feedback for the parallel loops of the intra-op thread pool.
+// "1": the thread pool measures the time spent per iteration by each loop and uses it instead of the
+//      cost estimated by the operator to choose the block size, and whether to parallelize at all,
+//      on the next runs of the same loop. Threads that finish their share of a loop steal smaller
+//      blocks from the others.
+// "0": the cost estimated by the operator is used. This is the default.
+// It has no effect when "session.dynamic_block_base" is set. Sessions using the global thread pools ignore it,
+// OrtApi::SetGlobalAdaptiveBlockSize enables it for the global intra-op thread pool.
+static const char* const kOrtSessionOptionsConfigAdaptiveBlockSize = "session.adaptive_block_size";
+
 // This option allows to decrease CPU usage between infrequent
 // requests and forces any TP threads spinning stop immediately when the last of
 // concurrent Run() call returns.
@@ -184,3 +224,22 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    an id of 64 will be inferred as the last processor of the 1st group, while 65 will be interpreted as the 1st processor of the second group.
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
+
+// "1": TreeEnsembleRegressor and TreeEnsembleClassifier repack every tree at initialization into a compact
+// depth-first layout (16-bit feature ids, one child stored next to its parent). The most likely child
+// (based on attribute nodes_hitrates if present, the true branch otherwise) is stored next to its parent.
+// This reduces the memory touched by a tree traversal on large models. Only the leaves are kept in the original form.
+// The option is read by the CPU execution provider created from the session options, a CPU execution provider
+// appended with OrtSessionOptionsAppendExecutionProvider_CPU keeps the default.
+// "0": nodes are stored in ONNX attribute order. The default.
+static const char* const kOrtSessionOptionsConfigTreeEnsembleCompactLayout = "session.tree_ensemble_compact_layout";
+
+// "1": BeamSearch, GreedySearch and Sampling with a GPT decoder evict finished sequences from the batch fed to the
+// decoder subgraph, and compact input ids, attention mask and past state after each step where a sequence finished.
+// For BeamSearch, a batch entry is evicted when the scorer has finished all its beams. Only used by the CPU
+// implementation. It is ignored when past and present share a buffer, or when BeamSearch outputs scores.
+// Like kOrtSessionOptionsConfigTreeEnsembleCompactLayout, it is read by the CPU execution provider created from
+// the session options.
+// "0": all sequences are run through the decoder until every sequence finishes. The default.
+static const char* const kOrtSessionOptionsConfigGenerationCompactFinishedSequences =
+    "session.generation_compact_finished_sequences";
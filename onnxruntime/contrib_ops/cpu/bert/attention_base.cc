@@ -165,6 +165,10 @@ Status AttentionBase::CheckInputs(const TensorShape& input_shape,
                                "past_sequence_length tensor must be of one element when past_present_share_buffer is set");
       }
       past_sequence_length = *past_seq_len->Data<int32_t>();
+      if (past_sequence_length < 0) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "past_sequence_length must not be negative, got ", past_sequence_length);
+      }
     }
   }
 
@@ -357,5 +361,18 @@ Tensor* AttentionBase::GetPresent(OpKernelContext* context,
   return present;
 }
 
+Tensor* AttentionBase::GetPresentSharingPast(OpKernelContext* context, const Tensor* past) const {
+  Tensor* present = context->Output(1, past->Shape());
+  if (nullptr == present) {
+    ORT_THROW("Expect to have present state output when past state input is given");
+  }
+
+  if (present->DataRaw() != past->DataRaw()) {
+    memcpy(present->MutableDataRaw(), past->DataRaw(), past->SizeInBytes());
+  }
+
+  return present;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -30,6 +30,11 @@ class AttentionBase {
                      int sequence_length,
                      int& past_sequence_length) const;
 
+  // When past_present_share_buffer is set, present has the shape of past:
+  // (2, batch_size, num_heads, max_sequence_length, head_size), and the new key and value are written in place
+  // after the past state. Past is copied only if present could not reuse its buffer.
+  Tensor* GetPresentSharingPast(OpKernelContext* context, const Tensor* past) const;
+
  protected:
   AttentionBase(const OpKernelInfo& info, bool require_same_hidden_size) {
     int64_t num_heads = 0;
@@ -31,7 +31,9 @@ class AttentionCPUBase : public AttentionBase {
                         int v_head_size,                      // head size of V (H_v)
                         int v_hidden_size,                    // hidden size of V (D_v)
                         const Tensor* relative_position_bias, // bias addition in QK. Its size is BxNxSxT
-                        OpKernelContext* context) const {
+                        OpKernelContext* context,
+                        const Tensor* past_seq_len = nullptr  // past sequence length when past and present share buffer
+  ) const {
     const int kv_sequence_length = sequence_length;
 
     AllocatorPtr allocator;
@@ -40,7 +42,17 @@ class AttentionCPUBase : public AttentionBase {
     auto* tp = context->GetOperatorThreadPool();
 
     int past_sequence_length = 0;
-    Tensor* present = GetPresent(context, past, batch_size, v_head_size, sequence_length, past_sequence_length);
+    // Sequence length of the present buffer when it is shared with past, 0 otherwise. The key and value of
+    // the new tokens are then appended in place, the past state is not copied at every step.
+    int max_sequence_length = 0;
+    Tensor* present = nullptr;
+    if (past_present_share_buffer_ && past != nullptr) {
+      past_sequence_length = *past_seq_len->Data<int32_t>();
+      max_sequence_length = static_cast<int>(past->Shape().GetDims()[3]);
+      present = GetPresentSharingPast(context, past);
+    } else {
+      present = GetPresent(context, past, batch_size, v_head_size, sequence_length, past_sequence_length);
+    }
 
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
@@ -64,7 +76,8 @@ class AttentionCPUBase : public AttentionBase {
     gsl::span<const int64_t> mask_index_dims = mask_index != nullptr
                                                    ? mask_index->Shape().GetDims()
                                                    : gsl::span<const int64_t>{};
-    const T* past_data = past != nullptr ? past->Data<T>() : nullptr;
+    // The past state is already in present when they share buffer.
+    const T* past_data = (past != nullptr && max_sequence_length == 0) ? past->Data<T>() : nullptr;
     T* present_data = present != nullptr ? present->MutableData<T>() : nullptr;
 
     const T* relative_position_bias_data = nullptr;
@@ -74,7 +87,7 @@ class AttentionCPUBase : public AttentionBase {
 
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data), has_unidirectional,
-                             batch_size, sequence_length, past_sequence_length,
+                             batch_size, sequence_length, past_sequence_length, max_sequence_length,
                              qk_head_size == 0 ? v_head_size : qk_head_size,
                              past_data, present_data, tp, relative_position_bias_data);
 
@@ -86,7 +99,7 @@ class AttentionCPUBase : public AttentionBase {
     ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(out_tmp_data),
                             static_cast<T*>(attention_probs), V,
                             batch_size, sequence_length, kv_sequence_length, past_sequence_length,
-                            v_head_size, v_hidden_size,
+                            max_sequence_length, v_head_size, v_hidden_size,
                             past_data, present_data, tp);
 
     return Status::OK();
@@ -108,6 +121,7 @@ class AttentionCPUBase : public AttentionBase {
                              int batch_size,                            // batch size of self-attention
                              int sequence_length,                       // sequence length of self-attention
                              int past_sequence_length,                  // sequence length of past state
+                             int max_sequence_length,                   // sequence length of present if shared with past
                              int head_size,                             // head size of self-attention
                              const T* past,                             // past state
                              T* present,                                // present state
@@ -117,7 +131,9 @@ class AttentionCPUBase : public AttentionBase {
     const int total_sequence_length = past_sequence_length + sequence_length;                // T = P + L
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;  // P x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length) * head_size;      // L x H
-    const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // T x H
+    const size_t present_chunk_length = max_sequence_length > 0                               // M x H or T x H
+                                            ? static_cast<size_t>(max_sequence_length) * head_size
+                                            : past_chunk_length + input_chunk_length;
 
     {
       // mask_data is nullptr when mask_index is nullptr and not unidirectional, otherwise its shape is BxSxT
@@ -151,7 +167,10 @@ class AttentionCPUBase : public AttentionBase {
           }
 
           const T* k = K + input_chunk_length * i;
-          if (nullptr != present) {
+          if (max_sequence_length > 0) {
+            // Append K after past_K in place: (BxNx)LxH -> (BxNx)MxH
+            k = AppendStateChunk(k, present, past_chunk_length, input_chunk_length, present_chunk_length, i);
+          } else if (nullptr != present) {
             // Concatenate past_K and K : (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
             k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
           }
@@ -201,6 +220,7 @@ class AttentionCPUBase : public AttentionBase {
                                int sequence_length,       // sequence length
                                int kv_sequence_length,    // sequence length of K or V
                                int past_sequence_length,  // sequence length in past state
+                               int max_sequence_length,   // sequence length of present if shared with past
                                int v_head_size,           // head size of V (H_v)
                                int v_hidden_size,         // hidden size of V (D_v)
                                const T* past,             // past state
@@ -209,14 +229,16 @@ class AttentionCPUBase : public AttentionBase {
     const int total_sequence_length = past_sequence_length + kv_sequence_length;               // T = P + L
     const ptrdiff_t past_chunk_length = SafeInt<ptrdiff_t>(past_sequence_length) * v_head_size;  // P x H_v
     const ptrdiff_t input_chunk_length = SafeInt<ptrdiff_t>(kv_sequence_length) * v_head_size;   // L x H_v
-    const ptrdiff_t present_chunk_length = past_chunk_length + input_chunk_length;               // T x H_v
+    const ptrdiff_t present_chunk_length = max_sequence_length > 0                               // M x H_v or T x H_v
+                                               ? SafeInt<ptrdiff_t>(max_sequence_length) * v_head_size
+                                               : past_chunk_length + input_chunk_length;
 
     // Move the pointer of past and present to start of v values.
     if (nullptr != past) {
       past += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * past_sequence_length * v_head_size;
     }
     if (nullptr != present) {
-      present += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * total_sequence_length * v_head_size;
+      present += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * present_chunk_length;
     }
 
     const double cost =
@@ -225,7 +247,10 @@ class AttentionCPUBase : public AttentionBase {
     ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const T* v = V + input_chunk_length * i;
-        if (nullptr != present) {
+        if (max_sequence_length > 0) {
+          // Append V after past_V in place: (BxNx)LxH_v -> (BxNx)MxH_v
+          v = AppendStateChunk(v, present, past_chunk_length, input_chunk_length, present_chunk_length, i);
+        } else if (nullptr != present) {
           // Concatenate past_V and V: (BxNx)PxH_v, (BxNx)LxH_v -> (BxNx)TxH_v
           v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
         }
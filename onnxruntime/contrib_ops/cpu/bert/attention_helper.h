@@ -173,5 +173,20 @@ T* ConcatStateChunk(const T* past,
   return start;
 }
 
+// Append an input state chunk LxH after the past state chunk PxH held by a present state chunk MxH,
+// when past and present share the same buffer of max sequence length M.
+// Returns a pointer to the start of present state chunk.
+template <typename T>
+T* AppendStateChunk(const T* chunk,
+                    T* present,
+                    size_t past_chunk_length,
+                    size_t input_chunk_length,
+                    size_t present_chunk_length,
+                    std::ptrdiff_t i) {
+  T* start = present + i * present_chunk_length;
+  memcpy(start + past_chunk_length, chunk, input_chunk_length * sizeof(T));
+  return start;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
@@ -3,8 +3,14 @@
 
 #if !defined(DISABLE_SPARSE_TENSORS)
 
+#include <algorithm>
+#include <numeric>
+
 #include "core/framework/sparse_tensor.h"
+#include "core/common/inlined_containers.h"
 #include "core/common/narrow.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
 #include "core/providers/cpu/math/gemm_matmul_common.h"
 #include "core/providers/cpu/math/matmul_helper.h"
 #include "core/util/math.h"
@@ -45,75 +51,204 @@ struct ComputeCtx {
   bool trans_A;
   bool trans_B;
   float alpha;
+  concurrency::ThreadPool* thread_pool;
 };
 
-#if !defined(__i386__) && !defined(_M_IX86) && !defined(__wasm__) && !defined(__ANDROID__)
 template <typename T>
-inline void SparseDenseMatMulImpl(const ComputeCtx& ctx, const ConstSparseMatrixMap<T>& map_A,
-                                  const ConstEigenMatrixMapRowMajor<T>& map_B, EigenMatrixMapRowMajor<T>& output_map) {
-  if (ctx.trans_A && ctx.trans_B) {
-    output_map = map_A.transpose() * map_B.transpose();
-  } else if (ctx.trans_A && !ctx.trans_B) {
-    output_map = map_A.transpose() * map_B;
-  } else if (!ctx.trans_A && ctx.trans_B) {
-    output_map = map_A * map_B.transpose();
-  } else {
-    output_map = map_A * map_B;
+inline T ApplyAlpha(T a_value, float) {
+  return a_value;
+}
+
+template <>
+inline float ApplyAlpha<float>(float a_value, float alpha) {
+  return a_value * alpha;
+}
+
+// Below this number of multiply-adds a partition is not worth a thread
+constexpr int64_t kMinWorkPerPartition = 32 * 1024;
+
+// Runs fn(row_begin, row_end) over ranges of the rows of a row compressed matrix so that every range holds about
+// the same number of nonzeros. A row costs its nonzeros plus one for writing out the output row, and every unit
+// costs work_per_unit multiply-adds. Balancing by nonzeros rather than by rows keeps threads busy when a few rows
+// hold most of the values, which is common for pruned weights.
+template <typename F>
+void ParallelForBalancedRows(concurrency::ThreadPool* thread_pool, gsl::span<const int64_t> outer,
+                             int64_t work_per_unit, F&& fn) {
+  const int64_t rows = static_cast<int64_t>(outer.size()) - 1;
+  if (rows <= 0) {
+    return;
+  }
+
+  auto units_before = [&outer](int64_t row) { return outer[row] - outer[0] + row; };
+  const int64_t total_units = units_before(rows);
+
+  int64_t num_partitions = std::min<int64_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool), rows);
+  num_partitions = std::min<int64_t>(num_partitions,
+                                     std::max<int64_t>(1, total_units * work_per_unit / kMinWorkPerPartition));
+  if (num_partitions <= 1) {
+    fn(0, rows);
+    return;
   }
+
+  InlinedVector<int64_t> bounds(narrow<size_t>(num_partitions + 1));
+  bounds[0] = 0;
+  bounds[narrow<size_t>(num_partitions)] = rows;
+  for (int64_t p = 1; p < num_partitions; ++p) {
+    const int64_t target = total_units * p / num_partitions;
+    int64_t lo = bounds[narrow<size_t>(p - 1)];
+    int64_t hi = rows;
+    while (lo < hi) {
+      const int64_t mid = lo + (hi - lo) / 2;
+      if (units_before(mid) < target) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    bounds[narrow<size_t>(p)] = lo;
+  }
+
+  concurrency::ThreadPool::TrySimpleParallelFor(thread_pool, num_partitions, [&](std::ptrdiff_t p) {
+    fn(bounds[narrow<size_t>(p)], bounds[narrow<size_t>(p + 1)]);
+  });
 }
 
-template<> inline
-void SparseDenseMatMulImpl<float>(const ComputeCtx& ctx, const ConstSparseMatrixMap<float>& map_A,
-                                  const ConstEigenMatrixMapRowMajor<float>& map_B, EigenMatrixMapRowMajor<float>& output_map) {
-  if (ctx.trans_A && ctx.trans_B) {
-    output_map = map_A.transpose() * ctx.alpha * map_B.transpose();
-  } else if (ctx.trans_A && !ctx.trans_B) {
-    output_map = map_A.transpose() * ctx.alpha * map_B;
-  } else if (!ctx.trans_A && ctx.trans_B) {
-    output_map = map_A * ctx.alpha * map_B.transpose();
-  } else {
-    output_map = map_A * ctx.alpha * map_B;
+// Row compressed op(A). Either a view of a CSR input or built from the input when A is transposed or COO.
+template <typename T>
+struct CsrMatrix {
+  gsl::span<const int64_t> outer;
+  gsl::span<const int64_t> inner;
+  gsl::span<const T> values;
+
+  std::vector<int64_t> outer_buffer;
+  std::vector<int64_t> inner_buffer;
+  std::vector<T> values_buffer;
+};
+
+// Counting sort of nnz (row, col, value) entries in any order into the row compressed form.
+template <typename T, typename RowOf, typename ColOf>
+Status BuildCsr(int64_t rows, int64_t cols, size_t nnz, RowOf row_of, ColOf col_of, gsl::span<const T> values,
+                CsrMatrix<T>& csr) {
+  csr.outer_buffer.assign(narrow<size_t>(rows + 1), 0);
+  for (size_t i = 0; i < nnz; ++i) {
+    const int64_t row = row_of(i);
+    const int64_t col = col_of(i);
+    ORT_RETURN_IF_NOT(row >= 0 && row < rows, "Sparse row index: ", row, " is out of bounds of: ", rows);
+    ORT_RETURN_IF_NOT(col >= 0 && col < cols, "Sparse column index: ", col, " is out of bounds of: ", cols);
+    ++csr.outer_buffer[narrow<size_t>(row + 1)];
   }
+  for (size_t r = 1; r < csr.outer_buffer.size(); ++r) {
+    csr.outer_buffer[r] += csr.outer_buffer[r - 1];
+  }
+
+  std::vector<int64_t> next(csr.outer_buffer.begin(), csr.outer_buffer.end() - 1);
+  csr.inner_buffer.resize(nnz);
+  csr.values_buffer.resize(nnz);
+  for (size_t i = 0; i < nnz; ++i) {
+    const auto pos = narrow<size_t>(next[narrow<size_t>(row_of(i))]++);
+    csr.inner_buffer[pos] = col_of(i);
+    csr.values_buffer[pos] = values[i];
+  }
+
+  csr.outer = csr.outer_buffer;
+  csr.inner = csr.inner_buffer;
+  csr.values = csr.values_buffer;
+  return Status::OK();
+}
+
+// Y[m, :] = sum over the nonzeros A[m, k] of alpha * A[m, k] * B[k, :] with B row-major [K, N].
+// Every output row is owned by a single thread so no synchronization is needed.
+template <typename T>
+void CsrTimesDense(const ComputeCtx& ctx, const CsrMatrix<T>& a, const T* b, int64_t n, T* y) {
+  ParallelForBalancedRows(ctx.thread_pool, a.outer, n, [&](int64_t row_begin, int64_t row_end) {
+    const int64_t* inner = a.inner.data();
+    const T* values = a.values.data();
+    auto b_row = [b, n](int64_t k) { return ConstEigenVectorArrayMap<T>(b + k * n, narrow<size_t>(n)); };
+
+    for (int64_t m = row_begin; m < row_end; ++m) {
+      EigenVectorArrayMap<T> y_row(y + m * n, narrow<size_t>(n));
+      y_row.setZero();
+
+      int64_t p = a.outer[m];
+      const int64_t p_end = a.outer[m + 1];
+      // four nonzeros per pass over the output row to cut its loads and stores
+      for (; p + 4 <= p_end; p += 4) {
+        y_row += ApplyAlpha(values[p], ctx.alpha) * b_row(inner[p]) +
+                 ApplyAlpha(values[p + 1], ctx.alpha) * b_row(inner[p + 1]) +
+                 ApplyAlpha(values[p + 2], ctx.alpha) * b_row(inner[p + 2]) +
+                 ApplyAlpha(values[p + 3], ctx.alpha) * b_row(inner[p + 3]);
+      }
+      for (; p < p_end; ++p) {
+        y_row += ApplyAlpha(values[p], ctx.alpha) * b_row(inner[p]);
+      }
+    }
+  });
 }
 
-// Handle CSR sparse format using Eigen
-template <class T>
+// Makes B row-major [K, N], transposing it into buffer when needed.
+template <typename T>
+const T* DenseOperand(const ComputeCtx& ctx, const Tensor& B, std::vector<T>& buffer) {
+  const auto& b_dims = B.Shape().GetDims();
+  if (!ctx.trans_B) {
+    return B.Data<T>();
+  }
+  buffer.resize(narrow<size_t>(b_dims[0] * b_dims[1]));
+  EigenMatrixMapRowMajor<T>(buffer.data(), narrow<size_t>(b_dims[1]), narrow<size_t>(b_dims[0])) =
+      ConstEigenMatrixMapRowMajor<T>(B.Data<T>(), narrow<size_t>(b_dims[0]), narrow<size_t>(b_dims[1])).transpose();
+  return buffer.data();
+}
+
+template <typename T>
 struct SparseToDenseCsr {
-  void operator()(const ComputeCtx& ctx, const SparseTensor& A, const Tensor& B, Tensor& output) const {
+  Status operator()(const ComputeCtx& ctx, const SparseTensor& A, const Tensor& B, Tensor& output) const {
     const auto& a_dims = A.DenseShape().GetDims();
-    const auto& b_dims = B.Shape().GetDims();
     const auto& out_dims = output.Shape().GetDims();
+    const auto nnz = A.NumValues();
     auto csr_view = A.AsCsr();
+    auto outer = csr_view.Outer().DataAsSpan<int64_t>();
+    auto inner = csr_view.Inner().DataAsSpan<int64_t>();
+    auto a_values = A.Values().DataAsSpan<T>();
 
-    ConstSparseMatrixMap<T> map_A(a_dims[0], a_dims[1], A.NumValues(),
-                                  csr_view.Outer().Data<int64_t>(),
-                                  csr_view.Inner().Data<int64_t>(),
-                                  A.Values().Data<T>());
-    ConstEigenMatrixMapRowMajor<T> map_B(B.Data<T>(), b_dims[0], b_dims[1]);
-    EigenMatrixMapRowMajor<T> output_map(output.MutableData<T>(), out_dims[0], out_dims[1]);
-    // XXX: Consider re-writing it as a parallel loop as Eigen requires it to use OpenMP
-    // XXX: Consider vectorization
-    SparseDenseMatMulImpl(ctx, map_A, map_B, output_map);
-  }
-};
-
-#endif  //!defined(__i386__) && !defined(_M_IX86) && !defined(__wasm__) && !defined(__ANDROID__)
+    ORT_RETURN_IF_NOT(outer.front() == 0 && outer.back() == static_cast<int64_t>(nnz),
+                      "CSR outer indices must start at 0 and end at NNZ: ", nnz);
+    // every row range below indexes the values, so check all of them before using any
+    for (size_t r = 0; r + 1 < outer.size(); ++r) {
+      ORT_RETURN_IF_NOT(outer[r] <= outer[r + 1] && outer[r + 1] <= static_cast<int64_t>(nnz),
+                        "CSR outer indices must be non-decreasing and not exceed NNZ: ", nnz);
+    }
 
-template<typename T> inline
-T Mul(T a_value, float, T b_value) {
-  return a_value * b_value;
-}
+    CsrMatrix<T> csr;
+    if (ctx.trans_A) {
+      // rows of A^T are the columns of A
+      std::vector<int64_t> row_of_value(nnz);
+      for (size_t r = 0; r + 1 < outer.size(); ++r) {
+        std::fill(row_of_value.begin() + outer[r], row_of_value.begin() + outer[r + 1], static_cast<int64_t>(r));
+      }
+      ORT_RETURN_IF_ERROR(BuildCsr<T>(
+          a_dims[1], a_dims[0], nnz,
+          [&inner](size_t i) { return inner[i]; },
+          [&row_of_value](size_t i) { return row_of_value[i]; },
+          a_values, csr));
+    } else {
+      for (auto k : inner) {
+        ORT_RETURN_IF_NOT(k >= 0 && k < a_dims[1], "CSR inner index: ", k, " is out of bounds of: ", a_dims[1]);
+      }
+      csr.outer = outer;
+      csr.inner = inner;
+      csr.values = a_values;
+    }
 
-template <> inline
-constexpr float Mul<float>(float a_value, float alpha, float b_value) {
-  return a_value * alpha * b_value;
-}
+    std::vector<T> b_buffer;
+    const T* b_data = DenseOperand<T>(ctx, B, b_buffer);
+    CsrTimesDense(ctx, csr, b_data, out_dims[1], output.MutableData<T>());
+    return Status::OK();
+  }
+};
 
-// Inspired by TensorFlow SparseTensorDenseMatmul
 template <typename T>
 struct SparseToDenseCoo {
   Status operator()(const ComputeCtx& ctx, const SparseTensor& A, const Tensor& B, Tensor& output) const {
-    const auto& b_dims = B.Shape().GetDims();
+    const auto& a_dims = A.DenseShape().GetDims();
     const auto& out_dims = output.Shape().GetDims();
     const auto nnz = A.NumValues();
 
@@ -121,30 +256,108 @@ struct SparseToDenseCoo {
     auto coo_view = A.AsCoo();
     const auto& ind_dims = coo_view.Indices().Shape().GetDims();
     ORT_RETURN_IF_NOT(ind_dims.size() == 2, "COO indices must be 2-D, got: ", ind_dims.size());
-    ConstEigenMatrixMapRowMajor<int64_t> a_indicies_map(coo_view.Indices().Data<int64_t>(), narrow<size_t>(ind_dims[0]), narrow<size_t>(ind_dims[1]));
-    ConstEigenMatrixMapRowMajor<T> map_b(B.Data<T>(), narrow<size_t>(b_dims[0]), narrow<size_t>(b_dims[1]));
-    EigenMatrixMapRowMajor<T> output_map(output.MutableData<T>(), narrow<size_t>(out_dims[0]), narrow<size_t>(out_dims[1]));
-    output_map.setZero();
-
-    const auto rhs_right = (ctx.trans_B) ? b_dims[0] : b_dims[1];
-    const auto lhs_right = (ctx.trans_B) ? b_dims[1] : b_dims[0];
-    const int lhs_index_a = (ctx.trans_A) ? 1 : 0;
-    const int rhs_index_a = (ctx.trans_A) ? 0 : 1;
-    const auto out_left = out_dims[0];
-
-    // XXX: Make this parallel
-    for (size_t i = 0; i < nnz; ++i) {
-      const auto m = a_indicies_map(i, lhs_index_a);
-      const auto k = a_indicies_map(i, rhs_index_a);
-      ORT_RETURN_IF_NOT(k < lhs_right, "COO k index: ", k, " is out of bounds of lhs_right: ", lhs_right);
-      ORT_RETURN_IF_NOT(m < out_left, "COO m index: ", m, " is out of bounds of out_left: ", out_left);
-      const T a_value = a_values[i];
-      for (int64_t n = 0; n < rhs_right; ++n) {
-        const T b_value = (ctx.trans_B) ? map_b(narrow<size_t>(n), narrow<size_t>(k)) : map_b(narrow<size_t>(k), narrow<size_t>(n));
-        output_map(narrow<size_t>(m), narrow<size_t>(n)) += Mul(a_value, ctx.alpha, b_value);
-      }
+    const int64_t* indices = coo_view.Indices().Data<int64_t>();
+
+    // indices are (row, col) pairs in any order, sort them into the rows of op(A)
+    const size_t lhs_index_a = (ctx.trans_A) ? 1 : 0;
+    const size_t rhs_index_a = (ctx.trans_A) ? 0 : 1;
+    const int64_t rows = (ctx.trans_A) ? a_dims[1] : a_dims[0];
+    const int64_t cols = (ctx.trans_A) ? a_dims[0] : a_dims[1];
+
+    CsrMatrix<T> csr;
+    ORT_RETURN_IF_ERROR(BuildCsr<T>(
+        rows, cols, nnz,
+        [indices, lhs_index_a](size_t i) { return indices[2 * i + lhs_index_a]; },
+        [indices, rhs_index_a](size_t i) { return indices[2 * i + rhs_index_a]; },
+        a_values, csr));
+
+    std::vector<T> b_buffer;
+    const T* b_data = DenseOperand<T>(ctx, B, b_buffer);
+    CsrTimesDense(ctx, csr, b_data, out_dims[1], output.MutableData<T>());
+    return Status::OK();
+  }
+};
+
+// Multiplies a dense block of op(A) with block_size rows of B and accumulates into block_size rows of Y.
+template <typename T>
+inline void BlockTimesDense(const T* block, bool transpose_block, float, int64_t block_size,
+                            const T* b, int64_t n, T* y) {
+  ConstEigenMatrixMapRowMajor<T> block_map(block, narrow<size_t>(block_size), narrow<size_t>(block_size));
+  ConstEigenMatrixMapRowMajor<T> b_map(b, narrow<size_t>(block_size), narrow<size_t>(n));
+  EigenMatrixMapRowMajor<T> y_map(y, narrow<size_t>(block_size), narrow<size_t>(n));
+  if (transpose_block) {
+    y_map.noalias() += block_map.transpose() * b_map;
+  } else {
+    y_map.noalias() += block_map * b_map;
+  }
+}
+
+template <>
+inline void BlockTimesDense<float>(const float* block, bool transpose_block, float alpha, int64_t block_size,
+                                   const float* b, int64_t n, float* y) {
+  const auto bs = narrow<size_t>(block_size);
+  MlasGemm(transpose_block ? CblasTrans : CblasNoTrans, CblasNoTrans, bs, narrow<size_t>(n), bs,
+           alpha, block, bs, b, narrow<size_t>(n), 1.0f, y, narrow<size_t>(n), nullptr);
+}
+
+// Block sparse (BSR) A as used for structured pruning: values are [num_blocks, block_size, block_size] dense
+// row-major blocks and indices are [2, num_blocks] holding the block row and the block column of every block.
+template <typename T>
+struct SparseToDenseBlockSparse {
+  Status operator()(const ComputeCtx& ctx, const SparseTensor& A, const Tensor& B, Tensor& output) const {
+    const auto& a_dims = A.DenseShape().GetDims();
+    const auto& out_dims = output.Shape().GetDims();
+    const auto& values_dims = A.Values().Shape().GetDims();
+    T* y = output.MutableData<T>();
+
+    if (A.Values().Shape().Size() == 0) {
+      std::fill_n(y, output.Shape().Size(), T{});
+      return Status::OK();
     }
 
+    ORT_RETURN_IF_NOT(values_dims.size() == 3 && values_dims[1] == values_dims[2],
+                      "Block sparse values must be [num_blocks, block_size, block_size]. Got: ",
+                      A.Values().Shape());
+    const int64_t num_blocks = values_dims[0];
+    const int64_t block_size = values_dims[1];
+    ORT_RETURN_IF_NOT(block_size > 0 && a_dims[0] % block_size == 0 && a_dims[1] % block_size == 0,
+                      "Dense shape of A: ", A.DenseShape(), " must be a multiple of block size: ", block_size);
+
+    const auto& indices_tensor = A.AsBlockSparse().Indices();
+    ORT_RETURN_IF_NOT(indices_tensor.Shape().Size() == 2 * num_blocks,
+                      "Block sparse indices must be [2, num_blocks]. Got: ", indices_tensor.Shape());
+    const int32_t* indices = indices_tensor.Data<int32_t>();
+    const int32_t* row_indices = (ctx.trans_A) ? indices + num_blocks : indices;
+    const int32_t* col_indices = (ctx.trans_A) ? indices : indices + num_blocks;
+    const int64_t block_rows = ((ctx.trans_A) ? a_dims[1] : a_dims[0]) / block_size;
+    const int64_t block_cols = ((ctx.trans_A) ? a_dims[0] : a_dims[1]) / block_size;
+
+    // sort the blocks into the block rows of op(A), the values hold the index of each block
+    std::vector<int64_t> block_ids(narrow<size_t>(num_blocks));
+    std::iota(block_ids.begin(), block_ids.end(), int64_t{0});
+    CsrMatrix<int64_t> bsr;
+    ORT_RETURN_IF_ERROR(BuildCsr<int64_t>(
+        block_rows, block_cols, narrow<size_t>(num_blocks),
+        [row_indices](size_t i) { return static_cast<int64_t>(row_indices[i]); },
+        [col_indices](size_t i) { return static_cast<int64_t>(col_indices[i]); },
+        gsl::make_span(block_ids), bsr));
+
+    std::vector<T> b_buffer;
+    const T* b_data = DenseOperand<T>(ctx, B, b_buffer);
+    const T* a_values = A.Values().Data<T>();
+    const int64_t n = out_dims[1];
+    const int64_t block_elements = block_size * block_size;
+
+    ParallelForBalancedRows(ctx.thread_pool, bsr.outer, block_elements * n, [&](int64_t row_begin, int64_t row_end) {
+      for (int64_t br = row_begin; br < row_end; ++br) {
+        T* y_rows = y + br * block_size * n;
+        std::fill_n(y_rows, block_size * n, T{});
+        for (int64_t p = bsr.outer[br]; p < bsr.outer[br + 1]; ++p) {
+          BlockTimesDense<T>(a_values + bsr.values[p] * block_elements, ctx.trans_A, ctx.alpha, block_size,
+                             b_data + bsr.inner[p] * block_size * n, n, y_rows);
+        }
+      }
+    });
     return Status::OK();
   }
 };
@@ -176,10 +389,14 @@ Status SparseToDenseMatMul::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{outer_A, outer_B};
   auto* output = ctx->Output(0, output_shape);
 
+  // Bail out early if the output is going to be empty
+  if (output_shape.Size() == 0)
+    return Status::OK();
+
   utils::MLTypeCallDispatcher<float, double, int32_t, uint32_t, int64_t, uint64_t> t_disp(A->GetElementType());
   // I am not expecting to do the below in every kernel but this is a reference
   // implementation to show the expectations.
-  ComputeCtx compute_ctx{trans_a_attr_ != 0, trans_b_attr_ != 0, alpha_attr_};
+  ComputeCtx compute_ctx{trans_a_attr_ != 0, trans_b_attr_ != 0, alpha_attr_, ctx->GetOperatorThreadPool()};
   if (A->Format() == SparseFormat::kCoo) {
     auto coo_view = A->AsCoo();
     const auto num_dims = coo_view.Indices().Shape().NumDimensions();
@@ -187,23 +404,17 @@ Status SparseToDenseMatMul::Compute(OpKernelContext* ctx) const {
     ORT_RETURN_IF_NOT(A->Values().Shape().Size() * 2 == coo_view.Indices().Shape().Size(), "Expecting 2xValues == indices");
     auto status = t_disp.InvokeRet<Status, SparseToDenseCoo>(compute_ctx, *A, *B, *output);
     ORT_RETURN_IF_ERROR(status);
-// Eigen has a bug in x86 where it calculates reallocation size as -1
-// and throws bad_alloc
-#if !defined(__i386__) && !defined(_M_IX86) && !defined(__wasm__) && !defined(__ANDROID__)
   } else if (A->Format() == SparseFormat::kCsrc) {
     auto csr_view = A->AsCsr();
     ORT_RETURN_IF_NOT(A->Values().Shape().Size() == csr_view.Inner().Shape().Size(),
                       "Expecting the same number NNZ == size of Inner indices");
     ORT_RETURN_IF_NOT((A_shape.GetDims()[0] + 1) == csr_view.Outer().Shape().Size(), "Outer size must be M + 1");
-    t_disp.Invoke<SparseToDenseCsr>(compute_ctx, *A, *B, *output);
-  } else {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Currently support only COO and CSR(x64) formats");
-  }
-#else
+    ORT_RETURN_IF_ERROR((t_disp.InvokeRet<Status, SparseToDenseCsr>(compute_ctx, *A, *B, *output)));
+  } else if (A->Format() == SparseFormat::kBlockSparse) {
+    ORT_RETURN_IF_ERROR((t_disp.InvokeRet<Status, SparseToDenseBlockSparse>(compute_ctx, *A, *B, *output)));
   } else {
-    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "WASM and 32-bit builds support only COO format");
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Currently support only COO, CSR and block sparse formats");
   }
-#endif //!defined(__i386__) && !defined(_M_IX86) && !defined(__wasm__) && !defined(__ANDROID__)
 
   return Status::OK();
 }
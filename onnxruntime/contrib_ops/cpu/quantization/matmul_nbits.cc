@@ -0,0 +1,188 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class MatMulNBits final : public OpKernel {
+ public:
+  MatMulNBits(const OpKernelInfo& info)
+      : OpKernel(info),
+        K_{narrow<size_t>(info.GetAttr<int64_t>("K"))},
+        N_{narrow<size_t>(info.GetAttr<int64_t>("N"))},
+        block_size_{narrow<size_t>(info.GetAttr<int64_t>("block_size"))},
+        nbits_{narrow<size_t>(info.GetAttrOrDefault<int64_t>("bits", 4))} {
+    ORT_ENFORCE(nbits_ == 4, "Only 4-bit weights are supported. Got bits=", nbits_);
+    ORT_ENFORCE(MlasQ4GemmPackBSize(block_size_, N_, K_) != 0,
+                "block_size must be 32, 64 or 128. Got ", block_size_);
+  }
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+  Status UsePersistedPrePackedBuffers(const Tensor& /*tensor*/, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx, /*out*/ bool& used_persisted_buffers) override {
+    // B is packed with its scales and zero points, the packed buffer holds all the state
+    return UseSharedPrePackedBuffers(prepacked_buffers, input_idx, used_persisted_buffers);
+  }
+
+  bool CanUsePersistedPrePackedBuffers(int input_idx) const override { return input_idx == 1; }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  Status ValidateInputs(const Tensor& b, const Tensor& scales, const Tensor* zero_points) const;
+
+  const size_t K_;
+  const size_t N_;
+  const size_t block_size_;
+  const size_t nbits_;
+  BufferUniquePtr packed_b_;
+};
+
+Status MatMulNBits::ValidateInputs(const Tensor& b, const Tensor& scales, const Tensor* zero_points) const {
+  const size_t k_blocks = (K_ + block_size_ - 1) / block_size_;
+  const size_t blob_size = block_size_ * nbits_ / 8;
+
+  ORT_RETURN_IF_NOT(b.Shape().Size() == static_cast<int64_t>(SafeInt<size_t>(N_) * k_blocks * blob_size),
+                    "Input B must have ", N_ * k_blocks * blob_size, " elements. Got shape ", b.Shape());
+  ORT_RETURN_IF_NOT(scales.Shape().Size() == static_cast<int64_t>(SafeInt<size_t>(N_) * k_blocks),
+                    "Input scales must have ", N_ * k_blocks, " elements. Got shape ", scales.Shape());
+  ORT_RETURN_IF_NOT(zero_points == nullptr ||
+                        zero_points->Shape().Size() == static_cast<int64_t>(SafeInt<size_t>(N_) * ((k_blocks + 1) / 2)),
+                    "Input zero_points must have ", N_ * ((k_blocks + 1) / 2), " elements. Got shape ",
+                    zero_points->Shape());
+  return Status::OK();
+}
+
+Status MatMulNBits::PrePack(const Tensor& tensor, int input_idx, /*out*/ AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // B is packed together with its scales and zero points, so all of them must be constant initializers.
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  const Tensor* scales = nullptr;
+  const Tensor* zero_points = nullptr;
+  if (!Info().TryGetConstantInput(2, &scales)) {
+    return Status::OK();
+  }
+  const auto& input_defs = Info().node().InputDefs();
+  if (input_defs.size() > 3 && input_defs[3]->Exists() && !Info().TryGetConstantInput(3, &zero_points)) {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(ValidateInputs(tensor, *scales, zero_points));
+
+  const size_t packed_b_size = MlasQ4GemmPackBSize(block_size_, N_, K_);
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(alloc));
+
+  MlasQ4GemmPackB(block_size_, N_, K_, tensor.Data<uint8_t>(), scales->Data<float>(),
+                  zero_points ? zero_points->Data<uint8_t>() : nullptr, packed_b_data);
+
+  is_packed = true;
+
+  bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (share_prepacked_weights) {
+    prepacked_weights->buffers_.push_back(std::move(packed_b_));
+    prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+  }
+
+  return Status::OK();
+}
+
+Status MatMulNBits::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status MatMulNBits::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+
+  // The weights are packed per call when they are not constant initializers.
+  BufferUniquePtr packed_b_per_call;
+  const void* packed_b = packed_b_.get();
+  if (packed_b == nullptr) {
+    const Tensor* b = ctx->Input<Tensor>(1);
+    const Tensor* scales = ctx->Input<Tensor>(2);
+    const Tensor* zero_points = ctx->Input<Tensor>(3);
+    ORT_RETURN_IF_ERROR(ValidateInputs(*b, *scales, zero_points));
+
+    AllocatorPtr alloc;
+    ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+    auto* packed_b_data = alloc->Alloc(MlasQ4GemmPackBSize(block_size_, N_, K_));
+    packed_b_per_call = BufferUniquePtr(packed_b_data, BufferDeleter(std::move(alloc)));
+
+    MlasQ4GemmPackB(block_size_, N_, K_, b->Data<uint8_t>(), scales->Data<float>(),
+                    zero_points ? zero_points->Data<uint8_t>() : nullptr, packed_b_data);
+    packed_b = packed_b_data;
+  }
+
+  TensorShape b_shape({static_cast<int64_t>(K_), static_cast<int64_t>(N_)});
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape, false, false));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const auto* a_data = a->Data<float>();
+  auto* y_data = y->MutableData<float>();
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+  const size_t lda = helper.Lda(false);
+
+  std::vector<MLAS_Q4GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = lda;
+    data[i].B = packed_b;
+    data[i].Bias = nullptr;
+    data[i].C = y_data + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+  MlasQ4GemmBatch(block_size_, M, N, K, max_len, data.data(), thread_pool);
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulNBits,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulNBits);
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -8,6 +8,9 @@
 #include "core/framework/op_kernel.h"
 #include "re2/re2.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace onnxruntime {
 namespace contrib {
 
@@ -36,6 +39,9 @@ class Tokenizer final : public OpKernel {
   int64_t mincharnum_{0};
   bool char_tokenezation_{false};
   std::vector<std::unique_ptr<re2::RE2>> separators_;
+  // Populated when none of the separators has regex metacharacters,
+  // they are then searched for directly instead of running the regexes.
+  std::vector<std::string> literal_separators_;
   std::unique_ptr<re2::RE2> regex_;
 };
 
@@ -52,6 +58,32 @@ ONNX_CPU_OPERATOR_TYPED_MS_KERNEL(
 namespace tokenizer_details {
 constexpr char start_text = 0x2;
 constexpr char end_text = 0x3;
+
+inline bool IsLiteral(const std::string& pattern) {
+  return !pattern.empty() && pattern.find_first_of("\\^$.|?*+()[]{}") == std::string::npos;
+}
+
+// Finds the first occurrence of literal in text at or after start_pos,
+// which is what RE2 matches for a pattern without metacharacters.
+inline bool MatchLiteral(re2::StringPiece text, size_t start_pos, const std::string& literal,
+                         re2::StringPiece* submatch) {
+  const char* const text_end = text.data() + text.size();
+  const char* pos = text.data() + start_pos;
+  const size_t len = literal.size();
+  while (static_cast<size_t>(text_end - pos) >= len) {
+    // memchr scans for the first byte many bytes at a time
+    pos = static_cast<const char*>(memchr(pos, literal[0], static_cast<size_t>(text_end - pos) - len + 1));
+    if (pos == nullptr) {
+      return false;
+    }
+    if (memcmp(pos + 1, literal.data() + 1, len - 1) == 0) {
+      *submatch = re2::StringPiece(pos, len);
+      return true;
+    }
+    ++pos;
+  }
+  return false;
+}
 }  // namespace tokenizer_details
 
 using namespace tokenizer_details;
@@ -100,6 +132,9 @@ Tokenizer::Tokenizer(const OpKernelInfo& info) : OpKernel(info) {
         }
         separators_.push_back(std::move(regex));
       }
+      if (std::all_of(separators.begin(), separators.end(), IsLiteral)) {
+        literal_separators_ = separators;
+      }
     } else {
       // Use tokenexp
       assert(!tokenexp.empty());
@@ -196,8 +231,12 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                                                size_t N, size_t C,
                                                gsl::span<const int64_t> input_dims) const {
   using namespace re2;
-  std::vector<std::vector<StringPiece>> rows;
-  rows.reserve(N * C);
+  // The tokens of all the rows one after the other
+  std::vector<StringPiece> all_tokens;
+  std::vector<size_t> row_sizes;
+  row_sizes.reserve(N * C);
+  std::vector<StringPiece> row;
+  std::vector<StringPiece> tokens;
 
   // We do not constraint the search to match
   // on the beginning or end of the string
@@ -219,10 +258,10 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
                     "Input string contains invalid utf8 chars: " + s);
     }
 
-    std::vector<StringPiece> row{s};
+    row.assign(1, StringPiece(s));
 
-    for (const auto& sep : separators_) {
-      std::vector<StringPiece> tokens;
+    for (size_t sep_idx = 0; sep_idx < separators_.size(); ++sep_idx) {
+      tokens.clear();
       for (const auto& text : row) {
         const auto end_pos = text.length();
         size_t start_pos = 0;
@@ -230,7 +269,11 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
 
         bool match = true;
         do {
-          match = sep->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+          if (!literal_separators_.empty()) {
+            match = MatchLiteral(text, start_pos, literal_separators_[sep_idx], &submatch);
+          } else {
+            match = separators_[sep_idx]->Match(text, start_pos, end_pos, anchor, &submatch, 1);
+          }
           if (match) {
             // Record  pos/len
             assert(submatch.data() != nullptr);
@@ -273,7 +316,8 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
       row.swap(tokens);
     }  // separators_
     max_tokens = std::max(max_tokens, row.size());
-    rows.push_back(std::move(row));
+    all_tokens.insert(all_tokens.end(), row.begin(), row.end());
+    row_sizes.push_back(row.size());
     ++curr_input;
   }
 
@@ -301,8 +345,9 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
   const size_t max_output_index = N * C * max_tokens;
 #endif
   size_t output_index = 0;
+  auto token = all_tokens.cbegin();
   curr_input = input_data;
-  for (auto& row : rows) {
+  for (size_t row_size : row_sizes) {
 #ifdef _DEBUG
     size_t c_idx = output_index;
 #endif
@@ -311,15 +356,15 @@ Status Tokenizer::SeparatorExpressionTokenizer(OpKernelContext* ctx,
       ++output_index;
     }
     // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.size());
+    for (auto const row_end = token + row_size; token != row_end; ++token) {
+      (output_data + output_index)->assign(token->data(), token->size());
       ++output_index;
     }
     if (mark_) {
       (output_data + output_index)->assign(&end_text, 1);
       ++output_index;
     }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
+    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row_size;
     for (size_t p = 0; p < pads; ++p) {
       *(output_data + output_index) = pad_value_;
       ++output_index;
@@ -337,10 +382,10 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                                   size_t N, size_t C,
                                   gsl::span<const int64_t> input_dims) const {
   using namespace re2;
-  // Represents a token that will be output after
-  // first is the index, second is the size;
-  std::vector<std::vector<StringPiece>> tokens;
-  tokens.reserve(N * C);
+  // The tokens of all the rows one after the other
+  std::vector<StringPiece> all_tokens;
+  std::vector<size_t> row_sizes;
+  row_sizes.reserve(N * C);
 
   size_t max_tokens = 0;
   auto X = ctx->Input<Tensor>(0);
@@ -362,8 +407,7 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                     "Input string contains invalid utf8 chars: " + s);
     }
 
-    tokens.emplace_back();
-    auto& row = tokens.back();
+    const size_t row_start = all_tokens.size();
 
     StringPiece text(s);
     const auto end_pos = s.length();
@@ -387,7 +431,7 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
                         "Match contains invalid utf8 chars: " + submatch.as_string());
         }
         if (utf8_chars >= size_t(mincharnum_)) {
-          row.push_back(submatch);
+          all_tokens.push_back(submatch);
           start_pos = match_pos + token_len;
         } else {
           size_t bytes = 0;
@@ -396,7 +440,8 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
         }
       }
     } while (match);
-    max_tokens = std::max(max_tokens, row.size());
+    row_sizes.push_back(all_tokens.size() - row_start);
+    max_tokens = std::max(max_tokens, row_sizes.back());
     ++curr_input;
   }
 
@@ -426,7 +471,8 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
 #endif
   curr_input = input_data;
   size_t output_index = 0;
-  for (const auto& row : tokens) {
+  auto token = all_tokens.cbegin();
+  for (size_t row_size : row_sizes) {
     assert(curr_input != last);
 #ifdef _DEBUG
     size_t c_idx = output_index;
@@ -436,15 +482,15 @@ Status Tokenizer::TokenExpression(OpKernelContext* ctx,
       ++output_index;
     }
     // Output tokens for this row
-    for (const auto& token : row) {
-      (output_data + output_index)->assign(token.data(), token.length());
+    for (auto const row_end = token + row_size; token != row_end; ++token) {
+      (output_data + output_index)->assign(token->data(), token->length());
       ++output_index;
     }
     if (mark_) {
       (output_data + output_index)->assign(&end_text, 1);
       ++output_index;
     }
-    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row.size();
+    const size_t pads = max_tokens - (static_cast<size_t>(mark_) * 2) - row_size;
     for (size_t p = 0; p < pads; ++p) {
       *(output_data + output_index) = pad_value_;
       ++output_index;
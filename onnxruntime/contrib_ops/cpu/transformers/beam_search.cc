@@ -26,6 +26,7 @@
 #include "core/framework/TensorSeq.h"
 #include "core/framework/allocator.h"
 #include "core/framework/ort_value.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/common/gsl.h"
 #include "contrib_ops/cpu/transformers/beam_search.h"
 #include "contrib_ops/cpu/transformers/logits_processor.h"
@@ -59,6 +60,10 @@ namespace transformers {
 
 void BeamSearch::Init(const OpKernelInfo& info) {
   parameters_.ParseFromAttributes(info);
+  const auto* provider = info.GetExecutionProvider();
+  parameters_.compact_finished_sequences =
+      provider->Type() == kCpuExecutionProvider &&
+      static_cast<const CPUExecutionProvider*>(provider)->GetInfo().generation_compact_finished_sequences;
 
   // Model_type could be either 0 (GPT-2) or 1 (encoder-decoder like T5)
   ORT_ENFORCE(parameters_.model_type == IGenerationParameters::kModelTypeGpt ||
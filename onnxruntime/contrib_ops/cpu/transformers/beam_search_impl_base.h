@@ -266,6 +266,7 @@ Status BeamSearchBase<T>::GenerateNextToken(
 #endif
 
   cpu_state.sequences.AppendNextTokenToSequences(beam_indices, beam_next_tokens);
+  StreamNextTokens(cpu_state.sequences.GetSequenceLength(), beam_next_tokens, beam_indices);
 
 #ifdef DEBUG_GENERATION
   cpu_state.sequences.PrintSequences(&cpu_dumper_);
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <numeric>
+
 #include "contrib_ops/cpu/transformers/beam_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/generation_device_helper.h"
 
 #include "core/common/span_utils.h"
 
@@ -230,6 +233,20 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // When enabled, beams of batch entries that the scorer has finished are evicted from the batch fed to the
+  // decoder subgraph. active_rows holds the rows in the full batch that are still searched, in increasing order.
+  // Scores of finished rows would no longer be computed, so it is not used when the scores output is requested.
+  const bool compact_finished_sequences = parameters->compact_finished_sequences &&
+                                          !this->IsCuda() &&
+                                          !parameters->output_scores;
+  const int num_beams = parameters->num_beams;
+  std::vector<int32_t> active_rows(static_cast<size_t>(parameters->BatchBeamSize()));
+  std::iota(active_rows.begin(), active_rows.end(), 0);
+  std::vector<int32_t> active_positions(active_rows.size());
+  std::vector<int32_t> active_next_tokens;
+  std::vector<int32_t> active_indices;
+  std::vector<int32_t> remaining_rows;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -279,7 +296,12 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    OrtValue expanded_logits;
+    if (active_rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      GenerationCpuDeviceHelper::ExpandCompactedLogits<T>(this->temp_space_allocator_, fetches[0], active_rows,
+                                                          parameters->BatchBeamSize(), expanded_logits);
+    }
+    const OrtValue& logits = expanded_logits.IsAllocated() ? expanded_logits : fetches[0];
     gsl::span<int32_t> beam_next_tokens;
     gsl::span<int32_t> beam_indices;
     ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
@@ -302,10 +324,51 @@ Status BeamSearchGpt<T>::Execute(const FeedsFetchesManager* init_run_feeds_fetch
       // For the first iteration, position_ids is initialized as sequence lengths. We can add it to feeds directly.
       // For the remaining iterations, we need increase position_ids first, then add it to feeds.
       bool increase_position = (iteration_counter > 1);
-      ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
-                                      position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(beam_next_tokens),
-                                      ReinterpretAsSpan<const int32_t>(beam_indices)));
+      if (!compact_finished_sequences) {
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        ReinterpretAsSpan<const int32_t>(beam_next_tokens),
+                                        ReinterpretAsSpan<const int32_t>(beam_indices)));
+      } else {
+        // Feeds are updated for the rows that were run in this iteration, with beam indices translated to
+        // positions in the compacted batch. Then beams of batch entries that are done are removed.
+        // The scorer pads a finished batch entry with beam index 0, which might not be active any more.
+        // Those rows are removed right after, so they pick their own past state instead.
+        std::fill(active_positions.begin(), active_positions.end(), -1);
+        for (size_t i = 0; i < active_rows.size(); i++) {
+          active_positions[active_rows[i]] = static_cast<int32_t>(i);
+        }
+
+        active_next_tokens.clear();
+        active_indices.clear();
+        remaining_rows.clear();
+        for (size_t i = 0; i < active_rows.size(); i++) {
+          const int32_t row = active_rows[i];
+          const int32_t source = active_positions[beam_indices[row]];
+          active_next_tokens.push_back(beam_next_tokens[row]);
+          active_indices.push_back(source >= 0 ? source : static_cast<int32_t>(i));
+          if (!this->beam_scorer_->IsDone(static_cast<size_t>(row / num_beams))) {
+            remaining_rows.push_back(static_cast<int32_t>(i));
+          }
+        }
+
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        active_next_tokens,
+                                        active_indices));
+
+        if (remaining_rows.size() < active_rows.size()) {
+          ORT_RETURN_IF_ERROR(GenerationCpuDeviceHelper::CompactGptFeeds<T>(this->temp_space_allocator_,
+                                                                             feeds,
+                                                                             position_ids,
+                                                                             remaining_rows,
+                                                                             gpt_subgraph_.GetFirstPastInputIndex()));
+          for (size_t i = 0; i < remaining_rows.size(); i++) {
+            active_rows[i] = active_rows[remaining_rows[i]];
+          }
+          active_rows.resize(remaining_rows.size());
+        }
+      }
     }
     fetches.clear();
   }
@@ -92,6 +92,9 @@ class BeamSearchScorer : public IBeamScorer {
 
   bool IsDone();
 
+  // Whether all beams of the given batch entry are finished.
+  bool IsDone(size_t batch) const { return done_[batch]; }
+
   gsl::span<float>& GetNextScores() { return next_beam_scores_; }
   gsl::span<int32_t>& GetNextTokens() { return next_beam_tokens_; }
   gsl::span<int32_t>& GetNextIndices() { return next_beam_indices_; }
@@ -89,6 +89,12 @@ class GenerateBase {
     cpu_allocator_ = decoder_session_state.GetExecutionProviders()
                          .Get(onnxruntime::kCpuExecutionProvider)
                          ->GetAllocator(OrtMemTypeDefault);
+
+    const RunOptions* run_options = context_.GetRunOptions();
+    if (run_options != nullptr) {
+      streaming_callback_ = run_options->generation_streaming_callback;
+      streaming_callback_user_data_ = run_options->generation_streaming_callback_user_data;
+    }
   }
 
   virtual ~GenerateBase() = default;
@@ -212,6 +218,19 @@ class GenerateBase {
  protected:
   bool IsCuda() const { return ort_stream_ != nullptr; }
 
+  // Pass the tokens appended to the sequences in this step to the streaming callback of the run, if any.
+  void StreamNextTokens(int sequence_length,
+                        gsl::span<const int32_t> next_tokens,
+                        gsl::span<const int32_t> beam_indices) const {
+    if (streaming_callback_ != nullptr) {
+      streaming_callback_(streaming_callback_user_data_,
+                          static_cast<int32_t>(sequence_length),
+                          next_tokens.data(),
+                          beam_indices.empty() ? nullptr : beam_indices.data(),
+                          static_cast<int64_t>(next_tokens.size()));
+    }
+  }
+
   const IConsoleDumper* GetConsoleDumper() const { return IsCuda() ? cuda_dumper_ : &(cpu_dumper_); }
 
   OpKernelContextInternal& context_;
@@ -235,6 +254,9 @@ class GenerateBase {
   // Device specific functions
   GenerationDeviceHelper::TopkFunc topk_func_;
   GenerationDeviceHelper::DeviceCopyFunc<float> device_copy_func_;
+
+  GenerationStreamingCallbackFn streaming_callback_ = nullptr;
+  void* streaming_callback_user_data_ = nullptr;
 };
 
 }  // namespace transformers
@@ -645,6 +645,98 @@ Status UpdateGptFeeds(
   return Status::OK();
 }
 
+// Gather rows of a tensor with shape (num_rows, ...).
+template <typename T>
+static OrtValue GatherRows(AllocatorPtr allocator, const OrtValue& input, gsl::span<const int32_t> rows) {
+  const Tensor& input_tensor = input.Get<Tensor>();
+  TensorShape shape = input_tensor.Shape();
+  const auto row_size = onnxruntime::narrow<size_t>(shape.SizeFromDimension(1));
+  shape[0] = static_cast<int64_t>(rows.size());
+
+  OrtValue output;
+  Tensor::InitOrtValue(input_tensor.DataType(), shape, allocator, output);
+  const T* source = input_tensor.Data<T>();
+  T* target = output.GetMutable<Tensor>()->MutableData<T>();
+  for (size_t i = 0; i < rows.size(); i++) {
+    std::copy_n(source + static_cast<size_t>(rows[i]) * row_size, row_size, target + i * row_size);
+  }
+  return output;
+}
+
+template <typename T>
+Status CompactGptFeeds(
+    AllocatorPtr allocator,
+    std::vector<OrtValue>& feeds,
+    OrtValue& position_ids,
+    gsl::span<const int32_t> rows,
+    int gpt_subgraph_first_past_input_idx) {
+  // feeds: input_ids, position_id, attention_mask, past_0, past_1, ...
+  feeds[0] = GatherRows<int32_t>(allocator, feeds[0], rows);
+  feeds[2] = GatherRows<int32_t>(allocator, feeds[2], rows);
+
+  // position_ids uses a buffer that is updated in place by UpdateGptFeeds, so keep using the same buffer.
+  // Rows are in increasing order, so rows[i] >= i and the copy never overwrites a row that is still needed.
+  Tensor* position_tensor = position_ids.GetMutable<Tensor>();
+  int32_t* position_data = position_tensor->MutableData<int32_t>();
+  for (size_t i = 0; i < rows.size(); i++) {
+    position_data[i] = position_data[rows[i]];
+  }
+  int64_t position_dims[] = {static_cast<int64_t>(rows.size()), 1};
+  TensorShape position_shape(&position_dims[0], 2);
+  OrtValue compacted_position_ids;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), position_shape, position_data,
+                       position_tensor->Location(), compacted_position_ids);
+  position_ids = compacted_position_ids;
+  feeds[1] = position_ids;
+
+  // Past state has shape like (2, batch_beam_size, num_heads, past_seq_len, head_size).
+  for (size_t i = gpt_subgraph_first_past_input_idx; i < feeds.size(); ++i) {
+    const Tensor& past = feeds[i].Get<Tensor>();
+    TensorShape past_shape = past.Shape();
+    ORT_RETURN_IF(past_shape.NumDimensions() != 5 || past_shape[0] != 2,
+                  "Past state is expected to have shape (2, batch_beam_size, num_heads, past_seq_len, head_size)");
+    const auto block_size_per_row = onnxruntime::narrow<size_t>(past_shape.SizeFromDimension(2));
+    const auto past_key_size = onnxruntime::narrow<size_t>(past_shape.SizeFromDimension(1));
+    past_shape[1] = static_cast<int64_t>(rows.size());
+
+    OrtValue compacted_past;
+    Tensor::InitOrtValue(past.DataType(), past_shape, allocator, compacted_past);
+    const T* past_data = past.Data<T>();
+    T* compacted_data = compacted_past.GetMutable<Tensor>()->MutableData<T>();
+    const size_t compacted_key_size = rows.size() * block_size_per_row;
+    for (size_t j = 0; j < rows.size(); j++) {
+      const size_t offset = static_cast<size_t>(rows[j]) * block_size_per_row;
+      std::copy_n(past_data + offset, block_size_per_row, compacted_data + j * block_size_per_row);
+      std::copy_n(past_data + past_key_size + offset, block_size_per_row,
+                  compacted_data + compacted_key_size + j * block_size_per_row);
+    }
+    feeds[i] = compacted_past;
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+void ExpandCompactedLogits(
+    AllocatorPtr allocator,
+    const OrtValue& logits,
+    gsl::span<const int32_t> rows,
+    int batch_beam_size,
+    OrtValue& expanded_logits) {
+  const Tensor& logits_tensor = logits.Get<Tensor>();
+  TensorShape shape = logits_tensor.Shape();
+  const auto row_size = onnxruntime::narrow<size_t>(shape.SizeFromDimension(1));
+  shape[0] = batch_beam_size;
+
+  Tensor::InitOrtValue(logits_tensor.DataType(), shape, allocator, expanded_logits);
+  T* target = expanded_logits.GetMutable<Tensor>()->MutableData<T>();
+  std::fill_n(target, onnxruntime::narrow<size_t>(shape.Size()), T{});
+  const T* source = logits_tensor.Data<T>();
+  for (size_t i = 0; i < rows.size(); i++) {
+    std::copy_n(source + i * row_size, row_size, target + static_cast<size_t>(rows[i]) * row_size);
+  }
+}
+
 // ---------------------------------------------------------------
 // The following functions are for encoder-decoder model like T5
 // ---------------------------------------------------------------
@@ -897,6 +989,34 @@ template Status UpdateGptFeeds<float>(
     bool past_present_share_buffer,
     int past_sequence_len);
 
+template Status CompactGptFeeds<float>(
+    AllocatorPtr allocator,
+    std::vector<OrtValue>& feeds,
+    OrtValue& position_ids,
+    gsl::span<const int32_t> rows,
+    int gpt_subgraph_first_past_input_idx);
+
+template void ExpandCompactedLogits<float>(
+    AllocatorPtr allocator,
+    const OrtValue& logits,
+    gsl::span<const int32_t> rows,
+    int batch_beam_size,
+    OrtValue& expanded_logits);
+
+template Status CompactGptFeeds<MLFloat16>(
+    AllocatorPtr allocator,
+    std::vector<OrtValue>& feeds,
+    OrtValue& position_ids,
+    gsl::span<const int32_t> rows,
+    int gpt_subgraph_first_past_input_idx);
+
+template void ExpandCompactedLogits<MLFloat16>(
+    AllocatorPtr allocator,
+    const OrtValue& logits,
+    gsl::span<const int32_t> rows,
+    int batch_beam_size,
+    OrtValue& expanded_logits);
+
 template Status UpdateDecoderFeeds<float>(
     AllocatorPtr allocator,
     Stream* stream,
@@ -262,6 +262,28 @@ Status UpdateGptFeeds(
     bool past_present_share_buffer,
     int past_sequence_len);
 
+// Keep only the given rows of GPT subgraph inputs (input_ids, position_ids, attention_mask and past state),
+// so that finished sequences are no longer run through the decoder. Rows are indices into the current feeds
+// in increasing order. position_ids is compacted in place and shall be the same OrtValue as feeds[1].
+template <typename T>
+Status CompactGptFeeds(
+    AllocatorPtr allocator,
+    std::vector<OrtValue>& feeds,
+    OrtValue& position_ids,
+    gsl::span<const int32_t> rows,
+    int gpt_subgraph_first_past_input_idx);
+
+// Scatter logits of shape (num_rows, input_length, vocab_size) that are computed for a compacted batch to
+// a tensor of shape (batch_beam_size, input_length, vocab_size). rows[i] is the row in the full batch that
+// row i of logits belongs to. Rows not listed are filled with zeros.
+template <typename T>
+void ExpandCompactedLogits(
+    AllocatorPtr allocator,
+    const OrtValue& logits,
+    gsl::span<const int32_t> rows,
+    int batch_beam_size,
+    OrtValue& expanded_logits);
+
 // ---------------------------------------------------------------
 // Functions for encoder-decoder model like T5
 // ---------------------------------------------------------------
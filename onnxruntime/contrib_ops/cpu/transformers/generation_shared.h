@@ -161,6 +161,9 @@ struct IGenerationParameters {
   int seed = 0;
   int min_tokens_to_keep = 1;
   bool custom_sampling = false;
+
+  // Parameters from session options.
+  bool compact_finished_sequences = false;  // evict finished sequences from the decoder batch
 };
 
 }  // namespace transformers
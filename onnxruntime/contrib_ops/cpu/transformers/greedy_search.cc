@@ -26,6 +26,7 @@
 #include "core/framework/session_options.h"
 #include "core/framework/TensorSeq.h"
 #include "core/framework/ort_value.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/common/gsl.h"
 #include "contrib_ops/cpu/transformers/greedy_search.h"
 #include "contrib_ops/cpu/transformers/logits_processor.h"
@@ -78,6 +79,10 @@ std::pair<Status, std::unique_ptr<GptSubgraph>> CreateGptSubgraphAndUpdateParame
 
 void GreedySearch::Init(const OpKernelInfo& info) {
   parameters_.ParseFromAttributes(info);
+  const auto* provider = info.GetExecutionProvider();
+  parameters_.compact_finished_sequences =
+      provider->Type() == kCpuExecutionProvider &&
+      static_cast<const CPUExecutionProvider*>(provider)->GetInfo().generation_compact_finished_sequences;
   parameters_.vocab_size = (parameters_.vocab_size == 0 ? -1 : parameters_.vocab_size);
 
   // Model_type could be either 0 (GPT-2) or 1 (encoder-decoder like T5)
@@ -258,6 +258,7 @@ Status GreedySearchBase<T, ParametersT>::GenerateNextToken(
   }
 
   greedy_state.sequences.AppendNextTokenToSequences(next_tokens);
+  this->StreamNextTokens(greedy_state.sequences.GetSequenceLength(), next_tokens, {});
 
 #ifdef DEBUG_GENERATION
   greedy_state.sequences.PrintSequences(&cpu_dumper_);
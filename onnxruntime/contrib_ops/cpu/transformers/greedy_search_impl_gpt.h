@@ -3,10 +3,12 @@
 
 #pragma once
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "core/common/span_utils.h"
 #include "contrib_ops/cpu/transformers/greedy_search_impl_base.h"
+#include "contrib_ops/cpu/transformers/generation_device_helper.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -237,6 +239,16 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
                        this->temp_space_allocator_->Info(),
                        position_ids);
 
+  // When enabled, sequences that have met EOS are evicted from the batch fed to the decoder subgraph.
+  // active_rows holds the rows in the full batch that are still generating, in increasing order.
+  const bool compact_finished_sequences = parameters->compact_finished_sequences &&
+                                          !this->IsCuda() &&
+                                          !gpt_subgraph_.past_present_share_buffer_;
+  std::vector<int32_t> active_rows(static_cast<size_t>(parameters->BatchBeamSize()));
+  std::iota(active_rows.begin(), active_rows.end(), 0);
+  std::vector<int32_t> active_next_tokens;
+  std::vector<int32_t> remaining_rows;
+
   int current_length = parameters->sequence_length;
   int iteration_counter = 0;
   while (current_length < parameters->max_length) {
@@ -281,7 +293,12 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
 
     ORT_RETURN_IF_ERROR(status);
 
-    const OrtValue& logits = fetches[0];
+    OrtValue expanded_logits;
+    if (active_rows.size() < static_cast<size_t>(parameters->BatchBeamSize())) {
+      GenerationCpuDeviceHelper::ExpandCompactedLogits<T>(this->temp_space_allocator_, fetches[0], active_rows,
+                                                          parameters->BatchBeamSize(), expanded_logits);
+    }
+    const OrtValue& logits = expanded_logits.IsAllocated() ? expanded_logits : fetches[0];
     gsl::span<int32_t> next_tokens;
 
     ORT_RETURN_IF_ERROR(this->GenerateNextToken(logits,
@@ -311,10 +328,39 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     if (current_length < parameters->max_length) {
       bool increase_position = (iteration_counter > 1);
 
-      ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
-                                      position_ids, increase_position,
-                                      ReinterpretAsSpan<const int32_t>(next_tokens),
-                                      current_length - 1));
+      if (!compact_finished_sequences) {
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        ReinterpretAsSpan<const int32_t>(next_tokens),
+                                        current_length - 1));
+      } else {
+        // Feeds are updated for the rows that were run in this iteration, then the finished rows are removed.
+        active_next_tokens.clear();
+        remaining_rows.clear();
+        for (size_t i = 0; i < active_rows.size(); i++) {
+          active_next_tokens.push_back(next_tokens[active_rows[i]]);
+          if (!eos_meet[active_rows[i]]) {
+            remaining_rows.push_back(static_cast<int32_t>(i));
+          }
+        }
+
+        ORT_RETURN_IF_ERROR(UpdateFeeds(fetches, feeds, current_length,
+                                        position_ids, increase_position,
+                                        active_next_tokens,
+                                        current_length - 1));
+
+        if (remaining_rows.size() < active_rows.size()) {
+          ORT_RETURN_IF_ERROR(GenerationCpuDeviceHelper::CompactGptFeeds<T>(this->temp_space_allocator_,
+                                                                             feeds,
+                                                                             position_ids,
+                                                                             remaining_rows,
+                                                                             gpt_subgraph_.GetFirstPastInputIndex()));
+          for (size_t i = 0; i < remaining_rows.size(); i++) {
+            active_rows[i] = active_rows[remaining_rows[i]];
+          }
+          active_rows.resize(remaining_rows.size());
+        }
+      }
     }
     if (gpt_subgraph_.past_present_share_buffer_) {
       // clear fetched values before presents[]
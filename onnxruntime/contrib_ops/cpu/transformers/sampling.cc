@@ -11,6 +11,7 @@
 
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "contrib_ops/cpu/transformers/sampling.h"
 #include "contrib_ops/cpu/transformers/logits_processor.h"
 #include "contrib_ops/cpu/transformers/sequences.h"
@@ -40,6 +41,10 @@ namespace transformers {
 
 void Sampling::Init(const OpKernelInfo& info) {
   parameters_.ParseFromAttributes(info);
+  const auto* provider = info.GetExecutionProvider();
+  parameters_.compact_finished_sequences =
+      provider->Type() == kCpuExecutionProvider &&
+      static_cast<const CPUExecutionProvider*>(provider)->GetInfo().generation_compact_finished_sequences;
   parameters_.vocab_size = (parameters_.vocab_size == 0 ? -1 : parameters_.vocab_size);
 
   // Model_type could be either 0 (GPT-2) or 1 (encoder-decoder like T5)
@@ -13,12 +13,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 #include <optional>
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
 #include "core/common/cpuid_info.h"
+#include "core/common/hash_combine.h"
 #include "core/common/eigen_common_wrapper.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 #include "core/platform/ort_mutex.h"
@@ -308,19 +311,22 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 
   // Attempt to claim iterations from the sharded counter.  The function either
   // returns true, along with a block of exactly block_size iterations, or it returns false
-  // if all of the iterations have been claimed.
+  // if all of the iterations have been claimed.  Blocks claimed from a shard other than
+  // the home shard have steal_block_size iterations instead (block_size by default).
   bool ClaimIterations(unsigned my_home_shard,
                        unsigned& my_shard,
                        uint64_t& my_start,
                        uint64_t& my_end,
-                       uint64_t block_size) {
+                       uint64_t block_size,
+                       uint64_t steal_block_size = 0) {
     do {
       if (_shards[my_shard]._next < _shards[my_shard]._end) {
         // Appears to be work in the current shard, try to claim with atomic fetch-and-add
-        uint64_t temp_start = _shards[my_shard]._next.fetch_add(block_size);
+        uint64_t claim_size = (my_shard == my_home_shard || steal_block_size == 0) ? block_size : steal_block_size;
+        uint64_t temp_start = _shards[my_shard]._next.fetch_add(claim_size);
         if (temp_start < _shards[my_shard]._end) {
           my_start = temp_start;
-          my_end = std::min(_shards[my_shard]._end, temp_start + block_size);
+          my_end = std::min(_shards[my_shard]._end, temp_start + claim_size);
           return true;
         }
       }
@@ -369,6 +375,57 @@ class alignas(CACHE_LINE_BYTES) LoopCounter {
 #pragma warning(pop) /* Padding added in LoopCounterShard, LoopCounter */
 #endif
 
+// Weight of a new measurement in the moving average of the cost of a loop.
+static constexpr double CostSmoothingFactor = 0.25;
+
+const ParallelForCostTable::Entry* ParallelForCostTable::Find(uint64_t key) const {
+  for (unsigned i = 0; i < kMaxProbes; i++) {
+    const Entry& entry = entries_[(key + i) & (kNumEntries - 1)];
+    uint64_t entry_key = entry.key.load(std::memory_order_acquire);
+    if (entry_key == key) {
+      return &entry;
+    }
+    if (entry_key == 0) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+ParallelForCostTable::Entry* ParallelForCostTable::FindOrInsert(uint64_t key) {
+  for (unsigned i = 0; i < kMaxProbes; i++) {
+    Entry& entry = entries_[(key + i) & (kNumEntries - 1)];
+    uint64_t entry_key = entry.key.load(std::memory_order_acquire);
+    if (entry_key == 0 && entry.key.compare_exchange_strong(entry_key, key, std::memory_order_acq_rel)) {
+      return &entry;
+    }
+    // entry_key holds the key of the entry, whether it was already used or used concurrently.
+    if (entry_key == key) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+double ParallelForCostTable::Lookup(uint64_t key) const {
+  const Entry* entry = Find(key);
+  return entry == nullptr ? -1 : entry->ns_per_iteration.load(std::memory_order_relaxed);
+}
+
+void ParallelForCostTable::Record(uint64_t key, uint64_t num_iterations, uint64_t nanoseconds) {
+  if (num_iterations == 0) {
+    return;
+  }
+  Entry* entry = FindOrInsert(key);
+  if (entry == nullptr) {
+    return;
+  }
+  double sample = static_cast<double>(nanoseconds) / static_cast<double>(num_iterations);
+  double average = entry->ns_per_iteration.load(std::memory_order_relaxed);
+  entry->ns_per_iteration.store(average < 0 ? sample : average + (sample - average) * CostSmoothingFactor,
+                                std::memory_order_relaxed);
+}
+
 ThreadPool::ThreadPool(Env* env,
                        const ThreadOptions& thread_options,
                        const NAME_CHAR_TYPE* name,
@@ -396,6 +453,10 @@ ThreadPool::ThreadPool(Env* env,
                                                 *env,
                                                 thread_options_);
     underlying_threadpool_ = extended_eigen_threadpool_.get();
+
+    if (thread_options_.adaptive_block_size_ && thread_options_.dynamic_block_base_ <= 0) {
+      cost_table_ = std::make_unique<ParallelForCostTable>();
+    }
   }
 }
 
@@ -420,7 +481,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     // Split the work across threads in the pool.  Each work item will run a loop claiming iterations,
     // hence we need at most one for each thread, even if the number of blocks of iterations is larger.
     auto num_blocks = total / block_size;
-    auto num_threads_inc_main = NumThreads() + 1;
+    auto num_threads_inc_main = NumThreadsForCaller();
     int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(num_threads_inc_main), num_blocks));
     assert(num_work_items > 0);
 
@@ -459,7 +520,7 @@ void ThreadPool::ParallelForFixedBlockSizeScheduling(const std::ptrdiff_t total,
     };
     // Distribute task among all threads in the pool, reduce number of work items if 
     // num_of_blocks is smaller than number of threads.
-    RunInParallel(run_work, std::min(NumThreads() + 1, num_of_blocks), base_block_size);
+    RunInParallel(run_work, std::min(NumThreadsForCaller(), num_of_blocks), base_block_size);
   }
 }
 
@@ -495,7 +556,10 @@ std::string ThreadPool::StopProfiling() {
 
 namespace {
 thread_local std::optional<ThreadPoolParallelSection> current_parallel_section;
-}
+
+// Number of callers sharing the threads of the pools with the current thread, see ThreadShareScope.
+thread_local int current_num_callers = 1;
+}  // namespace
 
 ThreadPool::ParallelSection::ParallelSection(ThreadPool* tp) {
   ORT_ENFORCE(!current_parallel_section.has_value(), "Nested parallelism not supported");
@@ -515,6 +579,15 @@ ThreadPool::ParallelSection::~ParallelSection() {
   }
 }
 
+ThreadPool::ThreadShareScope::ThreadShareScope(int num_callers)
+    : previous_num_callers_(current_num_callers) {
+  current_num_callers = std::max(1, num_callers);
+}
+
+ThreadPool::ThreadShareScope::~ThreadShareScope() {
+  current_num_callers = previous_num_callers_;
+}
+
 void ThreadPool::RunInParallel(std::function<void(unsigned idx)> fn, unsigned n, std::ptrdiff_t block_size) {
   if (underlying_threadpool_) {
     if (current_parallel_section.has_value()) {
@@ -546,6 +619,11 @@ bool ThreadPool::ShouldParallelizeLoop(const std::ptrdiff_t num_iterations,
     return false;
   }
 
+  // Do not parallelize loops when the share of the pool of the caller is a single thread.
+  if (NumThreadsForCaller() == 1) {
+    return false;
+  }
+
   return true;
 }
 
@@ -611,8 +689,13 @@ static ptrdiff_t CalculateParallelForBlock(const ptrdiff_t n, const Eigen::Tenso
 }
 
 void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
-                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f) {
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f,
+                             const ParallelForCallSite& call_site) {
   ORT_ENFORCE(n >= 0);
+  if (cost_table_) {
+    AdaptiveParallelFor(n, c, f, call_site);
+    return;
+  }
   Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
   auto d_of_p = DegreeOfParallelism(this);
   // Compute small problems directly in the caller thread.
@@ -626,6 +709,85 @@ void ThreadPool::ParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
   ParallelForFixedBlockSizeScheduling(n, block, f);
 }
 
+// The cost model works with cycles while the measured costs are times, they are converted
+// assuming a 3GHz clock.  Only the relative costs of the loops matter to choose the block sizes.
+static constexpr double CyclesPerNanosecond = 3.0;
+
+// Blocks stolen from another shard are this many times smaller than the blocks of the home shard,
+// which balances the end of the loop when the measured cost is not uniform across iterations.
+static constexpr std::ptrdiff_t StealGranularityFactor = 4;
+
+// Identifies a loop run through ParallelFor.  The source location of the TryParallelFor call
+// identifies the call site, the type of the callable separates the instantiations of a call
+// site in a template, and the static cost distinguishes the loops of a call site which depend
+// on the shapes of the inputs.
+static uint64_t ParallelForKey(const TensorOpCost& c,
+                               const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f,
+                               const ParallelForCallSite& call_site) {
+  size_t key = 0;
+  HashCombine(reinterpret_cast<uintptr_t>(call_site.file), key);
+  HashCombine(call_site.line, key);
+#ifndef ORT_NO_RTTI
+  HashCombine(f.target_type().hash_code(), key);
+#else
+  ORT_UNUSED_PARAMETER(f);
+#endif
+  HashCombine(c.bytes_loaded, key);
+  HashCombine(c.bytes_stored, key);
+  HashCombine(c.compute_cycles, key);
+  return key == 0 ? 1 : static_cast<uint64_t>(key);
+}
+
+static uint64_t NanosecondsSince(std::chrono::steady_clock::time_point start) {
+  return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
+void ThreadPool::AdaptiveParallelFor(std::ptrdiff_t n, const TensorOpCost& c,
+                                     const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& f,
+                                     const ParallelForCallSite& call_site) {
+  const uint64_t key = ParallelForKey(c, f, call_site);
+  Eigen::TensorOpCost cost{c.bytes_loaded, c.bytes_stored, c.compute_cycles};
+  double measured_ns = cost_table_->Lookup(key);
+  if (measured_ns >= 0) {
+    cost = Eigen::TensorOpCost{0, 0, measured_ns * CyclesPerNanosecond};
+  }
+
+  auto d_of_p = DegreeOfParallelism(this);
+  ptrdiff_t block = n;
+  if (ShouldParallelizeLoop(n) && CostModel::numThreads(static_cast<double>(n), cost, d_of_p) != 1) {
+    block = CalculateParallelForBlock(n, cost, nullptr, d_of_p);
+  }
+
+  // Compute small problems directly in the caller thread.  The loop is still measured
+  // so that a cost underestimated by the caller is corrected on the next run.
+  if (n <= block) {
+    auto start = std::chrono::steady_clock::now();
+    f(0, n);
+    cost_table_->Record(key, static_cast<uint64_t>(n), NanosecondsSince(start));
+    return;
+  }
+
+  auto num_blocks = n / block;
+  int num_work_items = static_cast<int>(std::min(static_cast<std::ptrdiff_t>(NumThreadsForCaller()), num_blocks));
+  uint64_t steal_block = static_cast<uint64_t>(std::max<std::ptrdiff_t>(1, block / StealGranularityFactor));
+  LoopCounter lc(n, d_of_p, block);
+  alignas(CACHE_LINE_BYTES) std::atomic<uint64_t> busy_ns{0};
+  std::function<void(unsigned)> run_work = [&](unsigned idx) {
+    auto start = std::chrono::steady_clock::now();
+    unsigned my_home_shard = lc.GetHomeShard(idx);
+    unsigned my_shard = my_home_shard;
+    uint64_t my_iter_start, my_iter_end;
+    while (lc.ClaimIterations(my_home_shard, my_shard, my_iter_start, my_iter_end, block, steal_block)) {
+      f(static_cast<std::ptrdiff_t>(my_iter_start),
+        static_cast<std::ptrdiff_t>(my_iter_end));
+    }
+    busy_ns.fetch_add(NanosecondsSince(start), std::memory_order_relaxed);
+  };
+  RunInParallel(run_work, num_work_items, block);
+  cost_table_->Record(key, static_cast<uint64_t>(n), busy_ns.load(std::memory_order_relaxed));
+}
+
 void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
                              const std::function<void(std::ptrdiff_t first, std::ptrdiff_t)>& fn) {
   ParallelFor(total, TensorOpCost{0, 0, static_cast<double>(cost_per_unit)}, fn);
@@ -640,9 +802,9 @@ int ThreadPool::DegreeOfParallelism(const concurrency::ThreadPool* tp) {
   // tp, plus 1 for the thread entering a loop.
   if (tp) {
     if (tp->force_hybrid_ || CPUIDInfo::GetCPUIDInfo().IsHybrid()) {
-      return ((tp->NumThreads() + 1)) * TaskGranularityFactor;
+      return tp->NumThreadsForCaller() * TaskGranularityFactor;
     } else {
-      return ((tp->NumThreads() + 1));
+      return tp->NumThreadsForCaller();
     }
   } else {
     return 1;
@@ -684,6 +846,11 @@ int ThreadPool::NumThreads() const {
   }
 }
 
+int ThreadPool::NumThreadsForCaller() const {
+  const int num_threads = NumThreads() + 1;
+  return current_num_callers > 1 ? std::max(1, num_threads / current_num_callers) : num_threads;
+}
+
 // Return ID of the current thread within this pool.  Returns -1 for a thread outside the
 // current pool.
 int ThreadPool::CurrentThreadId() const {
@@ -695,12 +862,13 @@ int ThreadPool::CurrentThreadId() const {
 }
 
 void ThreadPool::TryParallelFor(concurrency::ThreadPool* tp, std::ptrdiff_t total, const TensorOpCost& cost_per_unit,
-                                const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn) {
+                                const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn,
+                                const ParallelForCallSite& call_site) {
   if (tp == nullptr) {
     fn(0, total);
     return;
   }
-  tp->ParallelFor(total, cost_per_unit, fn);
+  tp->ParallelFor(total, cost_per_unit, fn, call_site);
 }
 
 }  // namespace concurrency
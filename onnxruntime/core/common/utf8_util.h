@@ -5,9 +5,54 @@
 
 #include "core/common/common.h"
 
+#include <cstring>
+
 namespace onnxruntime {
 namespace utf8_util {
 
+// Returns the number of leading ASCII bytes of s.
+// Checks 8 bytes at a time as ASCII text is the common case.
+inline size_t ascii_prefix_len(const unsigned char* s, size_t len) {
+  constexpr uint64_t high_bits = 0x8080808080808080ULL;
+  size_t idx = 0;
+  for (; idx + sizeof(uint64_t) <= len; idx += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, s + idx, sizeof(word));
+    if ((word & high_bits) != 0) {
+      break;
+    }
+  }
+  while (idx < len && s[idx] < 0x80u) {
+    ++idx;
+  }
+  return idx;
+}
+
+// Converts the ASCII string s to lower (or upper) case in place, 8 bytes at a time.
+// All the bytes of s must be ASCII.
+inline void ascii_change_case(char* s, size_t len, bool to_upper) {
+  // A byte is in [first, last] if adding 0x80 - first sets its high bit and adding 0x7F - last does not.
+  // Bytes are below 0x80 so the additions never carry into the next byte.
+  constexpr uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t first = (to_upper ? 'a' : 'A') * ones;
+  const uint64_t last = (to_upper ? 'z' : 'Z') * ones;
+  size_t idx = 0;
+  for (; idx + sizeof(uint64_t) <= len; idx += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, s + idx, sizeof(word));
+    const uint64_t in_range = ((word + 0x80 * ones - first) ^ (word + 0x7F * ones - last)) & (0x80 * ones);
+    // the case bit is 0x20
+    word ^= in_range >> 2;
+    memcpy(s + idx, &word, sizeof(word));
+  }
+  for (; idx < len; ++idx) {
+    const char ch = s[idx];
+    if (to_upper ? (ch >= 'a' && ch <= 'z') : (ch >= 'A' && ch <= 'Z')) {
+      s[idx] = static_cast<char>(ch ^ 0x20);
+    }
+  }
+}
+
 // Returns the number of bytes in the utf8 character
 // by analyzing its leading byte
 inline bool utf8_bytes(unsigned char ch, size_t& len) {
@@ -33,7 +78,9 @@ inline bool utf8_bytes(unsigned char ch, size_t& len) {
 
 // Computes length of the utf8 string in characters
 inline bool utf8_len(const unsigned char* s, size_t bytes, size_t& len) {
-  size_t result = 0;
+  size_t result = ascii_prefix_len(s, bytes);
+  s += result;
+  bytes -= result;
   while (bytes > 0) {
     size_t char_bytes = 0;
     bool valid = utf8_bytes(*s, char_bytes);
@@ -49,8 +96,8 @@ inline bool utf8_len(const unsigned char* s, size_t bytes, size_t& len) {
 }
 
 inline bool utf8_validate(const unsigned char* s, size_t len, size_t& utf8_chars) {
-  size_t utf8_len = 0;
-  size_t idx = 0;
+  size_t utf8_len = ascii_prefix_len(s, len);
+  size_t idx = utf8_len;
   while (idx < len) {
     size_t bytes = 0;
     auto ch = s[idx];
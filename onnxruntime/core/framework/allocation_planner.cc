@@ -8,6 +8,8 @@
 #include <sstream>
 #include <ctime>
 #include <iomanip>
+#include <limits>
+#include <numeric>
 #include "core/common/exceptions.h"
 #include "core/common/inlined_containers.h"
 #include "core/common/safeint.h"
@@ -1753,7 +1755,11 @@ class PlannerImpl {
   void
   PartitionIntoStreams(const logging::Logger& logger, const ExecutionProviders& execution_providers,
                        const PathString& partition_config_file) {
-    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file);
+    // subgraphs are run in single thread mode, only the main graph is worth splitting along its critical path
+    const auto default_strategy = context_->IsCriticalPathPartitionEnabled() && parent_node_ == nullptr
+                                      ? IGraphPartitioner::GraphPartitioningStrategy::CriticalPathPartition
+                                      : IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+    auto partitioner = IGraphPartitioner::CreateGraphPartitioner(logger, partition_config_file, default_strategy);
     auto status = partitioner->PartitionGraph(graph_viewer_, execution_providers, stream_nodes_, context_->GetExecutionOrder());
     ORT_ENFORCE(status.IsOK(), status.ErrorMessage());
     node_stream_map_.resize(SafeInt<size_t>(graph_viewer_.MaxNodeIndex()) + 1);
@@ -2347,12 +2353,355 @@ void DeviceBasedPartitioner::SaveConfig() const {
   }
 }
 
+namespace {
+
+// Number of elements of a value, its unknown dims are counted as 1.
+double NumElements(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists()) {
+    return 0.0;
+  }
+
+  double num_elements = 1.0;
+  const auto* shape = arg->Shape();
+  if (shape != nullptr) {
+    for (const auto& dim : shape->dim()) {
+      if (utils::HasDimValue(dim)) {
+        num_elements *= static_cast<double>(dim.dim_value());
+      }
+    }
+  }
+  return num_elements;
+}
+
+// Value of a dim of arg, or 1 if it is unknown. Negative axes count from the last dim.
+double DimValue(const NodeArg* arg, int axis) {
+  const auto* shape = (arg != nullptr && arg->Exists()) ? arg->Shape() : nullptr;
+  if (shape == nullptr) {
+    return 1.0;
+  }
+
+  if (axis < 0) {
+    axis += shape->dim_size();
+  }
+  if (axis < 0 || axis >= shape->dim_size() || !utils::HasDimValue(shape->dim(axis))) {
+    return 1.0;
+  }
+  return static_cast<double>(shape->dim(axis).dim_value());
+}
+
+// Rough number of operations of a node. The contractions multiply every element of their output by the size of
+// the reduced dims, the other nodes touch every element of their inputs and outputs about once. Every node also
+// pays a fixed overhead for its launch.
+double EstimateNodeCost(const Node& node) {
+  constexpr double kNodeOverhead = 4096.0;
+  const auto& op_type = node.OpType();
+  const auto& inputs = node.InputDefs();
+  const auto& outputs = node.OutputDefs();
+
+  double output_elements = 0.0;
+  for (const auto* output : outputs) {
+    output_elements += NumElements(output);
+  }
+
+  if (inputs.empty()) {
+    return kNodeOverhead + output_elements;
+  }
+
+  if (op_type == "MatMul" || op_type == "FusedMatMul" || op_type == "MatMulInteger" ||
+      op_type == "MatMulIntegerToFloat" || op_type == "QLinearMatMul") {
+    return kNodeOverhead + output_elements * DimValue(inputs[0], -1);
+  }
+
+  if (op_type == "Gemm" || op_type == "FusedGemm") {
+    const auto& attributes = node.GetAttributes();
+    const auto trans_a = attributes.find("transA");
+    const bool is_trans_a = trans_a != attributes.end() && trans_a->second.i() != 0;
+    return kNodeOverhead + output_elements * DimValue(inputs[0], is_trans_a ? 0 : 1);
+  }
+
+  if (op_type == "Conv" || op_type == "FusedConv" || op_type == "NhwcFusedConv" || op_type == "ConvInteger" ||
+      op_type == "QLinearConv" || op_type == "ConvTranspose") {
+    const size_t weight_index = op_type == "QLinearConv" ? 3 : 1;
+    if (weight_index < inputs.size()) {
+      // the weight is [M, C/group, k...] and [C, M/group, k...] for ConvTranspose
+      const double weight_per_channel = NumElements(inputs[weight_index]) /
+                                        std::max(1.0, DimValue(inputs[weight_index], 0));
+      const double elements = op_type == "ConvTranspose" ? NumElements(inputs[0]) : output_elements;
+      return kNodeOverhead + elements * weight_per_channel;
+    }
+  }
+
+  double elements = output_elements;
+  for (const auto* input : inputs) {
+    elements += NumElements(input);
+  }
+  return kNodeOverhead + elements;
+}
+
+}  // namespace
+
+/*
+CriticalPathPartitioner is the default partitioner in parallel execution mode.
+Like DeviceBasedPartitioner it puts the nodes of each non-CPU device in one stream, and it splits the CPU nodes
+into streams which run concurrently on the inter-op thread pool:
+1. the cost of every node is estimated from the shapes of its inputs and outputs, see EstimateNodeCost,
+   or read from the "costs" of the config file, e.g. the durations of the nodes in a profile;
+2. a node continues the stream of the input it waits for the longest, if it is the consumer of that input
+   with the most expensive path to the outputs of the graph. Otherwise it starts a new stream, so the
+   branches forking from a node run in parallel and the critical path stays in one stream;
+3. the streams with too little work to pay for their synchronization are merged into the stream of a
+   consumer or a producer of their nodes.
+Streams are ordered by decreasing cost of the path from their first node to the outputs of the graph.
+The executor launches and triggers the streams in this order, so the branches on the critical path get
+threads first.
+------------------------------------------------------
+{
+"type":"CriticalPathPartitioner",
+"costs":{"node_1":120.5,"node_2":30.0}
+}
+------------------------------------------------------
+When "costs" is given, the nodes missing from it are assumed to have no cost.
+*/
+class CriticalPathPartitioner : public IGraphPartitioner {
+ public:
+  CriticalPathPartitioner(const logging::Logger& logger,
+                          const PathString& config_file) : IGraphPartitioner(logger, config_file) {
+    Initialize();
+  }
+
+  Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                        const ExecutionProviders& execution_providers,
+                        std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                        ExecutionOrder execution_order) override;
+
+  const char* Type() const override { return "CriticalPathPartitioner"; }
+  size_t Streams() const override { return num_streams_; }
+
+ private:
+  void Initialize();
+
+  // streams cheaper than this fraction of the critical path are merged into another stream
+  static constexpr double kMinStreamCostFraction = 1.0 / 32;
+
+  InlinedHashMap<std::string, double> node_costs_;
+  size_t num_streams_ = 0;
+};
+
+Status CriticalPathPartitioner::PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
+                                               const ExecutionProviders& execution_providers,
+                                               std::vector<InlinedVector<NodeIndex>>& stream_nodes,
+                                               ExecutionOrder execution_order) {
+  constexpr NodeIndex kNoNode = std::numeric_limits<NodeIndex>::max();
+  const auto& p_graph_nodes = graph_viewer.GetNodesInTopologicalOrder(execution_order);
+  const size_t num_node_indices = SafeInt<size_t>(graph_viewer.MaxNodeIndex()) + 1;
+
+  // the cost of every node, and of the most expensive path from the inputs of the graph to the end of the node
+  // (finish) and from the start of the node to the outputs of the graph (remaining)
+  std::vector<double> cost(num_node_indices, 0.0);
+  std::vector<double> finish(num_node_indices, 0.0);
+  std::vector<double> remaining(num_node_indices, 0.0);
+  std::vector<OrtDevice::DeviceType> device_types(num_node_indices, OrtDevice::CPU);
+  InlinedHashMap<std::string, int> op_type_counter;
+
+  for (auto node_index : p_graph_nodes) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    auto* ep = execution_providers.Get(*node);
+    device_types[node_index] = ep->GetAllocator(OrtMemType::OrtMemTypeDefault)->Info().device.Type();
+
+    if (node_costs_.empty()) {
+      cost[node_index] = EstimateNodeCost(*node);
+    } else {
+      auto node_name = node->Name();
+      if (node_name.empty()) {
+        node_name = node->OpType() + std::to_string(op_type_counter[node->OpType()]++);
+      }
+      auto it = node_costs_.find(node_name);
+      cost[node_index] = it != node_costs_.end() ? it->second : 0.0;
+    }
+
+    double start = 0.0;
+    for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+      if (graph_viewer.GetNode(it->Index()) != nullptr) {
+        start = std::max(start, finish[it->Index()]);
+      }
+    }
+    finish[node_index] = start + cost[node_index];
+  }
+
+  double critical_path = 0.0;
+  for (auto node_it = p_graph_nodes.rbegin(); node_it != p_graph_nodes.rend(); ++node_it) {
+    const auto* node = graph_viewer.GetNode(*node_it);
+    double rest = 0.0;
+    for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+      if (graph_viewer.GetNode(it->Index()) != nullptr) {
+        rest = std::max(rest, remaining[it->Index()]);
+      }
+    }
+    remaining[*node_it] = cost[*node_it] + rest;
+    critical_path = std::max(critical_path, remaining[*node_it]);
+  }
+
+  // the consumer on the same device with the most expensive path to the outputs of the graph
+  std::vector<NodeIndex> critical_consumer(num_node_indices, kNoNode);
+  for (auto node_index : p_graph_nodes) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    for (auto it = node->OutputNodesBegin(); it != node->OutputNodesEnd(); ++it) {
+      const NodeIndex consumer = it->Index();
+      if (graph_viewer.GetNode(consumer) != nullptr && device_types[consumer] == device_types[node_index] &&
+          (critical_consumer[node_index] == kNoNode || remaining[consumer] > remaining[critical_consumer[node_index]])) {
+        critical_consumer[node_index] = consumer;
+      }
+    }
+  }
+
+  // 1. split the nodes into streams
+  std::vector<size_t> node_stream(num_node_indices, 0);
+  std::vector<OrtDevice::DeviceType> stream_devices;
+  std::vector<double> stream_costs;
+  std::vector<NodeIndex> stream_first_nodes;
+  std::vector<NodeIndex> stream_last_nodes;
+  InlinedHashMap<OrtDevice::DeviceType, size_t> device_to_stream;
+
+  for (auto node_index : p_graph_nodes) {
+    const auto* node = graph_viewer.GetNode(node_index);
+    const auto device_type = device_types[node_index];
+    size_t stream = stream_devices.size();
+
+    if (device_type != OrtDevice::CPU) {
+      auto it = device_to_stream.find(device_type);
+      if (it != device_to_stream.end()) {
+        stream = it->second;
+      } else {
+        device_to_stream[device_type] = stream;
+      }
+    } else {
+      NodeIndex producer = kNoNode;
+      for (auto it = node->InputNodesBegin(); it != node->InputNodesEnd(); ++it) {
+        if (critical_consumer[it->Index()] == node_index &&
+            (producer == kNoNode || finish[it->Index()] > finish[producer])) {
+          producer = it->Index();
+        }
+      }
+      if (producer != kNoNode) {
+        stream = node_stream[producer];
+      }
+    }
+
+    if (stream == stream_devices.size()) {
+      stream_devices.push_back(device_type);
+      stream_costs.push_back(0.0);
+      stream_first_nodes.push_back(node_index);
+      stream_last_nodes.push_back(node_index);
+    }
+    node_stream[node_index] = stream;
+    stream_costs[stream] += cost[node_index];
+    stream_last_nodes[stream] = node_index;
+  }
+
+  // 2. merge the CPU streams too cheap to pay for their synchronization into another CPU stream.
+  // The nodes of every stream are in topological order, so the nodes of two merged streams are too.
+  const double min_stream_cost = critical_path * kMinStreamCostFraction;
+  std::vector<size_t> merged_into(stream_devices.size());
+  std::iota(merged_into.begin(), merged_into.end(), size_t{0});
+  auto resolve = [&merged_into](size_t stream) {
+    while (merged_into[stream] != stream) {
+      stream = merged_into[stream];
+    }
+    return stream;
+  };
+
+  // returns the stream a neighbour of node is merged into, if it is another CPU stream than stream
+  auto neighbour_stream = [&](NodeIndex neighbour, size_t stream) {
+    if (graph_viewer.GetNode(neighbour) == nullptr || device_types[neighbour] != OrtDevice::CPU) {
+      return stream;
+    }
+    return resolve(node_stream[neighbour]);
+  };
+
+  for (size_t stream = 0; stream < stream_devices.size(); ++stream) {
+    if (stream_devices[stream] != OrtDevice::CPU || stream_costs[stream] >= min_stream_cost) {
+      continue;
+    }
+
+    // prefer the stream of a consumer of the last node, then of a producer of the first node
+    size_t target = stream;
+    const auto* last_node = graph_viewer.GetNode(stream_last_nodes[stream]);
+    for (auto it = last_node->OutputNodesBegin(); it != last_node->OutputNodesEnd() && target == stream; ++it) {
+      target = neighbour_stream(it->Index(), stream);
+    }
+    const auto* first_node = graph_viewer.GetNode(stream_first_nodes[stream]);
+    for (auto it = first_node->InputNodesBegin(); it != first_node->InputNodesEnd() && target == stream; ++it) {
+      target = neighbour_stream(it->Index(), stream);
+    }
+    for (size_t other = 0; other < stream_devices.size() && target == stream; ++other) {
+      if (other != stream && merged_into[other] == other && stream_devices[other] == OrtDevice::CPU) {
+        target = other;
+      }
+    }
+
+    if (target != stream) {
+      merged_into[stream] = target;
+      stream_costs[target] += stream_costs[stream];
+    }
+  }
+
+  std::vector<InlinedVector<NodeIndex>> merged_streams(stream_devices.size());
+  for (auto node_index : p_graph_nodes) {
+    merged_streams[resolve(node_stream[node_index])].push_back(node_index);
+  }
+
+  // 3. order the streams by decreasing cost of the path from their first node to the outputs of the graph
+  InlinedVector<size_t> stream_order;
+  for (size_t stream = 0; stream < merged_streams.size(); ++stream) {
+    if (!merged_streams[stream].empty()) {
+      stream_order.push_back(stream);
+    }
+  }
+  std::stable_sort(stream_order.begin(), stream_order.end(), [&](size_t a, size_t b) {
+    return remaining[merged_streams[a].front()] > remaining[merged_streams[b].front()];
+  });
+
+  stream_nodes.clear();
+  stream_nodes.reserve(stream_order.size());
+  for (size_t stream : stream_order) {
+    stream_nodes.push_back(std::move(merged_streams[stream]));
+  }
+  num_streams_ = stream_nodes.size();
+
+  LOGS(logger_, INFO) << "CriticalPathPartitioner split " << p_graph_nodes.size() << " nodes into " << num_streams_
+                      << " streams, the cost of the critical path is " << critical_path;
+  return Status::OK();
+}
+
+void CriticalPathPartitioner::Initialize() {
+  if (config_file_.empty()) {
+    return;
+  }
+  std::ifstream if_stream(config_file_);
+  if (!if_stream.is_open()) {
+    return;
+  }
+  try {
+    json json_config = json::parse(if_stream);
+    if (json_config.contains("costs")) {
+      for (const auto& node_cost : json_config["costs"].items()) {
+        node_costs_[node_cost.key()] = node_cost.value().get<double>();
+      }
+    }
+  } catch (const std::exception& ex) {
+    LOGS(logger_, WARNING) << "Failed to read the node costs of CriticalPathPartitioner: " << ex.what();
+    node_costs_.clear();
+  }
+  if_stream.close();
+}
+
 std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(const logging::Logger& logger,
-                                                                             const PathString& config_file) {
-  // use device based partitioner by default
-  IGraphPartitioner::GraphPartitioningStrategy partitioner_type =
-      IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+                                                                             const PathString& config_file,
+                                                                             GraphPartitioningStrategy default_strategy) {
+  IGraphPartitioner::GraphPartitioningStrategy partitioner_type = default_strategy;
   if (!config_file.empty()) {
+    // use device based partitioner unless the config selects another one, it saves the config if missing
+    partitioner_type = IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
     std::ifstream f(config_file);
     if (f.is_open()) {
       try {
@@ -2361,6 +2710,8 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
           auto type = json_config["type"];
           if (type == "DeviceBasedPartitioner") {
             partitioner_type = IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition;
+          } else if (type == "CriticalPathPartitioner") {
+            partitioner_type = IGraphPartitioner::GraphPartitioningStrategy::CriticalPathPartition;
           }
         }
       } catch (const std::exception& ex) {
@@ -2372,6 +2723,9 @@ std::unique_ptr<IGraphPartitioner> IGraphPartitioner::CreateGraphPartitioner(con
   if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::DeviceBasedPartition) {
     LOGS(logger, INFO) << "Use DeviceBasedPartition as default";
     return std::make_unique<DeviceBasedPartitioner>(logger, config_file);
+  } else if (partitioner_type == IGraphPartitioner::GraphPartitioningStrategy::CriticalPathPartition) {
+    LOGS(logger, INFO) << "Use CriticalPathPartition";
+    return std::make_unique<CriticalPathPartitioner>(logger, config_file);
   }  // else if other partitioner types ...
   ORT_THROW("Failed to create partitioner");
 }
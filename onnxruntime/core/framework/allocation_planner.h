@@ -46,6 +46,11 @@ class ISequentialPlannerContext {
   virtual ExecutionOrder GetExecutionOrder() const { return ExecutionOrder::DEFAULT; }
 
   virtual bool GetEnableMemoryReuse() const { return true; }
+
+  // If it returns true and no partition config file selects another partitioner, the nodes of the main graph
+  // are partitioned into streams by CriticalPathPartitioner, see IGraphPartitioner.
+  virtual bool IsCriticalPathPartitionEnabled() const { return false; }
+
   virtual ~ISequentialPlannerContext() = default;
 };
 
@@ -67,6 +72,8 @@ class SequentialPlannerContext : public ISequentialPlannerContext {
 
   bool GetEnableMemoryReuse() const override { return enable_memory_reuse_; }
 
+  bool IsCriticalPathPartitionEnabled() const override { return execution_mode_ == ExecutionMode::ORT_PARALLEL; }
+
  private:
   ExecutionMode execution_mode_ = ExecutionMode::ORT_SEQUENTIAL;
   ExecutionOrder exection_order_ = ExecutionOrder::DEFAULT;
@@ -82,16 +89,20 @@ class IGraphPartitioner {
   // DeviceBasedPartitioner is the default, who partitions a graph based off device information.
   // i.e., given a graph which has CPU EP nodes, Cuda EP nodes and TRT EP nodes,
   // it will be partitioned as two sequences, one is for CPU EP nodes, another is for TRT and Cuda nodes.
-  // We will add more optimized partitioner later.
+  // CriticalPathPartitioner, the default in parallel execution mode, further splits the CPU EP nodes into
+  // sequences along the critical path of the graph, so independent branches run concurrently.
   enum GraphPartitioningStrategy {
     DeviceBasedPartition = 0,
+    CriticalPathPartition,
     Unknown,
   };
   virtual ~IGraphPartitioner() = default;
   // create the partition based on the partition type.
-  // perform partition based on the user input when provided.
-  static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(const logging::Logger& logger,
-                                                                   const PathString& config_file);
+  // perform partition based on the user input when provided, otherwise use default_strategy.
+  static std::unique_ptr<IGraphPartitioner> CreateGraphPartitioner(
+      const logging::Logger& logger,
+      const PathString& config_file,
+      GraphPartitioningStrategy default_strategy = GraphPartitioningStrategy::DeviceBasedPartition);
   virtual Status PartitionGraph(const onnxruntime::GraphViewer& graph_viewer,
                                 const ExecutionProviders& execution_providers,
                                 std::vector<InlinedVector<NodeIndex>>& stream_nodes,
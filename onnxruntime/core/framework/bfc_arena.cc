@@ -3,15 +3,45 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include "core/common/spin_pause.h"
 #include <type_traits>
 
 namespace onnxruntime {
+
+namespace {
+std::atomic<uint64_t> next_arena_id{1};
+}  // namespace
+
+struct BFCArena::ThreadCache {
+  // Taken by the owning thread for each operation on the cache, and by the threads holding
+  // lock_ to drain the cache or to update cache_regions_. It is almost never contended.
+  std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  std::vector<void*> free_chunks[kNumCacheClasses];
+
+  // Written under the lock above, read by GetStats().
+  std::atomic<int64_t> cached_bytes{0};
+  std::atomic<int64_t> num_hits{0};
+  std::atomic<int64_t> num_misses{0};
+
+  // Cleared when the owning thread exits or forgets the cache, another thread then adopts it.
+  std::atomic<bool> owned{true};
+
+  void Lock() {
+    while (busy.test_and_set(std::memory_order_acquire)) {
+      concurrency::SpinPause();
+    }
+  }
+
+  void Unlock() { busy.clear(std::memory_order_release); }
+};
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
-                   int initial_growth_chunk_size_bytes)
+                   int initial_growth_chunk_size_bytes,
+                   int thread_cache_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -23,13 +53,19 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       next_allocation_id_(1),
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
-      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes) {
+      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
+      thread_cache_bytes_(thread_cache_bytes > 0 ? static_cast<size_t>(thread_cache_bytes) : 0),
+      arena_id_(next_arena_id.fetch_add(1, std::memory_order_relaxed)) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_bytes: " << thread_cache_bytes_;
+
+  // A class must fit several times in a cache, otherwise each free would empty it.
+  max_cached_size_ = std::min(kMaxCachedSize, thread_cache_bytes_ / 4);
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -205,6 +241,9 @@ Status BFCArena::Extend(size_t rounded_bytes) {
                      << static_cast<void*>(static_cast<char*>(mem_addr) + bytes);
   region_manager_.AddAllocationRegion(mem_addr, bytes, stats_.num_arena_extensions);
   stats_.num_arena_extensions += 1;
+  if (thread_cache_bytes_ > 0) {
+    AddCacheRegion(mem_addr, bytes);
+  }
 
   // Create one large chunk for the whole memory space that will
   // be chunked later.
@@ -261,6 +300,9 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (size > 0 && size <= max_cached_size_) {
+    return AllocateFromThreadCache(size);
+  }
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
@@ -371,6 +413,258 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  for (const auto& cache : thread_caches_) {
+    stats->num_thread_cache_hits += cache->num_hits.load(std::memory_order_relaxed);
+    stats->num_thread_cache_misses += cache->num_misses.load(std::memory_order_relaxed);
+    stats->thread_cache_bytes += cache->cached_bytes.load(std::memory_order_relaxed);
+  }
+}
+
+int BFCArena::CacheClassForSize(size_t rounded_bytes) {
+  // 16 classes with a step of kMinAllocationSize up to 4KB, then 4 classes per power of 2 up to 64KB.
+  if (rounded_bytes <= 4096) {
+    return static_cast<int>(rounded_bytes / kMinAllocationSize) - 1;
+  }
+  int log2 = Log2FloorNonZero(rounded_bytes - 1);
+  size_t step = size_t{1} << (log2 - 2);
+  return 16 + (log2 - 12) * 4 + static_cast<int>((rounded_bytes - 1 - (size_t{1} << log2)) / step);
+}
+
+size_t BFCArena::CacheClassSize(int cache_class) {
+  if (cache_class < 16) {
+    return kMinAllocationSize * (cache_class + 1);
+  }
+  int log2 = 12 + (cache_class - 16) / 4;
+  return (size_t{1} << log2) + ((cache_class - 16) % 4 + 1) * (size_t{1} << (log2 - 2));
+}
+
+BFCArena::ThreadCache* BFCArena::GetThreadCache() {
+  // Each thread remembers its caches in the last arenas it used. The slots share the ownership
+  // of the caches with the arenas, so that they can be released in any order.
+  struct Slot {
+    uint64_t arena_id = 0;
+    std::shared_ptr<ThreadCache> cache;
+  };
+  constexpr int kNumSlots = 4;
+  struct Slots {
+    Slot slots[kNumSlots];
+    int next_slot = 0;
+
+    ~Slots() {
+      for (Slot& slot : slots) {
+        if (slot.cache) {
+          slot.cache->owned.store(false, std::memory_order_release);
+        }
+      }
+    }
+  };
+  thread_local Slots slots;
+
+  for (const Slot& slot : slots.slots) {
+    if (slot.arena_id == arena_id_) {
+      return slot.cache.get();
+    }
+  }
+
+  // Adopt the cache of a thread that exited, so that short lived threads do not leave their
+  // chunks behind until Shrink() or the destruction of the arena.
+  std::shared_ptr<ThreadCache> cache;
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    for (const auto& c : thread_caches_) {
+      bool owned = c->owned.load(std::memory_order_acquire);
+      if (!owned && c->owned.compare_exchange_strong(owned, true, std::memory_order_acq_rel)) {
+        cache = c;
+        break;
+      }
+    }
+    if (!cache) {
+      cache = std::make_shared<ThreadCache>();
+      thread_caches_.push_back(cache);
+    }
+  }
+
+  Slot& slot = slots.slots[slots.next_slot];
+  if (slot.cache) {
+    slot.cache->owned.store(false, std::memory_order_release);
+  }
+  slot = Slot{arena_id_, std::move(cache)};
+  slots.next_slot = (slots.next_slot + 1) % kNumSlots;
+  return slot.cache.get();
+}
+
+void* BFCArena::AllocateFromThreadCache(size_t num_bytes) {
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  const int cache_class = CacheClassForSize(rounded_bytes);
+  const size_t class_size = CacheClassSize(cache_class);
+  ThreadCache* cache = GetThreadCache();
+
+  cache->Lock();
+  auto& free_chunks = cache->free_chunks[cache_class];
+  if (!free_chunks.empty()) {
+    void* ptr = free_chunks.back();
+    free_chunks.pop_back();
+    cache->cached_bytes.store(cache->cached_bytes.load(std::memory_order_relaxed) - class_size,
+                              std::memory_order_relaxed);
+    cache->num_hits.fetch_add(1, std::memory_order_relaxed);
+    cache->Unlock();
+    return ptr;
+  }
+  cache->Unlock();
+  cache->num_misses.fetch_add(1, std::memory_order_relaxed);
+
+  // Take a batch of chunks from the bins, keep one quarter of the capacity of the cache for this class.
+  const size_t batch_size = std::max<size_t>(1, std::min(kMaxRefillChunks, thread_cache_bytes_ / (4 * class_size)));
+  std::vector<void*> chunks;
+  chunks.reserve(batch_size);
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    const BinNum bin_num = BinNumForSize(class_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+      Chunk* chunk = FindChunkPtr(bin_num, class_size, class_size, nullptr, false);
+      if (chunk == nullptr && i == 0 && Extend(class_size).IsOK()) {
+        chunk = FindChunkPtr(bin_num, class_size, class_size, nullptr, false);
+      }
+      if (chunk == nullptr) {
+        break;
+      }
+      SetCacheClass(chunk->ptr, static_cast<uint8_t>(cache_class + 1));
+      chunks.push_back(chunk->ptr);
+    }
+  }
+
+  if (chunks.empty()) {
+    // Let the regular path find out whether any memory is left and report the failure.
+    return AllocateRawInternal(num_bytes, false, nullptr, false, nullptr);
+  }
+
+  void* ptr = chunks.back();
+  chunks.pop_back();
+  if (!chunks.empty()) {
+    cache->Lock();
+    free_chunks.insert(free_chunks.end(), chunks.begin(), chunks.end());
+    cache->cached_bytes.store(cache->cached_bytes.load(std::memory_order_relaxed) + chunks.size() * class_size,
+                              std::memory_order_relaxed);
+    cache->Unlock();
+  }
+  return ptr;
+}
+
+bool BFCArena::FreeToThreadCache(void* p) {
+  ThreadCache* cache = GetThreadCache();
+  std::vector<void*> released;
+
+  cache->Lock();
+  int cache_class = -1;
+  if (const CacheRegion* region = CacheRegionFor(p)) {
+    auto granule = (reinterpret_cast<std::uintptr_t>(p) - region->begin) >> kMinAllocationBits;
+    cache_class = static_cast<int>(region->classes[granule].load(std::memory_order_relaxed)) - 1;
+  }
+  if (cache_class < 0) {
+    cache->Unlock();
+    return false;
+  }
+
+  cache->free_chunks[cache_class].push_back(p);
+  int64_t cached_bytes = cache->cached_bytes.load(std::memory_order_relaxed) +
+                         static_cast<int64_t>(CacheClassSize(cache_class));
+  const int64_t capacity = static_cast<int64_t>(thread_cache_bytes_);
+  if (cached_bytes > capacity) {
+    // Give back the oldest chunks until the cache is half full, starting with the class of p.
+    for (int i = 0; i < kNumCacheClasses && cached_bytes > capacity / 2; ++i) {
+      int c = (cache_class + i) % kNumCacheClasses;
+      auto& free_chunks = cache->free_chunks[c];
+      const int64_t chunk_size = static_cast<int64_t>(CacheClassSize(c));
+      size_t n = 0;
+      while (n < free_chunks.size() && cached_bytes > capacity / 2) {
+        cached_bytes -= chunk_size;
+        ++n;
+      }
+      released.insert(released.end(), free_chunks.begin(), free_chunks.begin() + n);
+      free_chunks.erase(free_chunks.begin(), free_chunks.begin() + n);
+    }
+  }
+  cache->cached_bytes.store(cached_bytes, std::memory_order_relaxed);
+  cache->Unlock();
+
+  if (!released.empty()) {
+    std::lock_guard<OrtMutex> lock(lock_);
+    ReleaseCachedChunks(released);
+  }
+  return true;
+}
+
+void BFCArena::ReleaseCachedChunks(gsl::span<void* const> ptrs) {
+  for (void* p : ptrs) {
+    SetCacheClass(p, 0);
+    DeallocateRawInternal(p);
+  }
+}
+
+void BFCArena::DrainThreadCaches() {
+  std::vector<void*> released;
+  for (auto& cache : thread_caches_) {
+    cache->Lock();
+    for (auto& free_chunks : cache->free_chunks) {
+      released.insert(released.end(), free_chunks.begin(), free_chunks.end());
+      free_chunks.clear();
+    }
+    cache->cached_bytes.store(0, std::memory_order_relaxed);
+    cache->Unlock();
+  }
+  ReleaseCachedChunks(released);
+}
+
+void BFCArena::AddCacheRegion(void* ptr, size_t memory_size) {
+  CacheRegion region;
+  region.begin = reinterpret_cast<std::uintptr_t>(ptr);
+  region.end = region.begin + memory_size;
+  const size_t n_granules = memory_size >> kMinAllocationBits;
+  region.classes = std::make_unique<std::atomic<uint8_t>[]>(n_granules);
+  for (size_t i = 0; i < n_granules; ++i) {
+    region.classes[i].store(0, std::memory_order_relaxed);
+  }
+
+  auto it = std::upper_bound(cache_regions_.begin(), cache_regions_.end(), region.begin,
+                             [](std::uintptr_t p, const CacheRegion& r) { return p < r.begin; });
+  for (auto& cache : thread_caches_) {
+    cache->Lock();
+  }
+  cache_regions_.insert(it, std::move(region));
+  for (auto& cache : thread_caches_) {
+    cache->Unlock();
+  }
+}
+
+void BFCArena::RemoveCacheRegion(void* ptr) {
+  auto it = std::find_if(cache_regions_.begin(), cache_regions_.end(),
+                         [ptr](const CacheRegion& r) { return r.begin == reinterpret_cast<std::uintptr_t>(ptr); });
+  ORT_ENFORCE(it != cache_regions_.end(), "Could not find cache region for: ", ptr);
+  for (auto& cache : thread_caches_) {
+    cache->Lock();
+  }
+  cache_regions_.erase(it);
+  for (auto& cache : thread_caches_) {
+    cache->Unlock();
+  }
+}
+
+const BFCArena::CacheRegion* BFCArena::CacheRegionFor(const void* p) const {
+  const std::uintptr_t p_int = reinterpret_cast<std::uintptr_t>(p);
+  auto it = std::upper_bound(cache_regions_.begin(), cache_regions_.end(), p_int,
+                             [](std::uintptr_t v, const CacheRegion& r) { return v < r.begin; });
+  if (it == cache_regions_.begin()) {
+    return nullptr;
+  }
+  --it;
+  return p_int < it->end ? &(*it) : nullptr;
+}
+
+void BFCArena::SetCacheClass(const void* p, uint8_t value) {
+  const CacheRegion* region = CacheRegionFor(p);
+  ORT_ENFORCE(region != nullptr, "Could not find cache region for: ", p);
+  region->classes[(reinterpret_cast<std::uintptr_t>(p) - region->begin) >> kMinAllocationBits].store(
+      value, std::memory_order_relaxed);
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -488,6 +782,9 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+  if (thread_cache_bytes_ > 0 && FreeToThreadCache(p)) {
+    return;
+  }
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -502,6 +799,7 @@ void BFCArena::Free(void* p) {
 
 Status BFCArena::Shrink() {
   std::lock_guard<OrtMutex> lock(lock_);
+  DrainThreadCaches();
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
   std::vector<size_t> region_sizes;
@@ -552,6 +850,9 @@ Status BFCArena::Shrink() {
 
       device_allocator_->Free(region_ptr);
       region_manager_.RemoveAllocationRegion(region_ptr);
+      if (thread_cache_bytes_ > 0) {
+        RemoveCacheRegion(region_ptr);
+      }
       stats_.num_arena_extensions--;
     }
 
@@ -16,9 +16,11 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
@@ -60,6 +62,7 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_MAX_DEAD_BYTES_PER_CHUNK = 128 * 1024 * 1024;
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int DEFAULT_THREAD_CACHE_BYTES = 0;
 
   enum ArenaType {
     BaseArena,
@@ -71,7 +74,8 @@ class BFCArena : public IAllocator {
            ArenaExtendStrategy arena_extend_strategy = DEFAULT_ARENA_EXTEND_STRATEGY,
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
-           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES);
+           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+           int thread_cache_bytes = DEFAULT_THREAD_CACHE_BYTES);
 
   ~BFCArena() override;
 
@@ -85,6 +89,7 @@ class BFCArena : public IAllocator {
 
   // Frees all allocation regions in which no chunk is in use.
   // Does not free any reserved chunks.
+  // The chunks held by the per-thread caches are given back to the arena first.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
   // future allocation sizes are determined by the arena growth strategy
@@ -361,6 +366,50 @@ class BFCArena : public IAllocator {
     std::vector<AllocationRegion> regions_;
   };
 
+  // Per-thread caches of free chunks, enabled when thread_cache_bytes_ > 0.
+  //
+  // Small allocations are grouped in kNumCacheClasses size classes. A thread cache is filled
+  // with a batch of chunks of the size of a class taken from the bins under lock_, it then
+  // serves the allocations of this class and takes back the freed chunks of any class without
+  // taking lock_. When it holds more than thread_cache_bytes_ bytes, half of them are given
+  // back to the bins in a single batch. The chunks owned by the caches stay in use from the
+  // point of view of the bins.
+  //
+  // Each allocation region has a CacheRegion recording, for each kMinAllocationSize granule,
+  // the class of the cached chunk starting there (0 if it is not owned by a cache), so that
+  // Free() finds out without taking lock_ whether a pointer goes back to a thread cache.
+  // A thread reads cache_regions_ while holding the lock of its own cache, cache_regions_
+  // is only modified while holding lock_ and the locks of all the caches.
+  struct ThreadCache;
+
+  struct CacheRegion {
+    std::uintptr_t begin = 0;
+    std::uintptr_t end = 0;
+    std::unique_ptr<std::atomic<uint8_t>[]> classes;
+  };
+
+  static constexpr int kNumCacheClasses = 32;
+  static constexpr size_t kMaxCachedSize = 64 * 1024;
+  static constexpr size_t kMaxRefillChunks = 16;
+
+  // Returns the smallest class whose chunks hold 'rounded_bytes' bytes.
+  int CacheClassForSize(size_t rounded_bytes);
+  static size_t CacheClassSize(int cache_class);
+
+  ThreadCache* GetThreadCache();
+  void* AllocateFromThreadCache(size_t num_bytes);
+  // Returns false if 'p' is not owned by the thread caches.
+  bool FreeToThreadCache(void* p);
+
+  // The following functions require lock_.
+  void ReleaseCachedChunks(gsl::span<void* const> ptrs);
+  void DrainThreadCaches();
+  void AddCacheRegion(void* ptr, size_t memory_size);
+  void RemoveCacheRegion(void* ptr);
+  void SetCacheClass(const void* p, uint8_t value);
+  // Requires lock_ or the lock of a thread cache.
+  const CacheRegion* CacheRegionFor(const void* p) const;
+
   // Returns 'bytes' rounded up to the next highest kMinAllocationSize.
   size_t RoundedBytes(size_t bytes);
 
@@ -512,6 +561,16 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // Capacity of each thread cache, 0 if they are disabled.
+  const size_t thread_cache_bytes_;
+  // Largest allocation served by the thread caches.
+  size_t max_cached_size_ = 0;
+  // Unique among the arenas created by the process, identifies the arena in the thread local
+  // lookup table of GetThreadCache() even after another arena is created at the same address.
+  const uint64_t arena_id_;
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;  // guarded by lock_
+  std::vector<CacheRegion> cache_regions_;                     // sorted by address
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/captured_run.h"
+
+#include <algorithm>
+
+#include "core/framework/op_kernel.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/framework/session_state.h"
+#include "core/graph/constants.h"
+
+namespace onnxruntime {
+
+bool CapturedRun::CanCapture(const SessionState& session_state) {
+  const auto* plan = session_state.GetExecutionPlan();
+  if (plan == nullptr || session_state.GetGraphViewer().ParentNode() != nullptr) {
+    return false;
+  }
+
+  const SequentialExecutionPlan::LogicStream* cpu_stream = nullptr;
+  for (const auto& logic_stream : plan->execution_plan) {
+    if (logic_stream->steps_.empty()) {
+      continue;
+    }
+
+    if (cpu_stream != nullptr || logic_stream->device_.Type() != OrtDevice::CPU) {
+      return false;
+    }
+
+    cpu_stream = logic_stream.get();
+  }
+
+  if (cpu_stream == nullptr) {
+    return false;
+  }
+
+  for (const auto& step : cpu_stream->steps_) {
+    NodeIndex node_index;
+    if (!step->LaunchesKernel(node_index)) {
+      return false;
+    }
+
+    const OpKernel* kernel = session_state.GetKernel(node_index);
+    if (kernel == nullptr || kernel->IsAsync() || kernel->KernelDef().OpName() == "YieldOp" ||
+        kernel->Info().GetExecutionProvider()->Type() != kCpuExecutionProvider) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+Status CapturedRun::Capture(const SessionState& session_state, const FeedsFetchesInfo& feeds_fetches_info,
+                            gsl::span<const OrtValue> feeds, std::unique_ptr<CapturedRun>& captured_run) {
+  ORT_RETURN_IF_NOT(feeds.size() == feeds_fetches_info.feeds_mlvalue_idxs.size(),
+                    "The feeds don't match the feeds info of the run.");
+
+  std::unique_ptr<CapturedRun> capture(new CapturedRun());
+  capture->feeds_fetches_info_ = feeds_fetches_info;
+
+  capture->feed_infos_.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    ORT_RETURN_IF_NOT(feed.IsTensor(), "Only runs with tensor feeds can be captured.");
+    const auto& tensor = feed.Get<Tensor>();
+    capture->feed_infos_.push_back({tensor.DataType(), tensor.Shape(), tensor.Location().device});
+  }
+
+  // resolve the ref counted releases of the plan for its only stream, where the order of the kernels is fixed
+  const auto& plan = *session_state.GetExecutionPlan();
+  InlinedVector<size_t> release_counts;
+  release_counts.reserve(plan.release_actions.size());
+  for (const auto& release_action : plan.release_actions) {
+    release_counts.push_back(release_action.ref_count);
+  }
+
+  for (const auto& logic_stream : plan.execution_plan) {
+    for (const auto& step : logic_stream->steps_) {
+      NodeIndex node_index;
+      ORT_RETURN_IF_NOT(step->LaunchesKernel(node_index), "Only plans of kernel launches can be captured.");
+
+      Kernel kernel{session_state.GetKernel(node_index), {}};
+      for (size_t release_idx : plan.node_release_list[node_index]) {
+        if (--release_counts[release_idx] == 0) {
+          kernel.values_to_release.push_back(static_cast<int>(plan.release_actions[release_idx].value_index));
+        }
+      }
+
+      capture->kernels_.push_back(std::move(kernel));
+    }
+  }
+
+  // keep the blocks of the memory pattern allocated, each replay places its tensors in them
+  if (session_state.GetEnableMemoryPattern()) {
+    capture->mem_patterns_ = session_state.GetMemoryPatternGroup(feeds, feeds_fetches_info.feeds_mlvalue_idxs,
+                                                                 capture->inferred_shapes_);
+  }
+
+  if (capture->mem_patterns_) {
+    const auto& mem_patterns = *capture->mem_patterns_;
+    for (size_t i = 0; i < mem_patterns.locations.size(); ++i) {
+      void* buffer = nullptr;
+      const size_t peak_size = mem_patterns.patterns[i].PeakSize();
+      AllocatorPtr alloc = session_state.GetAllocator(mem_patterns.locations[i]);
+      if (peak_size > 0 && alloc) {
+        // a block that can't be allocated is left to the allocator as in ExecutionFrame
+        ORT_TRY {
+          buffer = alloc->Alloc(peak_size);
+        }
+        ORT_CATCH(const OnnxRuntimeException& ex) {
+          ORT_HANDLE_EXCEPTION([&]() {
+            LOGS(session_state.Logger(), INFO) << "Allocation of the captured memory pattern buffer for "
+                                               << mem_patterns.locations[i].ToString() << " failed. Error:"
+                                               << ex.what();
+          });
+        }
+
+        if (buffer != nullptr) {
+          capture->buffers_.emplace_back(buffer, BufferDeleter(std::move(alloc)));
+        }
+      }
+
+      capture->buffer_ptrs_.push_back(buffer);
+    }
+  }
+
+  captured_run = std::move(capture);
+  return Status::OK();
+}
+
+bool CapturedRun::Matches(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                          gsl::span<const std::string> output_names, gsl::span<const OrtValue> fetches) const {
+  if (feeds.size() != feed_infos_.size() ||
+      !std::equal(feed_names.begin(), feed_names.end(),
+                  feeds_fetches_info_.feed_names.begin(), feeds_fetches_info_.feed_names.end()) ||
+      !std::equal(output_names.begin(), output_names.end(),
+                  feeds_fetches_info_.output_names.begin(), feeds_fetches_info_.output_names.end())) {
+    return false;
+  }
+
+  if (!fetches.empty() && fetches.size() != output_names.size()) {
+    return false;
+  }
+
+  for (const auto& fetch : fetches) {
+    if (fetch.IsAllocated()) {
+      return false;
+    }
+  }
+
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = feeds[i].Get<Tensor>();
+    const auto& feed_info = feed_infos_[i];
+    if (tensor.DataType() != feed_info.element_type || tensor.Location().device != feed_info.device ||
+        tensor.Shape() != feed_info.shape) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}  // namespace onnxruntime
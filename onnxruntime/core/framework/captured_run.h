@@ -0,0 +1,98 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/buffer_deleter.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+class OpKernel;
+class SessionState;
+
+// A run of a session recorded so that later runs with the same inputs and outputs can replay it.
+//
+// A replay skips the per-run work that only depends on the names, types and shapes of the feeds and fetches:
+// validating them against the model, mapping the names to OrtValue indices, finding the memory pattern and
+// allocating its blocks, and walking the steps of the execution plan. The kernels are called in the order of the
+// plan, each followed by the release of the values it was the last consumer of, and the tensors of the memory
+// pattern are placed in blocks that the capture keeps allocated.
+//
+// Only plans with a single stream of CPU kernels can be captured.
+class CapturedRun {
+ public:
+  struct Kernel {
+    const OpKernel* kernel;
+    // values to release once the kernel has run
+    InlinedVector<int> values_to_release;
+  };
+
+  // Returns true if the runs of the plan of session_state can be captured.
+  static bool CanCapture(const SessionState& session_state);
+
+  // Captures a run that succeeded with feeds and feeds_fetches_info, and didn't use preallocated fetches.
+  static Status Capture(const SessionState& session_state, const FeedsFetchesInfo& feeds_fetches_info,
+                        gsl::span<const OrtValue> feeds, std::unique_ptr<CapturedRun>& captured_run);
+
+  // Returns true if a run with these arguments can replay the capture: the names are the same, the feeds are
+  // tensors with the types, shapes and locations of the captured ones and the fetches are not preallocated.
+  bool Matches(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+               gsl::span<const std::string> output_names, gsl::span<const OrtValue> fetches) const;
+
+  // Reserves the blocks of the memory pattern for one replay. Returns false if another replay is using them.
+  bool TryAcquire() {
+    return !in_use_.test_and_set(std::memory_order_acquire);
+  }
+
+  void Release() {
+    in_use_.clear(std::memory_order_release);
+  }
+
+  const FeedsFetchesInfo& GetFeedsFetchesInfo() const { return feeds_fetches_info_; }
+  gsl::span<const Kernel> GetKernels() const { return kernels_; }
+
+  // The memory pattern of the feed shapes and the blocks holding it, one per location of the pattern.
+  // A block is nullptr if it couldn't be allocated.
+  const std::shared_ptr<const MemoryPatternGroup>& GetMemoryPatterns() const { return mem_patterns_; }
+  const InlinedHashMap<int, TensorShape>* GetInferredShapes() const { return inferred_shapes_; }
+  gsl::span<void* const> GetBuffers() const { return buffer_ptrs_; }
+
+  size_t NumReplays() const { return num_replays_.load(std::memory_order_relaxed); }
+  void OnReplay() { num_replays_.fetch_add(1, std::memory_order_relaxed); }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CapturedRun);
+
+ private:
+  CapturedRun() = default;
+
+  struct FeedInfo {
+    MLDataType element_type;
+    TensorShape shape;
+    OrtDevice device;
+  };
+
+  FeedsFetchesInfo feeds_fetches_info_;
+  InlinedVector<FeedInfo> feed_infos_;
+  InlinedVector<Kernel> kernels_;
+
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
+  const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
+  InlinedVector<BufferUniquePtr> buffers_;
+  InlinedVector<void*> buffer_ptrs_;
+
+  std::atomic_flag in_use_ = ATOMIC_FLAG_INIT;
+  std::atomic<size_t> num_replays_{0};
+};
+
+}  // namespace onnxruntime
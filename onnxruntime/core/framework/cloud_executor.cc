@@ -29,20 +29,10 @@ common::Status CloudExecutor::Execute(const SessionState& session_state, gsl::sp
     output_names.push_back(output->Name());
   }
 
-  //create invoker
-  static const OrtDevice cpu_device;
-  auto allocator = session_state.GetAllocator(cpu_device);
-  std::unique_ptr<CloudEndPointInvoker> invoker;
-
-  auto status = CloudEndPointInvoker::CreateInvoker(
-      session_state.GetSessionOptions().config_options.configurations,
-      allocator, invoker);
-
-  if (invoker) {
-    return invoker->Send(run_options_, input_names, feeds, output_names, fetches);
-  } else {
-    return status;
-  }
+  //the invoker is created on first use and kept by the session state
+  CloudEndPointInvoker* invoker = nullptr;
+  ORT_RETURN_IF_ERROR(session_state.GetCloudEndPointInvoker(invoker));
+  return invoker->Send(run_options_, input_names, feeds, output_names, fetches);
 }
 
 }  // namespace onnxruntime
@@ -2,10 +2,14 @@
 // Licensed under the MIT License.
 
 #ifdef USE_AZURE
+#include <algorithm>
+#include <chrono>
 #include "http_client.h"
 #include "core/common/common.h"
+#include "core/common/parse_string.h"
 #include "core/framework/cloud_invoker.h"
 #include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
 
 #define CHECK_TRITON_ERR(ret, msg)                                                           \
   if (!ret.IsOk()) {                                                                         \
@@ -25,6 +29,9 @@ const char* kAzureVerbose = "azure.verbose";
 const char* kAzureEndpointType = "azure.endpoint_type";
 const char* kAzureAuthKey = "azure.auth_key";
 const char* kAzureTriton = "triton";
+const char* kAzureMaxConnections = "azure.max_connections";
+const char* kAzureMaxBatchSize = "azure.max_batch_size";
+const char* kAzureMaxBatchDelayUs = "azure.max_batch_delay_us";
 
 CloudEndPointInvoker::CloudEndPointInvoker(const CloudEndPointConfig& config,
                                            const AllocatorPtr& allocator) : config_(config), allocator_(allocator) {
@@ -43,14 +50,33 @@ class AzureTritonInvoker : public CloudEndPointInvoker {
                            std::vector<OrtValue>& ort_outputs) const override;
 
  private:
+  using TritonClientPtr = std::unique_ptr<triton::client::InferenceServerHttpClient>;
+
   static std::string MapDataType(int32_t ort_data_type);
   onnxruntime::TensorPtr CreateTensor(const std::string& data_type, const onnxruntime::VectorInt64& dim) const;
 
+  // The clients are kept between the requests so that their connection to the endpoint stays alive.
+  // A client serves one request at a time, a new one is created when all of them are busy unless
+  // there are already max_connections_ of them.
+  Status AcquireClient(TritonClientPtr& client) const;
+  void ReleaseClient(TritonClientPtr client) const;
+  onnxruntime::Status Send(triton::client::InferenceServerHttpClient& triton_client,
+                           const CloudEndPointConfig& run_options,
+                           const InlinedVector<std::string>& input_names,
+                           gsl::span<const OrtValue> ort_inputs,
+                           const InlinedVector<std::string>& output_names,
+                           std::vector<OrtValue>& ort_outputs) const;
+
   std::string uri_;
   std::string model_name_;
   std::string model_ver_ = "1";
   std::string verbose_ = "0";
-  std::unique_ptr<triton::client::InferenceServerHttpClient> triton_client_;
+  int64_t max_connections_ = 0;  // 0 for no limit
+
+  mutable OrtMutex clients_mutex_;
+  mutable OrtCondVar clients_cv_;
+  mutable std::vector<TritonClientPtr> idle_clients_;
+  mutable int64_t num_clients_ = 0;
 };
 
 std::string AzureTritonInvoker::MapDataType(int32_t ort_data_type) {
@@ -143,11 +169,49 @@ AzureTritonInvoker::AzureTritonInvoker(const CloudEndPointConfig& config,
   ReadConfig(kAzureModelName, model_name_);
   ReadConfig(kAzureModelVer, model_ver_, false);
   ReadConfig(kAzureVerbose, verbose_, false);
+  ReadConfig(kAzureMaxConnections, max_connections_);
 
-  auto err = tc::InferenceServerHttpClient::Create(&triton_client_, uri_, verbose_ != "0");
+  TritonClientPtr triton_client;
+  auto err = tc::InferenceServerHttpClient::Create(&triton_client, uri_, verbose_ != "0");
   if (!err.IsOk()) {
     ORT_THROW("Failed to initialize triton client, triton err: " + err.Message());
   }
+  idle_clients_.push_back(std::move(triton_client));
+  num_clients_ = 1;
+}
+
+Status AzureTritonInvoker::AcquireClient(TritonClientPtr& client) const {
+  {
+    std::unique_lock<OrtMutex> lock(clients_mutex_);
+    clients_cv_.wait(lock, [this]() {
+      return !idle_clients_.empty() || max_connections_ <= 0 || num_clients_ < max_connections_;
+    });
+    if (!idle_clients_.empty()) {
+      client = std::move(idle_clients_.back());
+      idle_clients_.pop_back();
+      return Status::OK();
+    }
+    ++num_clients_;
+  }
+
+  auto err = tc::InferenceServerHttpClient::Create(&client, uri_, verbose_ != "0");
+  if (!err.IsOk()) {
+    {
+      std::lock_guard<OrtMutex> lock(clients_mutex_);
+      --num_clients_;
+    }
+    clients_cv_.notify_one();
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to create triton client, triton err: ", err.Message());
+  }
+  return Status::OK();
+}
+
+void AzureTritonInvoker::ReleaseClient(TritonClientPtr client) const {
+  {
+    std::lock_guard<OrtMutex> lock(clients_mutex_);
+    idle_clients_.push_back(std::move(client));
+  }
+  clients_cv_.notify_one();
 }
 
 onnxruntime::Status AzureTritonInvoker::Send(const CloudEndPointConfig& run_options,
@@ -155,6 +219,19 @@ onnxruntime::Status AzureTritonInvoker::Send(const CloudEndPointConfig& run_opti
                                         gsl::span<const OrtValue> ort_inputs,
                                         const InlinedVector<std::string>& output_names,
                                         std::vector<OrtValue>& ort_outputs) const {
+  TritonClientPtr triton_client;
+  ORT_RETURN_IF_ERROR(AcquireClient(triton_client));
+  auto status = Send(*triton_client, run_options, input_names, ort_inputs, output_names, ort_outputs);
+  ReleaseClient(std::move(triton_client));
+  return status;
+}
+
+onnxruntime::Status AzureTritonInvoker::Send(tc::InferenceServerHttpClient& triton_client,
+                                             const CloudEndPointConfig& run_options,
+                                             const InlinedVector<std::string>& input_names,
+                                             gsl::span<const OrtValue> ort_inputs,
+                                             const InlinedVector<std::string>& output_names,
+                                             std::vector<OrtValue>& ort_outputs) const {
   const auto auth_key_iter = run_options.find(kAzureAuthKey);
   if (run_options.end() == auth_key_iter) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
@@ -225,10 +302,10 @@ onnxruntime::Status AzureTritonInvoker::Send(const CloudEndPointConfig& run_opti
     tc::Headers http_headers;
     http_headers["Authorization"] = std::string{"Bearer "} + auth_key_iter->second;
 
-    err = triton_client_->Infer(&results, options, triton_inputs, triton_outputs,
-                                http_headers, tc::Parameters(),
-                                tc::InferenceServerHttpClient::CompressionType::NONE,  //support compression in config?
-                                tc::InferenceServerHttpClient::CompressionType::NONE);
+    err = triton_client.Infer(&results, options, triton_inputs, triton_outputs,
+                              http_headers, tc::Parameters(),
+                              tc::InferenceServerHttpClient::CompressionType::NONE,  //support compression in config?
+                              tc::InferenceServerHttpClient::CompressionType::NONE);
     results_ptr.reset(results);
     CHECK_TRITON_ERR(err, "Triton client failed to do inference");
 
@@ -268,6 +345,203 @@ onnxruntime::Status AzureTritonInvoker::Send(const CloudEndPointConfig& run_opti
   return Status::OK();
 }
 
+// Merges the requests sent concurrently to the wrapped invoker into a single request. The inputs
+// of the merged requests are concatenated along their first dimension and the outputs are split
+// along their first dimension, so the model of the endpoint must handle a batch of rows.
+// The first request of a batch waits up to max_delay_ for other requests to join it, the batch is
+// sent as soon as it holds max_batch_size_ rows.
+class BatchingInvoker : public CloudEndPointInvoker {
+ public:
+  BatchingInvoker(const CloudEndPointConfig& config, const AllocatorPtr& allocator,
+                  std::unique_ptr<CloudEndPointInvoker> invoker, int64_t max_batch_size);
+  onnxruntime::Status Send(const CloudEndPointConfig& run_options,
+                           const InlinedVector<std::string>& input_names,
+                           gsl::span<const OrtValue> ort_inputs,
+                           const InlinedVector<std::string>& output_names,
+                           std::vector<OrtValue>& ort_outputs) const override;
+
+ private:
+  struct Request {
+    const CloudEndPointConfig* run_options;
+    gsl::span<const OrtValue> inputs;
+    std::vector<OrtValue>* outputs;
+    int64_t rows;
+    Status status;
+    bool done = false;
+  };
+
+  struct Batch {
+    InlinedVector<Request*> requests;
+    int64_t rows = 0;
+    bool closed = false;
+  };
+
+  // Returns false if the inputs cannot be merged with the inputs of other requests.
+  static bool IsBatchable(gsl::span<const OrtValue> inputs, int64_t& rows);
+  static bool CanMerge(const Request& a, const Request& b);
+  Status SendBatch(const InlinedVector<std::string>& input_names,
+                   const InlinedVector<std::string>& output_names,
+                   const Batch& batch) const;
+
+  std::unique_ptr<CloudEndPointInvoker> invoker_;
+  const int64_t max_batch_size_;
+  std::chrono::microseconds max_delay_{1000};
+
+  mutable OrtMutex mutex_;
+  mutable OrtCondVar cv_;
+  mutable InlinedVector<Batch*> open_batches_;
+};
+
+BatchingInvoker::BatchingInvoker(const CloudEndPointConfig& config, const AllocatorPtr& allocator,
+                                 std::unique_ptr<CloudEndPointInvoker> invoker, int64_t max_batch_size)
+    : CloudEndPointInvoker(config, allocator), invoker_(std::move(invoker)), max_batch_size_(max_batch_size) {
+  int64_t max_delay_us = max_delay_.count();
+  ReadConfig(kAzureMaxBatchDelayUs, max_delay_us);
+  max_delay_ = std::chrono::microseconds(max_delay_us);
+}
+
+bool BatchingInvoker::IsBatchable(gsl::span<const OrtValue> inputs, int64_t& rows) {
+  rows = -1;
+  for (const auto& input : inputs) {
+    if (!input.IsTensor()) {
+      return false;
+    }
+    const auto& tensor = input.Get<Tensor>();
+    const auto& shape = tensor.Shape();
+    if (tensor.IsDataTypeString() || shape.NumDimensions() == 0 || shape[0] <= 0 ||
+        (rows != -1 && shape[0] != rows)) {
+      return false;
+    }
+    rows = shape[0];
+  }
+  return rows > 0;
+}
+
+bool BatchingInvoker::CanMerge(const Request& a, const Request& b) {
+  if (*a.run_options != *b.run_options || a.inputs.size() != b.inputs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.inputs.size(); ++i) {
+    const auto& tensor_a = a.inputs[i].Get<Tensor>();
+    const auto& tensor_b = b.inputs[i].Get<Tensor>();
+    const auto dims_a = tensor_a.Shape().GetDims();
+    const auto dims_b = tensor_b.Shape().GetDims();
+    if (tensor_a.DataType() != tensor_b.DataType() || dims_a.size() != dims_b.size() ||
+        !std::equal(dims_a.begin() + 1, dims_a.end(), dims_b.begin() + 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+onnxruntime::Status BatchingInvoker::Send(const CloudEndPointConfig& run_options,
+                                          const InlinedVector<std::string>& input_names,
+                                          gsl::span<const OrtValue> ort_inputs,
+                                          const InlinedVector<std::string>& output_names,
+                                          std::vector<OrtValue>& ort_outputs) const {
+  int64_t rows = 0;
+  if (!IsBatchable(ort_inputs, rows) || rows >= max_batch_size_) {
+    return invoker_->Send(run_options, input_names, ort_inputs, output_names, ort_outputs);
+  }
+
+  Request request{&run_options, ort_inputs, &ort_outputs, rows};
+  std::unique_lock<OrtMutex> lock(mutex_);
+  for (Batch* batch : open_batches_) {
+    if (batch->closed || !CanMerge(*batch->requests.front(), request)) {
+      continue;
+    }
+    if (batch->rows + rows > max_batch_size_) {
+      // The batch cannot grow anymore, do not make it wait.
+      batch->closed = true;
+      cv_.notify_all();
+      continue;
+    }
+    batch->requests.push_back(&request);
+    batch->rows += rows;
+    if (batch->rows == max_batch_size_) {
+      batch->closed = true;
+      cv_.notify_all();
+    }
+    cv_.wait(lock, [&request]() { return request.done; });
+    return request.status;
+  }
+
+  // Lead a new batch, wait for other requests to join it.
+  Batch batch;
+  batch.requests.push_back(&request);
+  batch.rows = rows;
+  open_batches_.push_back(&batch);
+  const auto deadline = std::chrono::steady_clock::now() + max_delay_;
+  for (auto now = std::chrono::steady_clock::now(); !batch.closed && now < deadline;
+       now = std::chrono::steady_clock::now()) {
+    cv_.wait_for(lock, deadline - now);
+  }
+  open_batches_.erase(std::find(open_batches_.begin(), open_batches_.end(), &batch));
+  lock.unlock();
+
+  Status status = SendBatch(input_names, output_names, batch);
+
+  lock.lock();
+  for (Request* r : batch.requests) {
+    r->status = status;
+    r->done = true;
+  }
+  lock.unlock();
+  cv_.notify_all();
+  return status;
+}
+
+Status BatchingInvoker::SendBatch(const InlinedVector<std::string>& input_names,
+                                  const InlinedVector<std::string>& output_names,
+                                  const Batch& batch) const {
+  const Request& first = *batch.requests.front();
+  if (batch.requests.size() == 1) {
+    return invoker_->Send(*first.run_options, input_names, first.inputs, output_names, *first.outputs);
+  }
+
+  std::vector<OrtValue> merged_inputs(first.inputs.size());
+  for (size_t i = 0; i < merged_inputs.size(); ++i) {
+    const auto& first_tensor = first.inputs[i].Get<Tensor>();
+    auto dims = first_tensor.Shape().AsShapeVector();
+    dims[0] = batch.rows;
+    Tensor::InitOrtValue(first_tensor.DataType(), TensorShape(dims), allocator_, merged_inputs[i]);
+    auto* dst = static_cast<uint8_t*>(merged_inputs[i].GetMutable<Tensor>()->MutableDataRaw());
+    for (const Request* r : batch.requests) {
+      const auto& tensor = r->inputs[i].Get<Tensor>();
+      memcpy(dst, tensor.DataRaw(), tensor.SizeInBytes());
+      dst += tensor.SizeInBytes();
+    }
+  }
+
+  std::vector<OrtValue> merged_outputs;
+  ORT_RETURN_IF_ERROR(invoker_->Send(*first.run_options, input_names, merged_inputs, output_names, merged_outputs));
+
+  for (const Request* r : batch.requests) {
+    if (r->outputs->empty()) {
+      r->outputs->resize(merged_outputs.size());
+    }
+  }
+  for (size_t o = 0; o < merged_outputs.size(); ++o) {
+    const auto& merged_tensor = merged_outputs[o].Get<Tensor>();
+    auto dims = merged_tensor.Shape().AsShapeVector();
+    if (dims.empty() || dims[0] != batch.rows || merged_tensor.IsDataTypeString()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Cannot split output ", output_names[o],
+                             " of a batched request along its first dimension, shape: ", merged_tensor.Shape());
+    }
+    const size_t row_size = merged_tensor.SizeInBytes() / static_cast<size_t>(batch.rows);
+    const auto* src = static_cast<const uint8_t*>(merged_tensor.DataRaw());
+    for (const Request* r : batch.requests) {
+      dims[0] = r->rows;
+      OrtValue& output = (*r->outputs)[o];
+      Tensor::InitOrtValue(merged_tensor.DataType(), TensorShape(dims), allocator_, output);
+      const size_t size = row_size * static_cast<size_t>(r->rows);
+      memcpy(output.GetMutable<Tensor>()->MutableDataRaw(), src, size);
+      src += size;
+    }
+  }
+  return Status::OK();
+}
+
 void CloudEndPointInvoker::ReadConfig(const char* config_name, std::string& config_val, bool required) {
   const auto iter = config_.find(config_name);
   if (config_.end() != iter) {
@@ -277,6 +551,13 @@ void CloudEndPointInvoker::ReadConfig(const char* config_name, std::string& conf
   }
 }
 
+void CloudEndPointInvoker::ReadConfig(const char* config_name, int64_t& config_val) {
+  const auto iter = config_.find(config_name);
+  if (config_.end() != iter && !TryParseStringWithClassicLocale(iter->second, config_val)) {
+    ORT_THROW("Invalid value for config ", config_name, ": ", iter->second);
+  }
+}
+
 Status CloudEndPointInvoker::CreateInvoker(const CloudEndPointConfig& config,
                                            const AllocatorPtr& allocator,
                                            std::unique_ptr<CloudEndPointInvoker>& invoker) {
@@ -286,8 +567,19 @@ Status CloudEndPointInvoker::CreateInvoker(const CloudEndPointConfig& config,
     if (config.end() != iter) {
       if (iter->second == kAzureTriton) {
         invoker = std::make_unique<AzureTritonInvoker>(config, allocator);
-        return status;
-      } // else other endpoint types ...
+      }  // else other endpoint types ...
+    }
+    if (invoker) {
+      const auto batch_size_iter = config.find(kAzureMaxBatchSize);
+      int64_t max_batch_size = 0;
+      if (config.end() != batch_size_iter &&
+          !TryParseStringWithClassicLocale(batch_size_iter->second, max_batch_size)) {
+        ORT_THROW("Invalid value for config ", kAzureMaxBatchSize, ": ", batch_size_iter->second);
+      }
+      if (max_batch_size > 1) {
+        invoker = std::make_unique<BatchingInvoker>(config, allocator, std::move(invoker), max_batch_size);
+      }
+      return status;
     }
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
                              "Cannot create azure invoker due to missed or mismatched endpoint type.");
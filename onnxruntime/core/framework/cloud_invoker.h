@@ -20,6 +20,9 @@ class CloudEndPointInvoker {
   virtual ~CloudEndPointInvoker() = default;
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CloudEndPointInvoker);
 
+  // Creates the invoker of the endpoint type given by the config. The invoker is meant to be
+  // created once per session and reused by all the runs, Send() may be called concurrently.
+  // If "azure.max_batch_size" is greater than 1, the invoker merges concurrent requests.
   static Status CreateInvoker(const CloudEndPointConfig& config,
                               const AllocatorPtr& allocator,
                               std::unique_ptr<CloudEndPointInvoker>& invoker);
@@ -32,8 +35,9 @@ class CloudEndPointInvoker {
 
  protected:
   void ReadConfig(const char* config_name, std::string& config_val, bool required = true);
+  void ReadConfig(const char* config_name, int64_t& config_val);
   CloudEndPointConfig config_;
-  const AllocatorPtr& allocator_;
+  const AllocatorPtr allocator_;
 };
 }  // namespace onnxruntime
 #endif
@@ -336,6 +336,25 @@ bool IExecutionFrame::IsOutput(int ort_value_idx) const {
   return std::find(fetch_mlvalue_idxs_.begin(), fetch_mlvalue_idxs_.end(), ort_value_idx) != fetch_mlvalue_idxs_.end();
 }
 
+namespace {
+std::function<bool(const std::string& name)> IsSparseInitializerFunc(const SessionState& session_state) {
+#if !defined(DISABLE_SPARSE_TENSORS)
+  return [&session_state](const std::string& name) -> bool {
+    int idx = -1;
+    if (session_state.GetOrtValueNameIdxMap().GetIdx(name, idx).IsOK()) {
+      return session_state.IsSparseInitializer(idx);
+    }
+    return false;
+  };
+#else
+  ORT_UNUSED_PARAMETER(session_state);
+  return [](const std::string& /*name*/) -> bool {
+    return false;
+  };
+#endif
+}
+}  // namespace
+
 ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
                                gsl::span<const int> fetch_mlvalue_idxs, gsl::span<const OrtValue> fetches,
                                const std::unordered_map<size_t, IExecutor::CustomAllocator>& fetch_allocators,
@@ -345,22 +364,8 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
       session_state_(session_state),
       mem_patterns_(nullptr),
       device_streams_(device_streams) {
-  Init(
-      feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(),
-#if !defined(DISABLE_SPARSE_TENSORS)
-      [&session_state](const std::string& name) -> bool {
-        int idx = -1;
-        if (session_state.GetOrtValueNameIdxMap().GetIdx(name, idx).IsOK()) {
-          return session_state.IsSparseInitializer(idx);
-        }
-        return false;
-      },
-#else
-      [&](const std::string& /*name*/) -> bool {
-        return false;
-      },
-#endif
-      fetches);
+  Init(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), IsSparseInitializerFunc(session_state),
+       fetches);
 
 #if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
   session_state.GetMemoryProfiler()->GetMemoryInfo().IncreaseIteration();
@@ -467,6 +472,36 @@ ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span
   }
 }
 
+ExecutionFrame::ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                               gsl::span<const int> fetch_mlvalue_idxs, gsl::span<const OrtValue> fetches,
+                               const SessionState& session_state,
+                               std::shared_ptr<const MemoryPatternGroup> mem_patterns,
+                               const InlinedHashMap<int, TensorShape>* inferred_shapes,
+                               gsl::span<void* const> buffers)
+    : IExecutionFrame(session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo(), fetch_mlvalue_idxs),
+      session_state_(session_state),
+      mem_patterns_(std::move(mem_patterns)),
+      inferred_shapes_(inferred_shapes) {
+  Init(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), IsSparseInitializerFunc(session_state),
+       fetches);
+
+#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
+  session_state.GetMemoryProfiler()->GetMemoryInfo().IncreaseIteration();
+#endif
+
+  if (mem_patterns_) {
+    ORT_ENFORCE(buffers.size() == mem_patterns_->locations.size(),
+                "Expected a buffer for each of the ", mem_patterns_->locations.size(), " memory pattern locations.");
+    buffers_.reserve(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      if (buffers[i] != nullptr) {
+        // no allocator in the deleter, the caller owns the buffers
+        buffers_[mem_patterns_->locations[i]] = BufferUniquePtr(buffers[i], BufferDeleter());
+      }
+    }
+  }
+}
+
 ExecutionFrame::~ExecutionFrame() = default;
 
 Status ExecutionFrame::CopyTensor(const Tensor& src, Tensor& dest) const {
@@ -528,8 +563,9 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       if (block) {
         auto it = buffers_.find(location);
         if (it != buffers_.end()) {
-          // if the block is not correct, log message then fall back to default behavior
-          if (block->size_ == size) {
+          // the block was planned for the largest shapes of a bucket of the memory pattern cache so it may be
+          // bigger than needed. if the block is too small, log message then fall back to default behavior
+          if (size <= block->size_) {
             void* buffer = it->second.get();
             auto status = AllocateTensorWithPreAllocateBufferHelper(
                 ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
@@ -538,8 +574,6 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
           } else {
             // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
             // fed in, so use VERBOSE as the log level as it's expected.
-            // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
-            // to be freed if the size difference was too large so our memory usage doesn't stick at a high water mark
             LOGS(session_state_.Logger(), VERBOSE) << "For ort_value with index: " << ort_value_index
                                                    << ", block in memory pattern size is: " << block->size_
                                                    << " but the actually size is: " << size
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -141,6 +142,15 @@ class ExecutionFrame final : public IExecutionFrame {
                  const SessionState& session_state,
                  gsl::span<Stream*> device_streams);
 
+  // Creates a frame for the replay of a CapturedRun. The tensors of mem_patterns are placed in buffers, which hold
+  // one block per location of mem_patterns (nullptr if there is none) and are owned by the caller.
+  ExecutionFrame(gsl::span<const int> feed_mlvalue_idxs, gsl::span<const OrtValue> feeds,
+                 gsl::span<const int> fetch_mlvalue_idxs, gsl::span<const OrtValue> fetches,
+                 const SessionState& session_state,
+                 std::shared_ptr<const MemoryPatternGroup> mem_patterns,
+                 const InlinedHashMap<int, TensorShape>* inferred_shapes,
+                 gsl::span<void* const> buffers);
+
   ~ExecutionFrame() override;
 
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
@@ -220,8 +230,8 @@ class ExecutionFrame final : public IExecutionFrame {
 
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
-  // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // kernel's input/output tensors. Shared with the cache of the session state, which may evict it.
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -233,7 +243,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
-  // inferred_shapes_ is generated together with mem_patterns_.
+  // inferred_shapes_ is generated together with mem_patterns_ and lives as long as it.
   // It is never updated after creation
   const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
 
@@ -73,6 +73,11 @@ std::string LaunchKernelStep::ToString() const {
   return ::onnxruntime::MakeString("Launch kernel with node id: ", node_index_, ". ");
 }
 
+bool LaunchKernelStep::LaunchesKernel(NodeIndex& node_index) const {
+  node_index = node_index_;
+  return true;
+}
+
 ActivateNotificationStep::ActivateNotificationStep(
     NotificationIndex notification_index) : SequentialExecutionPlan::ExecutionStep(),
                                             notification_idx_(notification_index) {}
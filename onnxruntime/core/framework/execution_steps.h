@@ -57,6 +57,8 @@ class LaunchKernelStep : public SequentialExecutionPlan::ExecutionStep {
 
   std::string ToString() const override;
 
+  bool LaunchesKernel(NodeIndex& node_index) const override;
+
  private:
   NodeIndex node_index_{0};
 };
@@ -20,6 +20,7 @@ struct MemoryBlock {
 
 class MemoryPattern {
   friend class MemPatternPlanner;
+  friend class MemoryPatternGroupCache;
 
  public:
   MemoryPattern() = default;
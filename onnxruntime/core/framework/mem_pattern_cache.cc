@@ -0,0 +1,237 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+
+#include "core/common/hash_combine.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// Returns true if every input of input_dims has the rank of the same input of entry_dims
+// and is not bigger in any dim.
+bool Serves(gsl::span<const int64_t> entry_dims, gsl::span<const int64_t> input_dims) {
+  if (entry_dims.size() != input_dims.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < input_dims.size();) {
+    const int64_t rank = input_dims[i];
+    if (entry_dims[i] != rank) {
+      return false;
+    }
+
+    for (size_t end = i + 1 + static_cast<size_t>(rank), j = i + 1; j < end; ++j) {
+      if (input_dims[j] > entry_dims[j]) {
+        return false;
+      }
+    }
+
+    i += 1 + static_cast<size_t>(rank);
+  }
+
+  return true;
+}
+
+// Returns the elementwise max of the dims of two entries of the same bucket, which have the same ranks
+InlinedVector<int64_t> MaxDims(gsl::span<const int64_t> dims_a, gsl::span<const int64_t> dims_b) {
+  InlinedVector<int64_t> dims(dims_a.begin(), dims_a.end());
+  for (size_t i = 0; i < dims.size(); ++i) {
+    dims[i] = std::max(dims[i], dims_b[i]);
+  }
+  return dims;
+}
+
+bool Overlap(const MemoryBlock& a, const MemoryBlock& b) {
+  return a.offset_ < b.offset_ + b.size_ && b.offset_ < a.offset_ + a.size_;
+}
+
+}  // namespace
+
+MemoryPattern MemoryPatternGroupCache::MergePatterns(const MemoryPattern& a, const MemoryPattern& b) {
+  // The blocks of two values overlap in a pattern only if the values are never used at the same time, so such
+  // values may share memory in the merged pattern too. Any other two values must not.
+  struct Value {
+    int ml_value_idx;
+    const MemoryBlock* block_a;
+    const MemoryBlock* block_b;
+    MemoryBlock block;
+  };
+
+  std::vector<Value> values;
+  values.reserve(a.GetPatternsMap().size() + b.GetPatternsMap().size());
+  for (const auto& [ml_value_idx, block] : a.GetPatternsMap()) {
+    values.push_back({ml_value_idx, &block, b.GetBlock(ml_value_idx), {}});
+  }
+  for (const auto& [ml_value_idx, block] : b.GetPatternsMap()) {
+    if (a.GetBlock(ml_value_idx) == nullptr) {
+      values.push_back({ml_value_idx, nullptr, &block, {}});
+    }
+  }
+
+  // place the values in the order of the first pattern, first fit
+  auto first_offset = [](const Value& value) {
+    return value.block_a ? value.block_a->offset_ : value.block_b->offset_;
+  };
+  std::sort(values.begin(), values.end(), [&](const Value& lhs, const Value& rhs) {
+    return std::make_pair(first_offset(lhs), lhs.ml_value_idx) < std::make_pair(first_offset(rhs), rhs.ml_value_idx);
+  });
+
+  MemoryPattern merged;
+  std::vector<MemoryBlock> used;
+  for (size_t i = 0; i < values.size(); ++i) {
+    Value& value = values[i];
+    const size_t size = std::max(value.block_a ? value.block_a->size_ : 0, value.block_b ? value.block_b->size_ : 0);
+
+    used.clear();
+    for (size_t j = 0; j < i; ++j) {
+      const Value& placed = values[j];
+      const bool disjoint_lifetimes =
+          (value.block_a && placed.block_a && Overlap(*value.block_a, *placed.block_a)) ||
+          (value.block_b && placed.block_b && Overlap(*value.block_b, *placed.block_b));
+      if (!disjoint_lifetimes) {
+        used.push_back(placed.block);
+      }
+    }
+    std::sort(used.begin(), used.end());
+
+    size_t offset = 0;
+    for (const auto& block : used) {
+      if (block.offset_ >= offset + size) {
+        break;
+      }
+      offset = std::max(offset, block.offset_ + block.size_);
+    }
+
+    value.block = MemoryBlock(offset, size);
+    merged.patterns_[value.ml_value_idx] = value.block;
+    merged.peak_size_ = std::max(merged.peak_size_, offset + size);
+  }
+
+  return merged;
+}
+
+MemoryPatternGroup MemoryPatternGroupCache::MergePatterns(const MemoryPatternGroup& a, const MemoryPatternGroup& b) {
+  const MemoryPattern empty;
+  MemoryPatternGroup merged;
+  for (size_t i = 0; i < a.locations.size(); ++i) {
+    const MemoryPattern* pattern_b = b.GetPatterns(a.locations[i]);
+    merged.locations.push_back(a.locations[i]);
+    merged.patterns.push_back(MergePatterns(a.patterns[i], pattern_b ? *pattern_b : empty));
+  }
+  for (size_t i = 0; i < b.locations.size(); ++i) {
+    if (a.GetPatterns(b.locations[i]) == nullptr) {
+      merged.locations.push_back(b.locations[i]);
+      merged.patterns.push_back(MergePatterns(empty, b.patterns[i]));
+    }
+  }
+  return merged;
+}
+
+InlinedVector<int64_t> MemoryPatternGroupCache::GetInputDims(gsl::span<const OrtValue> tensor_inputs) {
+  InlinedVector<int64_t> input_dims;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    input_dims.push_back(static_cast<int64_t>(dims.size()));
+    input_dims.insert(input_dims.end(), dims.begin(), dims.end());
+  }
+  return input_dims;
+}
+
+size_t MemoryPatternGroupCache::KeyHash::operator()(const Key& key) const {
+  size_t seed = 0;
+  for (int64_t dim : key) {
+    HashCombine(dim, seed);
+  }
+  return seed;
+}
+
+MemoryPatternGroupCache::Key MemoryPatternGroupCache::GetKey(gsl::span<const int64_t> input_dims) const {
+  Key key(input_dims.begin(), input_dims.end());
+  if (dim_bucket_size_ <= 1) {
+    return key;
+  }
+
+  for (size_t i = 0; i < key.size();) {
+    const size_t rank = static_cast<size_t>(key[i]);
+    // dims of 0 are kept apart, those tensors have no data
+    for (size_t j = i + 1; j <= i + rank; ++j) {
+      if (key[j] > 0) {
+        key[j] = (key[j] + dim_bucket_size_ - 1) / dim_bucket_size_ * dim_bucket_size_;
+      }
+    }
+    i += 1 + rank;
+  }
+  return key;
+}
+
+InlinedVector<int64_t> MemoryPatternGroupCache::GetPlanDims(gsl::span<const int64_t> input_dims) const {
+  auto it = entries_.find(GetKey(input_dims));
+  if (it == entries_.end()) {
+    return InlinedVector<int64_t>(input_dims.begin(), input_dims.end());
+  }
+
+  return MaxDims(it->second->second->input_dims, input_dims);
+}
+
+std::shared_ptr<const MemoryPatternGroupCache::Entry> MemoryPatternGroupCache::Find(
+    gsl::span<const int64_t> input_dims) {
+  auto it = entries_.find(GetKey(input_dims));
+  if (it == entries_.end() || !Serves(it->second->second->input_dims, input_dims)) {
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  ++stats_.hits;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<const MemoryPatternGroupCache::Entry> MemoryPatternGroupCache::Insert(
+    gsl::span<const int64_t> input_dims, MemoryPatternGroup patterns,
+    InlinedHashMap<int, TensorShape> inferred_shapes) {
+  auto entry = std::make_shared<Entry>();
+  entry->patterns = std::move(patterns);
+  entry->input_dims.assign(input_dims.begin(), input_dims.end());
+  entry->inferred_shapes = std::move(inferred_shapes);
+
+  Key key = GetKey(input_dims);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // Keep the entry if it already serves input_dims, e.g. when several frames planned the same shapes
+    const Entry& cached = *it->second->second;
+    if (Serves(cached.input_dims, input_dims)) {
+      lru_.splice(lru_.begin(), lru_, it->second);
+      return it->second->second;
+    }
+
+    // shapes that are bigger in different dims, e.g. [1, 100, 64] and [1, 64, 100], would keep replacing each
+    // other, so make the entry serve both
+    if (!Serves(input_dims, cached.input_dims)) {
+      entry->patterns = MergePatterns(cached.patterns, entry->patterns);
+      entry->input_dims = MaxDims(cached.input_dims, input_dims);
+      // they are only valid for the exact dims they were inferred for
+      entry->inferred_shapes.clear();
+    }
+
+    it->second->second = std::move(entry);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  if (capacity_ > 0 && lru_.size() >= capacity_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+
+  lru_.emplace_front(key, std::move(entry));
+  entries_.emplace(std::move(key), lru_.begin());
+  return lru_.front().second;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+
+struct MemoryPatternCacheStats {
+  size_t hits{0};
+  size_t misses{0};
+  size_t evictions{0};
+  size_t size{0};
+};
+
+// LRU cache of the memory patterns planned for the input shapes of a session.
+//
+// Entries are keyed on the input shapes with every dim rounded up to a multiple of dim_bucket_size, so one entry
+// serves all the shapes of a bucket (e.g.) every sequence length in (64, 128]. An entry serves the shapes that are
+// not bigger than the ones it was planned for in any dim, as their tensors fit in the blocks of the pattern.
+// A shape of the bucket that is bigger in some dim is planned for the elementwise max of its dims and the dims of
+// the entry, or merged with the entry when inserted, so the entry grows to serve every shape seen in its bucket
+// instead of alternating between shapes that are bigger in different dims.
+// With dim_bucket_size <= 1 an entry only serves the exact shapes it was planned for.
+//
+// Not thread safe, SessionState serializes the calls.
+class MemoryPatternGroupCache {
+ public:
+  struct Entry {
+    MemoryPatternGroup patterns;
+    // rank followed by the dims of every input the patterns were planned for
+    InlinedVector<int64_t> input_dims;
+    // shapes of the values inferred when planning for input_dims in training builds.
+    // they are only valid for the exact input_dims.
+    InlinedHashMap<int, TensorShape> inferred_shapes;
+  };
+
+  // capacity is the maximum number of entries, 0 means unbounded.
+  MemoryPatternGroupCache(size_t capacity, int64_t dim_bucket_size)
+      : capacity_(capacity), dim_bucket_size_(dim_bucket_size) {}
+
+  // Returns the rank followed by the dims of every tensor in tensor_inputs.
+  static InlinedVector<int64_t> GetInputDims(gsl::span<const OrtValue> tensor_inputs);
+
+  // Returns the entry that serves input_dims or nullptr. A hit makes the entry the most recently used.
+  std::shared_ptr<const Entry> Find(gsl::span<const int64_t> input_dims);
+
+  // Returns the dims to plan input_dims for, the elementwise max of input_dims and the dims of the entry of their
+  // bucket, so the planned patterns also serve the shapes the entry served.
+  InlinedVector<int64_t> GetPlanDims(gsl::span<const int64_t> input_dims) const;
+
+  // Adds the patterns planned for input_dims unless the entry of their bucket already serves input_dims.
+  // If the entry doesn't serve input_dims and the patterns don't serve the dims of the entry either, they are
+  // merged into an entry for the elementwise max of both dims with blocks big enough for both.
+  // Evicts the least recently used entry when full. Frames using an evicted entry keep it alive.
+  // Returns the entry serving input_dims.
+  std::shared_ptr<const Entry> Insert(gsl::span<const int64_t> input_dims, MemoryPatternGroup patterns,
+                                      InlinedHashMap<int, TensorShape> inferred_shapes = {});
+
+  MemoryPatternCacheStats GetStats() const {
+    MemoryPatternCacheStats stats = stats_;
+    stats.size = lru_.size();
+    return stats;
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternGroupCache);
+
+ private:
+  using Key = InlinedVector<int64_t>;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const;
+  };
+
+  using LruList = std::list<std::pair<Key, std::shared_ptr<const Entry>>>;
+
+  Key GetKey(gsl::span<const int64_t> input_dims) const;
+
+  // Lays out the values of both patterns so each block is as big as in either of them.
+  static MemoryPattern MergePatterns(const MemoryPattern& a, const MemoryPattern& b);
+  static MemoryPatternGroup MergePatterns(const MemoryPatternGroup& a, const MemoryPatternGroup& b);
+
+  const size_t capacity_;
+  const int64_t dim_bucket_size_;
+
+  // most recently used first
+  LruList lru_;
+  std::unordered_map<Key, LruList::iterator, KeyHash> entries_;
+  MemoryPatternCacheStats stats_;
+};
+
+}  // namespace onnxruntime
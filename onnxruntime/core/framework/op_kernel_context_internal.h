@@ -5,6 +5,7 @@
 
 #include <functional>
 #include "core/framework/op_kernel.h"
+#include "core/framework/run_options.h"
 #include "core/framework/session_state.h"
 #include "core/session/onnxruntime_c_api.h"
 
@@ -22,10 +23,12 @@ class OpKernelContextInternal : public OpKernelContext {
                                    const OpKernel& kernel,
                                    const logging::Logger& logger,
                                    const bool& terminate_flag,
-                                   Stream* stream)
+                                   Stream* stream,
+                                   const RunOptions* run_options = nullptr)
       : OpKernelContext(&frame, &kernel, stream, session_state.GetThreadPool(), logger),
         session_state_(session_state),
-        terminate_flag_(terminate_flag) {
+        terminate_flag_(terminate_flag),
+        run_options_(run_options) {
     const auto& implicit_inputs = kernel.Node().ImplicitInputDefs();
     int num_implicit_inputs = static_cast<int>(implicit_inputs.size());
     implicit_input_values_.reserve(num_implicit_inputs);
@@ -71,9 +74,14 @@ class OpKernelContextInternal : public OpKernelContext {
 
   const bool& GetTerminateFlag() const noexcept { return terminate_flag_; }
 
+  // Options of the current Run.
+  // nullptr when the kernel is not run from InferenceSession::Run, e.g. inside a subgraph.
+  const RunOptions* GetRunOptions() const noexcept { return run_options_; }
+
  private:
   const SessionState& session_state_;
   const bool& terminate_flag_;
+  const RunOptions* run_options_;
   std::vector<const OrtValue*> implicit_input_values_;
 };
 
@@ -0,0 +1,395 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/prepacked_weights_file_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <type_traits>
+
+#include "core/common/cpuid_info.h"
+#include "core/framework/murmurhash3.h"
+#include "core/framework/tensor.h"
+#include "core/graph/graph.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// File layout:
+//   FileHeader
+//   entry_count x { uint64_t key_length, char key[key_length], uint64_t buffer_count,
+//                   buffer_count x { uint64_t offset, uint64_t size } }
+//   buffers, each starting at an offset aligned to kBufferAlignment
+constexpr char kMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', 'C', '\0'};
+constexpr uint32_t kFileFormatVersion = 1;
+constexpr size_t kIsaLength = 128;
+
+// The mapping is page aligned, keep the buffers aligned for the SIMD loads of the kernels
+constexpr size_t kBufferAlignment = 64;
+
+struct FileHeader {
+  char magic[sizeof(kMagic)];
+  uint32_t file_format_version;
+  uint32_t mlas_packed_format_version;
+  char isa[kIsaLength];
+  uint64_t entry_count;
+};
+
+// The packed layout chosen by a kernel depends on the instruction set extensions MLAS dispatches to
+std::string GetCpuIsaSignature() {
+  const auto& cpu = CPUIDInfo::GetCPUIDInfo();
+  std::ostringstream ss;
+#if defined(MLAS_TARGET_AMD64)
+  ss << "amd64";
+#elif defined(MLAS_TARGET_IX86)
+  ss << "ix86";
+#elif defined(MLAS_TARGET_ARM64)
+  ss << "arm64";
+#elif defined(MLAS_TARGET_ARM)
+  ss << "arm";
+#elif defined(MLAS_TARGET_POWER)
+  ss << "power";
+#else
+  ss << "other";
+#endif
+
+  const std::pair<const char*, bool> features[] = {
+      {"sse3", cpu.HasSSE3()},
+      {"sse4_1", cpu.HasSSE4_1()},
+      {"avx", cpu.HasAVX()},
+      {"avx2", cpu.HasAVX2()},
+      {"f16c", cpu.HasF16C()},
+      {"avx512f", cpu.HasAVX512f()},
+      {"avx512skylake", cpu.HasAVX512Skylake()},
+      {"avx512_bf16", cpu.HasAVX512_BF16()},
+      {"amx_bf16", cpu.HasAMX_BF16()},
+      {"neon_dot", cpu.HasArmNeonDot()},
+  };
+  for (const auto& feature : features) {
+    if (feature.second) {
+      ss << "," << feature.first;
+    }
+  }
+
+  return ss.str();
+}
+
+void FillHeader(FileHeader& header, const std::string& isa) {
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.file_format_version = kFileFormatVersion;
+  header.mlas_packed_format_version = MLAS_PACKED_FORMAT_VERSION;
+  memcpy(header.isa, isa.data(), std::min(isa.size(), kIsaLength - 1));
+}
+
+size_t AlignBufferOffset(size_t offset) {
+  return (offset + kBufferAlignment - 1) / kBufferAlignment * kBufferAlignment;
+}
+
+class KeyHasher {
+ public:
+  void Add(const void* data, size_t length) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+
+    // MurmurHash3 takes an int length, hash large initializers in chunks
+    do {
+      const size_t chunk = std::min(length, size_t{1} << 30);
+      MurmurHash3::x86_128(bytes, static_cast<int>(chunk), hash_[0], &hash_);
+      bytes += chunk;
+      length -= chunk;
+    } while (length > 0);
+  }
+
+  template <typename T>
+  void Add(T value) {
+    static_assert(std::is_arithmetic_v<T>);
+    Add(&value, sizeof(value));
+  }
+
+  void Add(const std::string& value) {
+    Add(value.size());
+    Add(value.data(), value.size());
+  }
+
+  std::string Key() const {
+    std::ostringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (uint32_t h : hash_) {
+      ss << std::setw(8) << h;
+    }
+    return ss.str();
+  }
+
+ private:
+  uint32_t hash_[4] = {0, 0, 0, 0};
+};
+
+}  // namespace
+
+Status PrepackedWeightsFileCache::Load(const PathString& file_path, const logging::Logger& logger,
+                                       /*out*/ std::unique_ptr<PrepackedWeightsFileCache>& cache) {
+  cache.reset(new PrepackedWeightsFileCache(file_path, logger));
+
+  const auto& env = Env::Default();
+  size_t file_length = 0;
+  if (!env.GetFileLength(file_path.c_str(), file_length).IsOK() || file_length == 0) {
+    LOGS(logger, INFO) << "Pre-packed weights cache file " << ToUTF8String(file_path)
+                       << " doesn't exist yet. It will be written once the session is initialized.";
+    cache->dirty_ = true;
+    return Status::OK();
+  }
+
+  Status status = env.MapFileIntoMemory(file_path.c_str(), 0, file_length, cache->mapped_file_);
+  if (!status.IsOK()) {
+    LOGS(logger, WARNING) << "Failed to map pre-packed weights cache file: " << status.ErrorMessage();
+    cache->dirty_ = true;
+    return Status::OK();
+  }
+
+  if (!cache->ParseMappedFile(file_length)) {
+    LOGS(logger, WARNING) << "Ignoring pre-packed weights cache file " << ToUTF8String(file_path)
+                          << " as it was written for a different CPU or version of onnxruntime, or is corrupted."
+                          << " It will be rewritten once the session is initialized.";
+    cache->entries_.clear();
+    cache->mapped_file_.reset();
+    cache->dirty_ = true;
+  }
+
+  return Status::OK();
+}
+
+bool PrepackedWeightsFileCache::ParseMappedFile(size_t file_length) {
+  const char* const base = mapped_file_.get();
+  size_t offset = 0;
+
+  auto read = [&](void* dst, size_t length) {
+    if (file_length - offset < length) {
+      return false;
+    }
+    memcpy(dst, base + offset, length);
+    offset += length;
+    return true;
+  };
+
+  FileHeader header;
+  FileHeader expected_header;
+  FillHeader(expected_header, GetCpuIsaSignature());
+  if (!read(&header, sizeof(header)) || memcmp(&header, &expected_header, offsetof(FileHeader, entry_count)) != 0) {
+    return false;
+  }
+
+  for (uint64_t i = 0; i < header.entry_count; i++) {
+    uint64_t key_length;
+    if (!read(&key_length, sizeof(key_length)) || key_length > file_length - offset) {
+      return false;
+    }
+    std::string key(base + offset, static_cast<size_t>(key_length));
+    offset += static_cast<size_t>(key_length);
+
+    uint64_t buffer_count;
+    if (!read(&buffer_count, sizeof(buffer_count))) {
+      return false;
+    }
+
+    PrePackedWeights weights;
+    for (uint64_t b = 0; b < buffer_count; b++) {
+      uint64_t buffer_offset = 0;
+      uint64_t buffer_size = 0;
+      if (!read(&buffer_offset, sizeof(buffer_offset)) || !read(&buffer_size, sizeof(buffer_size)) ||
+          buffer_offset > file_length || buffer_size > file_length - buffer_offset) {
+        return false;
+      }
+
+      // some pre-packed buffers are null "place-holders", they are stored with a zero size
+      void* buffer = buffer_size != 0 ? const_cast<char*>(base) + buffer_offset : nullptr;
+      weights.buffers_.emplace_back(buffer, BufferDeleter(nullptr));
+      weights.buffer_sizes_.push_back(static_cast<size_t>(buffer_size));
+    }
+
+    entries_.emplace(std::move(key), Entry{std::move(weights), false});
+  }
+
+  return true;
+}
+
+std::string PrepackedWeightsFileCache::GenerateNodeKey(const Node& node,
+                                                       gsl::span<const Tensor* const> constant_inputs) {
+  KeyHasher hasher;
+  hasher.Add(node.GetExecutionProviderType());
+  hasher.Add(node.Domain());
+  hasher.Add(node.OpType());
+  hasher.Add(node.SinceVersion());
+  hasher.Add(node.Name());
+
+  // attributes such as transB change the packed layout
+  const auto& attributes = node.GetAttributes();
+  std::vector<const std::string*> attribute_names;
+  attribute_names.reserve(attributes.size());
+  for (const auto& attribute : attributes) {
+    attribute_names.push_back(&attribute.first);
+  }
+  std::sort(attribute_names.begin(), attribute_names.end(),
+            [](const std::string* lhs, const std::string* rhs) { return *lhs < *rhs; });
+  for (const std::string* name : attribute_names) {
+    hasher.Add(*name);
+    const auto& attribute = attributes.at(*name);
+    if (!attribute.has_g() && attribute.graphs_size() == 0) {
+      hasher.Add(attribute.SerializeAsString());
+    }
+  }
+
+  for (size_t i = 0; i < constant_inputs.size(); i++) {
+    const Tensor* tensor = constant_inputs[i];
+    if (tensor == nullptr) {
+      continue;
+    }
+    if (tensor->IsDataTypeString()) {
+      return {};
+    }
+
+    hasher.Add(i);
+    hasher.Add(tensor->GetElementType());
+    hasher.Add(tensor->Shape().NumDimensions());
+    for (int64_t dim : tensor->Shape().GetDims()) {
+      hasher.Add(dim);
+    }
+    hasher.Add(tensor->DataRaw(), tensor->SizeInBytes());
+  }
+
+  return hasher.Key();
+}
+
+const PrePackedWeights* PrepackedWeightsFileCache::GetWeight(const std::string& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+
+  it->second.used = true;
+  return &it->second.weights;
+}
+
+void PrepackedWeightsFileCache::AddWeight(const std::string& key, PrePackedWeights&& weights, bool persist) {
+  if (persist && entries_.find(key) == entries_.end()) {
+    entries_.emplace(key, Entry{std::move(weights), true});
+    dirty_ = true;
+  } else {
+    session_weights_.push_back(std::move(weights));
+  }
+}
+
+PrepackedWeightsFileCache::~PrepackedWeightsFileCache() {
+  if (pending_file_path_.empty()) {
+    return;
+  }
+
+  mapped_file_.reset();
+  Status status = ReplaceFile(pending_file_path_);
+  if (!status.IsOK() && logging::LoggingManager::HasDefaultLogger()) {
+    LOGS_DEFAULT(WARNING) << "Failed to persist pre-packed weights: " << status.ErrorMessage();
+  }
+}
+
+Status PrepackedWeightsFileCache::ReplaceFile(const PathString& written_file_path) const {
+  std::error_code error;
+  std::filesystem::rename(written_file_path, file_path_, error);
+  if (error) {
+    const std::string message = error.message();
+    std::filesystem::remove(written_file_path, error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace pre-packed weights cache file ",
+                           ToUTF8String(file_path_), ": ", message);
+  }
+
+  return Status::OK();
+}
+
+Status PrepackedWeightsFileCache::Save() {
+  if (!dirty_) {
+    return Status::OK();
+  }
+
+  std::vector<std::pair<const std::string*, const PrePackedWeights*>> entries;
+  size_t index_length = 0;
+  for (const auto& entry : entries_) {
+    if (entry.second.used) {
+      entries.emplace_back(&entry.first, &entry.second.weights);
+      index_length += sizeof(uint64_t) + entry.first.size() + sizeof(uint64_t) +
+                      entry.second.weights.buffers_.size() * 2 * sizeof(uint64_t);
+    }
+  }
+
+  FileHeader header;
+  FillHeader(header, GetCpuIsaSignature());
+  header.entry_count = entries.size();
+
+  // Sessions of other processes may write the same file at the same time, each one writes its own temporary file.
+  static std::atomic<uint64_t> temp_file_counter{0};
+  const PathString temp_file_path = file_path_ + ToPathString("." + std::to_string(Env::Default().GetSelfPid()) +
+                                                              "." + std::to_string(temp_file_counter++) + ".tmp");
+  {
+    std::ofstream file(temp_file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file, "Failed to open pre-packed weights cache file: ", ToUTF8String(temp_file_path));
+
+    auto write = [&file](const void* data, size_t length) {
+      file.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+    };
+
+    write(&header, sizeof(header));
+
+    size_t data_offset = AlignBufferOffset(sizeof(header) + index_length);
+    for (const auto& entry : entries) {
+      const PrePackedWeights& weights = *entry.second;
+      const uint64_t key_length = entry.first->size();
+      const uint64_t buffer_count = weights.buffers_.size();
+      write(&key_length, sizeof(key_length));
+      write(entry.first->data(), entry.first->size());
+      write(&buffer_count, sizeof(buffer_count));
+      for (size_t b = 0; b < weights.buffers_.size(); b++) {
+        const uint64_t buffer_size = weights.buffers_[b] != nullptr ? weights.buffer_sizes_[b] : 0;
+        const uint64_t buffer_offset = data_offset;
+        write(&buffer_offset, sizeof(buffer_offset));
+        write(&buffer_size, sizeof(buffer_size));
+        data_offset = AlignBufferOffset(data_offset + static_cast<size_t>(buffer_size));
+      }
+    }
+
+    static const char padding[kBufferAlignment] = {};
+    size_t offset = sizeof(header) + index_length;
+    for (const auto& entry : entries) {
+      const PrePackedWeights& weights = *entry.second;
+      for (size_t b = 0; b < weights.buffers_.size(); b++) {
+        write(padding, AlignBufferOffset(offset) - offset);
+        offset = AlignBufferOffset(offset);
+        if (weights.buffers_[b] != nullptr) {
+          write(weights.buffers_[b].get(), weights.buffer_sizes_[b]);
+          offset += weights.buffer_sizes_[b];
+        }
+      }
+    }
+
+    ORT_RETURN_IF_NOT(file.flush(), "Failed to write pre-packed weights cache file: ",
+                      ToUTF8String(temp_file_path));
+  }
+
+  // The kernels of this session use the buffers mapped from the file, and Windows doesn't replace a mapped file.
+  if (mapped_file_) {
+    pending_file_path_ = temp_file_path;
+    LOGS(logger_, INFO) << "Wrote " << entries.size() << " pre-packed weights for " << ToUTF8String(file_path_)
+                        << ", which is replaced once the session releases the mapped weights.";
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF_ERROR(ReplaceFile(temp_file_path));
+  LOGS(logger_, INFO) << "Wrote " << entries.size() << " pre-packed weights to " << ToUTF8String(file_path_);
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/common/logging/logging.h"
+#include "core/common/path_string.h"
+#include "core/platform/env.h"
+#include "prepacked_weights.h"
+
+namespace onnxruntime {
+
+class Node;
+class Tensor;
+
+// Persists the pre-packed weights of a session in a file so that later processes loading the same model
+// can map them instead of running PrePack() again (see kOrtSessionOptionsConfigPrepackedWeightsCacheFile).
+//
+// The file is only used if it was written on a CPU with the same instruction set extensions and with the same
+// MLAS_PACKED_FORMAT_VERSION, as the layout chosen by PrePack() depends on both. Each weight is keyed by the
+// consuming node and the contents of the constant initializer.
+class PrepackedWeightsFileCache final {
+ public:
+  // Maps the file if it exists and is valid for this process. A missing or stale file is not an error,
+  // the cache starts empty and the file is rewritten by Save().
+  static Status Load(const PathString& file_path, const logging::Logger& logger,
+                     /*out*/ std::unique_ptr<PrepackedWeightsFileCache>& cache);
+
+  // Returns the part of the key shared by the weights pre-packed from the inputs of node. PrePack() may read
+  // any constant input (e.g.) MatMulNBits packs B with its scales, so all of them are hashed.
+  // constant_inputs holds the constant initializer of each input of node, or nullptr.
+  // Returns an empty string if the weights of node cannot be persisted (e.g.) an input is a string tensor.
+  static std::string GenerateNodeKey(const Node& node, gsl::span<const Tensor* const> constant_inputs);
+
+  // Returns the key of the weight pre-packed from the input input_idx of a node.
+  static std::string GenerateKey(const std::string& node_key, int input_idx) {
+    return node_key + "_" + std::to_string(input_idx);
+  }
+
+  // Returns the persisted weights for key or nullptr. The buffers of weights read from the file point into
+  // the mapping, which lives as long as this instance.
+  const PrePackedWeights* GetWeight(const std::string& key);
+
+  // Takes ownership of weights pre-packed by this session. They are written by Save() if persist is true,
+  // otherwise they are only kept alive for the kernel using them.
+  void AddWeight(const std::string& key, PrePackedWeights&& weights, bool persist);
+
+  // Rewrites the file with the weights used by this session if any weight was added since Load().
+  // The file is replaced atomically, so other processes never map a partially written cache. While this session
+  // maps the file, it is only replaced by the destructor once the mapping is released.
+  Status Save();
+
+  ~PrepackedWeightsFileCache();
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsFileCache);
+
+ private:
+  PrepackedWeightsFileCache(const PathString& file_path, const logging::Logger& logger)
+      : file_path_(file_path), logger_(logger) {}
+
+  // Parses the mapped file, returns false if it wasn't written for this process.
+  bool ParseMappedFile(size_t file_length);
+
+  // Replaces the file with the one written by Save().
+  Status ReplaceFile(const PathString& written_file_path) const;
+
+  struct Entry {
+    PrePackedWeights weights;
+    bool used;
+  };
+
+  const PathString file_path_;
+  const logging::Logger& logger_;
+
+  Env::MappedMemoryPtr mapped_file_;
+
+  // Weights to persist. The ones read from the file use BufferDeleter(nullptr) as the mapping owns their memory.
+  std::unordered_map<std::string, Entry> entries_;
+
+  // Weights pre-packed by kernels that cannot restore themselves from persisted buffers.
+  std::vector<PrePackedWeights> session_weights_;
+
+  bool dirty_ = false;
+
+  // File written by Save() that replaces the mapped file once the mapping is released.
+  PathString pending_file_path_;
+};
+
+}  // namespace onnxruntime
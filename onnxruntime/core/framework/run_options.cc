@@ -60,3 +60,10 @@ ORT_API_STATUS_IMPL(OrtApis::AddRunConfigEntry, _Inout_ OrtRunOptions* options,
                     _In_z_ const char* config_key, _In_z_ const char* config_value) {
   return onnxruntime::ToOrtStatus(options->config_options.AddConfigEntry(config_key, config_value));
 }
+
+ORT_API_STATUS_IMPL(OrtApis::RunOptionsSetGenerationStreamingCallback, _Inout_ OrtRunOptions* options,
+                    _In_opt_ GenerationStreamingCallbackFn callback, _In_opt_ void* user_data) {
+  options->generation_streaming_callback = callback;
+  options->generation_streaming_callback_user_data = user_data;
+  return nullptr;
+}
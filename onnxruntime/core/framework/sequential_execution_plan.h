@@ -116,6 +116,8 @@ struct SequentialExecutionPlan : public ExecutionPlanBase {
                            const bool& terminate_flag,
                            bool& continue_flag) = 0;
     virtual std::string ToString() const = 0;
+    // returns true and sets node_index if the step launches the kernel of a node
+    virtual bool LaunchesKernel(NodeIndex& /*node_index*/) const { return false; }
 #ifdef ENABLE_TRAINING
     // the partial execution mode for training needs special handling for barrier
     virtual bool IsBarrier() const { return false; }
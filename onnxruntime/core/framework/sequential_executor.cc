@@ -10,6 +10,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
+#include "core/framework/captured_run.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/stream_execution_context.h"
 #include "core/framework/session_state.h"
@@ -433,6 +434,26 @@ class KernelScope {
 #endif
 };
 
+// Returns the error of a failed kernel with the node it ran for.
+static Status KernelFailureStatus(const SessionState& session_state, const OpKernel& kernel, const Status& status,
+                                  const logging::Logger& logger) {
+  std::ostringstream ss;
+  const auto& node = kernel.Node();
+  ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+     << "' Status Message: " << status.ErrorMessage();
+  // If the computation failed, we still can record the memory consumption
+#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
+  session_state.GetMemoryProfiler()->CreateEvents(
+      "dynamic activations_" + std::to_string(session_state.GetMemoryProfiler()->GetMemoryInfo().GetIteration()),
+      session_state.GetMemoryProfiler()->GetAndIncreasePid(), MemoryInfo::MapType::DynamicActivation, "", 0);
+#else
+  ORT_UNUSED_PARAMETER(session_state);
+#endif
+  const auto msg_string = ss.str();
+  LOGS(logger, ERROR) << msg_string;
+  return Status(status.Category(), status.Code(), msg_string);
+}
+
 onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                   NodeIndex idx,
                                   size_t stream_idx,
@@ -454,7 +475,8 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
                                      *p_kernel,
                                      ctx.GetLogger(),
                                      terminate_flag,
-                                     ctx.GetDeviceStream(stream_idx));
+                                     ctx.GetDeviceStream(stream_idx),
+                                     ctx.GetRunOptions());
   onnxruntime::Status status;
   auto& logger = ctx.GetLogger();
   if (p_kernel->IsAsync()) {
@@ -502,19 +524,7 @@ onnxruntime::Status ExecuteKernel(StreamExecutionContext& ctx,
     }
   }
   if (!status.IsOK()) {
-    std::ostringstream ss;
-    const auto& node = p_kernel->Node();
-    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
-       << "' Status Message: " << status.ErrorMessage();
-    // If the computation failed, we still can record the memory consumption
-#if !defined(ORT_MINIMAL_BUILD) && defined(ORT_MEMORY_PROFILE)
-    ctx.GetSessionState().GetMemoryProfiler()->CreateEvents(
-        "dynamic activations_" + std::to_string(ctx.GetSessionState().GetMemoryProfiler()->GetMemoryInfo().GetIteration()),
-        ctx.GetSessionState().GetMemoryProfiler()->GetAndIncreasePid(), MemoryInfo::MapType::DynamicActivation, "", 0);
-#endif
-    const auto msg_string = ss.str();
-    LOGS(logger, ERROR) << msg_string;
-    return Status(status.Category(), status.Code(), msg_string);
+    return KernelFailureStatus(ctx.GetSessionState(), *p_kernel, status, logger);
   }
   ctx.RecycleNodeInputs(idx);
   LOGS(logger, VERBOSE) << "stream " << stream_idx << " launch kernel with idx " << idx;
@@ -531,7 +541,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #endif
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
-                                   bool single_thread_mode) {
+                                   bool single_thread_mode,
+                                   const RunOptions* run_options) {
   auto* execution_plan = session_state.GetExecutionPlan();
   LOGS(logger, VERBOSE) << "Number of streams: " << execution_plan->execution_plan.size();
   int32_t valid_streams = 0;
@@ -574,6 +585,8 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
   ORT_UNUSED_PARAMETER(only_execute_path_to_fetches);
 #endif
 
+  ctx.SetRunOptions(run_options);
+
   SessionScope session_scope(session_state, ctx.GetExecutionFrame());
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
@@ -613,6 +626,51 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
   return Status::OK();
 }
 
+onnxruntime::Status ReplayThePlan(const SessionState& session_state, const CapturedRun& captured_run,
+                                  gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                  const logging::Logger& logger,
+                                  const bool& terminate_flag,
+                                  const RunOptions* run_options) {
+  const auto& feeds_fetches_info = captured_run.GetFeedsFetchesInfo();
+  ExecutionFrame frame(feeds_fetches_info.feeds_mlvalue_idxs, feeds, feeds_fetches_info.fetches_mlvalue_idxs, fetches,
+                       session_state, captured_run.GetMemoryPatterns(), captured_run.GetInferredShapes(),
+                       captured_run.GetBuffers());
+
+  SessionScope session_scope(session_state, frame);
+
+  for (const auto& kernel : captured_run.GetKernels()) {
+    if (terminate_flag) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    }
+
+    // CPU kernels don't use streams
+    OpKernelContextInternal kernel_ctx(session_state, frame, *kernel.kernel, logger, terminate_flag,
+                                       /*stream*/ nullptr, run_options);
+    onnxruntime::Status status;
+    {
+      KernelScope kernel_scope(session_scope, kernel_ctx, *kernel.kernel);
+      ORT_TRY {
+        status = kernel.kernel->Compute(&kernel_ctx);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+    }
+
+    if (!status.IsOK()) {
+      return KernelFailureStatus(session_state, *kernel.kernel, status, logger);
+    }
+
+    for (int ort_value_idx : kernel.values_to_release) {
+      ORT_RETURN_IF_ERROR(frame.ReleaseMLValue(ort_value_idx));
+    }
+  }
+
+  return frame.GetOutputs(fetches);
+}
+
 #ifdef ENABLE_TRAINING
 onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
                                           gsl::span<const OrtValue> feeds, gsl::span<const int> fetch_mlvalue_idxs,
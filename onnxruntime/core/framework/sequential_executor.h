@@ -21,6 +21,7 @@
 
 namespace onnxruntime {
 
+class CapturedRun;
 class StreamExecutionContext;
 class DeviceStreamCollection;
 class SessionScope;
@@ -46,7 +47,15 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 #endif
                                    const bool& terminate_flag,
                                    const bool only_execute_path_to_fetches,
-                                   bool single_thread_mode);
+                                   bool single_thread_mode,
+                                   const RunOptions* run_options);
+
+// Runs the kernels of captured_run in order. captured_run must match feeds and fetches.
+onnxruntime::Status ReplayThePlan(const SessionState& session_state, const CapturedRun& captured_run,
+                                  gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                  const logging::Logger& logger,
+                                  const bool& terminate_flag,
+                                  const RunOptions* run_options);
 
 #ifdef ENABLE_TRAINING
 onnxruntime::Status PartialExecuteThePlan(const SessionState& session_state, gsl::span<const int> feed_mlvalue_idxs,
@@ -7,6 +7,7 @@
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -86,6 +87,7 @@ SessionState::SessionState(Graph& graph,
 {
   enable_mem_pattern_ = sess_options_.enable_mem_pattern &&
                         sess_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL;
+
   SetupAllocators();
 }
 
@@ -358,6 +360,60 @@ static Status KernelUseSharedPrePackedBuffers(OpKernel& kernel, int input_idx,
   return Status::OK();
 }
 
+// Returns the buffers of prepacked_weights without ownership, the kernel may only use them.
+static std::vector<BufferUniquePtr> GetUnownedPrePackedBuffers(const PrePackedWeights& prepacked_weights) {
+  std::vector<BufferUniquePtr> buffers;
+  buffers.reserve(prepacked_weights.buffers_.size());
+
+  for (const auto& prepacked_buffer : prepacked_weights.buffers_) {
+    buffers.emplace_back(prepacked_buffer.get(), BufferDeleter(nullptr));
+  }
+
+  return buffers;
+}
+
+// Pre-packs a constant initializer through the persisted pre-packed weights cache.
+// Kernels that can restore themselves from persisted buffers skip PrePack() when the cache holds their weight,
+// the weights they pre-pack are added to the cache to be written out once the session state is finalized.
+static Status PrePackUsingFileCache(OpKernel& kernel, const Node& node, const std::string& node_key, int input_idx,
+                                    const Tensor& tensor, const AllocatorPtr& alloc,
+                                    PrepackedWeightsFileCache& file_cache,
+                                    /*out*/ bool& is_packed, /*out*/ bool& used_persisted_weight) {
+  is_packed = false;
+  used_persisted_weight = false;
+
+  const std::string key = PrepackedWeightsFileCache::GenerateKey(node_key, input_idx);
+
+  if (const PrePackedWeights* persisted_weights = file_cache.GetWeight(key); persisted_weights != nullptr) {
+    auto buffers = GetUnownedPrePackedBuffers(*persisted_weights);
+    ORT_RETURN_IF_ERROR(kernel.UsePersistedPrePackedBuffers(tensor, buffers, input_idx, used_persisted_weight));
+    if (used_persisted_weight) {
+      is_packed = true;
+      return Status::OK();
+    }
+  }
+
+  PrePackedWeights weights_to_be_filled_in;
+  ORT_RETURN_IF_ERROR(kernel.PrePack(tensor, input_idx, alloc, is_packed, &weights_to_be_filled_in));
+
+  // The kernel keeps its pre-packed buffers if it cannot share them
+  if (!is_packed || weights_to_be_filled_in.buffers_.empty()) {
+    return Status::OK();
+  }
+
+  // Restore the kernel from the buffers it just packed, so the path taken by later sessions reading them back
+  // from the file is the one tested by this session.
+  auto buffers = GetUnownedPrePackedBuffers(weights_to_be_filled_in);
+  bool persist = false;
+  ORT_RETURN_IF_ERROR(kernel.UsePersistedPrePackedBuffers(tensor, buffers, input_idx, persist));
+  if (!persist) {
+    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(kernel, input_idx, weights_to_be_filled_in, node.Name()));
+  }
+
+  file_cache.AddWeight(key, std::move(weights_to_be_filled_in), persist);
+  return Status::OK();
+}
+
 static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
                                                      const PrePackedWeights& pre_packed_weights) {
   std::ostringstream ss_1;
@@ -370,10 +426,25 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
 
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  PrepackedWeightsFileCache* prepacked_weights_file_cache = GetPrepackedWeightsFileCache();
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     prepacked_weights_file_cache](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
+      // Key of the persisted pre-packed weights of the node. It hashes all the constant inputs of the node, so it
+      // is computed before any of them is released, and only for the kernels that can use persisted weights.
+      std::string file_cache_node_key;
+      if (prepacked_weights_file_cache != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider) {
+        auto constant_inputs = GetConstantInitializedInputs(node);
+        for (size_t i = 0; i < constant_inputs.size(); ++i) {
+          if (constant_inputs[i] != nullptr && kernel->CanUsePersistedPrePackedBuffers(static_cast<int>(i))) {
+            file_cache_node_key = PrepackedWeightsFileCache::GenerateNodeKey(node, constant_inputs);
+            break;
+          }
+        }
+      }
       int input_idx = 0;
       for (auto& input_def : node.InputDefs()) {
         if (input_def->Exists()) {
@@ -450,6 +521,19 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                     }
                   }
 
+                } else if (!file_cache_node_key.empty() &&
+                           kernel->CanUsePersistedPrePackedBuffers(input_idx)) {  // persisted pre-packed weights
+                  AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(OrtMemType::OrtMemTypeDefault);
+                  bool used_persisted_weight = false;
+                  ORT_RETURN_IF_ERROR(PrePackUsingFileCache(*kernel, node, file_cache_node_key, input_idx,
+                                                            const_initialized_tensor, session_cpu_alloc,
+                                                            *prepacked_weights_file_cache,
+                                                            is_packed, used_persisted_weight));
+                  if (used_persisted_weight) {
+                    LOGS(logger_, VERBOSE) << "Using persisted pre-packed weight for constant initializer: "
+                                           << input_name << " used in the node: " << node.Name();
+                    ++used_persisted_pre_packed_weights_counter_;
+                  }
                 } else {  // caching of pre-packed weights' turned OFF
                   AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(OrtMemType::OrtMemTypeDefault);
                   ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx,
@@ -497,14 +581,6 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -589,16 +665,18 @@ void TryCalculateSizeFromResolvedShape(int ml_value_idx, const InlinedHashMap<in
 }  // namespace
 
 // If this function fails NO memory planning will take place, hence lets ONLY FAIL and stop training where warranted, example SIZE overflow.
-Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
+Status SessionState::GeneratePatternGroupCache(gsl::span<const int64_t> input_dims,
                                                gsl::span<const int> feed_mlvalue_idxs,
                                                MemoryPatternGroup& output,
                                                InlinedHashMap<int, TensorShape>& resolved_shapes) const {
   InlinedHashMap<std::string, TensorShape> feeds;
   feeds.reserve(feed_mlvalue_idxs.size());
-  for (size_t i = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
+  for (size_t i = 0, dims_offset = 0, end = feed_mlvalue_idxs.size(); i < end; ++i) {
     std::string name;
     ORT_RETURN_IF_ERROR(this->ort_value_name_idx_map_.GetName(feed_mlvalue_idxs[i], name));
-    feeds.emplace(std::move(name), tensor_inputs[i].Get<Tensor>().Shape());
+    const size_t rank = static_cast<size_t>(input_dims[dims_offset]);
+    feeds.emplace(std::move(name), TensorShape(input_dims.subspan(dims_offset + 1, rank)));
+    dims_offset += 1 + rank;
   }
   InlinedHashMap<std::string, int64_t> map;
   ORT_RETURN_IF_ERROR(ResolveDimParams(*graph_viewer_, feeds, map));
@@ -739,38 +817,36 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
     const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  const auto input_dims = MemoryPatternGroupCache::GetInputDims(tensor_inputs);
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  auto entry = mem_patterns_->Find(input_dims);
+  if (!entry) {
 #ifdef ENABLE_TRAINING
+    // plan for the biggest dims of the bucket so the entry keeps serving the shapes it served before
+    const auto plan_dims = mem_patterns_->GetPlanDims(input_dims);
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
-    if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+    if (GeneratePatternGroupCache(plan_dims, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
+      entry = mem_patterns_->Insert(plan_dims, std::move(mem_patterns), std::move(inferred_shapes));
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
 #endif
-    return nullptr;
+    if (!entry) {
+      return nullptr;
+    }
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+  // the entry may serve these shapes from the bigger ones of its bucket, but the inferred shapes are exact
+  if (!entry->inferred_shapes.empty() && entry->input_dims == input_dims) {
+    out_inferred_shapes = &entry->inferred_shapes;
   }
-  return &it->second;
+  return std::shared_ptr<const MemoryPatternGroup>(entry, &entry->patterns);
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -821,14 +897,18 @@ void SessionState::ResolveMemoryPatternFlag() {
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
+  const auto input_dims = MemoryPatternGroupCache::GetInputDims(tensor_inputs);
 
   std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  mem_patterns_->Insert(input_dims, std::move(mem_patterns));
   return Status::OK();
 }
 
+MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const {
+  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
+  return mem_patterns_->GetStats();
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1154,10 +1234,64 @@ Status SessionState::FinalizeSessionState(const std::basic_string<PATH_CHAR_TYPE
   ORT_RETURN_IF_ERROR(VerifyEachNodeIsAssignedToAnEp(graph_, logger_, execution_providers_));
   ORT_RETURN_IF_ERROR(PopulateKernelCreateInfo(kernel_registry_manager, saving_ort_format));
 
+  const auto& config_options = sess_options_.config_options;
+  const std::string prepacked_weights_cache_file =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigPrepackedWeightsCacheFile, "");
+  if (!prepacked_weights_cache_file.empty() &&
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisablePrepacking, "0") != "1") {
+    ORT_RETURN_IF_ERROR(PrepackedWeightsFileCache::Load(ToPathString(prepacked_weights_cache_file), logger_,
+                                                        prepacked_weights_file_cache_));
+  }
+
   InlinedHashMap<std::string, size_t> constant_initializers_use_count;
   ComputeConstantInitializerUseCount(graph_, constant_initializers_use_count);
-  return FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
-                                  remove_initializers, constant_initializers_use_count);
+  ORT_RETURN_IF_ERROR(FinalizeSessionStateImpl(graph_location, kernel_registry_manager, nullptr, sess_options_,
+                                               remove_initializers, constant_initializers_use_count));
+
+  if (prepacked_weights_file_cache_) {
+    // Failing to persist the weights only costs the next session its startup time
+    Status status = prepacked_weights_file_cache_->Save();
+    if (!status.IsOK()) {
+      LOGS(logger_, WARNING) << "Failed to persist pre-packed weights: " << status.ErrorMessage();
+    }
+  }
+
+  return Status::OK();
+}
+
+InlinedVector<const Tensor*> SessionState::GetConstantInitializedInputs(const Node& node) {
+  InlinedVector<const Tensor*> constant_inputs;
+  for (const auto* input_def : node.InputDefs()) {
+    const Tensor* tensor = nullptr;
+    if (input_def->Exists()) {
+      // same lookup as PrepackConstantInitializedTensors(), a subgraph can use a value from the outer scope
+      const std::string& input_name = input_def->Name();
+      for (SessionState* st = this; st != nullptr; st = st->Parent()) {
+        int ort_value_idx;
+        if (st->GetOrtValueNameIdxMap().GetIdx(input_name, ort_value_idx).IsOK()) {
+          auto it = st->constant_initialized_tensors_.find(ort_value_idx);
+          if (it != st->constant_initialized_tensors_.end()) {
+            tensor = &it->second.Get<Tensor>();
+          }
+          if (tensor != nullptr || st != this || !st->graph_.IsOuterScopeValue(input_name)) {
+            break;
+          }
+        }
+      }
+    }
+    constant_inputs.push_back(tensor);
+  }
+
+  return constant_inputs;
+}
+
+PrepackedWeightsFileCache* SessionState::GetPrepackedWeightsFileCache() {
+  SessionState* root = this;
+  while (root->parent_ != nullptr) {
+    root = root->parent_;
+  }
+
+  return root->prepacked_weights_file_cache_.get();
 }
 
 static Status Index(const OrtValueNameIdxMap& ort_value_name_idx_map,
@@ -1285,6 +1419,17 @@ static void AccumulateAllNestedSubgraphsInfo(
   }
 }
 
+// Reads a session config value that must be a non-negative integer
+static Status GetNonNegativeConfig(const ConfigOptions& config_options, const char* config_key,
+                                   const char* default_value, int64_t& value) {
+  const std::string config_value = config_options.GetConfigOrDefault(config_key, default_value);
+  if (!TryParseStringWithClassicLocale(config_value, value) || value < 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Session config ", config_key,
+                           " must be a non-negative integer but is '", config_value, "'.");
+  }
+  return Status::OK();
+}
+
 Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_TYPE>& graph_location,
                                               const KernelRegistryManager& kernel_registry_manager,
                                               _In_opt_ const Node* parent_node,
@@ -1297,6 +1442,17 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
     CreateGraphInfo();
   }
 
+  int64_t mem_pattern_cache_capacity = 0;
+  int64_t mem_pattern_dim_bucket_size = 0;
+  ORT_RETURN_IF_ERROR(GetNonNegativeConfig(session_options.config_options,
+                                           kOrtSessionOptionsConfigMemoryPatternCacheCapacity, "128",
+                                           mem_pattern_cache_capacity));
+  ORT_RETURN_IF_ERROR(GetNonNegativeConfig(session_options.config_options,
+                                           kOrtSessionOptionsConfigMemoryPatternDimBucketSize, "0",
+                                           mem_pattern_dim_bucket_size));
+  mem_patterns_ = std::make_unique<MemoryPatternGroupCache>(static_cast<size_t>(mem_pattern_cache_capacity),
+                                                            mem_pattern_dim_bucket_size);
+
 #if defined(ORT_EXTENDED_MINIMAL_BUILD)
   // Remove any unused initializers.
   // Not needed in a full build because unused initializers should have been removed earlier by Graph::Resolve().
@@ -1582,4 +1738,17 @@ void SessionState::RecycleDeviceStreamCollection(std::unique_ptr<DeviceStreamCol
 }
 #endif
 
+#ifdef USE_AZURE
+Status SessionState::GetCloudEndPointInvoker(CloudEndPointInvoker*& invoker) const {
+  std::lock_guard<onnxruntime::OrtMutex> lock(cloud_invoker_mutex_);
+  if (!cloud_invoker_) {
+    static const OrtDevice cpu_device;
+    ORT_RETURN_IF_ERROR(CloudEndPointInvoker::CreateInvoker(sess_options_.config_options.configurations,
+                                                            GetAllocator(cpu_device), cloud_invoker_));
+  }
+  invoker = cloud_invoker_.get();
+  return Status::OK();
+}
+#endif
+
 }  // namespace onnxruntime
@@ -22,9 +22,11 @@
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/framework_common.h"
 #include "core/framework/prepacked_weights_container.h"
+#include "core/framework/prepacked_weights_file_cache.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
@@ -42,6 +44,9 @@
 #ifdef ENABLE_TRAINING
 #include "core/framework/program_region.h"
 #endif
+#ifdef USE_AZURE
+#include "core/framework/cloud_invoker.h"
+#endif
 
 namespace flatbuffers {
 class FlatBufferBuilder;
@@ -210,13 +215,11 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  The returned pointer keeps the pattern alive after it is evicted from the cache.
+  inferred_shapes is set in training scenarios if the pattern was generated for these exact input shapes,
+  it lives as long as the returned pattern.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
       const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
@@ -229,6 +232,11 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Get the hit, miss and eviction counters of the memory pattern cache.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -315,6 +323,10 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetUsedPersistedPrePackedWeightCounter() const {
+    return used_persisted_pre_packed_weights_counter_;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -333,6 +345,12 @@ class SessionState {
   }
 #endif
 
+#ifdef USE_AZURE
+  // Returns the invoker of the endpoint configured in the session options. It is created on the first call
+  // and shared by all the runs of the session, so that its connections to the endpoint are reused.
+  Status GetCloudEndPointInvoker(CloudEndPointInvoker*& invoker) const;
+#endif
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   void
   IncrementGraphExecutionCounter() {
@@ -368,6 +386,13 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // The cache of persisted pre-packed weights is owned by the root session state and shared with the subgraphs.
+  // Returns nullptr if kOrtSessionOptionsConfigPrepackedWeightsCacheFile is not set.
+  PrepackedWeightsFileCache* GetPrepackedWeightsFileCache();
+
+  // Returns the constant initializer of each input of node, or nullptr if the input is not a constant initializer.
+  InlinedVector<const Tensor*> GetConstantInitializedInputs(const Node& node);
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -388,8 +413,9 @@ class SessionState {
                                   bool graph_info_already_created = false);
 
 #ifdef ENABLE_TRAINING
+  // input_dims holds the rank followed by the dims of every input, see MemoryPatternGroupCache::GetInputDims
   Status GeneratePatternGroupCache(
-      gsl::span<const OrtValue> inputs,
+      gsl::span<const int64_t> input_dims,
       gsl::span<const int> feed_mlvalue_idxs,
       MemoryPatternGroup& output,
       InlinedHashMap<int, TensorShape>& inferred_shapes) const;
@@ -401,6 +427,10 @@ class SessionState {
   // fused_funcs_mgr_ must live longer than the session_kernels_, becaues a kernel could be created from this manager
   FuncManager fused_funcs_mgr_;
 
+  // Pre-packed weights persisted across processes. Kernels of this session state and of the subgraph session
+  // states reference the buffers in the mapped file, so it must live longer than both.
+  std::unique_ptr<PrepackedWeightsFileCache> prepacked_weights_file_cache_;
+
   // cache of the constructed kernels to avoid spending construction time per executor
   std::vector<std::unique_ptr<OpKernel>> session_kernels_;
   Graph& graph_;
@@ -484,16 +514,9 @@ class SessionState {
 
   // lock for the mem_patterns_
   mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  // cache for the generated mem_patterns and the shapes inferred with them in training scenarios.
+  // key is calculated based on input shapes.
+  mutable std::unique_ptr<MemoryPatternGroupCache> mem_patterns_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -546,6 +569,10 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight was read from the persisted pre-packed weights cache
+  // instead of invoking PrePack()
+  size_t used_persisted_pre_packed_weights_counter_ = 0;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
@@ -560,6 +587,11 @@ class SessionState {
   // flag to indicate whether current session using any EP that create device stream dynamically.
   bool has_device_stream_enabled_ep_ = false;
 #endif
+
+#ifdef USE_AZURE
+  mutable OrtMutex cloud_invoker_mutex_;
+  mutable std::unique_ptr<CloudEndPointInvoker> cloud_invoker_;
+#endif
 };
 
 }  // namespace onnxruntime
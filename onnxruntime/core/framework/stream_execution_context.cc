@@ -6,6 +6,7 @@
 #include "core/framework/bfc_arena.h"
 #include "core/framework/session_state.h"
 #include "core/common/spin_pause.h"
+#include "core/platform/threadpool.h"
 
 namespace onnxruntime {
 #ifdef ORT_ENABLE_STREAM
@@ -240,20 +241,37 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
   ORT_UNUSED_PARAMETER(is_downstream);
 #endif
 
+  // In multi-threads mode the CPU streams running at the same time, e.g. the branches of a graph split by
+  // CriticalPathPartitioner, split the intra-op thread pool between them instead of each using all of it.
+  // The share of each stream is updated at every step as streams start, wait on barriers and complete.
+  const bool share_intra_op_threads = !ctx.SingleThreadMode() && logic_stream->device_.Type() == OrtDevice::CPU;
+  if (share_intra_op_threads) {
+    ctx.EnterCpuStream();
+  }
+
+  // the stream leaves before completing its task, ctx may be destroyed once all the tasks are complete
+  auto complete_task = [&ctx, share_intra_op_threads]() {
+    if (share_intra_op_threads) {
+      ctx.LeaveCpuStream();
+    }
+    ctx.CompleteTask();
+  };
+
   while (since < end) {
     if (!ctx.TaskStatus().IsOK()) {
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     if (terminate_flag) {
       Status status_made = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
       ctx.SetStatus(status_made);
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     bool continue_flag = true;
     Status status;
     ORT_TRY {
+      concurrency::ThreadPool::ThreadShareScope thread_share(share_intra_op_threads ? ctx.NumRunningCpuStreams() : 1);
       status = logic_stream->steps_[since]->Execute(ctx, stream_idx, session_scope, terminate_flag, continue_flag);
     }
     ORT_CATCH(const std::exception& ex) {
@@ -264,18 +282,18 @@ void RunSince(size_t stream_idx, StreamExecutionContext& ctx, SessionScope& sess
     if (!status.IsOK()) {
       // terminate it
       ctx.SetStatus(status);
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     if (!continue_flag) {
       // break but not terminate
-      ctx.CompleteTask();
+      complete_task();
       return;
     }
     since++;
   }
   ORT_ENFORCE(since == end);
-  ctx.CompleteTask();
+  complete_task();
   return;
 }
 
@@ -3,6 +3,7 @@
 #pragma once
 #include "core/common/logging/logging.h"
 #include "core/framework/device_stream_collection.h"
+#include "core/framework/run_options.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/iexecutor.h"
@@ -94,6 +95,14 @@ class StreamExecutionContext {
   // 2. multi-threads mode: use inter-op thread pool to schedule the N streams.
   bool SingleThreadMode() const { return single_thread_mode_; }
 
+  // Number of CPU streams running concurrently in multi-threads mode. They share the intra-op thread pool,
+  // see RunSince.
+  int NumRunningCpuStreams() const { return running_cpu_streams_.load(std::memory_order_relaxed); }
+
+  void EnterCpuStream() { running_cpu_streams_.fetch_add(1, std::memory_order_relaxed); }
+
+  void LeaveCpuStream() { running_cpu_streams_.fetch_sub(1, std::memory_order_relaxed); }
+
   // Get the Stream instance for a given logic sequence.
   // return nullptr if the device of given logic sequence doesn't register stream support.
   Stream* GetDeviceStream(size_t idx);
@@ -114,6 +123,13 @@ class StreamExecutionContext {
   // Release the OrtValues after a step, based on the execution plan.
   void RecycleNodeInputs(onnxruntime::NodeIndex node_index);
 
+  // Options of the Run this execution belongs to. nullptr if not provided, e.g. for a subgraph.
+  void SetRunOptions(const RunOptions* run_options) {
+    run_options_ = run_options;
+  }
+
+  const RunOptions* GetRunOptions() const { return run_options_; }
+
 #ifdef ENABLE_TRAINING
   void SetOrtValueCache(OrtValueCachePtr cache) {
     cache_ = std::move(cache);
@@ -158,6 +174,8 @@ class StreamExecutionContext {
 
   Status task_status_{Status::OK()};
 
+  const RunOptions* run_options_{nullptr};
+
 #ifdef ENABLE_TRAINING
   const ProgramRegion* program_range_{nullptr};
 
@@ -169,6 +187,8 @@ class StreamExecutionContext {
 #endif
   const bool single_thread_mode_;
 
+  std::atomic_int running_cpu_streams_{0};
+
 #ifdef ORT_ENABLE_STREAM
   InlinedVector<std::unique_ptr<synchronize::Notification>> notifications_;
   // if it is nullptr, means current session doesn't have any EP using stream feature
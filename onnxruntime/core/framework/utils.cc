@@ -630,7 +630,8 @@ ExecuteGraphImpl(const SessionState& session_state,
                  DeviceStreamCollection* device_stream_collection,
 #endif
                  const bool only_execute_path_to_fetches = false,
-                 Stream* parent_stream = nullptr) {
+                 Stream* parent_stream = nullptr,
+                 const RunOptions* run_options = nullptr) {
   const auto& feeds_fetches_info = feeds_fetches_manager.GetFeedsFetchesInfo();
   const auto& device_copy_checks = feeds_fetches_manager.GetDeviceCopyChecks();
 #ifdef ORT_ENABLE_STREAM
@@ -662,7 +663,8 @@ ExecuteGraphImpl(const SessionState& session_state,
                                   terminate_flag,
                                   only_execute_path_to_fetches,
                                   // single thread mode
-                                  single_thread_mode));
+                                  single_thread_mode,
+                                  run_options));
     ORT_RETURN_IF_ERROR(status);
   } else {
     auto feeds_to_use = feeds;
@@ -730,7 +732,8 @@ ExecuteGraphImpl(const SessionState& session_state,
 #endif
                                   terminate_flag,
                                   only_execute_path_to_fetches,
-                                  single_thread_mode));
+                                  single_thread_mode,
+                                  run_options));
     ORT_RETURN_IF_ERROR(status);
     InlinedVector<Stream*> fetches_streams;
     fetches_streams.reserve(feeds_fetches_info.fetches_mlvalue_idxs.size());
@@ -765,7 +768,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             ExecutionMode execution_mode, const bool& terminate_flag,
                             const logging::Logger& logger, bool sync_execution_provider,
                             bool only_execute_path_to_fetches,
-                            Stream* parent_stream) {
+                            Stream* parent_stream,
+                            const RunOptions* run_options) {
   ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
@@ -777,7 +781,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
                                  execution_mode, terminate_flag, logger,
                                  device_stream_collection,
                                  only_execute_path_to_fetches,
-                                 parent_stream);
+                                 parent_stream,
+                                 run_options);
   if (device_stream_collection)
     ORT_CHECK_AND_SET_RETVAL(device_stream_collection->CleanUp(sync_execution_provider));
   return retval;
@@ -786,7 +791,8 @@ common::Status ExecuteGraph(const SessionState& session_state,
   return ExecuteGraphImpl(session_state, feeds_fetches_manager, feeds, fetches, {},
                           execution_mode, terminate_flag, logger,
                           only_execute_path_to_fetches,
-                          parent_stream);
+                          parent_stream,
+                          run_options);
 #endif
 }
 
@@ -814,7 +820,16 @@ common::Status ExecuteGraph(const SessionState& session_state,
                       run_options.terminate,
                       logger,
                       synchronize_execution_providers,
-                      run_options.only_execute_path_to_fetches);
+                      run_options.only_execute_path_to_fetches,
+                      nullptr,
+                      &run_options);
+}
+
+common::Status ReplayCapturedRun(const SessionState& session_state, const CapturedRun& captured_run,
+                                 gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                 const RunOptions& run_options, const logging::Logger& logger) {
+  return ReplayThePlan(session_state, captured_run, feeds, fetches, logger, run_options.terminate,
+                       &run_options);
 }
 
 #ifdef ENABLE_TRAINING
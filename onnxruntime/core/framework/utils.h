@@ -12,6 +12,7 @@
 #include "core/framework/session_options.h"
 
 namespace onnxruntime {
+class CapturedRun;
 class ExecutionProviders;
 struct FeedsFetchesInfo;
 class FeedsFetchesManager;
@@ -87,12 +88,18 @@ common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManag
                             ExecutionMode execution_mode, const bool& terminate_flag, const logging::Logger& logger,
                             bool sync_execution_provider,
                             bool only_execute_path_to_fetches = false,
-                            Stream* parent_stream = nullptr);
+                            Stream* parent_stream = nullptr,
+                            const RunOptions* run_options = nullptr);
 
 common::Status ExecuteGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
                             ExecutionMode execution_mode, const RunOptions& run_options, const logging::Logger& logger);
 
+// Replay a captured run of the main graph. captured_run must match feeds and fetches (see CapturedRun::Matches).
+common::Status ReplayCapturedRun(const SessionState& session_state, const CapturedRun& captured_run,
+                                 gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
+                                 const RunOptions& run_options, const logging::Logger& logger);
+
 #ifdef ENABLE_TRAINING
 common::Status ExecutePartialGraph(const SessionState& session_state, FeedsFetchesManager& feeds_fetches_manager,
                                    gsl::span<const OrtValue> feeds, std::vector<OrtValue>& fetches,
@@ -1727,7 +1727,7 @@ ONNX_MS_OPERATOR_SET_SCHEMA(FusedMatMul, 1,
 
 ONNX_MS_OPERATOR_SET_SCHEMA(SparseToDenseMatMul, 1,
                             OpSchema()
-                                .Input(0, "A", "2-dimensional sparse matrix A. Either COO or CSR format", "T")
+                                .Input(0, "A", "2-dimensional sparse matrix A. COO, CSR or block sparse format", "T")
                                 .Input(1, "B", "N-dimensional dense matrix B", "T1")
                                 .Attr(
                                     "alpha",
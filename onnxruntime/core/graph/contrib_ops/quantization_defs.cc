@@ -441,6 +441,56 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
         }));
 
+constexpr const char* MatMulNBits_ver1_doc = R"DOC(
+MatMulNBits computes Y = A * B' where B is quantized blockwise along its K dimension, for weight-only quantized
+models such as LLMs. B' is the [K, N] matrix dequantized from the transposed constant input B:
+
+    B'[k][n] = (B[n][k] - zero_point[n][k / block_size]) * scales[n][k / block_size]
+
+Input B is stored as [N][n_blocks_per_col][blob_size] with n_blocks_per_col = (K + block_size - 1) / block_size and
+blob_size = block_size / 8 * bits. For bits == 4, value k of a block is stored in byte k / 2, in the low nibble when
+k is even and in the high nibble otherwise. The scales are [N * n_blocks_per_col] and the optional zero points pack
+two 4-bit values per byte in the same order, [N * ((n_blocks_per_col + 1) / 2)], defaulting to 2^(bits - 1).
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    MatMulNBits, 1,
+    OpSchema()
+        .SetDoc(MatMulNBits_ver1_doc)
+        .Attr("K", "size of each input feature", AttributeProto::INT)
+        .Attr("N", "size of each output feature", AttributeProto::INT)
+        .Attr("bits", "number of bits used for weight quantization. Only 4 is supported.", AttributeProto::INT,
+              static_cast<int64_t>(4))
+        .Attr("block_size", "number of values of K sharing a scale and a zero point. Must be 32, 64 or 128.",
+              AttributeProto::INT)
+        .Input(0, "A", "The input tensor, not quantized, with K as its last dimension", "T1")
+        .Input(1, "B", "3D quantized weight of shape [N, n_blocks_per_col, blob_size]", "T2")
+        .Input(2, "scales", "1D scales of shape [N * n_blocks_per_col]", "T1")
+        .Input(3, "zero_points", "1D packed zero points of shape [N * ((n_blocks_per_col + 1) / 2)]", "T2",
+               OpSchema::Optional)
+        .Output(0, "Y", "Tensor of shape A.shape[:-1] + [N]", "T1")
+        .TypeConstraint("T1", {"tensor(float)"}, "Constrain input A, scales and output Y data type as float tensor.")
+        .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain quantized weight and zero point types to uint8 tensor.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+
+          const auto& a_shape = getInputShape(ctx, 0);
+          const int a_rank = a_shape.dim_size();
+          if (a_rank == 0) {
+            fail_shape_inference("Input A must have rank >= 1");
+          }
+
+          ONNX_NAMESPACE::TensorShapeProto y_shape;
+          for (int i = 0; i < a_rank - 1; ++i) {
+            *y_shape.add_dim() = a_shape.dim(i);
+          }
+          y_shape.add_dim()->set_dim_value(getAttribute(ctx, "N", 0));
+          updateOutputShape(ctx, 0, y_shape);
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QLinearAdd, 1,
     OpSchema().FillUsing(QLinearMathDocGenerator(
@@ -87,6 +87,14 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Version of the buffer layouts produced by the MlasXxxPackB/MlasXxxPackW
+// routines. Pre-packed weights may be persisted across processes, so this must
+// be incremented whenever any packed layout changes.
+//
+
+#define MLAS_PACKED_FORMAT_VERSION 1
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -746,6 +754,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -778,6 +787,11 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t TileCountH;
+            size_t TileCountW;
+            size_t TileBlock;
+        } Winograd;
     } u;
 };
 
@@ -797,8 +811,38 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
+                bool HasWinogradFilter,
                 MLAS_THREADPOOL* ThreadPool);
 
+bool
+MLASCALL
+MlasConvWinogradIsSupported(
+    size_t Dimensions,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+size_t
+MLASCALL
+MlasConvWinogradPackWSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackW(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    );
+
 void
 MLASCALL
 MlasConv(
@@ -1593,3 +1637,96 @@ MlasHalfGemmConvertPackB(
     size_t ldb,
     void* PackedB
     );
+
+//
+// Blockwise 4-bit quantized weight GEMM: C = A * Dequantize(B) + Bias
+//
+// Weights are quantized along K in blocks of BlockSize values. Each block of
+// a column has a float scale and an optional 4-bit zero point (8 if absent):
+//
+//     B[k][n] = (Q[n][k] - ZeroPoint[n][k / BlockSize]) * Scale[n][k / BlockSize]
+//
+
+/**
+ * @brief Data parameters for the blockwise 4-bit quantized weight GEMM
+ *        All except C are [in] parameters
+*/
+struct MLAS_Q4GEMM_DATA_PARAMS {
+    const float* A = nullptr;        /**< address of A */
+    const void* B = nullptr;         /**< address of B, packed by MlasQ4GemmPackB */
+    const float* Bias = nullptr;     /**< address of Bias, vector size N, optional */
+    float* C = nullptr;              /**< address of result matrix */
+    size_t lda = 0;                  /**< leading dimension of A */
+    size_t ldc = 0;                  /**< leading dimension of C */
+};
+
+/**
+ * @brief Returns size of the packing buffer needed for the 4-bit quantized
+ *        right hand side
+ * @param[in] BlockSize  Number of values along K sharing a scale, 32, 64 or 128
+ * @param[in] N          Number of columns
+ * @param[in] K          Number of rows
+ * @return  size of the packing buffer,
+ *          0 if the block size is not supported
+*/
+size_t
+MLASCALL
+MlasQ4GemmPackBSize(
+    size_t BlockSize,
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief Packs the 4-bit quantized right hand side, its scales and zero
+ *        points into the layout used by MlasQ4GemmBatch
+ *
+ * @param[in]  BlockSize   Number of values along K sharing a scale
+ * @param[in]  N           Number of columns
+ * @param[in]  K           Number of rows
+ * @param[in]  QuantData   Quantized values, [N][BlockCountK][BlockSize / 2]
+ *                         bytes with BlockCountK = ceil(K / BlockSize). Value
+ *                         k of a block is in byte k / 2, the low nibble holds
+ *                         the even values.
+ * @param[in]  Scales      Scales, [N][BlockCountK]
+ * @param[in]  ZeroPoints  Optional zero points, [N][ceil(BlockCountK / 2)]
+ *                         bytes packed as 4-bit values like QuantData, 8 is
+ *                         used when nullptr
+ * @param[out] PackedB     Packing buffer of MlasQ4GemmPackBSize bytes
+*/
+void
+MLASCALL
+MlasQ4GemmPackB(
+    size_t BlockSize,
+    size_t N,
+    size_t K,
+    const uint8_t* QuantData,
+    const float* Scales,
+    const uint8_t* ZeroPoints,
+    void* PackedB
+    );
+
+/**
+ * @brief Batched GEMM with 4-bit quantized weights:  C = A * B + Bias
+ *        B is dequantized on the fly, so its memory traffic is an eighth of
+ *        an fp32 GEMM.
+ *
+ * @param[in]  BlockSize   Number of values along K sharing a scale
+ * @param[in]  M           row size of matrix A and C
+ * @param[in]  N           column size of matrix B and C
+ * @param[in]  K           column size of matrix A and row size of matrix B
+ * @param[in]  BatchN      number of batches
+ * @param[inout]  DataParams  An array (size BatchN) of parameter blocks
+ * @param[in]  ThreadPool
+*/
+void
+MLASCALL
+MlasQ4GemmBatch(
+    size_t BlockSize,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    const MLAS_Q4GEMM_DATA_PARAMS* DataParams,
+    MLAS_THREADPOOL* ThreadPool = nullptr
+    );
@@ -23,6 +23,34 @@ Abstract:
 #define MLAS_CONV_WORKING_BUFFER_SIZE_PER_THREAD \
     (MLAS_SGEMM_STRIDEN * MLAS_SGEMM_STRIDEK)
 
+//
+// Define the tile sizes of the Winograd F(4x4, 3x3) algorithm. Each 4x4 tile
+// of the output is computed from a 6x6 tile of the input, as 36 independent
+// products in the transformed domain.
+//
+
+#define MLAS_CONV_WINOGRAD_OUTPUT_TILE 4
+#define MLAS_CONV_WINOGRAD_INPUT_TILE 6
+#define MLAS_CONV_WINOGRAD_TILE_ELEMENTS \
+    (MLAS_CONV_WINOGRAD_INPUT_TILE * MLAS_CONV_WINOGRAD_INPUT_TILE)
+
+//
+// Define the minimum number of input channels and filters per group for the
+// Winograd algorithm. Below these, the cost of the input and output transforms
+// is not recovered by the smaller products.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS 8
+
+//
+// Define the range of tiles transformed at once by a thread of the Winograd
+// algorithm and the target number of elements of its working buffer.
+//
+
+#define MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK 16
+#define MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK 64
+#define MLAS_CONV_WINOGRAD_WORKING_BUFFER_SIZE_PER_THREAD (256 * 1024)
+
 //
 // Define the parameters to execute segments of a convolution operation on
 // worker threads.
@@ -729,6 +757,377 @@ Return Value:
     }
 }
 
+MLAS_FORCEINLINE
+void
+MlasConvWinogradInputTransform6(
+    const float* d,
+    size_t Stride,
+    float* v,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the product of the B^T matrix of the Winograd
+    F(4x4, 3x3) algorithm with a vector of six elements.
+
+Arguments:
+
+    d - Supplies the vector to transform.
+
+    Stride - Supplies the stride between the elements of the vector.
+
+    v - Supplies the vector to receive the transformed elements.
+
+    OutputStride - Supplies the stride between the transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float d0 = d[0 * Stride];
+    const float d1 = d[1 * Stride];
+    const float d2 = d[2 * Stride];
+    const float d3 = d[3 * Stride];
+    const float d4 = d[4 * Stride];
+    const float d5 = d[5 * Stride];
+
+    v[0 * OutputStride] = 4.0f * d0 - 5.0f * d2 + d4;
+    v[1 * OutputStride] = -4.0f * (d1 + d2) + d3 + d4;
+    v[2 * OutputStride] = 4.0f * (d1 - d2) - d3 + d4;
+    v[3 * OutputStride] = 2.0f * (d3 - d1) - d2 + d4;
+    v[4 * OutputStride] = 2.0f * (d1 - d3) - d2 + d4;
+    v[5 * OutputStride] = 4.0f * d1 - 5.0f * d3 + d5;
+}
+
+MLAS_FORCEINLINE
+void
+MlasConvWinogradOutputTransform6(
+    const float* m,
+    size_t Stride,
+    float* y,
+    size_t OutputStride
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the product of the A^T matrix of the Winograd
+    F(4x4, 3x3) algorithm with a vector of six elements.
+
+Arguments:
+
+    m - Supplies the vector to transform.
+
+    Stride - Supplies the stride between the elements of the vector.
+
+    y - Supplies the vector to receive the four transformed elements.
+
+    OutputStride - Supplies the stride between the transformed elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const float m0 = m[0 * Stride];
+    const float m1 = m[1 * Stride];
+    const float m2 = m[2 * Stride];
+    const float m3 = m[3 * Stride];
+    const float m4 = m[4 * Stride];
+    const float m5 = m[5 * Stride];
+
+    const float a = m1 + m2;
+    const float b = m1 - m2;
+    const float c = m3 + m4;
+    const float d = m3 - m4;
+
+    y[0 * OutputStride] = m0 + a + c;
+    y[1 * OutputStride] = b + 2.0f * d;
+    y[2 * OutputStride] = a + 4.0f * c;
+    y[3 * OutputStride] = b + 8.0f * d + m5;
+}
+
+void
+MlasConvWinogradOperation(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* Filter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    size_t TileRowStart,
+    size_t TileRowCount
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the Winograd F(4x4, 3x3) convolution algorithm for
+    a range of rows of output tiles.
+
+    Blocks of tiles of every input channel are transformed to the working
+    buffer, the 36 elements of the transformed tiles are multiplied with the
+    transformed filter by independent GEMMs, and the products are transformed
+    back to the output tiles.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    Filter - Supplies the filter tensor transformed by MlasConvWinogradPackW.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare for a single thread.
+
+    Output - Supplies the output tensor.
+
+    TileRowStart - Supplies the first row of output tiles to compute.
+
+    TileRowCount - Supplies the number of rows of output tiles to compute.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t OutputTile = MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+    constexpr size_t InputTile = MLAS_CONV_WINOGRAD_INPUT_TILE;
+    constexpr size_t TileElements = MLAS_CONV_WINOGRAD_TILE_ELEMENTS;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TileCountW = Parameters->u.Winograd.TileCountW;
+    const size_t TileBlock = Parameters->u.Winograd.TileBlock;
+    const float Beta = Parameters->Beta;
+
+    float* TransformedInput = WorkingBuffer;
+    float* TransformedOutput = WorkingBuffer + TileElements * InputChannels * TileBlock;
+
+    const size_t TileStart = TileRowStart * TileCountW;
+    const size_t TileEnd = (TileRowStart + TileRowCount) * TileCountW;
+
+    size_t CountT;
+
+    for (size_t t = TileStart; t < TileEnd; t += CountT) {
+
+        CountT = TileEnd - t;
+
+        if (CountT > TileBlock) {
+            CountT = TileBlock;
+        }
+
+        //
+        // Transform the input tiles of every channel. The elements of the
+        // transformed tiles are stored as 36 matrices of [InputChannels, CountT].
+        //
+
+        const size_t TransformedInputStride = InputChannels * CountT;
+
+        for (size_t c = 0; c < InputChannels; c++) {
+
+            const float* input = Input + c * InputSize;
+
+            for (size_t tt = 0; tt < CountT; tt++) {
+
+                const size_t th = (t + tt) / TileCountW;
+                const size_t tw = (t + tt) % TileCountW;
+
+                //
+                // Gather the input tile with zero padding. The unsigned
+                // arithmetic wraps the rows and columns before the start of
+                // the image to values that fail the bounds check.
+                //
+
+                float d[TileElements];
+
+                const size_t ih0 = th * OutputTile - PaddingTop;
+                const size_t iw0 = tw * OutputTile - PaddingLeft;
+
+                for (size_t y = 0; y < InputTile; y++) {
+
+                    const size_t ih = ih0 + y;
+
+                    for (size_t x = 0; x < InputTile; x++) {
+
+                        const size_t iw = iw0 + x;
+
+                        d[y * InputTile + x] = (ih < InputHeight && iw < InputWidth) ?
+                            input[ih * InputWidth + iw] : 0.0f;
+                    }
+                }
+
+                //
+                // Compute B^T * d * B.
+                //
+
+                float tmp[TileElements];
+
+                for (size_t x = 0; x < InputTile; x++) {
+                    MlasConvWinogradInputTransform6(&d[x], InputTile, &tmp[x], InputTile);
+                }
+
+                float* v = TransformedInput + c * CountT + tt;
+
+                for (size_t y = 0; y < InputTile; y++) {
+                    MlasConvWinogradInputTransform6(&tmp[y * InputTile], 1,
+                        v + y * InputTile * TransformedInputStride, TransformedInputStride);
+                }
+            }
+        }
+
+        //
+        // Multiply the elements of the transformed tiles with the transformed
+        // filter. The products are stored as 36 matrices of [FilterCount, CountT].
+        //
+
+        const size_t TransformedOutputStride = FilterCount * CountT;
+
+        for (size_t e = 0; e < TileElements; e++) {
+
+            MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterCount, CountT,
+                InputChannels, 1.0f, Filter + e * FilterCount * InputChannels,
+                InputChannels, TransformedInput + e * TransformedInputStride, CountT,
+                0.0f, TransformedOutput + e * TransformedOutputStride, CountT);
+        }
+
+        //
+        // Transform the products back to the output tiles.
+        //
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            float* output = Output + f * OutputSize;
+
+            for (size_t tt = 0; tt < CountT; tt++) {
+
+                const size_t th = (t + tt) / TileCountW;
+                const size_t tw = (t + tt) % TileCountW;
+
+                //
+                // Compute A^T * m * A.
+                //
+
+                const float* m = TransformedOutput + f * CountT + tt;
+
+                float tmp[OutputTile * InputTile];
+
+                for (size_t x = 0; x < InputTile; x++) {
+                    MlasConvWinogradOutputTransform6(m + x * TransformedOutputStride,
+                        InputTile * TransformedOutputStride, &tmp[x], InputTile);
+                }
+
+                float y[OutputTile * OutputTile];
+
+                for (size_t row = 0; row < OutputTile; row++) {
+                    MlasConvWinogradOutputTransform6(&tmp[row * InputTile], 1,
+                        &y[row * OutputTile], 1);
+                }
+
+                //
+                // Store the part of the output tile inside the image.
+                //
+
+                const size_t oh0 = th * OutputTile;
+                const size_t ow0 = tw * OutputTile;
+
+                const size_t CountH = std::min(OutputTile, OutputHeight - oh0);
+                const size_t CountW = std::min(OutputTile, OutputWidth - ow0);
+
+                for (size_t row = 0; row < CountH; row++) {
+
+                    float* out = output + (oh0 + row) * OutputWidth + ow0;
+
+                    for (size_t col = 0; col < CountW; col++) {
+                        out[col] = (Beta == 0.0f) ? y[row * OutputTile + col] :
+                            y[row * OutputTile + col] + Beta * out[col];
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias to the rows of the output
+    // computed above.
+    //
+
+    const size_t OutputRowStart = TileRowStart * OutputTile;
+    const size_t OutputRowEnd =
+        std::min(OutputHeight, (TileRowStart + TileRowCount) * OutputTile);
+
+    MlasActivation(Parameters->Activation, Output + OutputRowStart * OutputWidth,
+        Bias, FilterCount, (OutputRowEnd - OutputRowStart) * OutputWidth, OutputSize);
+}
+
+void
+MlasConvWinogradThreaded(
+    void* Context,
+    ptrdiff_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    Winograd convolution operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_CONV_WORK_BLOCK* WorkBlock = (MLAS_CONV_WORK_BLOCK*)Context;
+
+    const MLAS_CONV_PARAMETERS* Parameters = WorkBlock->Parameters;
+
+    //
+    // Compute the range of tile rows to use for this thread.
+    //
+
+    size_t TileRowStart;
+    size_t TileRowCount;
+
+    MlasPartitionWork(Index, WorkBlock->TargetThreadCount, Parameters->u.Winograd.TileCountH,
+        &TileRowStart, &TileRowCount);
+
+    if (TileRowCount == 0) {
+        return;
+    }
+
+    const size_t WorkingBufferSizePerThread = MLAS_CONV_WINOGRAD_TILE_ELEMENTS *
+        (Parameters->InputChannels + Parameters->FilterCount) * Parameters->u.Winograd.TileBlock;
+
+    MlasConvWinogradOperation(Parameters, WorkBlock->Input, WorkBlock->Filter,
+        WorkBlock->Bias, WorkBlock->WorkingBuffer + Index * WorkingBufferSizePerThread,
+        WorkBlock->Output, TileRowStart, TileRowCount);
+}
+
 inline
 bool
 MlasConvTryMultithread(
@@ -865,15 +1264,17 @@ Return Value:
     const size_t OutputSize = Parameters->OutputSize;
     const size_t K = Parameters->K;
 
-    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
-    const size_t OutputGroupSize = FilterCount * OutputSize;
-    const size_t FilterGroupSize = FilterCount * K;
-
     const size_t BatchCount = Parameters->BatchCount;
     const size_t GroupCount = Parameters->GroupCount;
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    const size_t InputGroupSize = Parameters->InputChannels * Parameters->InputSize;
+    const size_t OutputGroupSize = FilterCount * OutputSize;
+    const size_t FilterGroupSize = (Algorithm == MlasConvAlgorithmWinograd) ?
+        FilterCount * Parameters->InputChannels * MLAS_CONV_WINOGRAD_TILE_ELEMENTS :
+        FilterCount * K;
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -1002,6 +1403,28 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                {
+                    //
+                    // Segment the rows of output tiles across multiple threads.
+                    //
+
+                    MLAS_CONV_WORK_BLOCK WorkBlock;
+
+                    WorkBlock.Parameters = Parameters;
+                    WorkBlock.Input = Input;
+                    WorkBlock.Filter = filter;
+                    WorkBlock.Bias = bias;
+                    WorkBlock.WorkingBuffer = WorkingBuffer;
+                    WorkBlock.Output = Output;
+                    WorkBlock.TargetThreadCount = Parameters->ThreadCount;
+
+                    MlasExecuteThreaded(MlasConvWinogradThreaded, &WorkBlock,
+                        Parameters->ThreadCount, ThreadPool);
+
+                    break;
+                }
             }
 
             //
@@ -1018,6 +1441,185 @@ Return Value:
         }
     }
 }
+bool
+MLASCALL
+MlasConvWinogradIsSupported(
+    size_t Dimensions,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine returns whether a convolution can use the Winograd F(4x4, 3x3)
+    algorithm, so the caller can transform its filter with
+    MlasConvWinogradPackW.
+
+Arguments:
+
+    Dimensions - Supplies the number of dimensions.
+
+    KernelShape - Supplies the shape of the kernel transform.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    StrideShape - Supplies the shape of the stride.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns true if the convolution is a 2D 3x3 convolution with unit strides
+    and dilations, and has enough channels to profit from the algorithm.
+
+--*/
+{
+    if (Dimensions != 2) {
+        return false;
+    }
+
+    for (size_t dim = 0; dim < Dimensions; dim++) {
+        if (KernelShape[dim] != 3 || DilationShape[dim] != 1 || StrideShape[dim] != 1) {
+            return false;
+        }
+    }
+
+    return InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackWSize(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements of the filter transformed by
+    MlasConvWinogradPackW.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of elements of the transformed filter.
+
+--*/
+{
+    return GroupCount * FilterCount * InputChannels * MLAS_CONV_WINOGRAD_TILE_ELEMENTS;
+}
+
+void
+MLASCALL
+MlasConvWinogradPackW(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms a 3x3 filter for the Winograd F(4x4, 3x3)
+    algorithm.
+
+    Each 3x3 kernel g is transformed to the 6x6 tile G * g * G^T. The elements
+    of the transformed tiles of a group are stored as 36 matrices of
+    [FilterCount, InputChannels], the left operands of the GEMMs of the
+    algorithm.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor in [GroupCount * FilterCount,
+        InputChannels, 3, 3] layout.
+
+    PackedFilter - Supplies the buffer to receive the transformed filter, sized
+        to the number of elements returned by MlasConvWinogradPackWSize.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    constexpr size_t InputTile = MLAS_CONV_WINOGRAD_INPUT_TILE;
+    constexpr size_t TileElements = MLAS_CONV_WINOGRAD_TILE_ELEMENTS;
+
+    //
+    // Computes G * g for a vector of three elements.
+    //
+
+    auto TransformFilter3 = [](const float* g, size_t Stride, float* u, size_t OutputStride) {
+
+        const float g0 = g[0 * Stride];
+        const float g1 = g[1 * Stride];
+        const float g2 = g[2 * Stride];
+
+        u[0 * OutputStride] = g0 / 4.0f;
+        u[1 * OutputStride] = -(g0 + g1 + g2) / 6.0f;
+        u[2 * OutputStride] = -(g0 - g1 + g2) / 6.0f;
+        u[3 * OutputStride] = g0 / 24.0f + g1 / 12.0f + g2 / 6.0f;
+        u[4 * OutputStride] = g0 / 24.0f - g1 / 12.0f + g2 / 6.0f;
+        u[5 * OutputStride] = g2;
+    };
+
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    for (size_t group = 0; group < GroupCount; group++) {
+
+        for (size_t f = 0; f < FilterCount; f++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                const float* g = Filter + (f * InputChannels + c) * 9;
+
+                //
+                // Compute G * g * G^T.
+                //
+
+                float tmp[InputTile * 3];
+
+                for (size_t x = 0; x < 3; x++) {
+                    TransformFilter3(&g[x], 3, &tmp[x], 3);
+                }
+
+                float* u = PackedFilter + f * InputChannels + c;
+
+                for (size_t y = 0; y < InputTile; y++) {
+                    TransformFilter3(&tmp[y * 3], 1, u + y * InputTile * MatrixSize, MatrixSize);
+                }
+            }
+        }
+
+        Filter += MatrixSize * 9;
+        PackedFilter += MatrixSize * TileElements;
+    }
+}
+
 #if defined(_MSC_VER) && !defined(__clang__)
 #pragma warning(push)
 // Chance of arithmetic overflow could be reduced
@@ -1041,6 +1643,7 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
+    bool HasWinogradFilter,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1085,6 +1688,15 @@ Arguments:
     WorkingBufferSize - Receives the number of elements to allocate for the
         working buffer for intermediate results.
 
+    Beta - Supplies the scalar beta multiplier applied to the output tensor
+        before the result is accumulated.
+
+    HasWinogradFilter - Supplies true if the caller transformed the filter with
+        MlasConvWinogradPackW, so the Winograd algorithm can be selected. The
+        algorithm is then always selected for a convolution accepted by
+        MlasConvWinogradIsSupported, and the caller passes the transformed
+        filter to MlasConv.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1211,6 +1823,75 @@ Return Value:
         }
     }
 
+    if (HasWinogradFilter && Dimensions == 2 && AllStridesAreOne && AllDilationsAreOne &&
+        Parameters->KernelShape[0] == 3 && Parameters->KernelShape[1] == 3 &&
+        InputChannels >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS &&
+        FilterCount >= MLAS_CONV_WINOGRAD_MINIMUM_CHANNELS) {
+
+        //
+        // Use the Winograd F(4x4, 3x3) algorithm, which needs 4 times fewer
+        // multiplies than the GEMM of the expanded input: 36 instead of 144
+        // per 4x4 output tile.
+        //
+        // Compute the number of tiles transformed at once by a thread, so
+        // its transformed tiles and products stay within its working buffer
+        // while the GEMMs have enough columns to run efficiently.
+        //
+
+        const size_t TileCountH = (Parameters->OutputShape[0] + MLAS_CONV_WINOGRAD_OUTPUT_TILE - 1) /
+            MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+        const size_t TileCountW = (Parameters->OutputShape[1] + MLAS_CONV_WINOGRAD_OUTPUT_TILE - 1) /
+            MLAS_CONV_WINOGRAD_OUTPUT_TILE;
+        const size_t TileElementsPerTile = MLAS_CONV_WINOGRAD_TILE_ELEMENTS * (InputChannels + FilterCount);
+
+        size_t TileBlock = MLAS_CONV_WINOGRAD_WORKING_BUFFER_SIZE_PER_THREAD / TileElementsPerTile;
+
+        if (TileBlock < MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK) {
+            TileBlock = MLAS_CONV_WINOGRAD_MINIMUM_TILE_BLOCK;
+        } else if (TileBlock > MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK) {
+            TileBlock = MLAS_CONV_WINOGRAD_MAXIMUM_TILE_BLOCK;
+        }
+
+        if (TileBlock > TileCountH * TileCountW) {
+            TileBlock = TileCountH * TileCountW;
+        }
+
+        //
+        // Segment the rows of tiles across threads given the complexity of
+        // the convolution operation.
+        //
+
+        ptrdiff_t TargetThreadCount;
+        double Complexity = double(FilterCount) * double(OutputSize) * double(K);
+
+        if (Complexity < double(MLAS_SGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+            TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+        } else {
+            TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+        }
+
+        ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+        if (TargetThreadCount >= MaximumThreadCount) {
+            TargetThreadCount = MaximumThreadCount;
+        }
+
+        if (size_t(TargetThreadCount) >= TileCountH) {
+            TargetThreadCount = ptrdiff_t(TileCountH);
+        }
+
+        Parameters->ThreadCount = TargetThreadCount;
+
+        Parameters->Algorithm = MlasConvAlgorithmWinograd;
+        Parameters->u.Winograd.TileCountH = TileCountH;
+        Parameters->u.Winograd.TileCountW = TileCountW;
+        Parameters->u.Winograd.TileBlock = TileBlock;
+
+        *WorkingBufferSize = TargetThreadCount * TileElementsPerTile * TileBlock;
+
+        return;
+    }
+
     if (FilterCount > OutputSize) {
 
         //
@@ -0,0 +1,153 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_avx2.cpp
+
+Abstract:
+
+    This module implements the fused dequantize kernel of the blockwise 4-bit
+    quantized weight GEMM using AVX2 instructions.
+
+    Each group of 32 values is loaded as 16 bytes, split into the low and
+    high nibbles, widened to fp32 and dequantized with a single multiply add
+    before being accumulated against up to four rows of A.
+
+--*/
+
+#include "../../q4gemm.h"
+
+#include <algorithm>
+
+MLAS_FORCEINLINE
+static
+float
+MlasReduceAddFloat32x8(
+    __m256 v
+    )
+{
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_movehdup_ps(s));
+    return _mm_cvtss_f32(s);
+}
+
+template <size_t Rows>
+MLAS_FORCEINLINE
+static
+void
+MlasQ4GemmRowsAvx2(
+    size_t BlockSize,
+    const float* A,
+    size_t lda,
+    const uint8_t* ColumnData,
+    const float* ColumnScales,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float Bias
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+
+    __m256 Accumulators[Rows];
+    float Tail[Rows];
+
+    for (size_t r = 0; r < Rows; r++) {
+        Accumulators[r] = _mm256_setzero_ps();
+        Tail[r] = Bias;
+    }
+
+    for (size_t b = 0; b < BlockCountK; b++) {
+        const uint8_t* BlockData = ColumnData + b * (BlockSize / 2);
+        const float Scale = ColumnScales[b * 2];
+        const float Offset = ColumnScales[b * 2 + 1];
+        const __m256 ScaleVector = _mm256_set1_ps(Scale);
+        const __m256 OffsetVector = _mm256_set1_ps(Offset);
+        const size_t k = b * BlockSize;
+        const size_t Count = std::min(BlockSize, K - k);
+
+        size_t g = 0;
+
+        for (; g + MLAS_Q4_GROUP_SIZE <= Count; g += MLAS_Q4_GROUP_SIZE) {
+            const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(BlockData + g / 2));
+            const __m128i Low = _mm_and_si128(Bytes, LowMask);
+            const __m128i High = _mm_and_si128(_mm_srli_epi16(Bytes, 4), LowMask);
+
+            const __m256 w0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(Low)), ScaleVector, OffsetVector);
+            const __m256 w1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(Low, 8))), ScaleVector, OffsetVector);
+            const __m256 w2 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(High)), ScaleVector, OffsetVector);
+            const __m256 w3 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(High, 8))), ScaleVector, OffsetVector);
+
+            for (size_t r = 0; r < Rows; r++) {
+                const float* a = A + r * lda + k + g;
+                __m256 acc = Accumulators[r];
+                acc = _mm256_fmadd_ps(_mm256_loadu_ps(a), w0, acc);
+                acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + 8), w1, acc);
+                acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + 16), w2, acc);
+                acc = _mm256_fmadd_ps(_mm256_loadu_ps(a + 24), w3, acc);
+                Accumulators[r] = acc;
+            }
+        }
+
+        if (g < Count) {
+            for (size_t r = 0; r < Rows; r++) {
+                Tail[r] += MlasQ4DotBlockTail(A + r * lda + k, BlockData, g, Count, Scale, Offset);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < Rows; r++) {
+        C[r * ldc] = MlasReduceAddFloat32x8(Accumulators[r]) + Tail[r];
+    }
+}
+
+void
+MLASCALL
+MlasQ4GemmKernelAvx2(
+    size_t BlockSize,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedData,
+    const float* PackedScales,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t K,
+    const float* Bias
+    )
+{
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    const size_t DataStride = BlockCountK * BlockSize / 2;
+    const size_t ScaleStride = BlockCountK * 2;
+
+    for (size_t n = 0; n < CountN; n++) {
+        const uint8_t* ColumnData = PackedData + n * DataStride;
+        const float* ColumnScales = PackedScales + n * ScaleStride;
+        const float ColumnBias = (Bias != nullptr) ? Bias[n] : 0.0f;
+
+        size_t m = 0;
+
+        for (; m + 4 <= CountM; m += 4) {
+            MlasQ4GemmRowsAvx2<4>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+        }
+
+        switch (CountM - m) {
+            case 3:
+                MlasQ4GemmRowsAvx2<3>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+                break;
+            case 2:
+                MlasQ4GemmRowsAvx2<2>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+                break;
+            case 1:
+                MlasQ4GemmRowsAvx2<1>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+                break;
+        }
+    }
+}
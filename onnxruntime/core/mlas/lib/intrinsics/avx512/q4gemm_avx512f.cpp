@@ -0,0 +1,135 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm_avx512f.cpp
+
+Abstract:
+
+    This module implements the fused dequantize kernel of the blockwise 4-bit
+    quantized weight GEMM using AVX512F instructions.
+
+    The low and high nibbles of a group of 32 values each widen to a full
+    vector of 16 fp32 values.
+
+--*/
+
+#include "../../q4gemm.h"
+
+#include <algorithm>
+
+template <size_t Rows>
+MLAS_FORCEINLINE
+static
+void
+MlasQ4GemmRowsAvx512F(
+    size_t BlockSize,
+    const float* A,
+    size_t lda,
+    const uint8_t* ColumnData,
+    const float* ColumnScales,
+    float* C,
+    size_t ldc,
+    size_t K,
+    float Bias
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+
+    __m512 Accumulators[Rows];
+    float Tail[Rows];
+
+    for (size_t r = 0; r < Rows; r++) {
+        Accumulators[r] = _mm512_setzero_ps();
+        Tail[r] = Bias;
+    }
+
+    for (size_t b = 0; b < BlockCountK; b++) {
+        const uint8_t* BlockData = ColumnData + b * (BlockSize / 2);
+        const float Scale = ColumnScales[b * 2];
+        const float Offset = ColumnScales[b * 2 + 1];
+        const __m512 ScaleVector = _mm512_set1_ps(Scale);
+        const __m512 OffsetVector = _mm512_set1_ps(Offset);
+        const size_t k = b * BlockSize;
+        const size_t Count = std::min(BlockSize, K - k);
+
+        size_t g = 0;
+
+        for (; g + MLAS_Q4_GROUP_SIZE <= Count; g += MLAS_Q4_GROUP_SIZE) {
+            const __m128i Bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(BlockData + g / 2));
+            const __m128i Low = _mm_and_si128(Bytes, LowMask);
+            const __m128i High = _mm_and_si128(_mm_srli_epi16(Bytes, 4), LowMask);
+
+            const __m512 w0 = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(Low)), ScaleVector, OffsetVector);
+            const __m512 w1 = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(High)), ScaleVector, OffsetVector);
+
+            for (size_t r = 0; r < Rows; r++) {
+                const float* a = A + r * lda + k + g;
+                __m512 acc = Accumulators[r];
+                acc = _mm512_fmadd_ps(_mm512_loadu_ps(a), w0, acc);
+                acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + 16), w1, acc);
+                Accumulators[r] = acc;
+            }
+        }
+
+        if (g < Count) {
+            for (size_t r = 0; r < Rows; r++) {
+                Tail[r] += MlasQ4DotBlockTail(A + r * lda + k, BlockData, g, Count, Scale, Offset);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < Rows; r++) {
+        C[r * ldc] = _mm512_reduce_add_ps(Accumulators[r]) + Tail[r];
+    }
+}
+
+void
+MLASCALL
+MlasQ4GemmKernelAvx512F(
+    size_t BlockSize,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedData,
+    const float* PackedScales,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t K,
+    const float* Bias
+    )
+{
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    const size_t DataStride = BlockCountK * BlockSize / 2;
+    const size_t ScaleStride = BlockCountK * 2;
+
+    for (size_t n = 0; n < CountN; n++) {
+        const uint8_t* ColumnData = PackedData + n * DataStride;
+        const float* ColumnScales = PackedScales + n * ScaleStride;
+        const float ColumnBias = (Bias != nullptr) ? Bias[n] : 0.0f;
+
+        size_t m = 0;
+
+        for (; m + 4 <= CountM; m += 4) {
+            MlasQ4GemmRowsAvx512F<4>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+        }
+
+        switch (CountM - m) {
+            case 3:
+                MlasQ4GemmRowsAvx512F<3>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+                break;
+            case 2:
+                MlasQ4GemmRowsAvx512F<2>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+                break;
+            case 1:
+                MlasQ4GemmRowsAvx512F<1>(BlockSize, A + m * lda, lda, ColumnData, ColumnScales, C + m * ldc + n, ldc, K, ColumnBias);
+                break;
+        }
+    }
+}
@@ -0,0 +1,318 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm.cpp
+
+Abstract:
+
+    This module implements the blockwise 4-bit quantized weight GEMM.
+
+    Small M (token generation) is bound by the bandwidth of B, so the values
+    are dequantized inside the kernel and never written out. Larger M is
+    compute bound: strips of B are dequantized into a thread local buffer and
+    multiplied with SGEMM.
+
+--*/
+
+#include "q4gemm.h"
+
+#include <algorithm>
+
+//
+// Rows of A handled by the fused dequantize kernel. Larger batches reuse
+// each dequantized value enough to amortize SGEMM.
+//
+
+constexpr size_t MLAS_Q4GEMM_FUSED_MAXIMUM_M = 4;
+
+constexpr size_t MLAS_Q4GEMM_STRIDEN_FUSED = 16;
+constexpr size_t MLAS_Q4GEMM_STRIDEN_SGEMM = 128;
+
+size_t
+MLASCALL
+MlasQ4GemmPackBSize(
+    size_t BlockSize,
+    size_t N,
+    size_t K
+    )
+{
+    if (!MlasQ4IsBlockSizeSupported(BlockSize)) {
+        return 0;
+    }
+
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    return N * BlockCountK * (2 * sizeof(float) + BlockSize / 2);
+}
+
+void
+MLASCALL
+MlasQ4GemmPackB(
+    size_t BlockSize,
+    size_t N,
+    size_t K,
+    const uint8_t* QuantData,
+    const float* Scales,
+    const uint8_t* ZeroPoints,
+    void* PackedB
+    )
+{
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    const size_t BlockBytes = BlockSize / 2;
+    const size_t ZeroPointStride = (BlockCountK + 1) / 2;
+
+    float* PackedScales = reinterpret_cast<float*>(PackedB);
+    uint8_t* PackedData = reinterpret_cast<uint8_t*>(PackedScales + N * BlockCountK * 2);
+
+    for (size_t n = 0; n < N; n++) {
+        for (size_t b = 0; b < BlockCountK; b++) {
+            const size_t BlockIndex = n * BlockCountK + b;
+            const float Scale = Scales[BlockIndex];
+
+            uint8_t ZeroPoint = 8;
+            if (ZeroPoints != nullptr) {
+                const uint8_t Byte = ZeroPoints[n * ZeroPointStride + b / 2];
+                ZeroPoint = (b % 2 == 0) ? (Byte & 0x0F) : (Byte >> 4);
+            }
+
+            PackedScales[BlockIndex * 2] = Scale;
+            PackedScales[BlockIndex * 2 + 1] = -float(ZeroPoint) * Scale;
+
+            const uint8_t* Src = QuantData + BlockIndex * BlockBytes;
+            uint8_t* Dst = PackedData + BlockIndex * BlockBytes;
+
+            auto Nibble = [Src](size_t Index) -> uint8_t {
+                return (Src[Index / 2] >> ((Index % 2) * 4)) & 0x0F;
+            };
+
+            for (size_t g = 0; g < BlockSize; g += MLAS_Q4_GROUP_SIZE) {
+                for (size_t i = 0; i < 16; i++) {
+                    Dst[g / 2 + i] = uint8_t(Nibble(g + i) | (Nibble(g + i + 16) << 4));
+                }
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasQ4GemmKernel(
+    size_t BlockSize,
+    const float* A,
+    size_t lda,
+    const uint8_t* PackedData,
+    const float* PackedScales,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t K,
+    const float* Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine is the portable implementation of the fused dequantize
+    kernel. It computes CountM rows and CountN columns of C.
+
+Arguments:
+
+    BlockSize - Supplies the number of values along K sharing a scale.
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedData - Supplies the quantized values of the first column.
+
+    PackedScales - Supplies the scales and offsets of the first column.
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+    CountM - Supplies the number of rows to compute.
+
+    CountN - Supplies the number of columns to compute.
+
+    K - Supplies the number of columns of matrix A.
+
+    Bias - Supplies the bias of the first column, optional.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    const size_t DataStride = BlockCountK * BlockSize / 2;
+    const size_t ScaleStride = BlockCountK * 2;
+
+    for (size_t n = 0; n < CountN; n++) {
+        const uint8_t* ColumnData = PackedData + n * DataStride;
+        const float* ColumnScales = PackedScales + n * ScaleStride;
+
+        for (size_t m = 0; m < CountM; m++) {
+            const float* a = A + m * lda;
+            float Sum = (Bias != nullptr) ? Bias[n] : 0.0f;
+
+            for (size_t b = 0; b < BlockCountK; b++) {
+                const size_t k = b * BlockSize;
+                Sum += MlasQ4DotBlockTail(a + k, ColumnData + b * (BlockSize / 2), 0,
+                                          std::min(BlockSize, K - k), ColumnScales[b * 2], ColumnScales[b * 2 + 1]);
+            }
+
+            C[m * ldc + n] = Sum;
+        }
+    }
+}
+
+static
+void
+MlasQ4GemmDequantizeB(
+    size_t BlockSize,
+    const uint8_t* PackedData,
+    const float* PackedScales,
+    float* Output,
+    size_t CountN,
+    size_t K
+    )
+/*++
+
+Routine Description:
+
+    This routine dequantizes CountN columns of the packed B matrix into a
+    [CountN][K] buffer, the transposed layout expected by SGEMM.
+
+--*/
+{
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    const size_t DataStride = BlockCountK * BlockSize / 2;
+    const size_t ScaleStride = BlockCountK * 2;
+
+    for (size_t n = 0; n < CountN; n++) {
+        for (size_t b = 0; b < BlockCountK; b++) {
+            const uint8_t* BlockData = PackedData + n * DataStride + b * (BlockSize / 2);
+            const float Scale = PackedScales[n * ScaleStride + b * 2];
+            const float Offset = PackedScales[n * ScaleStride + b * 2 + 1];
+            const size_t k = b * BlockSize;
+            const size_t Count = std::min(BlockSize, K - k);
+
+            float* out = Output + n * K + k;
+            for (size_t i = 0; i < Count; i++) {
+                out[i] = MlasQ4DequantizeValue(BlockData, i, Scale, Offset);
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasQ4GemmBatch(
+    size_t BlockSize,
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    const MLAS_Q4GEMM_DATA_PARAMS* DataParams,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (M == 0 || N == 0 || BatchN == 0) {
+        return;
+    }
+
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_Q4GEMM_KERNEL* Kernel = GetMlasPlatform().Q4GemmKernel;
+#else
+    MLAS_Q4GEMM_KERNEL* Kernel = MlasQ4GemmKernel;
+#endif
+
+    const size_t BlockCountK = MlasQ4BlockCountK(BlockSize, K);
+    const size_t DataStride = BlockCountK * BlockSize / 2;
+    const size_t ScaleStride = BlockCountK * 2;
+    const bool Fused = M <= MLAS_Q4GEMM_FUSED_MAXIMUM_M;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchN);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Wider strips re-read A less often in the SGEMM path, narrow them while
+    // there are fewer strips than threads.
+    //
+
+    size_t StrideN = Fused ? MLAS_Q4GEMM_STRIDEN_FUSED : MLAS_Q4GEMM_STRIDEN_SGEMM;
+
+    while (StrideN > MLAS_Q4GEMM_STRIDEN_FUSED &&
+           BatchN * ((N + StrideN - 1) / StrideN) < size_t(TargetThreadCount)) {
+        StrideN /= 2;
+    }
+
+    const size_t TileCountN = (N + StrideN - 1) / StrideN;
+    const size_t TileCount = TileCountN * BatchN;
+
+    if (size_t(TargetThreadCount) > TileCount) {
+        TargetThreadCount = ptrdiff_t(TileCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+        size_t TileIndex;
+        size_t TileRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, TileCount, &TileIndex, &TileRemaining);
+
+        for (; TileRemaining > 0; TileRemaining--, TileIndex++) {
+            const MLAS_Q4GEMM_DATA_PARAMS& Data = DataParams[TileIndex / TileCountN];
+            const size_t n = (TileIndex % TileCountN) * StrideN;
+            const size_t CountN = std::min(StrideN, N - n);
+
+            const float* PackedScales = reinterpret_cast<const float*>(Data.B);
+            const uint8_t* PackedData = reinterpret_cast<const uint8_t*>(PackedScales + N * ScaleStride);
+            PackedScales += n * ScaleStride;
+            PackedData += n * DataStride;
+
+            const float* Bias = (Data.Bias != nullptr) ? Data.Bias + n : nullptr;
+            float* C = Data.C + n;
+
+            if (Fused) {
+                Kernel(BlockSize, Data.A, Data.lda, PackedData, PackedScales, C, Data.ldc, M, CountN, K, Bias);
+                continue;
+            }
+
+            MlasThreadedBufAlloc(CountN * K * sizeof(float));
+            float* DequantizedB = reinterpret_cast<float*>(ThreadedBufHolder.get());
+
+            MlasQ4GemmDequantizeB(BlockSize, PackedData, PackedScales, DequantizedB, CountN, K);
+
+            MlasGemm(CblasNoTrans, CblasTrans, M, CountN, K, 1.0f, Data.A, Data.lda,
+                     DequantizedB, K, 0.0f, C, Data.ldc, nullptr);
+
+            if (Bias != nullptr) {
+                for (size_t m = 0; m < M; m++) {
+                    float* c = C + m * Data.ldc;
+                    for (size_t i = 0; i < CountN; i++) {
+                        c[i] += Bias[i];
+                    }
+                }
+            }
+        }
+    });
+}
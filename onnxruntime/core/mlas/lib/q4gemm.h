@@ -0,0 +1,92 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4gemm.h
+
+Abstract:
+
+    This module contains the private data structures and procedure prototypes
+    for the blockwise 4-bit quantized weight GEMM.
+
+    The packed B matrix produced by MlasQ4GemmPackB is laid out as:
+
+        float   [N][BlockCountK][2]              scale and offset of each block
+        uint8_t [N][BlockCountK][BlockSize / 2]  quantized values
+
+    The offset is -ZeroPoint * Scale, so a value dequantizes with a single
+    multiply add. Every group of 32 values of a block is stored in 16 bytes,
+    byte i holding value i in the low nibble and value i + 16 in the high
+    nibble. A vector kernel splits a group into two contiguous runs of 16
+    values with a mask and a shift.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+constexpr size_t MLAS_Q4_GROUP_SIZE = 32;
+
+MLAS_FORCEINLINE
+bool
+MlasQ4IsBlockSizeSupported(
+    size_t BlockSize
+    )
+{
+    return BlockSize == 32 || BlockSize == 64 || BlockSize == 128;
+}
+
+MLAS_FORCEINLINE
+size_t
+MlasQ4BlockCountK(
+    size_t BlockSize,
+    size_t K
+    )
+{
+    return (K + BlockSize - 1) / BlockSize;
+}
+
+MLAS_FORCEINLINE
+float
+MlasQ4DequantizeValue(
+    const uint8_t* BlockData,
+    size_t Index,
+    float Scale,
+    float Offset
+    )
+{
+    const uint8_t Byte = BlockData[(Index / MLAS_Q4_GROUP_SIZE) * (MLAS_Q4_GROUP_SIZE / 2) + (Index % 16)];
+    const uint8_t Value = (Index % MLAS_Q4_GROUP_SIZE) < 16 ? (Byte & 0x0F) : (Byte >> 4);
+    return float(Value) * Scale + Offset;
+}
+
+/*++
+
+Routine Description:
+
+    This routine computes the dot product of a row of A with the values of a
+    packed block starting at value Start, for the values before K.
+
+--*/
+MLAS_FORCEINLINE
+float
+MlasQ4DotBlockTail(
+    const float* A,
+    const uint8_t* BlockData,
+    size_t Start,
+    size_t Count,
+    float Scale,
+    float Offset
+    )
+{
+    float Sum = 0.0f;
+    for (size_t i = Start; i < Count; i++) {
+        Sum += A[i] * MlasQ4DequantizeValue(BlockData, i, Scale, Offset);
+    }
+    return Sum;
+}
@@ -91,6 +91,7 @@ struct ThreadOptions {
   void* custom_thread_creation_options = nullptr;
   OrtCustomJoinThreadFn custom_join_thread_fn = nullptr;
   int dynamic_block_base_ = 0;
+  bool adaptive_block_size_ = false;
 };
 
 std::ostream& operator<<(std::ostream& os, const LogicalProcessors&);
@@ -175,8 +176,9 @@ class Env {
 
   /**
    * Maps the content of the file into memory.
-   * This is a copy-on-write mapping, so any changes are not written to the
-   * actual file.
+   * Changes are never written to the actual file, but the mapping may be
+   * read-only depending on the platform. Use MapFileIntoMemoryCopyOnWrite()
+   * to update the mapped memory.
    * @param file_path The path to the file.
    * @param offset The file offset from which to start the mapping.
    * @param length The length in bytes of the mapping.
@@ -186,6 +188,20 @@ class Env {
   virtual common::Status MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
                                            MappedMemoryPtr& mapped_memory) const = 0;
 
+  /**
+   * Maps the content of the file into writable memory.
+   * This is a copy-on-write mapping on every platform, so any changes are not
+   * written to the actual file. Pages that were not changed may show later
+   * writes to the file.
+   * @param file_path The path to the file.
+   * @param offset The file offset from which to start the mapping.
+   * @param length The length in bytes of the mapping.
+   * @param[out] mapped_memory A smart pointer to the mapped memory which
+   *             unmaps the memory (unless release()'d) when destroyed.
+   */
+  virtual common::Status MapFileIntoMemoryCopyOnWrite(_In_z_ const ORTCHAR_T* file_path, FileOffsetType offset,
+                                                      size_t length, MappedMemoryPtr& mapped_memory) const = 0;
+
 #ifdef _WIN32
   /// \brief Returns true if the directory exists.
   virtual bool FolderExists(const std::wstring& path) const = 0;
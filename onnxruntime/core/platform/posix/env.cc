@@ -455,6 +455,12 @@ class PosixEnv : public Env {
     return Status::OK();
   }
 
+  Status MapFileIntoMemoryCopyOnWrite(const ORTCHAR_T* file_path, FileOffsetType offset, size_t length,
+                                      MappedMemoryPtr& mapped_memory) const override {
+    // MapFileIntoMemory() maps the file private and writable
+    return MapFileIntoMemory(file_path, offset, length, mapped_memory);
+  }
+
   static common::Status ReportSystemError(const char* operation_name, const std::string& path) {
     auto [err_no, err_msg] = GetSystemError();
     std::ostringstream oss;
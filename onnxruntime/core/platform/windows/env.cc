@@ -371,10 +371,13 @@ Status WindowsEnv::ReadFileIntoBuffer(_In_z_ const ORTCHAR_T* const file_path, c
   return Status::OK();
 }
 
-Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
-                                     FileOffsetType offset,
-                                     size_t length,
-                                     MappedMemoryPtr& mapped_memory) const {
+// Maps the file read-only, or copy-on-write so the pages can be written without changing the file.
+static Status MapFile(_In_z_ const ORTCHAR_T* file_path,
+                      FileOffsetType offset,
+                      size_t length,
+                      bool copy_on_write,
+                      Env::MappedMemoryPtr& mapped_memory) {
+  using MappedMemoryPtr = Env::MappedMemoryPtr;
   ORT_RETURN_IF_NOT(file_path, "file_path == nullptr");
   ORT_RETURN_IF_NOT(offset >= 0, "offset < 0");
 
@@ -403,7 +406,7 @@ Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
       CreateFileMapping2(file_handle.get(),
                          nullptr,
                          FILE_MAP_READ,
-                         PAGE_READONLY,
+                         copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY,
                          SEC_COMMIT,
                          0,
                          nullptr,
@@ -413,7 +416,7 @@ Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
   wil::unique_hfile file_mapping_handle{
       CreateFileMappingW(file_handle.get(),
                          nullptr,
-                         PAGE_READONLY,
+                         copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY,
                          0,
                          0,
                          nullptr)};
@@ -445,7 +448,7 @@ Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
   }
 
   void* const mapped_base = MapViewOfFile(file_mapping_handle.get(),
-                                          FILE_MAP_READ,
+                                          copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ,
                                           0,
                                           static_cast<DWORD>(mapped_offset),
                                           mapped_length);
@@ -457,6 +460,20 @@ Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
   return Status::OK();
 }
 
+Status WindowsEnv::MapFileIntoMemory(_In_z_ const ORTCHAR_T* file_path,
+                                     FileOffsetType offset,
+                                     size_t length,
+                                     MappedMemoryPtr& mapped_memory) const {
+  return MapFile(file_path, offset, length, false, mapped_memory);
+}
+
+Status WindowsEnv::MapFileIntoMemoryCopyOnWrite(_In_z_ const ORTCHAR_T* file_path,
+                                                FileOffsetType offset,
+                                                size_t length,
+                                                MappedMemoryPtr& mapped_memory) const {
+  return MapFile(file_path, offset, length, true, mapped_memory);
+}
+
 bool WindowsEnv::FolderExists(const std::wstring& path) const {
   DWORD attributes = GetFileAttributesW(path.c_str());
   return (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY);
@@ -65,6 +65,10 @@ class WindowsEnv : public Env {
                            FileOffsetType offset,
                            size_t length,
                            MappedMemoryPtr& mapped_memory) const override;
+  Status MapFileIntoMemoryCopyOnWrite(_In_z_ const ORTCHAR_T* file_path,
+                                      FileOffsetType offset,
+                                      size_t length,
+                                      MappedMemoryPtr& mapped_memory) const override;
   bool FolderExists(const std::wstring& path) const override;
   bool FolderExists(const std::string& path) const override;
   common::Status CreateFolder(const std::wstring& path) const override;
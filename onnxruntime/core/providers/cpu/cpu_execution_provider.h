@@ -12,6 +12,10 @@ namespace onnxruntime {
 // Information needed to construct CPU execution providers.
 struct CPUExecutionProviderInfo {
   bool create_arena{true};
+  // Kernel options the CPU execution provider created for a session reads from its configuration,
+  // see kOrtSessionOptionsConfigTreeEnsembleCompactLayout and kOrtSessionOptionsConfigGenerationCompactFinishedSequences.
+  bool tree_ensemble_compact_layout{false};
+  bool generation_compact_finished_sequences{false};
 
   explicit CPUExecutionProviderInfo(bool use_arena)
       : create_arena(use_arena) {}
@@ -34,6 +38,8 @@ class CPUExecutionProvider : public IExecutionProvider {
   std::shared_ptr<KernelRegistry> GetKernelRegistry() const override;
   std::unique_ptr<IDataTransfer> GetDataTransfer() const override;
 
+  const CPUExecutionProviderInfo& GetInfo() const noexcept { return info_; }
+
  private:
   CPUExecutionProviderInfo info_;
   std::vector<FuseRuleFn> fuse_rules_;
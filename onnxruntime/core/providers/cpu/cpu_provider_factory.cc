@@ -7,28 +7,38 @@
 
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/providers/cpu/cpu_provider_factory_creator.h"
+#include "core/framework/session_options.h"
 #include "core/session/abi_session_options_impl.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/ort_apis.h"
 
 namespace onnxruntime {
 
 struct CpuProviderFactory : IExecutionProviderFactory {
-  CpuProviderFactory(bool create_arena) : create_arena_(create_arena) {}
+  CpuProviderFactory(const CPUExecutionProviderInfo& info) : info_(info) {}
   ~CpuProviderFactory() override = default;
   std::unique_ptr<IExecutionProvider> CreateProvider() override;
 
  private:
-  bool create_arena_;
+  CPUExecutionProviderInfo info_;
 };
 
 std::unique_ptr<IExecutionProvider> CpuProviderFactory::CreateProvider() {
-  CPUExecutionProviderInfo info;
-  info.create_arena = create_arena_;
-  return std::make_unique<CPUExecutionProvider>(info, true /* delay allocator registration to allow sharing */);
+  return std::make_unique<CPUExecutionProvider>(info_, true /* delay allocator registration to allow sharing */);
 }
 
 std::shared_ptr<IExecutionProviderFactory> CPUProviderFactoryCreator::Create(int use_arena) {
-  return std::make_shared<onnxruntime::CpuProviderFactory>(use_arena != 0);
+  return std::make_shared<onnxruntime::CpuProviderFactory>(CPUExecutionProviderInfo{use_arena != 0});
+}
+
+std::shared_ptr<IExecutionProviderFactory> CPUProviderFactoryCreator::Create(const SessionOptions& session_options) {
+  const ConfigOptions& config_options = session_options.config_options;
+  CPUExecutionProviderInfo info{session_options.enable_cpu_mem_arena};
+  info.tree_ensemble_compact_layout =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigTreeEnsembleCompactLayout, "0") == "1";
+  info.generation_compact_finished_sequences =
+      config_options.GetConfigOrDefault(kOrtSessionOptionsConfigGenerationCompactFinishedSequences, "0") == "1";
+  return std::make_shared<onnxruntime::CpuProviderFactory>(info);
 }
 
 }  // namespace onnxruntime
@@ -8,7 +8,11 @@
 #include "core/providers/providers.h"
 
 namespace onnxruntime {
+struct SessionOptions;
+
 struct CPUProviderFactoryCreator {
   static std::shared_ptr<IExecutionProviderFactory> Create(int use_arena);
+  // Creates the CPU execution provider of a session, the kernel options are read from the session configuration.
+  static std::shared_ptr<IExecutionProviderFactory> Create(const SessionOptions& session_options);
 };
 }  // namespace onnxruntime
@@ -196,6 +196,40 @@ Status Gemm<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prep
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::UsePersistedPrePackedBuffers(const Tensor& /*tensor*/,
+                                             std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                             int /*input_idx*/,
+                                             /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::UsePersistedPrePackedBuffers(const Tensor& tensor,
+                                                 std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                 int input_idx,
+                                                 /*out*/ bool& used_persisted_buffers) {
+  ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(prepacked_buffers, input_idx, used_persisted_buffers));
+
+  // restore the shape PrePack() keeps for Compute()
+  if (used_persisted_buffers) {
+    b_shape_ = tensor.Shape();
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+bool Gemm<T>::CanUsePersistedPrePackedBuffers(int /*input_idx*/) const {
+  return false;
+}
+
+template <>
+bool Gemm<float>::CanUsePersistedPrePackedBuffers(int input_idx) const {
+  return input_idx == 1;
+}
+
 template <typename T>
 void Gemm<T>::ComputeActivation(T* y_data, size_t y_size, concurrency::ThreadPool* thread_pool) const {
   if (activation_) {
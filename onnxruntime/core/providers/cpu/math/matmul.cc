@@ -157,6 +157,20 @@ Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status MatMul<float>::UsePersistedPrePackedBuffers(const Tensor& tensor,
+                                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                   int input_idx,
+                                                   /*out*/ bool& used_persisted_buffers) {
+  ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(prepacked_buffers, input_idx, used_persisted_buffers));
+
+  // PrePack() only packs 2D weights, restore the shape it keeps for Compute()
+  if (used_persisted_buffers) {
+    b_shape_ = tensor.Shape();
+  }
+
+  return Status::OK();
+}
+
 Status MatMul<float>::Compute(OpKernelContext* ctx) const {
   concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
 
@@ -36,6 +36,11 @@ class MatMul<float> final : public OpKernel {
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx, /*out*/ bool& used_persisted_buffers) override;
+
+  bool CanUsePersistedPrePackedBuffers(int input_idx) const override { return input_idx == 1; }
+
   Status Compute(OpKernelContext* context) const override;
 
  private:
@@ -0,0 +1,346 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace ml {  // name space for onnx.ml operators
+
+namespace lookup_table_detail {
+
+// finalizer of splitmix64, spreads every input bit over the whole result
+inline uint64_t Mix(uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ULL;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebULL;
+  h ^= h >> 31;
+  return h;
+}
+
+inline uint64_t Hash(int64_t key) {
+  return Mix(static_cast<uint64_t>(key));
+}
+
+inline uint64_t Hash(float key) {
+  // -0.0f and 0.0f are the same key
+  if (key == 0.0f) {
+    key = 0.0f;
+  }
+
+  uint32_t bits;
+  memcpy(&bits, &key, sizeof(bits));
+  return Mix(bits);
+}
+
+inline uint64_t Hash(const std::string& key) {
+  const char* data = key.data();
+  size_t size = key.size();
+  uint64_t h = Mix(size + 0x9e3779b97f4a7c15ULL);
+
+  for (; size >= sizeof(uint64_t); data += sizeof(uint64_t), size -= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    h = Mix(h ^ word);
+  }
+
+  uint64_t tail = 0;
+  memcpy(&tail, data, size);
+  return Mix(h ^ tail);
+}
+
+template <typename TKey>
+bool IsMatchable(const TKey& key) {
+  if constexpr (std::is_floating_point<TKey>::value) {
+    // NaN never compares equal, so a NaN key can never be found
+    return !std::isnan(key);
+  } else {
+    ORT_UNUSED_PARAMETER(key);
+    return true;
+  }
+}
+
+}  // namespace lookup_table_detail
+
+// Read-only map used by LabelEncoder and CategoryMapper to translate whole tensors.
+//
+// Integer keys in a dense range are looked up in a flat array indexed by key - min. Other keys use a perfect hash
+// built with hash and displace: the keys are split into small buckets and every bucket gets the displacement that
+// sends its keys to free slots, so a lookup is one hash, one displacement and one slot with no probing.
+// Lookups hash a batch of inputs before touching the table so the loads of the batch overlap, and large inputs are
+// split across the intra-op thread pool.
+template <typename TKey, typename TValue>
+class LookupTable {
+ public:
+  LookupTable() = default;
+
+  // When a key is repeated its last value is kept, as for std::unordered_map::operator[].
+  LookupTable(gsl::span<const TKey> keys, gsl::span<const TValue> values) {
+    ORT_ENFORCE(keys.size() == values.size());
+
+    std::unordered_map<TKey, size_t> indices;
+    indices.reserve(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+      if (!lookup_table_detail::IsMatchable(keys[i])) {
+        continue;
+      }
+
+      auto result = indices.emplace(keys[i], keys_.size());
+      if (result.second) {
+        keys_.push_back(keys[i]);
+        values_.push_back(values[i]);
+      } else {
+        values_[result.first->second] = values[i];
+      }
+    }
+
+    if (keys_.empty()) {
+      return;
+    }
+
+    if constexpr (std::is_integral<TKey>::value) {
+      if (TryBuildFlatTable()) {
+        return;
+      }
+    }
+
+    BuildPerfectHash();
+  }
+
+  size_t Size() const { return keys_.size(); }
+
+  // Returns the value of key or nullptr if key isn't in the table.
+  const TValue* Find(const TKey& key) const {
+    const int32_t index = FindIndex(key);
+    return index < 0 ? nullptr : &values_[index];
+  }
+
+  // Writes the value of each element of input to output, or default_value for the ones not in the table.
+  void Lookup(gsl::span<const TKey> input, gsl::span<TValue> output, const TValue& default_value,
+              concurrency::ThreadPool* thread_pool) const {
+    ORT_ENFORCE(input.size() == output.size());
+
+    // strings are hashed, compared and copied byte by byte
+    constexpr bool has_string = std::is_same<TKey, std::string>::value || std::is_same<TValue, std::string>::value;
+    const TensorOpCost cost{static_cast<double>(sizeof(TKey)), static_cast<double>(sizeof(TValue)),
+                            has_string ? 64.0 : 8.0};
+
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(input.size()), cost,
+        [this, &input, &output, &default_value](std::ptrdiff_t first, std::ptrdiff_t last) {
+          LookupRange(input, output, default_value, static_cast<size_t>(first), static_cast<size_t>(last));
+        });
+  }
+
+ private:
+  static constexpr size_t kBatchSize = 32;
+
+  // the flat table is used if it has at most this many slots per key
+  static constexpr uint64_t kMaxFlatSlotsPerKey = 4;
+
+  // average number of keys per bucket of the perfect hash
+  static constexpr size_t kKeysPerBucket = 4;
+
+  static constexpr uint64_t kDisplacementMultiplier = 0x9e3779b97f4a7c15ULL;
+
+  bool TryBuildFlatTable() {
+    const auto min_max = std::minmax_element(keys_.begin(), keys_.end());
+    const uint64_t range = static_cast<uint64_t>(*min_max.second) - static_cast<uint64_t>(*min_max.first);
+
+    if (range >= kMaxFlatSlotsPerKey * keys_.size() + 16) {
+      return false;
+    }
+
+    flat_min_ = *min_max.first;
+    slots_.assign(static_cast<size_t>(range) + 1, -1);
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      slots_[static_cast<size_t>(static_cast<uint64_t>(keys_[i]) - static_cast<uint64_t>(flat_min_))] =
+          static_cast<int32_t>(i);
+    }
+
+    is_flat_ = true;
+    return true;
+  }
+
+  void BuildPerfectHash() {
+    ORT_ENFORCE(keys_.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()),
+                "Too many keys for the lookup table: ", keys_.size());
+
+    std::vector<uint64_t> hashes(keys_.size());
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      hashes[i] = lookup_table_detail::Hash(keys_[i]);
+    }
+
+    const size_t num_buckets = keys_.size() / kKeysPerBucket + 1;
+    std::vector<std::vector<int32_t>> buckets(num_buckets);
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      buckets[BucketOf(hashes[i], num_buckets)].push_back(static_cast<int32_t>(i));
+    }
+
+    // place the largest buckets first while most slots are free
+    std::vector<size_t> bucket_order(num_buckets);
+    std::iota(bucket_order.begin(), bucket_order.end(), size_t{0});
+    std::stable_sort(bucket_order.begin(), bucket_order.end(), [&buckets](size_t a, size_t b) {
+      return buckets[a].size() > buckets[b].size();
+    });
+
+    // keep the table at most 80% full. it is only grown in the unlikely case that no displacement places a bucket.
+    size_t num_slots = 1;
+    while (num_slots * 4 < keys_.size() * 5) {
+      num_slots <<= 1;
+    }
+
+    constexpr uint32_t kMaxDisplacement = 1 << 16;
+    std::vector<size_t> bucket_slots;
+
+    for (;;) {
+      slots_.assign(num_slots, -1);
+      displacements_.assign(num_buckets, 0);
+      const uint64_t slot_mask = num_slots - 1;
+      bool placed_all = true;
+
+      for (size_t bucket : bucket_order) {
+        const auto& bucket_keys = buckets[bucket];
+        if (bucket_keys.empty()) {
+          break;
+        }
+
+        bool placed = false;
+        for (uint32_t displacement = 0; displacement < kMaxDisplacement && !placed; ++displacement) {
+          bucket_slots.clear();
+          placed = true;
+
+          for (int32_t key_index : bucket_keys) {
+            const size_t slot = static_cast<size_t>(SlotOf(hashes[key_index], displacement, slot_mask));
+            if (slots_[slot] >= 0 || std::find(bucket_slots.begin(), bucket_slots.end(), slot) != bucket_slots.end()) {
+              placed = false;
+              break;
+            }
+
+            bucket_slots.push_back(slot);
+          }
+
+          if (placed) {
+            displacements_[bucket] = displacement;
+            for (size_t i = 0; i < bucket_keys.size(); ++i) {
+              slots_[bucket_slots[i]] = bucket_keys[i];
+            }
+          }
+        }
+
+        if (!placed) {
+          placed_all = false;
+          break;
+        }
+      }
+
+      if (placed_all) {
+        break;
+      }
+
+      ORT_ENFORCE(num_slots < (size_t{1} << 31), "Failed to build a perfect hash for ", keys_.size(), " keys.");
+      num_slots <<= 1;
+    }
+
+    slot_mask_ = num_slots - 1;
+  }
+
+  static size_t BucketOf(uint64_t hash, size_t num_buckets) {
+    return static_cast<size_t>((hash >> 32) % num_buckets);
+  }
+
+  static uint64_t SlotOf(uint64_t hash, uint32_t displacement, uint64_t slot_mask) {
+    return lookup_table_detail::Mix(hash + displacement * kDisplacementMultiplier) & slot_mask;
+  }
+
+  int32_t FindIndex(const TKey& key) const {
+    if (keys_.empty()) {
+      return -1;
+    }
+
+    if constexpr (std::is_integral<TKey>::value) {
+      if (is_flat_) {
+        const uint64_t offset = static_cast<uint64_t>(key) - static_cast<uint64_t>(flat_min_);
+        return offset < slots_.size() ? slots_[static_cast<size_t>(offset)] : -1;
+      }
+    }
+
+    const uint64_t hash = lookup_table_detail::Hash(key);
+    const int32_t index = slots_[static_cast<size_t>(SlotOf(hash, displacements_[BucketOf(hash, displacements_.size())],
+                                              slot_mask_))];
+    return (index >= 0 && keys_[index] == key) ? index : -1;
+  }
+
+  void LookupRange(gsl::span<const TKey> input, gsl::span<TValue> output, const TValue& default_value,
+                   size_t first, size_t last) const {
+    int32_t indices[kBatchSize];
+
+    for (size_t batch_start = first; batch_start < last; batch_start += kBatchSize) {
+      const size_t batch_size = std::min(kBatchSize, last - batch_start);
+      const TKey* keys = input.data() + batch_start;
+
+      // the slots of the whole batch are computed first, they don't depend on each other
+      if (keys_.empty()) {
+        std::fill_n(indices, batch_size, -1);
+      } else if (is_flat_) {
+        if constexpr (std::is_integral<TKey>::value) {
+          const uint64_t min = static_cast<uint64_t>(flat_min_);
+          const uint64_t num_slots = slots_.size();
+          for (size_t i = 0; i < batch_size; ++i) {
+            const uint64_t offset = static_cast<uint64_t>(keys[i]) - min;
+            indices[i] = offset < num_slots ? slots_[static_cast<size_t>(offset)] : -1;
+          }
+        }
+      } else {
+        const size_t num_buckets = displacements_.size();
+        for (size_t i = 0; i < batch_size; ++i) {
+          const uint64_t hash = lookup_table_detail::Hash(keys[i]);
+          indices[i] = slots_[static_cast<size_t>(SlotOf(hash, displacements_[BucketOf(hash, num_buckets)],
+                                                         slot_mask_))];
+        }
+
+        for (size_t i = 0; i < batch_size; ++i) {
+          if (indices[i] >= 0 && !(keys_[indices[i]] == keys[i])) {
+            indices[i] = -1;
+          }
+        }
+      }
+
+      TValue* out = output.data() + batch_start;
+      for (size_t i = 0; i < batch_size; ++i) {
+        out[i] = indices[i] >= 0 ? values_[indices[i]] : default_value;
+      }
+    }
+  }
+
+  std::vector<TKey> keys_;
+  std::vector<TValue> values_;
+
+  // index in keys_ and values_ of the key in each slot, or -1
+  std::vector<int32_t> slots_;
+
+  // perfect hash
+  std::vector<uint32_t> displacements_;
+  uint64_t slot_mask_ = 0;
+
+  // flat table of integer keys
+  bool is_flat_ = false;
+  TKey flat_min_{};
+};
+
+}  // namespace ml
+}  // namespace onnxruntime
@@ -96,6 +96,31 @@ struct TreeNodeElement {
   inline bool is_missing_track_true() const { return flags & MissingTrack::kTrue; }
 };
 
+// Compact node used when the trees are repacked in depth-first order, 12 bytes
+// for float thresholds and 16 bytes for double thresholds.
+// One child of a node is always stored right after it, `far_node_or_leaf` is the index
+// of the other child. In case of a leaf, `far_node_or_leaf` is the index of the leaf
+// in array `TreeEnsembleCommon::nodes_`, which only holds the leaves in that case.
+template <typename T>
+struct TreeNodeElementCompact {
+  enum Flags : uint8_t {
+    kLeaf = 1,
+    kFarTrue = 2,  // the true node is `far_node_or_leaf`, the false node is the next one
+    kMissingTrack = 4,
+  };
+
+  T threshold;
+  uint32_t far_node_or_leaf;
+  uint16_t feature_id;
+  uint8_t flags;
+
+  inline bool is_not_leaf() const { return !(flags & kLeaf); }
+  inline bool is_far_true() const { return flags & kFarTrue; }
+  inline bool is_missing_track_true() const { return flags & kMissingTrack; }
+};
+
+static_assert(sizeof(TreeNodeElementCompact<float>) == 12, "unexpected padding in TreeNodeElementCompact");
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 class TreeAggregator {
  protected:
@@ -7,11 +7,33 @@
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 #include "tree_ensemble_helper.h"
+#include <functional>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 namespace onnxruntime {
 namespace ml {
 namespace detail {
 
+// Returns the index of the lowest bit set in v, v must not be null.
+inline uint32_t LowestBitIndex(uint64_t v) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+  unsigned long index;
+  _BitScanForward64(&index, v);
+  return static_cast<uint32_t>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+  return static_cast<uint32_t>(__builtin_ctzll(v));
+#else
+  uint32_t index = 0;
+  while ((v & 1) == 0) {
+    v >>= 1;
+    ++index;
+  }
+  return index;
+#endif
+}
+
 class TreeEnsembleCommonAttributes {
  public:
   int64_t get_target_or_class_count() const { return this->n_targets_or_classes_; }
@@ -28,6 +50,7 @@ class TreeEnsembleCommonAttributes {
   int64_t max_feature_id_;
   int64_t n_trees_;
   bool same_mode_;
+  NODE_MODE branch_mode_;  // rule shared by all nodes if same_mode_ is true, LEAF if there is no branch
   bool has_missing_tracks_;
   int parallel_tree_;    // starts parallelizing the computing by trees if n_tree >= parallel_tree_
   int parallel_tree_N_;  // batch size if parallelizing by trees
@@ -48,8 +71,47 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   std::vector<SparseValue<ThresholdType>> weights_;    
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
 
+  // QuickScorer evaluation engine (bit-vector traversal). It is enabled in `Init`
+  // if every node uses the same rule BRANCH_LEQ or BRANCH_LT, no missing value
+  // is tracked and every tree has at most 64 leaves. The leaves of every tree
+  // are numbered from left (true branch) to right (false branch). Every node
+  // is a condition on one feature, and the bit mask of a node removes
+  // the leaves of its true branch. All conditions are sorted by feature,
+  // then by threshold, and the conditions of feature f are stored in
+  // [qs_feature_offsets_[f], qs_feature_offsets_[f + 1]).
+  bool use_quickscorer_;
+  std::vector<uint32_t> qs_feature_offsets_;
+  std::vector<ThresholdType> qs_thresholds_;
+  std::vector<uint32_t> qs_tree_ids_;
+  std::vector<uint64_t> qs_masks_;
+  // The leaves of tree t are stored in qs_leaves_[qs_leaf_offsets_[t]:qs_leaf_offsets_[t + 1]].
+  std::vector<uint32_t> qs_leaf_offsets_;
+  std::vector<const TreeNodeElement<ThresholdType>*> qs_leaves_;
+
+  // Structure-of-arrays copy of nodes_ used to walk a block of rows through
+  // the same tree in lock-step without any data-dependent branch.
+  // It is enabled in `Init` if all nodes share the same rule and the QuickScorer
+  // engine is not. node_children_[2 * i] is the true node of node i,
+  // node_children_[2 * i + 1] its false node. A leaf points to itself and follows
+  // feature 0, a row reaching a leaf stays there until the walk ends.
+  // tree_depths_[t] is the maximum number of steps needed to reach a leaf of tree t.
+  bool use_node_arrays_;
+  std::vector<int> node_feature_ids_;
+  std::vector<ThresholdType> node_thresholds_;
+  std::vector<uint32_t> node_children_;
+  std::vector<uint8_t> node_missing_tracks_;
+  std::vector<uint32_t> tree_depths_;
+
+  // Compact depth-first copy of the trees, requested through session option
+  // kOrtSessionOptionsConfigTreeEnsembleCompactLayout. The root of tree t is
+  // compact_nodes_[compact_roots_[t]], nodes_ then only holds the leaves and roots_ is empty.
+  bool compact_layout_;
+  bool use_compact_layout_;
+  std::vector<TreeNodeElementCompact<ThresholdType>> compact_nodes_;
+  std::vector<uint32_t> compact_roots_;
+
  public:
-  TreeEnsembleCommon() {}
+  TreeEnsembleCommon() : compact_layout_(false) {}
 
   virtual Status Init(const OpKernelInfo& info);
   virtual Status compute(OpKernelContext* ctx, const Tensor* X, Tensor* Y, Tensor* label) const;
@@ -83,8 +145,38 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(TreeNodeElement<ThresholdType>* root,
                                                        const InputType* x_data) const;
 
+  // Returns the leaf reached by one row in tree `tree`.
+  const TreeNodeElement<ThresholdType>* ProcessTreeNodeLeave(size_t tree, const InputType* x_data) const;
+
+  template <typename CMP>
+  const TreeNodeElement<ThresholdType>* ProcessTreeNodeLeaveCompact(size_t tree, const InputType* x_data,
+                                                                    CMP cmp) const;
+
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
+
+  bool InitQuickScorer();
+
+  // Computes the bit vector of every tree for one row. The exit leaf of tree t
+  // is given by the lowest bit set in bitvectors[t].
+  void ProcessQuickScorerBitVectors(const InputType* x_data, uint64_t* bitvectors) const;
+
+  bool InitNodeArrays();
+
+  bool InitCompactLayout(const std::vector<float>& nodes_hitrates,
+                         const std::vector<ThresholdType>& nodes_hitrates_as_tensor);
+
+  // Computes the leaves reached by n_rows consecutive rows in one tree.
+  void ProcessTreeNodeLeaves(size_t tree, const InputType* x_data, int64_t stride, size_t n_rows,
+                             const TreeNodeElement<ThresholdType>** leaves) const;
+
+  template <typename CMP>
+  void ProcessTreeNodeLeavesBatch(size_t tree, const InputType* x_data, int64_t stride, size_t n_rows,
+                                  const TreeNodeElement<ThresholdType>** leaves, CMP cmp) const;
+
+  template <typename AGG>
+  void ComputeAggQuickScorer(concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+                             int64_t* label_data, int64_t N, int64_t stride, const AGG& agg) const;
 };
 
 template <typename InputType, typename ThresholdType, typename OutputType>
@@ -97,6 +189,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(const OpKe
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "nodes_values_as_tensor", nodes_values_as_tensor));
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "target_weights_as_tensor", target_weights_as_tensor));
 #endif
+  compact_layout_ = UseCompactTreeLayout(info);
 
   return Init(
       80,
@@ -204,6 +297,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
     if (cmodes[i] != cmodes[fpos])
       same_mode_ = false;
   }
+  branch_mode_ = fpos == -1 ? NODE_MODE::LEAF : cmodes[fpos];
 
   // filling nodes
 
@@ -230,7 +324,7 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
                                       ? static_cast<ThresholdType>(nodes_values[i])
                                       : nodes_values_as_tensor[i];
 
-    /* hitrates is not used for inference, they are ignored.
+    /* hitrates are not stored in the nodes, InitCompactLayout reads them from the attributes.
     if (nodes_hitrates_as_tensor.empty()) {
       node.hitrates = static_cast<ThresholdType>(i < nodes_hitrates.size() ? nodes_hitrates[i] : -1);
     } else {
@@ -351,9 +445,271 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
       break;
     }
   }
+  use_quickscorer_ = false;
+  use_node_arrays_ = false;
+  use_compact_layout_ = false;
+  if (!InitQuickScorer()) {
+    if (!compact_layout_ || !InitCompactLayout(nodes_hitrates, nodes_hitrates_as_tensor)) {
+      InitNodeArrays();
+    }
+  }
   return Status::OK();
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+bool TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitCompactLayout(
+    const std::vector<float>& nodes_hitrates,
+    const std::vector<ThresholdType>& nodes_hitrates_as_tensor) {
+  use_compact_layout_ = false;
+  compact_nodes_.clear();
+  compact_roots_.clear();
+  if (!same_mode_ || max_feature_id_ > std::numeric_limits<uint16_t>::max()) {
+    return false;
+  }
+
+  auto hitrate = [&](size_t i) -> double {
+    if (!nodes_hitrates_as_tensor.empty()) {
+      return i < nodes_hitrates_as_tensor.size() ? static_cast<double>(nodes_hitrates_as_tensor[i]) : -1;
+    }
+    return i < nodes_hitrates.size() ? static_cast<double>(nodes_hitrates[i]) : -1;
+  };
+
+  // Every tree is stored in depth-first order, the most likely child of a node
+  // is visited first and stored right after it. The other child is visited once the
+  // whole subtree of the first one is stored, its position is then written in its parent.
+  constexpr uint32_t kNoParent = std::numeric_limits<uint32_t>::max();
+  std::vector<std::pair<uint32_t, uint32_t>> stack;
+  const TreeNodeElement<ThresholdType>* first_node = nodes_.data();
+  compact_nodes_.reserve(nodes_.size());
+  compact_roots_.reserve(roots_.size());
+  for (auto it = roots_.cbegin(); it != roots_.cend(); ++it) {
+    compact_roots_.push_back(static_cast<uint32_t>(compact_nodes_.size()));
+    stack.clear();
+    stack.emplace_back(static_cast<uint32_t>(*it - first_node), kNoParent);
+    while (!stack.empty()) {
+      auto item = stack.back();
+      stack.pop_back();
+      if (compact_nodes_.size() >= nodes_.size()) {
+        // A node is visited more than once, the nodes do not define a forest.
+        compact_nodes_.clear();
+        compact_roots_.clear();
+        return false;
+      }
+      uint32_t position = static_cast<uint32_t>(compact_nodes_.size());
+      if (item.second != kNoParent) {
+        compact_nodes_[item.second].far_node_or_leaf = position;
+      }
+
+      const TreeNodeElement<ThresholdType>& node = nodes_[item.first];
+      TreeNodeElementCompact<ThresholdType> compact;
+      if (!node.is_not_leaf()) {
+        compact.threshold = 0;
+        compact.far_node_or_leaf = item.first;
+        compact.feature_id = 0;
+        compact.flags = TreeNodeElementCompact<ThresholdType>::kLeaf;
+        compact_nodes_.push_back(compact);
+        continue;
+      }
+
+      if (node.truenode_inc_or_first_weight == 0 || node.falsenode_inc_or_n_weights == 0) {
+        compact_nodes_.clear();
+        compact_roots_.clear();
+        return false;
+      }
+      uint32_t true_id = item.first + node.truenode_inc_or_first_weight;
+      uint32_t false_id = item.first + node.falsenode_inc_or_n_weights;
+      bool far_true = hitrate(false_id) > hitrate(true_id);
+      compact.threshold = node.value_or_unique_weight;
+      compact.far_node_or_leaf = 0;  // updated when the far node is stored
+      compact.feature_id = static_cast<uint16_t>(node.feature_id);
+      compact.flags = static_cast<uint8_t>(
+          (far_true ? TreeNodeElementCompact<ThresholdType>::kFarTrue : 0) |
+          (node.is_missing_track_true() ? TreeNodeElementCompact<ThresholdType>::kMissingTrack : 0));
+      compact_nodes_.push_back(compact);
+      stack.emplace_back(far_true ? true_id : false_id, position);
+      stack.emplace_back(far_true ? false_id : true_id, kNoParent);
+    }
+  }
+
+  // Only the leaves of nodes_ are still used, the compact leaves now point to their index in the new nodes_.
+  std::vector<TreeNodeElement<ThresholdType>> leaves;
+  leaves.reserve((compact_nodes_.size() + compact_roots_.size()) / 2);
+  for (auto& compact : compact_nodes_) {
+    if (!compact.is_not_leaf()) {
+      leaves.push_back(nodes_[compact.far_node_or_leaf]);
+      compact.far_node_or_leaf = static_cast<uint32_t>(leaves.size() - 1);
+    }
+  }
+  nodes_ = std::move(leaves);
+  roots_.clear();
+  roots_.shrink_to_fit();
+
+  use_compact_layout_ = true;
+  return true;
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+bool TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitNodeArrays() {
+  use_node_arrays_ = false;
+  node_feature_ids_.clear();
+  node_thresholds_.clear();
+  node_children_.clear();
+  node_missing_tracks_.clear();
+  tree_depths_.clear();
+  if (!same_mode_ || nodes_.size() >= (static_cast<size_t>(1) << 31)) {
+    return false;
+  }
+
+  node_feature_ids_.reserve(nodes_.size());
+  node_thresholds_.reserve(nodes_.size());
+  node_children_.reserve(nodes_.size() * 2);
+  node_missing_tracks_.reserve(nodes_.size());
+  uint32_t i = 0;
+  for (auto it = nodes_.cbegin(); it != nodes_.cend(); ++it, ++i) {
+    if (it->is_not_leaf()) {
+      if (it->truenode_inc_or_first_weight == 0 || it->falsenode_inc_or_n_weights == 0) {
+        return false;
+      }
+      node_feature_ids_.push_back(it->feature_id);
+      node_thresholds_.push_back(it->value_or_unique_weight);
+      node_children_.push_back(i + it->truenode_inc_or_first_weight);
+      node_children_.push_back(i + it->falsenode_inc_or_n_weights);
+      node_missing_tracks_.push_back(it->is_missing_track_true() ? 1 : 0);
+    } else {
+      node_feature_ids_.push_back(0);
+      node_thresholds_.push_back(0);
+      node_children_.push_back(i);
+      node_children_.push_back(i);
+      node_missing_tracks_.push_back(0);
+    }
+  }
+
+  std::vector<std::pair<uint32_t, uint32_t>> stack;
+  tree_depths_.reserve(roots_.size());
+  for (auto it = roots_.cbegin(); it != roots_.cend(); ++it) {
+    uint32_t depth = 0;
+    size_t n_visited = 0;
+    stack.clear();
+    stack.emplace_back(static_cast<uint32_t>(*it - nodes_.data()), 0);
+    while (!stack.empty()) {
+      auto item = stack.back();
+      stack.pop_back();
+      if (++n_visited > nodes_.size()) {
+        return false;
+      }
+      if (!nodes_[item.first].is_not_leaf()) {
+        depth = std::max(depth, item.second);
+        continue;
+      }
+      stack.emplace_back(node_children_[2 * item.first], item.second + 1);
+      stack.emplace_back(node_children_[2 * item.first + 1], item.second + 1);
+    }
+    tree_depths_.push_back(depth);
+  }
+  use_node_arrays_ = true;
+  return true;
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+bool TreeEnsembleCommon<InputType, ThresholdType, OutputType>::InitQuickScorer() {
+  use_quickscorer_ = false;
+  qs_feature_offsets_.clear();
+  qs_thresholds_.clear();
+  qs_tree_ids_.clear();
+  qs_masks_.clear();
+  qs_leaf_offsets_.clear();
+  qs_leaves_.clear();
+  if (!same_mode_ || has_missing_tracks_ || roots_.empty() ||
+      roots_.size() >= std::numeric_limits<uint32_t>::max()) {
+    return false;
+  }
+
+  if (branch_mode_ != NODE_MODE::BRANCH_LEQ && branch_mode_ != NODE_MODE::BRANCH_LT &&
+      branch_mode_ != NODE_MODE::LEAF) {
+    return false;
+  }
+
+  struct Condition {
+    int feature_id;
+    ThresholdType threshold;
+    uint32_t tree_id;
+    uint64_t mask;
+  };
+  // Second member is false when the node is visited for the first time,
+  // true once its true branch was entirely visited.
+  std::vector<std::pair<const TreeNodeElement<ThresholdType>*, bool>> stack;
+  std::vector<Condition> conditions;
+  std::vector<uint32_t> true_begin(nodes_.size(), 0);
+  const TreeNodeElement<ThresholdType>* first_node = nodes_.data();
+  size_t n_visited = 0;
+
+  for (size_t tree_id = 0; tree_id < roots_.size(); ++tree_id) {
+    uint32_t n_leaves = 0;
+    qs_leaf_offsets_.push_back(static_cast<uint32_t>(qs_leaves_.size()));
+    stack.clear();
+    stack.emplace_back(roots_[tree_id], false);
+    // Depth-first traversal, true branch first.
+    while (!stack.empty()) {
+      auto item = stack.back();
+      stack.pop_back();
+      const TreeNodeElement<ThresholdType>* node = item.first;
+      // A node visited more than once means the nodes do not define a forest.
+      if (++n_visited > 2 * nodes_.size()) {
+        return false;
+      }
+      if (!node->is_not_leaf()) {
+        if (n_leaves == 64) {
+          return false;
+        }
+        qs_leaves_.push_back(node);
+        ++n_leaves;
+        continue;
+      }
+      if (node->feature_id < 0 || node->truenode_inc_or_first_weight == 0 ||
+          node->falsenode_inc_or_n_weights == 0 || std::isnan(node->value_or_unique_weight)) {
+        return false;
+      }
+      size_t node_index = static_cast<size_t>(node - first_node);
+      if (!item.second) {
+        true_begin[node_index] = n_leaves;
+        stack.emplace_back(node, true);
+        stack.emplace_back(node + node->truenode_inc_or_first_weight, false);
+        continue;
+      }
+      uint32_t begin = true_begin[node_index];
+      uint32_t n_true_leaves = n_leaves - begin;
+      if (n_true_leaves == 0 || n_true_leaves >= 64) {
+        return false;
+      }
+      conditions.push_back({node->feature_id,
+                            node->value_or_unique_weight,
+                            static_cast<uint32_t>(tree_id),
+                            ~(((static_cast<uint64_t>(1) << n_true_leaves) - 1) << begin)});
+      stack.emplace_back(node + node->falsenode_inc_or_n_weights, false);
+    }
+  }
+  qs_leaf_offsets_.push_back(static_cast<uint32_t>(qs_leaves_.size()));
+
+  std::sort(conditions.begin(), conditions.end(), [](const Condition& a, const Condition& b) {
+    return a.feature_id < b.feature_id || (a.feature_id == b.feature_id && a.threshold < b.threshold);
+  });
+  qs_feature_offsets_.resize(onnxruntime::narrow<size_t>(max_feature_id_ + 2), 0);
+  qs_thresholds_.reserve(conditions.size());
+  qs_tree_ids_.reserve(conditions.size());
+  qs_masks_.reserve(conditions.size());
+  for (auto it = conditions.cbegin(); it != conditions.cend(); ++it) {
+    ++qs_feature_offsets_[it->feature_id + 1];
+    qs_thresholds_.push_back(it->threshold);
+    qs_tree_ids_.push_back(it->tree_id);
+    qs_masks_.push_back(it->mask);
+  }
+  for (size_t f = 1; f < qs_feature_offsets_.size(); ++f) {
+    qs_feature_offsets_[f] += qs_feature_offsets_[f - 1];
+  }
+  use_quickscorer_ = true;
+  return true;
+}
+
 template <typename InputType, typename ThresholdType, typename OutputType>
 Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::compute(OpKernelContext* ctx,
                                                                          const Tensor* X,
@@ -364,28 +720,28 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::compute(OpKerne
       ComputeAgg(
           ctx->GetOperatorThreadPool(), X, Y, label,
           TreeAggregatorAverage<InputType, ThresholdType, OutputType>(
-              roots_.size(), n_targets_or_classes_,
+              static_cast<size_t>(n_trees_), n_targets_or_classes_,
               post_transform_, base_values_));
       return Status::OK();
     case AGGREGATE_FUNCTION::SUM:
       ComputeAgg(
           ctx->GetOperatorThreadPool(), X, Y, label,
           TreeAggregatorSum<InputType, ThresholdType, OutputType>(
-              roots_.size(), n_targets_or_classes_,
+              static_cast<size_t>(n_trees_), n_targets_or_classes_,
               post_transform_, base_values_));
       return Status::OK();
     case AGGREGATE_FUNCTION::MIN:
       ComputeAgg(
           ctx->GetOperatorThreadPool(), X, Y, label,
           TreeAggregatorMin<InputType, ThresholdType, OutputType>(
-              roots_.size(), n_targets_or_classes_,
+              static_cast<size_t>(n_trees_), n_targets_or_classes_,
               post_transform_, base_values_));
       return Status::OK();
     case AGGREGATE_FUNCTION::MAX:
       ComputeAgg(
           ctx->GetOperatorThreadPool(), X, Y, label,
           TreeAggregatorMax<InputType, ThresholdType, OutputType>(
-              roots_.size(), n_targets_or_classes_,
+              static_cast<size_t>(n_trees_), n_targets_or_classes_,
               post_transform_, base_values_));
       return Status::OK();
     default:
@@ -413,12 +769,19 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
   auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
+  // QuickScorer evaluates all trees of a row at once and can only split the rows.
+  // A single row with enough trees is parallelized by trees in sections B and B2.
+  if (use_quickscorer_ && (N > 1 || n_trees_ <= parallel_tree_ || max_num_threads == 1)) {
+    ComputeAggQuickScorer(ttp, x_data, z_data, label_data, N, stride, agg);
+    return;
+  }
+
   if (n_targets_or_classes_ == 1) {
     if (N == 1) {
       ScoreValue<ThresholdType> score = {0, 0};
       if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A: 1 output, 1 row and not enough trees to parallelize */
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data));
+          agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(onnxruntime::narrow<size_t>(j), x_data));
         }
       } else { /* section B: 1 output, 1 row and enough trees to parallelize */
         std::vector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_trees_), {0, 0});
@@ -426,7 +789,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
             ttp,
             SafeInt<int32_t>(n_trees_),
             [this, &scores, &agg, x_data](ptrdiff_t j) {
-              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(roots_[j], x_data));
+              agg.ProcessTreeNodePrediction1(scores[j], *ProcessTreeNodeLeave(static_cast<size_t>(j), x_data));
             },
             max_num_threads);
 
@@ -447,6 +810,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       // split into batch so that every batch holds on caches, then loop on trees and finally loop
       // on the batch rows.
       std::vector<ScoreValue<ThresholdType>> scores(parallel_tree_N_);
+      std::vector<const TreeNodeElement<ThresholdType>*> leaves(parallel_tree_N_);
       size_t j;
       int64_t i, batch, batch_end;
 
@@ -456,8 +820,9 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           scores[SafeInt<ptrdiff_t>(i - batch)] = {0, 0};
         }
         for (j = 0; j < static_cast<size_t>(n_trees_); ++j) {
+          ProcessTreeNodeLeaves(j, x_data + batch * stride, stride, static_cast<size_t>(batch_end - batch), leaves.data());
           for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+            agg.ProcessTreeNodePrediction1(scores[SafeInt<ptrdiff_t>(i - batch)], *leaves[SafeInt<ptrdiff_t>(i - batch)]);
           }
         }
         for (i = batch; i < batch_end; ++i) {
@@ -476,13 +841,15 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
             num_threads,
             [this, &agg, &scores, num_threads, x_data, N, begin_n, end_n, stride](ptrdiff_t batch_num) {
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
+              std::vector<const TreeNodeElement<ThresholdType>*> leaves(onnxruntime::narrow<size_t>(end_n - begin_n));
               for (int64_t i = begin_n; i < end_n; ++i) {
                 scores[batch_num * SafeInt<ptrdiff_t>(N) + i] = {0, 0};
               }
               for (auto j = work.start; j < work.end; ++j) {
+                ProcessTreeNodeLeaves(j, x_data + begin_n * stride, stride, leaves.size(), leaves.data());
                 for (int64_t i = begin_n; i < end_n; ++i) {
                   agg.ProcessTreeNodePrediction1(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                 *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+                                                 *leaves[SafeInt<ptrdiff_t>(i - begin_n)]);
                 }
               }
             });
@@ -508,7 +875,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
           [this, &agg, x_data, z_data, stride, label_data](ptrdiff_t i) {
             ScoreValue<ThresholdType> score = {0, 0};
             for (size_t j = 0; j < static_cast<size_t>(n_trees_); ++j) {
-              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride));
+              agg.ProcessTreeNodePrediction1(score, *ProcessTreeNodeLeave(static_cast<size_t>(j), x_data + i * stride));
             }
 
             agg.FinalizeScores1(z_data + i, score,
@@ -521,7 +888,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       if (n_trees_ <= parallel_tree_ || max_num_threads == 1) { /* section A2 */
         InlinedVector<ScoreValue<ThresholdType>> scores(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
         for (int64_t j = 0; j < n_trees_; ++j) {
-          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[onnxruntime::narrow<size_t>(j)], x_data), weights_);
+          agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(onnxruntime::narrow<size_t>(j), x_data), weights_);
         }
         agg.FinalizeScores(scores, z_data, -1, label_data);
       } else { /* section B2: 2+ outputs, 1 row, enough trees to parallelize */
@@ -534,7 +901,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
               scores[batch_num].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(n_trees_));
               for (auto j = work.start; j < work.end; ++j) {
-                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(roots_[j], x_data), weights_);
+                agg.ProcessTreeNodePrediction(scores[batch_num], *ProcessTreeNodeLeave(static_cast<size_t>(j), x_data), weights_);
               }
             });
         for (size_t i = 1, limit = scores.size(); i < limit; ++i) {
@@ -544,6 +911,7 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
       }
     } else if (N <= parallel_N_ || max_num_threads == 1) { /* section C2: 2+ outputs, 2+ rows, not enough rows to parallelize */
       std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(parallel_tree_N_);
+      std::vector<const TreeNodeElement<ThresholdType>*> leaves(parallel_tree_N_);
       size_t j, limit;
       int64_t i, batch, batch_end;
       batch_end = std::min(N, static_cast<int64_t>(parallel_tree_N_));
@@ -555,9 +923,10 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
         for (i = batch; i < batch_end; ++i) {
           std::fill(scores[SafeInt<ptrdiff_t>(i - batch)].begin(), scores[SafeInt<ptrdiff_t>(i - batch)].end(), ScoreValue<ThresholdType>({0, 0}));
         }
-        for (j = 0, limit = roots_.size(); j < limit; ++j) {
+        for (j = 0, limit = static_cast<size_t>(n_trees_); j < limit; ++j) {
+          ProcessTreeNodeLeaves(j, x_data + batch * stride, stride, static_cast<size_t>(batch_end - batch), leaves.data());
           for (i = batch; i < batch_end; ++i) {
-            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+            agg.ProcessTreeNodePrediction(scores[SafeInt<ptrdiff_t>(i - batch)], *leaves[SafeInt<ptrdiff_t>(i - batch)], weights_);
           }
         }
         for (i = batch; i < batch_end; ++i) {
@@ -577,13 +946,15 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
             num_threads,
             [this, &agg, &scores, num_threads, x_data, N, stride, begin_n, end_n](ptrdiff_t batch_num) {
               auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<size_t>(this->n_trees_));
+              std::vector<const TreeNodeElement<ThresholdType>*> leaves(onnxruntime::narrow<size_t>(end_n - begin_n));
               for (int64_t i = begin_n; i < end_n; ++i) {
                 scores[batch_num * SafeInt<ptrdiff_t>(N) + i].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_), {0, 0});
               }
               for (auto j = work.start; j < work.end; ++j) {
+                ProcessTreeNodeLeaves(j, x_data + begin_n * stride, stride, leaves.size(), leaves.data());
                 for (int64_t i = begin_n; i < end_n; ++i) {
                   agg.ProcessTreeNodePrediction(scores[batch_num * SafeInt<ptrdiff_t>(N) + i],
-                                                *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+                                                *leaves[SafeInt<ptrdiff_t>(i - begin_n)], weights_);
                 }
               }
             });
@@ -614,8 +985,8 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
 
             for (auto i = work.start; i < work.end; ++i) {
               std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
-              for (j = 0, limit = roots_.size(); j < limit; ++j) {
-                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(roots_[j], x_data + i * stride), weights_);
+              for (j = 0, limit = static_cast<size_t>(n_trees_); j < limit; ++j) {
+                agg.ProcessTreeNodePrediction(scores, *ProcessTreeNodeLeave(static_cast<size_t>(j), x_data + i * stride), weights_);
               }
 
               agg.FinalizeScores(scores,
@@ -627,6 +998,75 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggQuickScorer(
+    concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+    int64_t* label_data, int64_t N, int64_t stride, const AGG& agg) const {
+  // Every row evaluates all trees at once, the computation is parallelized by rows.
+  auto num_threads = N <= parallel_N_
+                         ? 1
+                         : std::min<int32_t>(concurrency::ThreadPool::DegreeOfParallelism(ttp), SafeInt<int32_t>(N));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      ttp,
+      num_threads,
+      [this, &agg, num_threads, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+        std::vector<uint64_t> bitvectors(onnxruntime::narrow<size_t>(n_trees_));
+        InlinedVector<ScoreValue<ThresholdType>> scores;
+        if (n_targets_or_classes_ != 1) {
+          scores.resize(onnxruntime::narrow<size_t>(n_targets_or_classes_));
+        }
+        auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, onnxruntime::narrow<ptrdiff_t>(N));
+        for (auto i = work.start; i < work.end; ++i) {
+          ProcessQuickScorerBitVectors(x_data + i * stride, bitvectors.data());
+          if (n_targets_or_classes_ == 1) {
+            ScoreValue<ThresholdType> score = {0, 0};
+            for (size_t j = 0, limit = bitvectors.size(); j < limit; ++j) {
+              agg.ProcessTreeNodePrediction1(score, *qs_leaves_[qs_leaf_offsets_[j] + LowestBitIndex(bitvectors[j])]);
+            }
+            agg.FinalizeScores1(z_data + i, score, label_data == nullptr ? nullptr : (label_data + i));
+          } else {
+            std::fill(scores.begin(), scores.end(), ScoreValue<ThresholdType>({0, 0}));
+            for (size_t j = 0, limit = bitvectors.size(); j < limit; ++j) {
+              agg.ProcessTreeNodePrediction(scores, *qs_leaves_[qs_leaf_offsets_[j] + LowestBitIndex(bitvectors[j])],
+                                            weights_);
+            }
+            agg.FinalizeScores(scores, z_data + i * n_targets_or_classes_, -1,
+                               label_data == nullptr ? nullptr : (label_data + i));
+          }
+        }
+      });
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessQuickScorerBitVectors(
+    const InputType* x_data, uint64_t* bitvectors) const {
+  std::fill(bitvectors, bitvectors + n_trees_, ~static_cast<uint64_t>(0));
+  const ThresholdType* thresholds = qs_thresholds_.data();
+  const uint32_t* tree_ids = qs_tree_ids_.data();
+  const uint64_t* masks = qs_masks_.data();
+  // Conditions are sorted by threshold, a condition is false (the row goes
+  // to the false branch) as long as the feature is not below the threshold.
+  // NaN values are never below a threshold and always follow the false branch.
+  InputType val;
+  uint32_t k, end;
+  if (branch_mode_ != NODE_MODE::BRANCH_LT) {
+    for (size_t f = 0, limit = qs_feature_offsets_.size() - 1; f < limit; ++f) {
+      val = x_data[f];
+      for (k = qs_feature_offsets_[f], end = qs_feature_offsets_[f + 1]; k < end && !(val <= thresholds[k]); ++k) {
+        bitvectors[tree_ids[k]] &= masks[k];
+      }
+    }
+  } else {
+    for (size_t f = 0, limit = qs_feature_offsets_.size() - 1; f < limit; ++f) {
+      val = x_data[f];
+      for (k = qs_feature_offsets_[f], end = qs_feature_offsets_[f + 1]; k < end && !(val < thresholds[k]); ++k) {
+        bitvectors[tree_ids[k]] &= masks[k];
+      }
+    }
+  }
+}
+
 #define TREE_FIND_VALUE(CMP)                                         \
   if (has_missing_tracks_) {                                         \
     while (root->is_not_leaf()) {                                    \
@@ -735,6 +1175,156 @@ TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
   return root;
 }
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+const TreeNodeElement<ThresholdType>*
+TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeave(
+    size_t tree, const InputType* x_data) const {
+  if (!use_compact_layout_) {
+    return ProcessTreeNodeLeave(roots_[tree], x_data);
+  }
+  switch (branch_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      return ProcessTreeNodeLeaveCompact(tree, x_data, std::less_equal<>());
+    case NODE_MODE::BRANCH_LT:
+      return ProcessTreeNodeLeaveCompact(tree, x_data, std::less<>());
+    case NODE_MODE::BRANCH_GTE:
+      return ProcessTreeNodeLeaveCompact(tree, x_data, std::greater_equal<>());
+    case NODE_MODE::BRANCH_GT:
+      return ProcessTreeNodeLeaveCompact(tree, x_data, std::greater<>());
+    case NODE_MODE::BRANCH_EQ:
+      return ProcessTreeNodeLeaveCompact(tree, x_data, std::equal_to<>());
+    case NODE_MODE::BRANCH_NEQ:
+      return ProcessTreeNodeLeaveCompact(tree, x_data, std::not_equal_to<>());
+    case NODE_MODE::LEAF:
+    default:
+      // every root is a leaf
+      return nodes_.data() + compact_nodes_[compact_roots_[tree]].far_node_or_leaf;
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename CMP>
+const TreeNodeElement<ThresholdType>*
+TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeaveCompact(
+    size_t tree, const InputType* x_data, CMP cmp) const {
+  const TreeNodeElementCompact<ThresholdType>* nodes = compact_nodes_.data();
+  const TreeNodeElementCompact<ThresholdType>* node = nodes + compact_roots_[tree];
+  InputType val;
+  bool cond;
+  if (has_missing_tracks_) {
+    while (node->is_not_leaf()) {
+      val = x_data[node->feature_id];
+      cond = cmp(val, node->threshold) || (node->is_missing_track_true() && _isnan_(val));
+      node = cond != node->is_far_true() ? node + 1 : nodes + node->far_node_or_leaf;
+    }
+  } else {
+    while (node->is_not_leaf()) {
+      cond = cmp(x_data[node->feature_id], node->threshold);
+      node = cond != node->is_far_true() ? node + 1 : nodes + node->far_node_or_leaf;
+    }
+  }
+  return nodes_.data() + node->far_node_or_leaf;
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeaves(
+    size_t tree, const InputType* x_data, int64_t stride, size_t n_rows,
+    const TreeNodeElement<ThresholdType>** leaves) const {
+  if (!use_node_arrays_) {
+    for (size_t i = 0; i < n_rows; ++i) {
+      leaves[i] = ProcessTreeNodeLeave(tree, x_data + i * stride);
+    }
+    return;
+  }
+  switch (branch_mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      ProcessTreeNodeLeavesBatch(tree, x_data, stride, n_rows, leaves, std::less_equal<>());
+      break;
+    case NODE_MODE::BRANCH_LT:
+      ProcessTreeNodeLeavesBatch(tree, x_data, stride, n_rows, leaves, std::less<>());
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      ProcessTreeNodeLeavesBatch(tree, x_data, stride, n_rows, leaves, std::greater_equal<>());
+      break;
+    case NODE_MODE::BRANCH_GT:
+      ProcessTreeNodeLeavesBatch(tree, x_data, stride, n_rows, leaves, std::greater<>());
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      ProcessTreeNodeLeavesBatch(tree, x_data, stride, n_rows, leaves, std::equal_to<>());
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      ProcessTreeNodeLeavesBatch(tree, x_data, stride, n_rows, leaves, std::not_equal_to<>());
+      break;
+    case NODE_MODE::LEAF:
+      // Every tree is a single leaf.
+      for (size_t i = 0; i < n_rows; ++i) {
+        leaves[i] = roots_[tree];
+      }
+      break;
+  }
+}
+
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename CMP>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ProcessTreeNodeLeavesBatch(
+    size_t tree, const InputType* x_data, int64_t stride, size_t n_rows,
+    const TreeNodeElement<ThresholdType>** leaves, CMP cmp) const {
+  // Rows are processed by blocks of kBlockSize. Every step moves all rows
+  // of a block one level down the tree, the inner loop does not contain any
+  // data-dependent branch, the compiler is free to vectorize it (gathers)
+  // and the processor to interleave the memory accesses of all rows.
+  // The walk stops when all rows of the block have reached a leaf.
+  constexpr size_t kBlockSize = 16;
+  const int* feature_ids = node_feature_ids_.data();
+  const ThresholdType* thresholds = node_thresholds_.data();
+  const uint32_t* children = node_children_.data();
+  const uint8_t* missing_tracks = node_missing_tracks_.data();
+  const uint32_t root = static_cast<uint32_t>(roots_[tree] - nodes_.data());
+  const uint32_t depth = tree_depths_[tree];
+  uint32_t ids[kBlockSize];
+  InputType val;
+  uint32_t id;
+  bool cond;
+
+  for (size_t begin = 0; begin < n_rows; begin += kBlockSize) {
+    const size_t n = std::min(kBlockSize, n_rows - begin);
+    const InputType* x = x_data + begin * stride;
+    for (size_t r = 0; r < n; ++r) {
+      ids[r] = root;
+    }
+    if (has_missing_tracks_) {
+      for (uint32_t d = 0; d < depth; ++d) {
+        uint32_t moved = 0;
+        for (size_t r = 0; r < n; ++r) {
+          id = ids[r];
+          val = x[r * stride + feature_ids[id]];
+          cond = cmp(val, thresholds[id]) || (missing_tracks[id] && _isnan_(val));
+          ids[r] = children[2 * id + (cond ? 0 : 1)];
+          moved |= ids[r] ^ id;
+        }
+        if (moved == 0) {
+          break;
+        }
+      }
+    } else {
+      for (uint32_t d = 0; d < depth; ++d) {
+        uint32_t moved = 0;
+        for (size_t r = 0; r < n; ++r) {
+          id = ids[r];
+          ids[r] = children[2 * id + (cmp(x[r * stride + feature_ids[id]], thresholds[id]) ? 0 : 1)];
+          moved |= ids[r] ^ id;
+        }
+        if (moved == 0) {
+          break;
+        }
+      }
+    }
+    for (size_t r = 0; r < n; ++r) {
+      leaves[begin + r] = nodes_.data() + ids[r];
+    }
+  }
+}
+
 // TI: input type
 // TH: threshold type, double if T==double, float otherwise
 // TO: output type
@@ -788,6 +1378,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::Init(
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "nodes_values_as_tensor", nodes_values_as_tensor));
   ORT_THROW_IF_ERROR(GetVectorAttrsOrDefault(info, "class_weights_as_tensor", class_weights_as_tensor));
 #endif
+  this->compact_layout_ = UseCompactTreeLayout(info);
 
   return Init(
       80,
@@ -901,7 +1492,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::compu
     this->ComputeAgg(
         ctx->GetOperatorThreadPool(), X, Z, label,
         TreeAggregatorClassifier<InputType, ThresholdType, OutputType>(
-            this->roots_.size(), this->n_targets_or_classes_,
+            static_cast<size_t>(this->n_trees_), this->n_targets_or_classes_,
             this->post_transform_, this->base_values_,
             classlabels_int64s_, binary_case_,
             weights_are_all_positive_));
@@ -913,7 +1504,7 @@ Status TreeEnsembleCommonClassifier<InputType, ThresholdType, OutputType>::compu
     this->ComputeAgg(
         ctx->GetOperatorThreadPool(), X, Z, &label_int64,
         TreeAggregatorClassifier<InputType, ThresholdType, OutputType>(
-            this->roots_.size(), this->n_targets_or_classes_,
+            static_cast<size_t>(this->n_trees_), this->n_targets_or_classes_,
             this->post_transform_, this->base_values_,
             class_labels_, binary_case_,
             weights_are_all_positive_));
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/ml/tree_ensemble_helper.h"
 #include "core/common/common.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "onnx/defs/tensor_proto_util.h"
 
 using namespace ::onnxruntime::common;
@@ -62,5 +63,11 @@ Status GetVectorAttrsOrDefault(const OpKernelInfo& info, const std::string& name
   return GetVectorAttrsOrDefault(info, name, ONNX_NAMESPACE::TensorProto_DataType::TensorProto_DataType_FLOAT, data);
 }
 
+bool UseCompactTreeLayout(const OpKernelInfo& info) {
+  const auto* provider = info.GetExecutionProvider();
+  return provider->Type() == kCpuExecutionProvider &&
+         static_cast<const CPUExecutionProvider*>(provider)->GetInfo().tree_ensemble_compact_layout;
+}
+
 }  // namespace ml
 }  // namespace onnxruntime
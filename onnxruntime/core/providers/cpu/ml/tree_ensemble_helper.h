@@ -11,5 +11,8 @@ namespace ml {
 Status GetVectorAttrsOrDefault(const OpKernelInfo& info, const std::string& name, std::vector<double>& data);
 Status GetVectorAttrsOrDefault(const OpKernelInfo& info, const std::string& name, std::vector<float>& data);
 
+// Tells if the CPU execution provider running the kernel requests the compact layout for the trees.
+bool UseCompactTreeLayout(const OpKernelInfo& info);
+
 }  // namespace ml
 }  // namespace onnxruntime
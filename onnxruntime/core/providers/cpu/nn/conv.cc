@@ -153,6 +153,80 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  if (input_idx != 1) {
+    return Status::OK();
+  }
+
+  const auto& shape = tensor.Shape();
+  if (shape.NumDimensions() != 4 || shape[0] % conv_attrs_.group != 0) {
+    return Status::OK();
+  }
+
+  // invalid attributes are reported by Compute
+  TensorShapeVector kernel_shape;
+  if (!conv_attrs_.ComputeKernelShape(shape, kernel_shape).IsOK()) {
+    return Status::OK();
+  }
+
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+  if (dilations.size() != kernel_shape.size() || strides.size() != kernel_shape.size()) {
+    return Status::OK();
+  }
+
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t group_input_channels = static_cast<size_t>(shape[1]);
+  const size_t group_output_channels = static_cast<size_t>(shape[0]) / group_count;
+
+  if (!MlasConvWinogradIsSupported(kernel_shape.size(), kernel_shape.data(), dilations.data(), strides.data(),
+                                   group_input_channels, group_output_channels)) {
+    return Status::OK();
+  }
+
+  // MlasConvPrepare always selects the Winograd algorithm for such a filter, the filter input is released
+  filter_shape_ = shape;
+
+  const size_t packed_size = MlasConvWinogradPackWSize(group_count, group_input_channels, group_output_channels);
+  const size_t packed_W_size = SafeInt<size_t>(packed_size) * sizeof(float);
+  auto* packed_W = static_cast<float*>(alloc->Alloc(packed_W_size));
+  winograd_filter_ = BufferUniquePtr(packed_W, BufferDeleter(std::move(alloc)));
+
+  MlasConvWinogradPackW(group_count, group_input_channels, group_output_channels, tensor.Data<float>(), packed_W);
+
+  bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (share_prepacked_weights) {
+    prepacked_weights->buffers_.push_back(std::move(winograd_filter_));
+    prepacked_weights->buffer_sizes_.push_back(packed_W_size);
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    winograd_filter_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
@@ -161,12 +235,14 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  // W is null if PrePack replaced it with the filter transformed for the Winograd algorithm
+  const TensorShape& W_shape = W != nullptr ? W->Shape() : filter_shape_;
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -231,15 +307,19 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &activation_,
                     &WorkingBufferSize,
                     Beta,
+                    winograd_filter_ != nullptr,
                     thread_pool);
 
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
                                                : nullptr;
     BufferUniquePtr working_buffer(working_data, BufferDeleter(std::move(alloc)));
 
+    const float* Wdata = winograd_filter_ != nullptr ? static_cast<const float*>(winograd_filter_.get())
+                                                     : W->Data<float>();
+
     MlasConv(&Parameters,
              Xdata,
-             W->Data<float>(),
+             Wdata,
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata,
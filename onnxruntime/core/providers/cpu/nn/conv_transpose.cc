@@ -114,6 +114,40 @@ Status ConvTranspose<float>::UseSharedPrePackedBuffers(std::vector<BufferUniqueP
   return Status::OK();
 }
 
+template <typename T>
+Status ConvTranspose<T>::UsePersistedPrePackedBuffers(const Tensor& /*tensor*/,
+                                                      std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
+                                                      int /*input_idx*/,
+                                                      /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+  return Status::OK();
+}
+
+template <>
+Status ConvTranspose<float>::UsePersistedPrePackedBuffers(const Tensor& tensor,
+                                                          std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                          int input_idx,
+                                                          /*out*/ bool& used_persisted_buffers) {
+  ORT_RETURN_IF_ERROR(UseSharedPrePackedBuffers(prepacked_buffers, input_idx, used_persisted_buffers));
+
+  // restore the filter shape PrePack() keeps for Compute()
+  if (used_persisted_buffers) {
+    filter_shape_ = tensor.Shape();
+  }
+
+  return Status::OK();
+}
+
+template <typename T>
+bool ConvTranspose<T>::CanUsePersistedPrePackedBuffers(int /*input_idx*/) const {
+  return false;
+}
+
+template <>
+bool ConvTranspose<float>::CanUsePersistedPrePackedBuffers(int input_idx) const {
+  return input_idx == 1;
+}
+
 template <typename T>
 Status ConvTranspose<T>::Compute(OpKernelContext* context) const {
   return ConvTranspose<T>::DoConvTranspose(context, false);
@@ -35,6 +35,11 @@ class ConvTranspose : public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx, /*out*/ bool& used_persisted_buffers) override;
+
+  bool CanUsePersistedPrePackedBuffers(int input_idx) const override;
+
   Status Compute(OpKernelContext* context) const override;
 
  protected:
@@ -3,6 +3,7 @@
 
 #include "string_normalizer.h"
 #include "core/common/common.h"
+#include "core/common/utf8_util.h"
 #include "core/framework/tensor.h"
 
 #ifdef _MSC_VER
@@ -192,12 +193,38 @@ const std::string default_locale("en_US.UTF-8");  // All non-MS
 
 #endif  // MS_VER
 
+inline bool IsAscii(const std::string& s) {
+  return utf8_util::ascii_prefix_len(reinterpret_cast<const unsigned char*>(s.data()), s.size()) == s.size();
+}
+
+// Returns true if loc changes the case of ASCII chars only within A-Z and a-z.
+// This is not the case for Turkish locales that map 'I' to a dotless 'ı'.
+bool ChangesAsciiCaseLikeC(const Locale& loc) {
+  std::wstring lower;
+  for (wchar_t ch = 0; ch < 0x80; ++ch) {
+    lower.push_back(ch);
+  }
+  std::wstring upper(lower);
+  loc.ChangeCase(StringNormalizer::LOWER, lower);
+  loc.ChangeCase(StringNormalizer::UPPER, upper);
+  for (wchar_t ch = 0; ch < 0x80; ++ch) {
+    const bool is_upper = ch >= L'A' && ch <= L'Z';
+    const bool is_lower = ch >= L'a' && ch <= L'z';
+    const wchar_t other_case = static_cast<wchar_t>(ch ^ 0x20);
+    if (lower[ch] != (is_upper ? other_case : ch) || upper[ch] != (is_lower ? other_case : ch)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 template <class ForwardIter>
 Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
                       const Locale& loc,
                       Utf8Converter& converter,
                       size_t N, size_t C,
-                      StringNormalizer::CaseAction caseaction) {
+                      StringNormalizer::CaseAction caseaction,
+                      bool ascii_case_change) {
   std::vector<int64_t> output_dims;
   if (N == 1) {
     output_dims.push_back(1);
@@ -221,7 +248,12 @@ Status CopyCaseAction(ForwardIter first, ForwardIter end, OpKernelContext* ctx,
   size_t output_idx = 0;
   while (first != end) {
     auto& s = *first;
-    if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
+    if ((caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) &&
+        ascii_case_change && IsAscii(s)) {
+      std::string& output = *(output_data + output_idx);
+      output = s;
+      utf8_util::ascii_change_case(output.data(), output.size(), caseaction == StringNormalizer::UPPER);
+    } else if (caseaction == StringNormalizer::LOWER || caseaction == StringNormalizer::UPPER) {
       std::wstring wstr = converter.from_bytes(s);
       if (wstr == wconv_error) {
         // Please do not include the input text in the error message as it could
@@ -249,7 +281,8 @@ using namespace string_normalizer;
 StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
                                                                is_case_sensitive_(true),
                                                                case_change_action_(NONE),
-                                                               compare_caseaction_(NONE) {
+                                                               compare_caseaction_(NONE),
+                                                               ascii_case_change_(false) {
   int64_t iscasesensitive = 0;
   Status status = info.GetAttr("is_case_sensitive", &iscasesensitive);
   ORT_ENFORCE(status.IsOK(), "attribute is_case_sensitive is not set");
@@ -273,8 +306,8 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     compare_caseaction_ = (case_change_action_ == UPPER) ? UPPER : LOWER;
   }
 
-  locale_name_ = info.GetAttrOrDefault("locale", default_locale);
-  Locale locale(locale_name_);
+  locale_ = std::make_unique<Locale>(info.GetAttrOrDefault("locale", default_locale));
+  ascii_case_change_ = ChangesAsciiCaseLikeC(*locale_);
   Utf8Converter converter(conv_error, wconv_error);
 
   std::vector<std::string> swords = info.GetAttrsOrDefault<std::string>("stopwords");
@@ -286,13 +319,16 @@ StringNormalizer::StringNormalizer(const OpKernelInfo& info) : OpKernel(info),
     } else {
       std::wstring wstr = converter.from_bytes(sw);
       ORT_ENFORCE(wstr != wconv_error, "Stopword contains invalid utf8 chars");
-      locale.ChangeCase(compare_caseaction_, wstr);
+      locale_->ChangeCase(compare_caseaction_, wstr);
+      stopwords_.insert(converter.to_bytes(wstr));
       auto p = wstopwords_.insert(std::move(wstr));
       ORT_ENFORCE(p.second, "Duplicate stopwords not allowed");
     }
   }
 }
 
+StringNormalizer::~StringNormalizer() = default;
+
 Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   using namespace string_normalizer;
 
@@ -321,7 +357,7 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
   }
 
   Status status;
-  Locale locale(locale_name_);
+  const Locale& locale = *locale_;
   Utf8Converter converter(conv_error, wconv_error);
   auto* const input_data = X->Data<std::string>();
   using StrRef = std::reference_wrapper<const std::string>;
@@ -339,10 +375,11 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
         ++first;
       }
       status = CopyCaseAction(filtered_strings.cbegin(), filtered_strings.cend(), ctx, locale, converter,
-                              N, filtered_strings.size(), case_change_action_);
+                              N, filtered_strings.size(), case_change_action_, ascii_case_change_);
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_,
+                              ascii_case_change_);
     }
   } else {
     if (!wstopwords_.empty()) {
@@ -353,10 +390,24 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       InlinedVector<std::string> filtered_cased_strings;
       filtered_orignal_strings.reserve(C);
       filtered_cased_strings.reserve(C);
+      std::string cased;
       auto first = input_data;
       auto const last = input_data + C;
       while (first != last) {
         const std::string& s = *first;
+        if (ascii_case_change_ && IsAscii(s)) {
+          cased = s;
+          utf8_util::ascii_change_case(cased.data(), cased.size(), compare_caseaction_ == UPPER);
+          if (0 == stopwords_.count(cased)) {
+            if (case_change_action_ == NONE) {
+              filtered_orignal_strings.push_back(std::cref(s));
+            } else {
+              filtered_cased_strings.push_back(cased);
+            }
+          }
+          ++first;
+          continue;
+        }
         std::wstring wstr = converter.from_bytes(s);
         if (wstr == wconv_error) {
           // Please do not include the input text in the error message as it could
@@ -376,14 +427,15 @@ Status StringNormalizer::Compute(OpKernelContext* ctx) const {
       }
       if (case_change_action_ == NONE) {
         status = CopyCaseAction(filtered_orignal_strings.cbegin(), filtered_orignal_strings.cend(), ctx, locale, converter,
-                                N, filtered_orignal_strings.size(), NONE);
+                                N, filtered_orignal_strings.size(), NONE, ascii_case_change_);
       } else {
         status = CopyCaseAction(filtered_cased_strings.begin(), filtered_cased_strings.end(), ctx, locale, converter,
-                                N, filtered_cased_strings.size(), NONE);
+                                N, filtered_cased_strings.size(), NONE, ascii_case_change_);
       }
     } else {
       // Nothing to filter. Copy input to output and change case if needed
-      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_);
+      status = CopyCaseAction(input_data, input_data + C, ctx, locale, converter, N, C, case_change_action_,
+                              ascii_case_change_);
     }
   }
   return status;
@@ -7,10 +7,15 @@
 #include "core/framework/op_kernel.h"
 
 #include <locale>
+#include <memory>
 #include <string>
 
 namespace onnxruntime {
 
+namespace string_normalizer {
+class Locale;
+}  // namespace string_normalizer
+
 class StringNormalizer : public OpKernel {
  public:
   enum CaseAction {
@@ -20,7 +25,7 @@ class StringNormalizer : public OpKernel {
   };
 
   explicit StringNormalizer(const OpKernelInfo& info);
-  ~StringNormalizer() override = default;
+  ~StringNormalizer() override;
 
   Status Compute(OpKernelContext* ctx) const override;
 
@@ -28,8 +33,12 @@ class StringNormalizer : public OpKernel {
   bool is_case_sensitive_;
   CaseAction case_change_action_;
   CaseAction compare_caseaction_;  // used for case-insensitive compare
-  std::string locale_name_;
-  // Either if these are populated but not both
+  std::unique_ptr<string_normalizer::Locale> locale_;
+  // True if the locale changes the case of ASCII chars the same way as the C locale,
+  // then ASCII strings skip the conversion to wide chars.
+  bool ascii_case_change_;
+  // Case-insensitive stopwords are stored in both with compare_caseaction_ applied,
+  // wstopwords_ is empty when case-sensitive.
   InlinedHashSet<std::string> stopwords_;
   InlinedHashSet<std::wstring> wstopwords_;
 };
@@ -6,7 +6,9 @@
 #include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
 
+#include <algorithm>
 #include <functional>
+#include <limits>
 #include <unordered_map>
 #include <core/common/safeint.h>
 
@@ -24,62 +26,130 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
-template <class T>
-struct NgramPart;
+// NgramTrie is a trie of all the n-grams of the pool, stored in two flat arrays.
+// Nodes are numbered in insertion order, the root is node 0. Every edge (parent node, label) -> child node
+// lives in a single open addressing hash table, so following an edge is one hash and usually one probe
+// instead of a lookup in a per node map.
+// For a unigram (1) the root gets a child with a valid n-gram id.
+// For (1,2,3) node 2 is a child of 1 but has id == 0 because (1,2) does not exist. Node 3 has a valid id.
+// Labels are the int64 values of the pool, or the indexes of the pool strings in a vocabulary.
+class NgramTrie {
+ public:
+  NgramTrie() : nodes_(1), edges_(kMinEdges), edge_mask_(kMinEdges - 1) {}
+
+  bool Empty() const { return nodes_.size() == 1; }
+
+  // Adds the n-gram of length ngram_size starting at labels, returns false if it is already in the trie.
+  bool Insert(const int64_t* labels, size_t ngram_size, size_t ngram_id) {
+    uint32_t node = kRoot;
+    for (size_t n = 0; n < ngram_size; ++n) {
+      node = AddChild(node, labels[n]);
+    }
+    if (nodes_[node].ngram_id != 0) {
+      return false;
+    }
+    nodes_[node].ngram_id = ngram_id;
+    return true;
+  }
 
-template <>
-struct NgramPart<int64_t>;
+  bool HasChildren(uint32_t node) const { return nodes_[node].num_children != 0; }
 
-template <>
-struct NgramPart<std::string>;
+  // 0 - means no entry, search for a bigger N
+  size_t NgramId(uint32_t node) const { return nodes_[node].ngram_id; }
 
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
+  // Returns the child of node with label or kRoot if there is none.
+  uint32_t Child(uint32_t node, int64_t label) const {
+    for (size_t slot = Slot(node, label);; slot = (slot + 1) & edge_mask_) {
+      const Edge& edge = edges_[slot];
+      if (edge.child == kRoot || (edge.label == label && edge.parent == node)) {
+        return edge.child;
+      }
+    }
+  }
 
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = std::unordered_map<int64_t, std::unique_ptr<NgramPartInt>>;
+  static constexpr uint32_t kRoot = 0;
 
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
+ private:
+  static constexpr size_t kMinEdges = 16;
 
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+  struct Node {
+    size_t ngram_id = 0;
+    uint32_t num_children = 0;
+  };
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+  // child == kRoot marks an empty slot as the root is nobody's child
+  struct Edge {
+    int64_t label = 0;
+    uint32_t parent = kRoot;
+    uint32_t child = kRoot;
+  };
 
-// Returns next ngram_id
-template <class K, class ForwardIter, class Map>
-inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
-  for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
+  size_t Slot(uint32_t parent, int64_t label) const {
+    // finalizer of splitmix64
+    uint64_t h = static_cast<uint64_t>(label) ^ (uint64_t{parent} * 0x9e3779b97f4a7c15ULL);
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return static_cast<size_t>(h) & edge_mask_;
+  }
+
+  uint32_t AddChild(uint32_t node, int64_t label) {
+    uint32_t child = Child(node, label);
+    if (child != kRoot) {
+      return child;
+    }
+
+    ORT_ENFORCE(nodes_.size() < std::numeric_limits<uint32_t>::max(), "Too many n-grams in the pool");
+    child = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    ++nodes_[node].num_children;
+
+    // edges are at most half of the slots so that the probe sequences stay short
+    if (2 * (nodes_.size() - 1) > edges_.size()) {
+      Grow();
+    }
+    InsertEdge(Edge{label, node, child});
+    return child;
+  }
+
+  void InsertEdge(const Edge& edge) {
+    size_t slot = Slot(edge.parent, edge.label);
+    while (edges_[slot].child != kRoot) {
+      slot = (slot + 1) & edge_mask_;
+    }
+    edges_[slot] = edge;
+  }
+
+  void Grow() {
+    std::vector<Edge> edges(edges_.size() * 2);
+    edges.swap(edges_);
+    edge_mask_ = edges_.size() - 1;
+    for (const Edge& edge : edges) {
+      if (edge.child != kRoot) {
+        InsertEdge(edge);
       }
-      ++n;
-      m = &p.first->second->leafs_;
     }
   }
+
+  std::vector<Node> nodes_;
+  std::vector<Edge> edges_;
+  size_t edge_mask_;
+};
+
+// Maps the pool strings to the labels of the trie
+using StrVocabulary = std::unordered_map<std::reference_wrapper<const std::string>, int64_t,
+                                         std::hash<std::string>, std::equal_to<std::string>>;
+
+// Returns next ngram_id
+inline size_t PopulateGrams(const int64_t* first, size_t ngrams, size_t ngram_size, size_t ngram_id,
+                            NgramTrie& trie) {
+  for (; ngrams > 0; --ngrams, first += ngram_size) {
+    ORT_ENFORCE(trie.Insert(first, ngram_size, ngram_id), "Duplicate ngram detected, size: ", ngram_size,
+                " id: ", ngram_id);
+    ++ngram_id;
+  }
   return ngram_id;
 }
 
@@ -90,10 +160,6 @@ using namespace onnxruntime::ngram_details;
 
 namespace onnxruntime {
 
-inline const void* AdvanceElementPtr(const void* p, size_t elements, size_t element_size) {
-  return reinterpret_cast<const uint8_t*>(p) + elements * element_size;
-}
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -129,10 +195,10 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const float> weights_;
 
   // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // of pool_strings attribute, it is empty for pool_int64s
+  StrVocabulary str_vocabulary_;
+  // All the n-grams of sizes [min_gram_length..max_gram_length]
+  NgramTrie trie_;
 
   size_t output_size_ = 0;
 
@@ -141,15 +207,25 @@ struct TfIdfVectorizer::Impl {
   Impl(const Impl&) = delete;
   Impl& operator=(const Impl&) = delete;
 
-  void IncrementCount(size_t ngram_id, size_t row_num,
-                      std::vector<uint32_t>& frequencies) const {
+  // Counts the n-gram in the output row, output_row holds the counts until ApplyWeights() is called.
+  // hits collects the output indexes with a non zero count.
+  void IncrementCount(size_t ngram_id, float* output_row, std::vector<size_t>& hits) const {
     assert(ngram_id != 0);
     --ngram_id;
     assert(ngram_id < ngram_indexes_.size());
-    size_t output_idx = row_num * output_size_ + SafeInt<size_t>(ngram_indexes_[ngram_id]);
-    assert(output_idx < frequencies.size());
-    ++frequencies[output_idx];
+    const size_t output_idx = SafeInt<size_t>(ngram_indexes_[ngram_id]);
+    assert(output_idx < output_size_);
+    if (output_row[output_idx] == 0) {
+      hits.push_back(output_idx);
+    }
+    output_row[output_idx] += 1;
   }
+
+  // Replaces the counts of the output row with their weighted values
+  void ApplyWeights(float* output_row, const std::vector<size_t>& hits) const;
+
+  // Counts the n-grams of a row of labels into output_row
+  void ComputeRow(const int64_t* labels, size_t row_size, float* output_row, std::vector<size_t>& hits) const;
 };
 
 TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), impl_(std::make_unique<Impl>()) {
@@ -218,8 +294,20 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
     ORT_ENFORCE(status.IsOK() && !pool_int64s.empty(), "non-empty pool_int64s is required if pool_strings not provided");
   }
 
+  // The trie is labeled with int64 values, pool strings are replaced by their index in the vocabulary.
+  std::vector<int64_t> pool_labels;
+  if (!pool_strings.empty()) {
+    impl_->str_vocabulary_.reserve(pool_strings.size());
+    pool_labels.reserve(pool_strings.size());
+    for (const auto& str : pool_strings) {
+      auto p = impl_->str_vocabulary_.emplace(str, static_cast<int64_t>(impl_->str_vocabulary_.size()));
+      pool_labels.push_back(p.first->second);
+    }
+    pool_int64s = pool_labels;
+  }
+
   // Iterator via the pool. Insert 1 item for 1-grams, 2 items for 2-grams, etc.
-  const auto total_items = (pool_strings.empty()) ? pool_int64s.size() : pool_strings.size();
+  const auto total_items = pool_int64s.size();
   size_t ngram_id = 1;  // start with 1, 0 - means no n-gram
   // Load into dictionary only required gram sizes
   const size_t min_gram_length = onnxruntime::narrow<size_t>(impl_->min_gram_length_);
@@ -237,11 +325,7 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       auto ngrams = items / ngram_size;
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
-        if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
-        } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
-        }
+        ngram_id = PopulateGrams(pool_int64s.data() + start_idx, ngrams, ngram_size, ngram_id, impl_->trie_);
       } else {
         ngram_id += ngrams;
       }
@@ -252,56 +336,26 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
 
 TfIdfVectorizer::~TfIdfVectorizer() = default;
 
-void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::vector<uint32_t>& frequences) const {
-  const Impl& impl = *impl_;
-  std::vector<int64_t> output_dims;
-  if (B == 0) {
-    output_dims.push_back(impl.output_size_);
-    B = 1;  // For use in the loops below
-  } else {
-    output_dims.push_back(B);
-    output_dims.push_back(impl.output_size_);
-  }
-
-  const auto row_size = impl.output_size_;
-
-  TensorShape output_shape(output_dims);
-  assert(frequences.size() == static_cast<size_t>(output_shape.Size()));
-
-  auto Y = ctx->Output(0, output_shape);
-  auto output_data = Y->MutableData<float>();
-  const auto& w = impl.weights_;
-  switch (impl.weighting_criteria_) {
-    case kTF: {
-      for (auto f : frequences) {
-        *output_data++ = static_cast<float>(f);
-      }
-    } break;
+void TfIdfVectorizer::Impl::ApplyWeights(float* output_row, const std::vector<size_t>& hits) const {
+  const auto& w = weights_;
+  switch (weighting_criteria_) {
+    case kTF:
+      break;
     case kIDF: {
       if (!w.empty()) {
-        const auto* freqs = frequences.data();
-        for (size_t batch = 0; batch < B; ++batch) {
-          for (size_t i = 0; i < row_size; ++i) {
-            *output_data++ = (*freqs++ > 0) ? w[i] : 0;
-          }
+        for (auto i : hits) {
+          output_row[i] = w[i];
         }
       } else {
-        for (auto f : frequences) {
-          *output_data++ = (f > 0) ? 1.0f : 0;
+        for (auto i : hits) {
+          output_row[i] = 1.0f;
         }
       }
     } break;
     case kTFIDF: {
       if (!w.empty()) {
-        const auto* freqs = frequences.data();
-        for (size_t batch = 0; batch < B; ++batch) {
-          for (size_t i = 0; i < row_size; ++i) {
-            *output_data++ = *freqs++ * w[i];
-          }
-        }
-      } else {
-        for (auto f : frequences) {
-          *output_data++ = static_cast<float>(f);
+        for (auto i : hits) {
+          output_row[i] *= w[i];
         }
       }
     } break;
@@ -311,68 +365,39 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
   }
 }
 
-void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
-                                  std::vector<uint32_t>& frequencies) const {
-  auto X = ctx->Input<Tensor>(0);
-  const auto elem_size = X->DataType()->Size();
-
-  const void* const row_begin = AdvanceElementPtr(X->DataRaw(), row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
-
-  const auto& impl = *impl_;
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
+void TfIdfVectorizer::Impl::ComputeRow(const int64_t* labels, size_t row_size, float* output_row,
+                                       std::vector<size_t>& hits) const {
+  const auto max_gram_length = max_gram_length_;
+  const auto max_skip_distance = max_skip_count_ + 1;  // Convert to distance
+  auto start_ngram_size = min_gram_length_;
 
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
+  for (int64_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+    const size_t skip = onnxruntime::narrow<size_t>(skip_distance);
 
-    while (ngram_start < ngram_row_end) {
-      // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, SafeInt<size_t>(skip_distance) * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
-        break;
-      }
-
-      auto ngram_item = ngram_start;
-      if (X->IsDataTypeString()) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          str_map = &hit->second->leafs_;
+    // The n-grams starting at or after ngram_row_end don't fit in the row,
+    // and neither do they for any bigger skip distance
+    const size_t span = SafeInt<size_t>(skip) * (start_ngram_size - 1);
+    if (span >= row_size) {
+      break;
+    }
+    const size_t ngram_row_end = row_size - span;
+
+    for (size_t ngram_start = 0; ngram_start < ngram_row_end; ++ngram_start) {
+      uint32_t node = NgramTrie::kRoot;
+      size_t item = ngram_start;
+      for (int64_t ngram_size = 1; ngram_size <= max_gram_length && trie_.HasChildren(node); ++ngram_size) {
+        node = trie_.Child(node, labels[item]);
+        if (node == NgramTrie::kRoot) {
+          break;
         }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (X->IsDataType<int32_t>()) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
-            break;
-          }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          int_map = &hit->second->leafs_;
+        if (ngram_size >= start_ngram_size && trie_.NgramId(node) != 0) {
+          IncrementCount(trie_.NgramId(node), output_row, hits);
+        }
+        if (row_size - item <= skip) {
+          break;
         }
+        item += skip;
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
     }
     // We count UniGrams only once since they are not affected
     // by skip distance
@@ -380,6 +405,8 @@ void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_
       break;
     }
   }
+
+  ApplyWeights(output_row, hits);
 }
 
 Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
@@ -387,7 +414,7 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   auto& input_shape = X->Shape();
   const size_t total_items = onnxruntime::narrow<size_t>(input_shape.Size());
 
-  int32_t num_rows = 0;
+  size_t num_rows = 0;
   size_t B = 0;
   size_t C = 0;
   auto input_dims = input_shape.GetDims();
@@ -401,7 +428,7 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   } else if (input_dims.size() == 2) {
     B = onnxruntime::narrow<size_t>(input_dims[0]);
     C = onnxruntime::narrow<size_t>(input_dims[1]);
-    num_rows = static_cast<int32_t>(B);
+    num_rows = B;
     if (B < 1) {
       return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
                     "Input shape must have either [C] or [B,C] dimensions with B > 0.");
@@ -412,30 +439,66 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   }
 
   assert((num_rows * C) == total_items);
-  // Frequency holder allocate [B..output_size_]
-  // and init all to zero
-  std::vector<uint32_t> frequencies;
-  frequencies.resize(num_rows * impl_->output_size_, 0);
-
-  if (total_items == 0 ||
-      (X->IsDataTypeString() && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+  const Impl& impl = *impl_;
+
+  std::vector<int64_t> output_dims;
+  if (B == 0) {
+    output_dims.push_back(impl.output_size_);
+  } else {
+    output_dims.push_back(B);
+    output_dims.push_back(impl.output_size_);
+  }
+
+  // Most of the output is zero as a row only contains a few of the n-grams of the pool.
+  // Rows are counted straight into the zeroed output and only the hit entries are weighted.
+  auto Y = ctx->Output(0, TensorShape(output_dims));
+  float* output_data = Y->MutableData<float>();
+  std::fill_n(output_data, num_rows * impl.output_size_, 0.0f);
+
+  const bool is_string = X->IsDataTypeString();
+  if (total_items == 0 || impl.trie_.Empty() || is_string == impl.str_vocabulary_.empty()) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
     // {b_dim, output_size} when b_dim is the number of received observations
     // and output_size the is the maximum value in ngram_indexes attribute plus 1.
-    OutputResult(ctx, B, frequencies);
     return Status::OK();
   }
 
-  std::function<void(ptrdiff_t)> fn = [this, ctx, C, &frequencies](ptrdiff_t row_num) {
-    ComputeImpl(ctx, row_num, C, frequencies);
-  };
-
-  concurrency::ThreadPool::TryBatchParallelFor(ctx->GetOperatorThreadPool(), num_rows, std::move(fn), 0);
+  // Every item is looked up at most once per n-gram size and skip distance
+  const double compute_cycles = static_cast<double>(C) * static_cast<double>(impl.max_gram_length_) *
+                                static_cast<double>(std::min<int64_t>(impl.max_skip_count_ + 1, static_cast<int64_t>(C))) * 4.0;
+  const TensorOpCost cost{static_cast<double>(C * X->DataType()->Size()),
+                          static_cast<double>(impl.output_size_ * sizeof(float)), compute_cycles};
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), static_cast<std::ptrdiff_t>(num_rows), cost,
+      [&impl, X, C, output_data, is_string](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // int32 and string rows are converted to the labels of the trie
+        std::vector<int64_t> labels;
+        std::vector<size_t> hits;
+        for (auto row_num = static_cast<size_t>(first); row_num < static_cast<size_t>(last); ++row_num) {
+          const int64_t* row_labels = nullptr;
+          if (is_string) {
+            const std::string* row = X->Data<std::string>() + row_num * C;
+            labels.resize(C);
+            for (size_t i = 0; i < C; ++i) {
+              auto hit = impl.str_vocabulary_.find(row[i]);
+              labels[i] = (hit == impl.str_vocabulary_.end()) ? -1 : hit->second;
+            }
+            row_labels = labels.data();
+          } else if (X->IsDataType<int32_t>()) {
+            const int32_t* row = X->Data<int32_t>() + row_num * C;
+            labels.assign(row, row + C);
+            row_labels = labels.data();
+          } else {
+            row_labels = X->Data<int64_t>() + row_num * C;
+          }
 
-  OutputResult(ctx, B, frequencies);
+          hits.clear();
+          impl.ComputeRow(row_labels, C, output_data + row_num * impl.output_size_, hits);
+        }
+      });
 
   return Status::OK();
 }
@@ -199,6 +199,7 @@ class UniDirectionalGru {
   IAllocatorUniquePtr<T> outputZRH_ptr_;
   gsl::span<T> outputZRH_;
 
+  // rt (.) Ht-1, the input of the GEMM with R[h] if linear_before_reset_ is false
   IAllocatorUniquePtr<T> cur_h_ptr_;
   IAllocatorUniquePtr<T> batched_hidden0_ptr_;
   IAllocatorUniquePtr<int> sequence_lengths_ptr_;
@@ -206,22 +207,25 @@ class UniDirectionalGru {
   gsl::span<T> batched_hidden0_;
   gsl::span<int> sequence_lengths_;
 
-  // Wb[zr] and Rb[zr] can always be added together upfront, and repeated to match the batch size for
-  // faster GEMM calculations, so these two members are all the
-  // Wb[z] + Rb[z] values added together, repeated batch_size_ times
-  IAllocatorUniquePtr<T> batched_bias_WRz_ptr_, batched_bias_WRr_ptr_;
-  gsl::span<T> batched_bias_WRz_, batched_bias_WRr_;
+  // [batch_size, 3*hidden_size] with the z, r and h gates of each block of hidden units next to each other
+  IAllocatorUniquePtr<T> recurrent_gates_ptr_;
+  gsl::span<T> recurrent_gates_;
 
-  // Wbh and Rbh can only be combined upfront if linear_before_reset_ is false
-  IAllocatorUniquePtr<T> batched_bias_WRh_ptr_;
-  gsl::span<T> batched_bias_WRh_;
+  // Ht of odd and even steps when Y isn't requested, as threads owning different hidden units need Ht-1 while Ht is
+  // written
+  IAllocatorUniquePtr<T> hidden_steps_ptr_;
+  gsl::span<T> hidden_steps_;
+
+  // Wb[zr] and Rb[zr] can always be added together upfront
+  IAllocatorUniquePtr<T> bias_WRz_ptr_, bias_WRr_ptr_;
+  gsl::span<T> bias_WRz_, bias_WRr_;
 
-  // if linear_before_reset_ is true, we need to setup Wbh and Rbh separately
-  IAllocatorUniquePtr<T> batched_bias_Wh_ptr_, batched_bias_Rh_ptr_;
-  gsl::span<T> batched_bias_Wh_, batched_bias_Rh_;
+  // Wbh and Rbh can only be combined upfront if linear_before_reset_ is false
+  IAllocatorUniquePtr<T> bias_WRh_ptr_;
+  gsl::span<T> bias_WRh_;
 
-  IAllocatorUniquePtr<T> linear_output_ptr_;
-  gsl::span<T> linear_output_;
+  // if linear_before_reset_ is true, we need to use Wbh and Rbh separately
+  gsl::span<const T> bias_Wh_, bias_Rh_;
 
   IAllocatorUniquePtr<T> inputs_reverse_ptr_;
   IAllocatorUniquePtr<T> outputs_reverse_ptr_;
@@ -241,6 +245,26 @@ class UniDirectionalGru {
 
   void AllocateBuffers();
 
+  // Computes A*R^T for num_gates gates of rows [row, row + num_rows) and the hidden units of block into
+  // recurrent_gates_, starting at first_gate. weights hold those gates for all the hidden units.
+  void ComputeRecurrentBlock(const GemmWeights<T>& weights, int num_gates, int first_gate, const T* A, int row,
+                             int num_rows, int block);
+
+  // Applies all the gates of rows [row, row + num_rows) and the hidden units of block once recurrent_gates_ holds
+  // Ht-1*R[zrh]^T for them, and writes Ht. Used if linear_before_reset_ is true.
+  void LinearBeforeResetBlockGates(gsl::span<const int> seq_lengths, int step, int row, int num_rows, int block,
+                                   const T* previous_state, T* batched_output, bool output_sequence);
+
+  // Computes zt and rt (.) Ht-1 of rows [row, row + num_rows) and the hidden units of block once recurrent_gates_
+  // holds Ht-1*R[zr]^T for them. Used if linear_before_reset_ is false.
+  void ResetBlockGates(gsl::span<const int> seq_lengths, int step, int row, int num_rows, int block,
+                       const T* previous_state);
+
+  // Computes ht and writes Ht of rows [row, row + num_rows) and the hidden units of block once recurrent_gates_
+  // holds (rt (.) Ht-1)*R[h]^T for them. Used if linear_before_reset_ is false.
+  void OutputBlockGates(gsl::span<const int> seq_lengths, int step, int row, int num_rows, int block,
+                        const T* previous_state, T* batched_output, bool output_sequence);
+
   onnxruntime::concurrency::ThreadPool* ttp_;
 };
 }  // namespace detail
@@ -314,21 +338,22 @@ bool DeepCpuGruOp::TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr&
     return false;
   }
 
-  const auto hidden_size_x_2 = N - hidden_size_;
-
-  // We are making two packed buffers, one for ZR weights and another for H weights.
-  const size_t ZR_packed_size = MlasGemmPackBSize(narrow<size_t>(hidden_size_x_2), narrow<size_t>(K));
+  // The weights are packed by blocks of hidden units so the gates of a block are computed right after its part of
+  // the recurrent GEMM, see rnn::detail::kRecurrentBlockSize. With linear_before_reset_ the whole Ht-1*R[zrh]^T of a
+  // block is a single GEMM. Otherwise rt (.) Ht-1 of every hidden unit is needed before applying R[h], so R[zr] and
+  // R[h] are packed in two buffers.
+  const int num_ZR_gates = linear_before_reset_ ? 3 : 2;
+  const size_t ZR_packed_size = PackedRecurrentWeightsSize(num_ZR_gates, hidden_size_);
   if (ZR_packed_size == 0) {
     return false;
   }
 
-  const size_t H_packed_size = MlasGemmPackBSize(narrow<size_t>(hidden_size_), narrow<size_t>(K));
-  if (H_packed_size == 0) {
+  const size_t H_packed_size = linear_before_reset_ ? 0 : PackedRecurrentWeightsSize(1, hidden_size_);
+  if (!linear_before_reset_ && H_packed_size == 0) {
     return false;
   }
-  const size_t buffer_size_ZR = SafeInt<size_t>(ZR_packed_size) * num_directions;
-  const size_t buffer_size_H = SafeInt<size_t>(H_packed_size) * num_directions;
 
+  const size_t buffer_size_ZR = SafeInt<size_t>(ZR_packed_size) * num_directions;
   auto* buffer_ZR = alloc->Alloc(buffer_size_ZR);
   memset(buffer_ZR, 0, buffer_size_ZR);
 
@@ -337,29 +362,31 @@ bool DeepCpuGruOp::TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr&
   pre_packed_recurrent_ZR_.shape_ = shape;  // original shape, not used in prepacked calculations, but useful for validation
   pre_packed_recurrent_ZR_.weights_size_ = ZR_packed_size;
 
-  auto* buffer_H = alloc->Alloc(buffer_size_H);
-  memset(buffer_H, 0, buffer_size_H);
+  void* buffer_H = nullptr;
+  if (!linear_before_reset_) {
+    const size_t buffer_size_H = SafeInt<size_t>(H_packed_size) * num_directions;
+    buffer_H = alloc->Alloc(buffer_size_H);
+    memset(buffer_H, 0, buffer_size_H);
 
-  pre_packed_recurrent_H_.buffer_ = BufferUniquePtr(buffer_H, BufferDeleter(alloc));
-  pre_packed_recurrent_H_.buffer_size_ = buffer_size_H;
-  pre_packed_recurrent_H_.shape_ = shape;  // original shape, not used in prepacked calculations, but useful for validation
-  pre_packed_recurrent_H_.weights_size_ = H_packed_size;
+    pre_packed_recurrent_H_.buffer_ = BufferUniquePtr(buffer_H, BufferDeleter(alloc));
+    pre_packed_recurrent_H_.buffer_size_ = buffer_size_H;
+    pre_packed_recurrent_H_.shape_ = shape;  // original shape, not used in prepacked calculations, but useful for validation
+    pre_packed_recurrent_H_.weights_size_ = H_packed_size;
+  }
 
-  const auto hidden_2_step = hidden_size_x_2 * K;
-  const auto hidden_1_step = hidden_size_ * K;  // square
+  const auto hidden_size_x_2 = 2 * hidden_size_;
+  const size_t direction_step = SafeInt<size_t>(N) * K;
   const auto* weights_data = weights.Data<float>();
-  MlasGemmPackB(CblasTrans, narrow<size_t>(hidden_size_x_2), narrow<size_t>(K), weights_data, narrow<size_t>(K), buffer_ZR);
-  weights_data += hidden_2_step;
-  MlasGemmPackB(CblasTrans, narrow<size_t>(hidden_size_), narrow<size_t>(K), weights_data, narrow<size_t>(K), buffer_H);
-
-  if (num_directions == 2) {
-    weights_data += hidden_1_step;
+  for (int64_t dir = 0; dir < num_directions; ++dir) {
+    PackRecurrentWeights(weights_data, num_ZR_gates, hidden_size_, buffer_ZR);
     buffer_ZR = static_cast<uint8_t*>(buffer_ZR) + ZR_packed_size;
-    MlasGemmPackB(CblasTrans, narrow<size_t>(hidden_size_x_2), narrow<size_t>(K), weights_data, narrow<size_t>(K), buffer_ZR);
 
-    weights_data += hidden_2_step;
-    buffer_H = static_cast<uint8_t*>(buffer_H) + H_packed_size;
-    MlasGemmPackB(CblasTrans, narrow<size_t>(hidden_size_), narrow<size_t>(K), weights_data, narrow<size_t>(K), buffer_H);
+    if (!linear_before_reset_) {
+      PackRecurrentWeights(weights_data + hidden_size_x_2 * K, 1, hidden_size_, buffer_H);
+      buffer_H = static_cast<uint8_t*>(buffer_H) + H_packed_size;
+    }
+
+    weights_data += direction_step;
   }
 
   return true;
@@ -386,8 +413,10 @@ Status DeepCpuGruOp::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr a
       if (is_packed && share_prepacked_weights) {
         prepacked_weights->buffers_.push_back(std::move(pre_packed_recurrent_ZR_.buffer_));
         prepacked_weights->buffer_sizes_.push_back(pre_packed_recurrent_ZR_.buffer_size_);
-        prepacked_weights->buffers_.push_back(std::move(pre_packed_recurrent_H_.buffer_));
-        prepacked_weights->buffer_sizes_.push_back(pre_packed_recurrent_H_.buffer_size_);
+        if (!linear_before_reset_) {
+          prepacked_weights->buffers_.push_back(std::move(pre_packed_recurrent_H_.buffer_));
+          prepacked_weights->buffer_sizes_.push_back(pre_packed_recurrent_H_.buffer_size_);
+        }
       }
     }
   }
@@ -404,13 +433,56 @@ Status DeepCpuGruOp::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pre
     used_shared_buffers = true;
   } else if (input_idx == 2) {
     pre_packed_recurrent_ZR_.buffer_ = std::move(prepacked_buffers[0]);
-    pre_packed_recurrent_H_.buffer_ = std::move(prepacked_buffers[1]);
+    if (!linear_before_reset_) {
+      pre_packed_recurrent_H_.buffer_ = std::move(prepacked_buffers[1]);
+    }
     used_shared_buffers = true;
   }
 
   return Status::OK();
 }
 
+static void UsePersistedPackedWeights(BufferUniquePtr& buffer, const TensorShape& shape, size_t weights_size,
+                                      int64_t num_directions, PackedWeights& packed_weights) {
+  packed_weights.weights_size_ = weights_size;
+  packed_weights.buffer_size_ = SafeInt<size_t>(packed_weights.weights_size_) * num_directions;
+  packed_weights.shape_ = shape;
+  packed_weights.buffer_ = std::move(buffer);
+}
+
+Status DeepCpuGruOp::UsePersistedPrePackedBuffers(const Tensor& tensor,
+                                                  std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                  int input_idx,
+                                                  /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  // the buffers were packed from a tensor of the same shape by TryPackInputWeights() or TryPackRecurrentWeights(),
+  // restore the sizes they keep for Compute()
+  const auto& shape = tensor.Shape();
+  if (!tensor.IsDataType<float>() || shape.NumDimensions() != 3) {
+    return Status::OK();
+  }
+
+  if (input_idx == 1) {
+    const size_t N = narrow<size_t>(shape[1]);
+    const size_t K = narrow<size_t>(shape[2]);
+    UsePersistedPackedWeights(prepacked_buffers[0], shape, MlasGemmPackBSize(N, K), shape[0],
+                              pre_packed_input_weights_);
+    used_persisted_buffers = true;
+  } else if (input_idx == 2) {
+    UsePersistedPackedWeights(prepacked_buffers[0], shape,
+                              PackedRecurrentWeightsSize(linear_before_reset_ ? 3 : 2, hidden_size_), shape[0],
+                              pre_packed_recurrent_ZR_);
+    if (!linear_before_reset_) {
+      UsePersistedPackedWeights(prepacked_buffers[1], shape, PackedRecurrentWeightsSize(1, hidden_size_), shape[0],
+                                pre_packed_recurrent_H_);
+    }
+    used_persisted_buffers = true;
+  }
+
+  return Status::OK();
+}
+
 Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
 
@@ -647,33 +719,22 @@ UniDirectionalGru<T>::UniDirectionalGru(AllocatorPtr allocator,
     auto bias_Rr = bias.subspan(4 * hidden_size_, hidden_size_);
     auto bias_Ro = bias.subspan(5 * hidden_size_, hidden_size_);
 
-    // add Wb[zr] and Rb[zr] and replicate so we have batch_size_ copies of the result
-    auto combine_and_replicate = [&](gsl::span<const T>& bias_w,
-                                     gsl::span<const T>& bias_r,
-                                     gsl::span<T>& output) {
-      // add once
+    auto combine = [&](gsl::span<const T>& bias_w, gsl::span<const T>& bias_r, gsl::span<T>& output) {
       for (int i = 0; i < hidden_size_; ++i) {
         output[i] = bias_w[i] + bias_r[i];
       }
-
-      // replicate what we just wrote to the start of the output span so we have batch_size_ copies
-      auto values = output.begin();
-      ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(values, values + hidden_size_,
-                                                           output.begin() + hidden_size_,  // skip the first batch
-                                                           batch_size_ - 1));              // and replicate batch size - 1 times
     };
 
     // we can always combine the z and r weights
-    combine_and_replicate(bias_Wz, bias_Rz, batched_bias_WRz_);
-    combine_and_replicate(bias_Wr, bias_Rr, batched_bias_WRr_);
+    combine(bias_Wz, bias_Rz, bias_WRz_);
+    combine(bias_Wr, bias_Rr, bias_WRr_);
 
     // how we treat the h weight depends on whether linear_before_reset_ is set
     if (linear_before_reset_) {
-      // need to replicate Wb[o] and Rb[o] separately
-      ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(bias_Wo.begin(), bias_Wo.end(), batched_bias_Wh_.begin(), batch_size_));
-      ORT_IGNORE_RETURN_VALUE(RepeatVectorToConstructArray(bias_Ro.begin(), bias_Ro.end(), batched_bias_Rh_.begin(), batch_size_));
+      bias_Wh_ = bias_Wo;
+      bias_Rh_ = bias_Ro;
     } else {
-      combine_and_replicate(bias_Wo, bias_Ro, batched_bias_WRh_);
+      combine(bias_Wo, bias_Ro, bias_WRh_);
     }
   }
 
@@ -691,9 +752,6 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
                                    const GemmWeights<T>& recurrent_weightsH_s,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
-  using span_T_const_iter = typename gsl::span<const T>::iterator;
-  using span_T_iter = typename gsl::span<T>::iterator;
-
   // copy inputs_arg as we may change it to point to inputs_reverse_
   gsl::span<const T> inputs = inputs_arg;
   gsl::span<const int> sequence_lengths = sequence_lengths_arg;
@@ -712,14 +770,6 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
     DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
   }
 
-  gsl::span<const T> recurrent_weightsZR;
-  if (!recurrent_weightsZR_s.is_prepacked_)
-    recurrent_weightsZR = recurrent_weightsZR_s.GetUnpackedSpan();
-
-  gsl::span<const T> recurrent_weightsH;
-  if (!recurrent_weightsH_s.is_prepacked_)
-    recurrent_weightsH = recurrent_weightsH_s.GetUnpackedSpan();
-
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
 
@@ -734,12 +784,9 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
     }
   }
 
-  // Calculate the max and min length
+  // Calculate the max length
   int32_t max_sequence_length = *std::max_element(sequence_lengths.begin(), sequence_lengths.end());
-  int32_t min_sequence_length = std::min(seq_length_, *std::min_element(sequence_lengths.begin(),
-                                                                        sequence_lengths.end()));
 
-  const int hidden_size_x2 = 2 * hidden_size_;
   const int hidden_size_x3 = 3 * hidden_size_;
   const int total_rows = max_sequence_length * batch_size_;
 
@@ -781,38 +828,38 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
   if (direction_ == kForward && num_directions == 2)
     output_step_length = 2 * batch_size_ * hidden_size_;
 
-  // convenience end iterators we use in the loops below to detect any bounds issues
-  span_T_const_iter batched_bias_WRz_local_end = batched_bias_WRz_.end();
-  span_T_const_iter batched_bias_WRr_local_end = batched_bias_WRr_.end();
-  span_T_const_iter batched_bias_Wh_local_end = batched_bias_Wh_.end();
-  span_T_const_iter batched_bias_Rh_local_end = batched_bias_Rh_.end();
-  span_T_const_iter batched_bias_WRh_local_end = batched_bias_WRh_.end();
-
-  size_t out_added_offset;
-
-  span_T_const_iter prev_Ht = batched_hidden0_.begin();  // Ht-1
-  span_T_const_iter prev_Ht_end = batched_hidden0_.end();
-  span_T_iter cur_h_local = cur_h_.begin();
-  span_T_iter cur_h_local_end = cur_h_.end();
-
-  span_T_const_iter batched_bias_WRz_local{};
-  span_T_const_iter batched_bias_WRr_local{};
-  span_T_const_iter batched_bias_WRh_local{};
-  span_T_const_iter batched_bias_Wh_local{};
-  span_T_const_iter batched_bias_Rh_local{};
-
-  if (use_bias_) {
-    batched_bias_WRz_local = batched_bias_WRz_.begin();
-    batched_bias_WRr_local = batched_bias_WRr_.begin();
-
-    if (linear_before_reset_) {
-      batched_bias_Wh_local = batched_bias_Wh_.begin();
-      batched_bias_Rh_local = batched_bias_Rh_.begin();
-    } else {
-      batched_bias_WRh_local = batched_bias_WRh_.begin();
-    }
+  // without output_sequence Ht of every step goes to the same place, where other threads may still read Ht-1
+  if (!output_sequence) {
+    hidden_steps_ = Allocate(allocator_, 2 * batch_size_ * hidden_size_, hidden_steps_ptr_, true);
   }
 
+  // The recurrent GEMM and the gates are computed block by block of hidden units, see kRecurrentBlockSize.
+  // For small batches the blocks are split between the threads, so each thread only reads its part of R at every
+  // step. Larger batches split the rows instead. A thread isn't given less work than MlasGemm would give it.
+  const int num_blocks = (hidden_size_ + kRecurrentBlockSize - 1) / kRecurrentBlockSize;
+  const double step_complexity = static_cast<double>(batch_size_) * hidden_size_x3 * hidden_size_;
+  const int max_tasks = static_cast<int>(std::max(1.0, std::min<double>(
+                                                           concurrency::ThreadPool::DegreeOfParallelism(ttp_),
+                                                           step_complexity / (64 * 1024))));
+  const int num_row_tasks = batch_size_ <= 8 ? 1 : std::min(max_tasks, batch_size_);
+  const int num_block_tasks = batch_size_ <= 8 ? std::min(max_tasks, num_blocks) : 1;
+
+  auto for_each_block = [&](auto&& block_fn) {
+    concurrency::ThreadPool::TrySimpleParallelFor(
+        ttp_, num_row_tasks * num_block_tasks,
+        [&](std::ptrdiff_t task) {
+          const int row_task = static_cast<int>(task) / num_block_tasks;
+          const int block_task = static_cast<int>(task) % num_block_tasks;
+          const int row = row_task * batch_size_ / num_row_tasks;
+          const int num_rows = (row_task + 1) * batch_size_ / num_row_tasks - row;
+          const int end_block = (block_task + 1) * num_blocks / num_block_tasks;
+
+          for (int block = block_task * num_blocks / num_block_tasks; block < end_block; block++) {
+            block_fn(row, num_rows, block);
+          }
+        });
+  };
+
   {
     // Enter a parallel section encompassing the kernels invoked
     // below.  This lets the runtime system amortize loop entry/exit
@@ -820,248 +867,65 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
     // affinity between iterations of successive loops.
     onnxruntime::concurrency::ThreadPool::ParallelSection ps(ttp_);
 
+    const T* previous_state = batched_hidden0_.data();
+
     // for each item in sequence run all calculations
     for (int step = 0; step < max_sequence_length; step++) {
 #if defined(DUMP_MATRIXES)
       const std::string seqno_str = " [seqno=" + std::to_string(step) + "]";
 #endif
-      DumpMatrix("Ht-1" + seqno_str, &*prev_Ht, batch_size_, hidden_size_);
-
-      out_added_offset = (step * batch_size_) * hidden_size_x3;
-
-      // calculate Ht-1*R[zr], and add to the weighted inputs that are in outputZRH_
-      // Ht-1 * R[zr] + Xt*(W[zr]^T)
-      if (!recurrent_weightsZR_s.is_prepacked_) {
-        ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
-                    prev_Ht, prev_Ht_end,
-                    hidden_size_,
-                    recurrent_weightsZR.begin(), recurrent_weightsZR.end(),
-                    hidden_size_, 1.f,  // beta == 1 so we add existing values in outputZRH_
-                    outputZRH_.begin() + out_added_offset, outputZRH_.end(),
-                    hidden_size_x3, ttp_);
-      } else {
-        MlasGemm(
-            CblasNoTrans,
-            static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_x2), static_cast<size_t>(hidden_size_), alpha,
-            &*prev_Ht,
-            static_cast<size_t>(hidden_size_),
-            recurrent_weightsZR_s.buffer_,
-            1.f,
-            &*(outputZRH_.begin() + out_added_offset),
-            static_cast<size_t>(hidden_size_x3), ttp_);
-      }
+      DumpMatrix("Ht-1" + seqno_str, previous_state, batch_size_, hidden_size_);
 
-      DumpMatrix("Ht-1 * R[zr] + Xt*(W[zr]^T)" + seqno_str,
-                 outputZRH_.data() + out_added_offset, batch_size_, hidden_size_x2, 0, hidden_size_x3);
+      T* batched_output = output_sequence ? outputs.data() + step * output_step_length
+                                          : hidden_steps_.data() + (step % 2) * batch_size_ * hidden_size_;
 
       if (linear_before_reset_) {
-        // copy Rbh to linear output
-        if (use_bias_) {
-          gsl::copy(batched_bias_Rh_.subspan(batched_bias_Rh_local - batched_bias_Rh_.begin(),
-                                             batched_bias_Rh_local_end - batched_bias_Rh_local),
-                    linear_output_);
-        }
-
-        // compute Ht-1 * (Rh^T) + Rbh
-        if (!recurrent_weightsH_s.is_prepacked_) {
-          ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                      prev_Ht, prev_Ht_end,  // Ht-1
-                      hidden_size_,
-                      recurrent_weightsH.begin(), recurrent_weightsH.end(),  // Rh^T
-                      hidden_size_,
-                      use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-                      linear_output_.begin(),
-                      linear_output_.end(),  // pre: Rbh if use_bias_, post:output
-                      hidden_size_, ttp_);
-        } else {
-          MlasGemm(
-              CblasNoTrans,
-              static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
-              &*prev_Ht,
-              static_cast<size_t>(hidden_size_),
-              recurrent_weightsH_s.buffer_,
-              use_bias_ ? 1.f : 0.f,  // don't add values in linear_output_ if no bias input
-              &*linear_output_.begin(),
-              static_cast<size_t>(hidden_size_), ttp_);
-        }
-
-        DumpMatrix("Ht-1 * (Rh^T) + Rbh " + seqno_str, linear_output_.data(), batch_size_, hidden_size_);
-      }
-
-      // 1st Set Of Activations
-      for (int r = 0; r < batch_size_; r++) {
-        const T* p_bias_r = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRr_local + r * hidden_size_,
-                                                               batched_bias_WRr_local_end, hidden_size_)
-                                      : nullptr;
-
-        // initialize p_rt with input to calculate rt. outputZRH_ has Xt*(Wr^T) + Ht-1*(Rr^T).
-        T* p_rt = SafeRawPointer(outputZRH_, out_added_offset + r * hidden_size_x3 + hidden_size_, hidden_size_);
-
-        // add the bias and clip. post: p_rt == Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr
-        clip_with_bias_ptr_(clip_, p_bias_r, p_rt, hidden_size_);
-
-        if (linear_before_reset_) {
-          // p_linear_output = Ht-1 * (Rh^T) + Rbh
-          T* p_linear_output = SafeRawPointer<T>(linear_output_, r * hidden_size_, hidden_size_);
-          T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
-
-          // calculate rt in-place [p_rt = f(p_rt)]
-          // calculate rt (.) (Ht-1 * (Rh^T) + Rbh) using p_linear_output. write to p_cur_h
-          reset_gate_(p_linear_output, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
-
-        } else {
-          const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
-          T* p_cur_h = SafeRawPointer<T>(cur_h_local + r * hidden_size_, cur_h_local_end, hidden_size_);
-
-          // calculate rt in-place [p_rt = f(p_rt)]
-          // calculate rt (.) Ht-1 using p_prev_Ht, and write to p_cur_h
-          reset_gate_(p_prev_Ht, p_rt, p_cur_h, hidden_size_, zr_alpha_, zr_beta_);
-        }
-      }
-
-#if defined(DUMP_MATRIXES)
-      std::string label = linear_before_reset_ ? "rt (.) (Ht-1 * (Rh^T) + Rbh)" : "rt (.) Ht-1";
-#endif
-      DumpMatrix(label + seqno_str, &*cur_h_local, batch_size_, hidden_size_);
-
-      if (linear_before_reset_) {
-        // input contains rt (.) (Ht-1*(Rh^T) + Rbh)
-        auto input = cur_h_local;
-        // out_H currently contains Xt*(W[zrh]^T).
-        auto out_H = outputZRH_.begin() + out_added_offset;
-
-        for (int r = 0; r < batch_size_; r++) {
-          // skip over the inputs with Z and R weights
-          out_H += hidden_size_x2;
-          for (int h = 0; h < hidden_size_; ++h) {
-            *out_H += *input;
-            ++out_H;
-            ++input;
-          }
-        }
-      } else {
-#if defined(DUMP_MATRIXES)
-        label += " * Rh^T";
-#endif
-
-        // out_H currently contains Xt*(Wh^T).
-        auto out_H = outputZRH_.begin() + out_added_offset + hidden_size_x2;
-
-        // Calculate Xt*(Wh^T) + rt (.) Ht-1 * Rh
-        if (!recurrent_weightsH_s.is_prepacked_) {
-          ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
-                      cur_h_local, cur_h_local_end,  // rt (.) Ht-1
-                      hidden_size_,
-                      recurrent_weightsH.begin(), recurrent_weightsH.end(),  // Rh^T
-                      hidden_size_, 1.f,                                     // beta == 1 to add Xt*(Wh^T) from out_H
-                      out_H, outputZRH_.end(),
-                      hidden_size_x3, ttp_);
-        } else {
-          MlasGemm(
-              CblasNoTrans,
-              static_cast<size_t>(batch_size_), static_cast<size_t>(hidden_size_), static_cast<size_t>(hidden_size_), alpha,
-              &*cur_h_local,
-              static_cast<size_t>(hidden_size_),
-              recurrent_weightsH_s.buffer_,
-              1.f,  // beta == 1 to add Xt*(Wh^T) from out_H
-              &*out_H,
-              static_cast<size_t>(hidden_size_x3), ttp_);
-        }
-      }
-
-      DumpMatrix("Xt*(Wh^T) + (" + label + ")" + seqno_str, outputZRH_.data() + out_added_offset,
-                 batch_size_, hidden_size_, hidden_size_x2, hidden_size_x3);
-
-      // 2nd Set of Activations
-      span_T_iter output;
-      span_T_iter output_end;
-      if (output_sequence) {
-        output = outputs.begin() + step * output_step_length;
-        output_end = outputs.end();
-
-      } else {
-        output = final_hidden_state.begin();
-        output_end = final_hidden_state.end();
-      }
-
-      for (int r = 0; r < batch_size_; r++) {
-        if (step >= min_sequence_length && step >= sequence_lengths[r]) {
-          // if we need output for every step,
-          // or we need to set prev_Ht for an empty sequence to avoid warnings about using uninitialized values
-          if (output_sequence || (step == 0 && sequence_lengths[r] == 0)) {
-            auto fill_output = output + r * hidden_size_;
-            std::fill_n(&*fill_output, hidden_size_, T{});
-          }
-
-          continue;
-        }
-
-        const T* p_bias_z = use_bias_ ? SafeRawConstPointer<T>(batched_bias_WRz_local,
-                                                               batched_bias_WRz_local_end, hidden_size_)
-                                      : nullptr;
-
-        // initialize p_zt with Xt*(Wz^T) + Ht-1*(Rz^T), which is most of the input to calculate zt:
-        T* p_zt = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3, hidden_size_);
-
-        // using p_zt, add bias and clip in-place
-        clip_with_bias_ptr_(clip_, p_bias_z, p_zt, hidden_size_);
-
-        // calculate zt in-place. p_zt = f(p_zt)
-        update_gate_(p_zt, hidden_size_, zr_alpha_, zr_beta_);
-
-        DumpMatrix("zt[" + std::to_string(r) + "]" + seqno_str, p_zt, 1, hidden_size_);
-
-        const T* p_bias_h = nullptr;
-        if (use_bias_) {
-          if (linear_before_reset_) {
-            // Wbh
-            p_bias_h = SafeRawConstPointer<T>(batched_bias_Wh_local + r * hidden_size_,
-                                              batched_bias_Wh_local_end, hidden_size_);
-
+        // rt only applies to Ht-1*(Rh^T) + Rbh, so the whole step is one GEMM and its gates for each block
+        for_each_block([&](int row, int num_rows, int block) {
+          if (recurrent_weightsZR_s.is_prepacked_) {
+            ComputeRecurrentBlock(recurrent_weightsZR_s, 3, 0, previous_state, row, num_rows, block);
           } else {
-            // Wbh + Wrh
-            p_bias_h = SafeRawConstPointer<T>(batched_bias_WRh_local + r * hidden_size_,
-                                              batched_bias_WRh_local_end, hidden_size_);
+            ComputeRecurrentBlock(recurrent_weightsZR_s, 2, 0, previous_state, row, num_rows, block);
+            ComputeRecurrentBlock(recurrent_weightsH_s, 1, 2, previous_state, row, num_rows, block);
           }
-        }
-
-        // setup p_ht with input to calculate ht
-        // p_ht = Xt*(Wh^T) + (rt (.) Ht-1 * Rh^T)          #  linear_before_reset_ == false
-        //      = Xt*(Wh^T) + (rt (.) (Ht-1*(Rh^T) + Rbh))  #  linear_before_reset_ == true
-        T* p_ht = SafeRawPointer<T>(outputZRH_, out_added_offset + r * hidden_size_x3 + hidden_size_x2, hidden_size_);
 
-        // add Wbh [and Wrh] and clip
-        clip_with_bias_ptr_(clip_, p_bias_h, p_ht, hidden_size_);  // post: p_ht == input to g() for calculating ht
-
-        DumpMatrix("ht input [" + std::to_string(r) + "]" + seqno_str, p_ht, 1, hidden_size_);
-
-        const T* p_prev_Ht = SafeRawConstPointer<T>(prev_Ht + r * hidden_size_, prev_Ht_end, hidden_size_);
-        T* p_Ht = SafeRawPointer<T>(output + r * hidden_size_, output_end, hidden_size_);
-
-        // calculate ht = g(p_ht) and write in-place to p_ht
-        // calculate Ht = (1 - zt) (.) ht + zt (.) Ht-1 and write to p_Ht
-        output_gate_(p_ht, p_zt, p_prev_Ht, p_Ht, hidden_size_, h_alpha_, h_beta_);  // calculate ht and Ht
+          LinearBeforeResetBlockGates(sequence_lengths, step, row, num_rows, block, previous_state, batched_output,
+                                      output_sequence);
+        });
+      } else {
+        // (rt (.) Ht-1)*(Rh^T) needs rt of every hidden unit, so the blocks first compute zt and rt (.) Ht-1, and
+        // then Ht
+        for_each_block([&](int row, int num_rows, int block) {
+          ComputeRecurrentBlock(recurrent_weightsZR_s, 2, 0, previous_state, row, num_rows, block);
+          ResetBlockGates(sequence_lengths, step, row, num_rows, block, previous_state);
+        });
+
+        DumpMatrix("rt (.) Ht-1" + seqno_str, cur_h_.data(), batch_size_, hidden_size_);
+
+        for_each_block([&](int row, int num_rows, int block) {
+          ComputeRecurrentBlock(recurrent_weightsH_s, 1, 2, cur_h_.data(), row, num_rows, block);
+          OutputBlockGates(sequence_lengths, step, row, num_rows, block, previous_state, batched_output,
+                           output_sequence);
+        });
       }
 
-      DumpMatrix("output" + seqno_str, &*output, batch_size_, hidden_size_);
+      DumpMatrix("output" + seqno_str, batched_output, batch_size_, hidden_size_);
 
-      prev_Ht = output;
-      prev_Ht_end = output_end;
+      previous_state = batched_output;
     }
   }  // End parallel section
 
   // copy last output to final_hidden_state
   for (int i = 0; i < batch_size_; i++) {
     const int seq_len = sequence_lengths[i];
-    if (output_sequence) {
-      if (seq_len == 0) {
-        auto final_hidden_state_dst = final_hidden_state.begin() + i * hidden_size_;
-        std::fill_n(&*final_hidden_state_dst, hidden_size_, T{});
-      } else {
-        auto src = outputs.subspan((seq_len - 1) * output_step_length + i * hidden_size_, hidden_size_);
-        auto dest = final_hidden_state.subspan(i * hidden_size_, hidden_size_);
-        gsl::copy(src, dest);
-      }
+    gsl::span<T> dest = final_hidden_state.subspan(i * hidden_size_, hidden_size_);
+    if (seq_len == 0) {
+      std::fill_n(dest.data(), hidden_size_, T{});
+    } else if (output_sequence) {
+      gsl::copy(outputs.subspan((seq_len - 1) * output_step_length + i * hidden_size_, hidden_size_), dest);
+    } else {
+      // Ht isn't written past the sequence length of a row, so its last value is in the buffer of its last step
+      gsl::copy(hidden_steps_.subspan((((seq_len - 1) % 2) * batch_size_ + i) * hidden_size_, hidden_size_), dest);
     }
   }
 
@@ -1087,27 +951,187 @@ void UniDirectionalGru<T>::Compute(gsl::span<const T> inputs_arg,
   }
 }
 
+template <typename T>
+void UniDirectionalGru<T>::ComputeRecurrentBlock(const GemmWeights<T>& weights, const int num_gates,
+                                                 const int first_gate, const T* A, const int row, const int num_rows,
+                                                 const int block) {
+  const int hidden_size_x3 = 3 * hidden_size_;
+  const int block_start = block * kRecurrentBlockSize;
+  const int block_size = std::min(kRecurrentBlockSize, hidden_size_ - block_start);
+
+  T* gates = SafeRawPointer<T>(recurrent_gates_, row * hidden_size_x3 + 3 * block_start + first_gate * block_size,
+                               (num_rows - 1) * hidden_size_x3 + num_gates * block_size);
+
+  // Do it sequentially to avoid nested parallelism
+  if (weights.is_prepacked_) {
+    MlasGemm(CblasNoTrans, num_rows, num_gates * block_size, hidden_size_, 1.0f,
+             A + row * hidden_size_, hidden_size_,
+             PackedRecurrentBlock(weights.buffer_, num_gates, hidden_size_, block), 0.0f,
+             gates, hidden_size_x3, nullptr);
+  } else {
+    const gsl::span<const T> weights_span = weights.GetUnpackedSpan();
+
+    for (int gate = 0; gate < num_gates; gate++) {
+      const T* gate_weights = SafeRawConstPointer<T>(
+          weights_span.subspan((gate * hidden_size_ + block_start) * hidden_size_), 0, block_size * hidden_size_);
+      MlasGemm(CblasNoTrans, CblasTrans, num_rows, block_size, hidden_size_, 1.0f,
+               A + row * hidden_size_, hidden_size_,
+               gate_weights, hidden_size_, 0.0f,
+               gates + gate * block_size, hidden_size_x3, nullptr);
+    }
+  }
+}
+
+template <typename T>
+void UniDirectionalGru<T>::LinearBeforeResetBlockGates(gsl::span<const int> seq_lengths, const int step,
+                                                       const int row, const int num_rows, const int block,
+                                                       const T* previous_state, T* batched_output,
+                                                       const bool output_sequence) {
+  const int hidden_size_x3 = 3 * hidden_size_;
+  const int block_start = block * kRecurrentBlockSize;
+  const int block_size = std::min(kRecurrentBlockSize, hidden_size_ - block_start);
+
+  const T* p_bias_z = use_bias_ ? bias_WRz_.data() + block_start : nullptr;
+  const T* p_bias_r = use_bias_ ? bias_WRr_.data() + block_start : nullptr;
+  const T* p_bias_h = use_bias_ ? bias_Wh_.data() + block_start : nullptr;
+
+  for (int r = row; r < row + num_rows; r++) {
+    T* p_Ht = batched_output + r * hidden_size_ + block_start;
+
+    if (step >= seq_lengths[r]) {
+      if (output_sequence) {
+        std::fill_n(p_Ht, block_size, T{});
+      }
+
+      continue;
+    }
+
+    // recurrent_gates_ contains Ht-1*(R[zrh]^T), outputZRH_ contains Xt*(W[zrh]^T)
+    T* p_zt = SafeRawPointer<T>(recurrent_gates_, r * hidden_size_x3 + 3 * block_start, 3 * block_size);
+    T* p_rt = p_zt + block_size;
+    T* p_ht = p_rt + block_size;
+    const T* p_x = SafeRawPointer<T>(outputZRH_, (step * batch_size_ + r) * hidden_size_x3 + block_start,
+                                     2 * hidden_size_ + block_size);
+
+    // zt = f(Xt*(Wz^T) + Ht-1*(Rz^T) + Wbz + Rbz)
+    deepcpu::elementwise_sum1(p_x, p_zt, block_size);
+    clip_with_bias_ptr_(clip_, p_bias_z, p_zt, block_size);
+    update_gate_(p_zt, block_size, zr_alpha_, zr_beta_);
+
+    // Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr, the input of f() to calculate rt
+    deepcpu::elementwise_sum1(p_x + hidden_size_, p_rt, block_size);
+    clip_with_bias_ptr_(clip_, p_bias_r, p_rt, block_size);
+
+    // calculate rt (.) (Ht-1*(Rh^T) + Rbh) in-place
+    if (use_bias_) {
+      deepcpu::elementwise_sum1(bias_Rh_.data() + block_start, p_ht, block_size);
+    }
+    reset_gate_(p_ht, p_rt, p_ht, block_size, zr_alpha_, zr_beta_);
+
+    // add Xt*(Wh^T) and Wbh, and clip. post: p_ht == input to g() for calculating ht
+    deepcpu::elementwise_sum1(p_x + 2 * hidden_size_, p_ht, block_size);
+    clip_with_bias_ptr_(clip_, p_bias_h, p_ht, block_size);
+
+    // calculate ht = g(p_ht) and write in-place to p_ht
+    // calculate Ht = (1 - zt) (.) ht + zt (.) Ht-1 and write to p_Ht
+    output_gate_(p_ht, p_zt, previous_state + r * hidden_size_ + block_start, p_Ht, block_size, h_alpha_, h_beta_);
+  }
+}
+
+template <typename T>
+void UniDirectionalGru<T>::ResetBlockGates(gsl::span<const int> seq_lengths, const int step, const int row,
+                                           const int num_rows, const int block, const T* previous_state) {
+  const int hidden_size_x3 = 3 * hidden_size_;
+  const int block_start = block * kRecurrentBlockSize;
+  const int block_size = std::min(kRecurrentBlockSize, hidden_size_ - block_start);
+
+  const T* p_bias_z = use_bias_ ? bias_WRz_.data() + block_start : nullptr;
+  const T* p_bias_r = use_bias_ ? bias_WRr_.data() + block_start : nullptr;
+
+  for (int r = row; r < row + num_rows; r++) {
+    if (step >= seq_lengths[r]) {
+      continue;
+    }
+
+    // recurrent_gates_ contains Ht-1*(R[zr]^T), outputZRH_ contains Xt*(W[zrh]^T)
+    T* p_zt = SafeRawPointer<T>(recurrent_gates_, r * hidden_size_x3 + 3 * block_start, 2 * block_size);
+    T* p_rt = p_zt + block_size;
+    const T* p_x = SafeRawPointer<T>(outputZRH_, (step * batch_size_ + r) * hidden_size_x3 + block_start,
+                                     hidden_size_ + block_size);
+
+    // zt = f(Xt*(Wz^T) + Ht-1*(Rz^T) + Wbz + Rbz), kept in recurrent_gates_ for OutputBlockGates()
+    deepcpu::elementwise_sum1(p_x, p_zt, block_size);
+    clip_with_bias_ptr_(clip_, p_bias_z, p_zt, block_size);
+    update_gate_(p_zt, block_size, zr_alpha_, zr_beta_);
+
+    // Xt*(Wr^T) + Ht-1*(Rr^T) + Wbr + Rbr, the input of f() to calculate rt
+    deepcpu::elementwise_sum1(p_x + hidden_size_, p_rt, block_size);
+    clip_with_bias_ptr_(clip_, p_bias_r, p_rt, block_size);
+
+    // calculate rt (.) Ht-1, and write to cur_h_
+    T* p_cur_h = SafeRawPointer<T>(cur_h_, r * hidden_size_ + block_start, block_size);
+    reset_gate_(previous_state + r * hidden_size_ + block_start, p_rt, p_cur_h, block_size, zr_alpha_, zr_beta_);
+  }
+}
+
+template <typename T>
+void UniDirectionalGru<T>::OutputBlockGates(gsl::span<const int> seq_lengths, const int step, const int row,
+                                            const int num_rows, const int block, const T* previous_state,
+                                            T* batched_output, const bool output_sequence) {
+  const int hidden_size_x3 = 3 * hidden_size_;
+  const int block_start = block * kRecurrentBlockSize;
+  const int block_size = std::min(kRecurrentBlockSize, hidden_size_ - block_start);
+
+  const T* p_bias_h = use_bias_ ? bias_WRh_.data() + block_start : nullptr;
+
+  for (int r = row; r < row + num_rows; r++) {
+    T* p_Ht = batched_output + r * hidden_size_ + block_start;
+
+    if (step >= seq_lengths[r]) {
+      if (output_sequence) {
+        std::fill_n(p_Ht, block_size, T{});
+      }
+
+      continue;
+    }
+
+    // recurrent_gates_ contains zt and (rt (.) Ht-1)*(Rh^T), outputZRH_ contains Xt*(W[zrh]^T)
+    const T* p_zt = SafeRawPointer<T>(recurrent_gates_, r * hidden_size_x3 + 3 * block_start, 3 * block_size);
+    T* p_ht = SafeRawPointer<T>(recurrent_gates_, r * hidden_size_x3 + 3 * block_start + 2 * block_size,
+                                block_size);
+    const T* p_x = SafeRawPointer<T>(outputZRH_,
+                                     (step * batch_size_ + r) * hidden_size_x3 + 2 * hidden_size_ + block_start,
+                                     block_size);
+
+    // add Xt*(Wh^T), Wbh and Rbh, and clip. post: p_ht == input to g() for calculating ht
+    deepcpu::elementwise_sum1(p_x, p_ht, block_size);
+    clip_with_bias_ptr_(clip_, p_bias_h, p_ht, block_size);
+
+    // calculate ht = g(p_ht) and write in-place to p_ht
+    // calculate Ht = (1 - zt) (.) ht + zt (.) Ht-1 and write to p_Ht
+    output_gate_(p_ht, p_zt, previous_state + r * hidden_size_ + block_start, p_Ht, block_size, h_alpha_, h_beta_);
+  }
+}
+
 template <typename T>
 void UniDirectionalGru<T>::AllocateBuffers() {
-  cur_h_ = Allocate(allocator_, hidden_size_ * batch_size_, cur_h_ptr_);
   batched_hidden0_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_hidden0_ptr_, true);
+  recurrent_gates_ = Allocate(allocator_, batch_size_ * 3 * hidden_size_, recurrent_gates_ptr_);
+
+  if (!linear_before_reset_) {
+    // rows past their sequence length aren't written, but are still read by the GEMM
+    cur_h_ = Allocate(allocator_, hidden_size_ * batch_size_, cur_h_ptr_, true);
+  }
 
   if (use_bias_) {
-    batched_bias_WRz_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_WRz_ptr_);
-    batched_bias_WRr_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_WRr_ptr_);
+    bias_WRz_ = Allocate(allocator_, hidden_size_, bias_WRz_ptr_);
+    bias_WRr_ = Allocate(allocator_, hidden_size_, bias_WRr_ptr_);
 
-    if (linear_before_reset_) {
-      batched_bias_Wh_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_Wh_ptr_);
-      batched_bias_Rh_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_Rh_ptr_);
-    } else {
-      batched_bias_WRh_ = Allocate(allocator_, batch_size_ * hidden_size_, batched_bias_WRh_ptr_);
+    if (!linear_before_reset_) {
+      bias_WRh_ = Allocate(allocator_, hidden_size_, bias_WRh_ptr_);
     }
   }
 
-  if (linear_before_reset_) {
-    linear_output_ = Allocate(allocator_, batch_size_ * hidden_size_, linear_output_ptr_);
-  }
-
   auto batch_times_seq_length = batch_size_ * seq_length_;
 
   outputZRH_ = Allocate(allocator_, hidden_size_ * 3 * batch_times_seq_length, outputZRH_ptr_, true);
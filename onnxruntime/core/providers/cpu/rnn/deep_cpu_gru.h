@@ -69,6 +69,11 @@ class DeepCpuGruOp final : public OpKernel {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx, /*out*/ bool& used_persisted_buffers) override;
+
+  bool CanUsePersistedPrePackedBuffers(int input_idx) const override { return input_idx == 1 || input_idx == 2; }
+
   bool TryPackInputWeights(const Tensor& weight, AllocatorPtr& alloc);
 
   bool TryPackRecurrentWeights(const Tensor& weights, AllocatorPtr& alloc);
@@ -86,9 +91,10 @@ class DeepCpuGruOp final : public OpKernel {
   // This kernel supports either forward or bidirectional
   // This is split in half for bidirectional, but we prepack it in the same buffer
   rnn::detail::PackedWeights pre_packed_input_weights_;
-  // recurrent_weights_ZR_ fwd, followed by bwd
+  // recurrent_weights_ZR_ fwd, followed by bwd, packed by blocks of hidden units.
+  // Holds recurrent_weights_ZRH_ if linear_before_reset_ is set.
   rnn::detail::PackedWeights pre_packed_recurrent_ZR_;
-  // recurrent_weights_H_ fwd, followed by bwd
+  // recurrent_weights_H_ fwd, followed by bwd, packed by blocks of hidden units. Unused if linear_before_reset_ is set.
   rnn::detail::PackedWeights pre_packed_recurrent_H_;
 
   template <typename T>
@@ -10,6 +10,7 @@
 #endif
 
 #include "deep_cpu_lstm.h"
+#include "uni_directional_lstm.h"
 
 #ifdef _MSC_VER
 #pragma warning(pop)
@@ -174,10 +175,9 @@ using namespace rnn::detail;
 
 // LSTM details
 
-Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, PackedWeights& packed_weights, bool& is_packed, AllocatorPtr& alloc) {
-  const auto& shape = weights.Shape();
+size_t DeepCpuLstmOp::GetPackedWeightsSize(const TensorShape& shape, bool is_recurrent) const {
   if (shape.NumDimensions() != 3) {
-    return Status::OK();
+    return 0;
   }
 
   // weights: [num_directions, 4*hidden_size, input_size]
@@ -186,14 +186,29 @@ Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, PackedWeights& packe
   const size_t K = static_cast<size_t>(shape[2]);
 
   if ((shape[0] != num_directions_) || (N != static_cast<size_t>(hidden_size_) * 4)) {
-    return Status::OK();
+    return 0;
   }
 
-  const size_t packed_weights_size = MlasGemmPackBSize(N, K);
+  // the recurrence weights are packed by blocks of hidden units, see rnn::detail::kRecurrentBlockSize
+  if (is_recurrent && K != static_cast<size_t>(hidden_size_)) {
+    return 0;
+  }
+
+  return is_recurrent ? rnn::detail::PackedRecurrentWeightsSize(4, hidden_size_) : MlasGemmPackBSize(N, K);
+}
+
+Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, bool is_recurrent, PackedWeights& packed_weights,
+                                     bool& is_packed, AllocatorPtr& alloc) {
+  const auto& shape = weights.Shape();
+  const size_t packed_weights_size = GetPackedWeightsSize(shape, is_recurrent);
   if (packed_weights_size == 0) {
     return Status::OK();
   }
 
+  // the shape was checked by GetPackedWeightsSize()
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+
   size_t packed_weights_data_size = SafeInt<size_t>(packed_weights_size) * num_directions_;
   auto* packed_weights_data = alloc->Alloc(packed_weights_data_size);
 
@@ -209,7 +224,11 @@ Status DeepCpuLstmOp::TryPackWeights(const Tensor& weights, PackedWeights& packe
 
   const auto* weights_data = weights.Data<float>();
   for (int i = 0; i < num_directions_; i++) {
-    MlasGemmPackB(CblasTrans, N, K, weights_data, K, packed_weights_data);
+    if (is_recurrent) {
+      rnn::detail::PackRecurrentWeights(weights_data, 4, hidden_size_, packed_weights_data);
+    } else {
+      MlasGemmPackB(CblasTrans, N, K, weights_data, K, packed_weights_data);
+    }
     packed_weights_data = static_cast<uint8_t*>(packed_weights_data) + packed_weights_size;
     weights_data += N * K;
   }
@@ -230,7 +249,7 @@ Status DeepCpuLstmOp::PrePack(const Tensor& tensor, int input_idx,
 
   if (tensor.IsDataType<float>()) {
     if (input_idx == 1) {
-      ORT_RETURN_IF_ERROR(TryPackWeights(tensor, packed_W_, is_packed, alloc));
+      ORT_RETURN_IF_ERROR(TryPackWeights(tensor, false, packed_W_, is_packed, alloc));
 
       bool share_prepacked_weights = (prepacked_weights != nullptr);
       if (is_packed && share_prepacked_weights) {
@@ -238,7 +257,7 @@ Status DeepCpuLstmOp::PrePack(const Tensor& tensor, int input_idx,
         prepacked_weights->buffer_sizes_.push_back(packed_W_.buffer_size_);
       }
     } else if (input_idx == 2) {
-      ORT_RETURN_IF_ERROR(TryPackWeights(tensor, packed_R_, is_packed, alloc));
+      ORT_RETURN_IF_ERROR(TryPackWeights(tensor, true, packed_R_, is_packed, alloc));
 
       bool share_prepacked_weights = (prepacked_weights != nullptr);
       if (is_packed && share_prepacked_weights) {
@@ -267,6 +286,33 @@ Status DeepCpuLstmOp::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& pr
   return Status::OK();
 }
 
+Status DeepCpuLstmOp::UsePersistedPrePackedBuffers(const Tensor& tensor,
+                                                   std::vector<BufferUniquePtr>& prepacked_buffers,
+                                                   int input_idx,
+                                                   /*out*/ bool& used_persisted_buffers) {
+  used_persisted_buffers = false;
+
+  if (!CanUsePersistedPrePackedBuffers(input_idx) || !tensor.IsDataType<float>()) {
+    return Status::OK();
+  }
+
+  // restore the sizes TryPackWeights() keeps for Compute()
+  const bool is_recurrent = input_idx == 2;
+  const size_t packed_weights_size = GetPackedWeightsSize(tensor.Shape(), is_recurrent);
+  if (packed_weights_size == 0) {
+    return Status::OK();
+  }
+
+  PackedWeights& packed_weights = is_recurrent ? packed_R_ : packed_W_;
+  packed_weights.buffer_ = std::move(prepacked_buffers[0]);
+  packed_weights.buffer_size_ = SafeInt<size_t>(packed_weights_size) * num_directions_;
+  packed_weights.weights_size_ = packed_weights_size;
+  packed_weights.shape_ = tensor.Shape();
+  used_persisted_buffers = true;
+
+  return Status::OK();
+}
+
 Status DeepCpuLstmOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
 
@@ -26,12 +26,20 @@ class DeepCpuLstmOp final : public OpKernel, public LSTMBase {
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
 
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx, /*out*/ bool& used_persisted_buffers) override;
+
+  bool CanUsePersistedPrePackedBuffers(int input_idx) const override { return input_idx == 1 || input_idx == 2; }
+
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuLstmOp() override = default;
 
  private:
-  Status TryPackWeights(const Tensor& weights, rnn::detail::PackedWeights& packed_weights,
+  // Returns the size of the packed weights of one direction, or 0 if the weights are not packed.
+  size_t GetPackedWeightsSize(const TensorShape& shape, bool is_recurrent) const;
+
+  Status TryPackWeights(const Tensor& weights, bool is_recurrent, rnn::detail::PackedWeights& packed_weights,
                         bool& is_packed, AllocatorPtr& alloc);
 
   template <typename T>
@@ -3,6 +3,7 @@
 
 #include "core/providers/cpu/rnn/rnn_helpers.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <iomanip>
@@ -10,6 +11,7 @@
 #include <stdlib.h>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
@@ -312,6 +314,45 @@ void ComputeGemm(const int M,
   MlasGemm(gemm_shape, gemm_params, thread_pool);
 }
 
+size_t PackedRecurrentWeightsSize(const int num_gates, const int hidden_size) {
+  const size_t packed_block_size = MlasGemmPackBSize(num_gates * kRecurrentBlockSize, hidden_size);
+  if (packed_block_size == 0) {
+    return 0;
+  }
+
+  // only the last block may have less than kRecurrentBlockSize hidden units
+  const int num_blocks = (hidden_size + kRecurrentBlockSize - 1) / kRecurrentBlockSize;
+  const int last_block_size = hidden_size - (num_blocks - 1) * kRecurrentBlockSize;
+  return SafeInt<size_t>(packed_block_size) * (num_blocks - 1) +
+         MlasGemmPackBSize(num_gates * last_block_size, hidden_size);
+}
+
+void PackRecurrentWeights(const float* weights, const int num_gates, const int hidden_size, void* packed_weights) {
+  const size_t packed_block_size = MlasGemmPackBSize(num_gates * kRecurrentBlockSize, hidden_size);
+  std::vector<float> block_weights(SafeInt<size_t>(num_gates * kRecurrentBlockSize) * hidden_size);
+
+  for (int block_start = 0; block_start < hidden_size; block_start += kRecurrentBlockSize) {
+    const int block_size = std::min(kRecurrentBlockSize, hidden_size - block_start);
+
+    // gather the rows of the block of hidden units from every gate
+    for (int gate = 0; gate < num_gates; gate++) {
+      const float* src = weights + (static_cast<size_t>(gate) * hidden_size + block_start) * hidden_size;
+      std::copy_n(src, static_cast<size_t>(block_size) * hidden_size,
+                  block_weights.data() + static_cast<size_t>(gate) * block_size * hidden_size);
+    }
+
+    MlasGemmPackB(CblasTrans, num_gates * block_size, hidden_size, block_weights.data(), hidden_size,
+                  packed_weights);
+    packed_weights = static_cast<uint8_t*>(packed_weights) + packed_block_size;
+  }
+}
+
+const void* PackedRecurrentBlock(const void* packed_weights, const int num_gates, const int hidden_size,
+                                 const int block) {
+  const size_t packed_block_size = MlasGemmPackBSize(num_gates * kRecurrentBlockSize, hidden_size);
+  return static_cast<const uint8_t*>(packed_weights) + block * packed_block_size;
+}
+
 namespace deepcpu {
 
 constexpr float alpha_1 = 4.89352455891786e-03f;
@@ -169,6 +169,23 @@ struct PackedWeights {
   TensorShape shape_;
 };
 
+// Pre-packed float recurrence weights R can hold a separate MlasGemmPackB matrix for each block of
+// kRecurrentBlockSize hidden units, made of the rows of every gate for those units. The gates of a block can then be
+// computed right after its part of Ht-1*R^T while that is still in cache, and a thread can own a block of hidden
+// units (and its part of R) for the whole sequence.
+constexpr int kRecurrentBlockSize = 32;
+
+// Returns the size in bytes of num_gates gates of R for one direction packed by blocks of hidden units, or 0 if they
+// can't be packed.
+size_t PackedRecurrentWeightsSize(int num_gates, int hidden_size);
+
+// Packs num_gates gates of R [num_gates*hidden_size, hidden_size] for one direction into packed_weights of
+// PackedRecurrentWeightsSize() bytes.
+void PackRecurrentWeights(const float* weights, int num_gates, int hidden_size, void* packed_weights);
+
+// Returns the packed matrix of a block of hidden units in weights packed by PackRecurrentWeights().
+const void* PackedRecurrentBlock(const void* packed_weights, int num_gates, int hidden_size, int block);
+
 struct QuantizationParameter {
   QuantizationParameter(const float* scale,
                         const uint8_t* zero_point,
@@ -287,110 +287,115 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
 
   DumpMatrix("Xt*(W[iofc]^T)", output_iofc_.data(), total_rows, hidden_size_x4);
 
-  beta = 1.0f;  // calls to ComputeGemm now add to existing data
-
-  // NOTE: we could refine the bounds checking in the calls below that use these values to instead
-  // explicitly check just the range for each iteration, however if it's going to run over
-  // it should also run over on the last iteration, so this should be good enough to catch any
-  // logic errors causing bounds violations.
-  const span_T_iter C_prev_end = batched_internal_state_prev_one_step.end();
-  const span_T_iter C_prev_clipped_end = batched_internal_state_clipped_one_step.end();
-
-  int num_seq_to_compute = batch_size_;
-  if (batch_parallel_) {
-    num_seq_to_compute = batch_size_ / num_threads_;
-    if (batch_size_ % num_threads_ != 0)
-      num_seq_to_compute++;
-  }
+  if constexpr (std::is_same<WeightT, float>::value) {
+    ComputeFusedSteps(recurrent_weights, sequence_lengths, max_sequence_length, outputs, output_step_length,
+                      final_hidden_state, final_cell_state);
+  } else {
+    beta = 1.0f;  // calls to ComputeGemm now add to existing data
+
+    // NOTE: we could refine the bounds checking in the calls below that use these values to instead
+    // explicitly check just the range for each iteration, however if it's going to run over
+    // it should also run over on the last iteration, so this should be good enough to catch any
+    // logic errors causing bounds violations.
+    const span_T_iter C_prev_end = batched_internal_state_prev_one_step.end();
+    const span_T_iter C_prev_clipped_end = batched_internal_state_clipped_one_step.end();
+
+    int num_seq_to_compute = batch_size_;
+    if (batch_parallel_) {
+      num_seq_to_compute = batch_size_ / num_threads_;
+      if (batch_size_ % num_threads_ != 0)
+        num_seq_to_compute++;
+    }
 
-  // lambda to do all processing on num_seq_to_compute sequences
-  auto sequences_calculator = [&](int seq_start, onnxruntime::concurrency::ThreadPool* ttp) {
-    auto previous_state_end = batched_hidden_state_one_step.end();
+    // lambda to do all processing on num_seq_to_compute sequences
+    auto sequences_calculator = [&](int seq_start, onnxruntime::concurrency::ThreadPool* ttp) {
+      auto previous_state_end = batched_hidden_state_one_step.end();
 
-    // handling boundaries
-    int num_seq_to_compute_adjusted = num_seq_to_compute;
-    if ((seq_start + num_seq_to_compute) > batch_size_)
-      num_seq_to_compute_adjusted = batch_size_ - seq_start;
+      // handling boundaries
+      int num_seq_to_compute_adjusted = num_seq_to_compute;
+      if ((seq_start + num_seq_to_compute) > batch_size_)
+        num_seq_to_compute_adjusted = batch_size_ - seq_start;
 
-    // these are all batch * hidden_size_ and get updated in-place when running GateComputations so non-const iters
-    span_T_iter c_prev = batched_internal_state_prev_one_step.begin() + seq_start * hidden_size_;
-    span_T_iter c_prev_clipped = batched_internal_state_clipped_one_step.begin() + seq_start * hidden_size_;
+      // these are all batch * hidden_size_ and get updated in-place when running GateComputations so non-const iters
+      span_T_iter c_prev = batched_internal_state_prev_one_step.begin() + seq_start * hidden_size_;
+      span_T_iter c_prev_clipped = batched_internal_state_clipped_one_step.begin() + seq_start * hidden_size_;
 
-    // hidden state can be provided as input for first step, so need to special case that.
-    // after the first step this will switch to the output from the previous step
-    auto previous_state = batched_hidden_state_one_step.begin() + seq_start * hidden_size_;
+      // hidden state can be provided as input for first step, so need to special case that.
+      // after the first step this will switch to the output from the previous step
+      auto previous_state = batched_hidden_state_one_step.begin() + seq_start * hidden_size_;
 
-    // run through steps sequentially
-    for (int step = 0; step < max_sequence_length; step++) {
+      // run through steps sequentially
+      for (int step = 0; step < max_sequence_length; step++) {
 #if defined(DUMP_MATRIXES)
-      const std::string row_str = " [row=" + std::to_string(row) + ",seqno=" + std::to_string(step) + "]";
+        const std::string row_str = " [row=" + std::to_string(row) + ",seqno=" + std::to_string(step) + "]";
 #endif
 
-      span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_ + seq_start) * hidden_size_x4;
-
-      // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
-      // Do it sequentially to avoid nested parallelism
-      ComputeGemm(num_seq_to_compute_adjusted, hidden_size_x4, hidden_size_, alpha,
-                  gsl::span<const T>(&*previous_state, previous_state_end - previous_state),  // Ht-1
-                  recurrent_weights,                                                          // R[iofc]
-                  beta, gsl::span<T>(&*step_out_IOFC, output_iofc_.end() - step_out_IOFC),    // input contains Xt*(W[iofc]^T)
-                  hidden_size_x4,
-                  quantized_input_or_a_.data() + (seq_start * hidden_size_),
-                  quantized_C_buffer_.data() + (seq_start * hidden_size_x4),
-                  ttp);
-
-      DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str, &*step_out_IOFC, num_seq_to_compute_adjusted, hidden_size_x4);
-
-      span_T_iter batched_output;
-      span_T_iter batched_output_end;
-      if (output_sequence) {
-        batched_output = outputs.begin() + step * output_step_length;
-        batched_output_end = outputs.end();
-
-      } else {
-        batched_output = final_hidden_state.begin();
-        batched_output_end = final_hidden_state.end();
-      }
-
-      span_T_iter step_out_IOFC_end = step_out_IOFC + num_seq_to_compute_adjusted * hidden_size_x4;
-      GateComputations(step_out_IOFC, step_out_IOFC_end, c_prev, C_prev_end, c_prev_clipped, C_prev_clipped_end,
-                       batched_output, batched_output_end, sequence_lengths, min_sequence_length, step, seq_start,
-                       num_seq_to_compute_adjusted, output_sequence);
-
-      // copy last row to final_cell_state
-      for (int lrow = seq_start; lrow < seq_start + num_seq_to_compute_adjusted; ++lrow) {
-        if ((step + 1) == sequence_lengths[lrow]) {
-          gsl::span<const T> src = batched_internal_memory_prev_.subspan(lrow * hidden_size_, hidden_size_);
-          gsl::span<T> dst = final_cell_state.subspan(lrow * hidden_size_, hidden_size_);
-          gsl::copy(src, dst);
+        span_T_iter step_out_IOFC = output_iofc_.begin() + (step * batch_size_ + seq_start) * hidden_size_x4;
+
+        // calculate Xt*(W[iofc]^T) + Ht-t*R[iofc]
+        // Do it sequentially to avoid nested parallelism
+        ComputeGemm(num_seq_to_compute_adjusted, hidden_size_x4, hidden_size_, alpha,
+                    gsl::span<const T>(&*previous_state, previous_state_end - previous_state),  // Ht-1
+                    recurrent_weights,                                                          // R[iofc]
+                    beta, gsl::span<T>(&*step_out_IOFC, output_iofc_.end() - step_out_IOFC),    // input contains Xt*(W[iofc]^T)
+                    hidden_size_x4,
+                    quantized_input_or_a_.data() + (seq_start * hidden_size_),
+                    quantized_C_buffer_.data() + (seq_start * hidden_size_x4),
+                    ttp);
+
+        DumpMatrix("Xt*(W[iofc]^T) + Ht-t*R[iofc]" + row_str, &*step_out_IOFC, num_seq_to_compute_adjusted, hidden_size_x4);
+
+        span_T_iter batched_output;
+        span_T_iter batched_output_end;
+        if (output_sequence) {
+          batched_output = outputs.begin() + step * output_step_length;
+          batched_output_end = outputs.end();
+
+        } else {
+          batched_output = final_hidden_state.begin();
+          batched_output_end = final_hidden_state.end();
         }
-        if (step == 0 && sequence_lengths[lrow] == 0) {
-          auto final_cell_state_dst = final_cell_state.begin() + lrow * hidden_size_;
-          std::fill_n(final_cell_state_dst, hidden_size_, T{});
+
+        span_T_iter step_out_IOFC_end = step_out_IOFC + num_seq_to_compute_adjusted * hidden_size_x4;
+        GateComputations(step_out_IOFC, step_out_IOFC_end, c_prev, C_prev_end, c_prev_clipped, C_prev_clipped_end,
+                         batched_output, batched_output_end, sequence_lengths, min_sequence_length, step, seq_start,
+                         num_seq_to_compute_adjusted, output_sequence);
+
+        // copy last row to final_cell_state
+        for (int lrow = seq_start; lrow < seq_start + num_seq_to_compute_adjusted; ++lrow) {
+          if ((step + 1) == sequence_lengths[lrow]) {
+            gsl::span<const T> src = batched_internal_memory_prev_.subspan(lrow * hidden_size_, hidden_size_);
+            gsl::span<T> dst = final_cell_state.subspan(lrow * hidden_size_, hidden_size_);
+            gsl::copy(src, dst);
+          }
+          if (step == 0 && sequence_lengths[lrow] == 0) {
+            auto final_cell_state_dst = final_cell_state.begin() + lrow * hidden_size_;
+            std::fill_n(final_cell_state_dst, hidden_size_, T{});
+          }
         }
-      }
 
-      if (output_sequence) {
-        // set to 0 if step >= sequence_length
-        for (int lrow = seq_start; lrow < seq_start + num_seq_to_compute_adjusted; lrow++) {
-          if (step >= min_sequence_length && step >= sequence_lengths[lrow]) {
-            auto output_lrow = outputs.begin() + step * output_step_length + lrow * hidden_size_;
-            std::fill_n(output_lrow, hidden_size_, (T)0);
+        if (output_sequence) {
+          // set to 0 if step >= sequence_length
+          for (int lrow = seq_start; lrow < seq_start + num_seq_to_compute_adjusted; lrow++) {
+            if (step >= min_sequence_length && step >= sequence_lengths[lrow]) {
+              auto output_lrow = outputs.begin() + step * output_step_length + lrow * hidden_size_;
+              std::fill_n(output_lrow, hidden_size_, (T)0);
+            }
           }
         }
+
+        previous_state = batched_output + seq_start * hidden_size_;
+        previous_state_end = batched_output_end;
       }
+    };
 
-      previous_state = batched_output + seq_start * hidden_size_;
-      previous_state_end = batched_output_end;
+    if (batch_parallel_) {
+      double gemm_cost = num_seq_to_compute * hidden_size_x4 * hidden_size_;
+      double cost = max_sequence_length * (gemm_cost + num_seq_to_compute);
+      ExecuteLambdaInParallel(sequences_calculator, batch_size_, num_seq_to_compute, cost, thread_pool_);
+    } else {
+      sequences_calculator(0, thread_pool_);
     }
-  };
-
-  if (batch_parallel_) {
-    double gemm_cost = num_seq_to_compute * hidden_size_x4 * hidden_size_;
-    double cost = max_sequence_length * (gemm_cost + num_seq_to_compute);
-    ExecuteLambdaInParallel(sequences_calculator, batch_size_, num_seq_to_compute, cost, thread_pool_);
-  } else {
-    sequences_calculator(0, thread_pool_);
   }
 
   for (int i = 0; i < batch_size_; i++) {
@@ -426,6 +431,230 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                        num_directions, thread_pool_);
 }
 
+template <typename T>
+void UniDirectionalLstm<T>::ComputeFusedSteps(const GemmWeights<T>& recurrent_weights,
+                                              const gsl::span<const int>& sequence_lengths,
+                                              const int max_sequence_length, gsl::span<T>& outputs,
+                                              const int output_step_length, gsl::span<T>& final_hidden_state,
+                                              gsl::span<T>& final_cell_state) {
+  const int num_blocks = (hidden_size_ + kRecurrentBlockSize - 1) / kRecurrentBlockSize;
+  const bool output_sequence = !outputs.empty();
+
+  recurrent_gates_ = Allocate(allocator_, batch_size_ * 4 * hidden_size_, recurrent_gates_ptr_);
+
+  // For small batches the blocks of hidden units are split between the threads instead of the rows, so each
+  // thread only reads its part of R at every step. All of Ht-1 is needed by every block so the threads
+  // synchronize once per step. Rows are still split if there are fewer blocks than rows to give to the threads.
+  int num_hidden_tasks = 1;
+  if (batch_size_ <= 8 && num_blocks >= (batch_parallel_ ? std::min(num_threads_, batch_size_) : 2)) {
+    num_hidden_tasks = std::min(num_threads_, num_blocks);
+  }
+
+  if (num_hidden_tasks > 1) {
+    // without output_sequence Ht of every step goes to the same place, where other threads may still read Ht-1
+    if (!output_sequence) {
+      hidden_steps_ = Allocate(allocator_, 2 * batch_size_ * hidden_size_, hidden_steps_ptr_);
+    }
+
+    const T* previous_state = batched_hidden0_.data();
+
+    for (int step = 0; step < max_sequence_length; step++) {
+      T* batched_output = output_sequence ? outputs.data() + step * output_step_length
+                                          : hidden_steps_.data() + (step % 2) * batch_size_ * hidden_size_;
+
+      concurrency::ThreadPool::TrySimpleParallelFor(
+          thread_pool_, num_hidden_tasks,
+          [&](std::ptrdiff_t task) {
+            const int first_block = static_cast<int>(task * num_blocks / num_hidden_tasks);
+            const int end_block = static_cast<int>((task + 1) * num_blocks / num_hidden_tasks);
+
+            for (int block = first_block; block < end_block; block++) {
+              ComputeRecurrentBlock(recurrent_weights, previous_state, 0, batch_size_, block);
+              BlockGateComputations(sequence_lengths, step, 0, batch_size_, block, batched_output, output_sequence);
+            }
+          });
+
+      previous_state = batched_output;
+    }
+
+    if (!output_sequence) {
+      // Ht isn't written past the sequence length of a row, so its last value is in the buffer of its last step
+      for (int lrow = 0; lrow < batch_size_; lrow++) {
+        const int seq_len = sequence_lengths[lrow];
+        if (seq_len > 0) {
+          gsl::span<const T> src =
+              hidden_steps_.subspan((((seq_len - 1) % 2) * batch_size_ + lrow) * hidden_size_, hidden_size_);
+          gsl::copy(src, final_hidden_state.subspan(lrow * hidden_size_, hidden_size_));
+        }
+      }
+    }
+  } else {
+    int num_seq_to_compute = batch_size_;
+    if (batch_parallel_) {
+      num_seq_to_compute = batch_size_ / num_threads_;
+      if (batch_size_ % num_threads_ != 0)
+        num_seq_to_compute++;
+    }
+
+    // lambda to do all processing on num_seq_to_compute sequences
+    auto sequences_calculator = [&](int seq_start, onnxruntime::concurrency::ThreadPool* /*ttp*/) {
+      const int num_rows = std::min(num_seq_to_compute, batch_size_ - seq_start);
+
+      // hidden state can be provided as input for first step, so need to special case that.
+      // after the first step this will switch to the output from the previous step
+      const T* previous_state = batched_hidden0_.data() + seq_start * hidden_size_;
+
+      for (int step = 0; step < max_sequence_length; step++) {
+        T* batched_output = output_sequence ? outputs.data() + step * output_step_length : final_hidden_state.data();
+
+        // Ht-1 and Ht may be the same buffer, so all of Ht-1*R[iofc]^T is computed before any of Ht is written
+        for (int block = 0; block < num_blocks; block++) {
+          ComputeRecurrentBlock(recurrent_weights, previous_state, seq_start, num_rows, block);
+        }
+
+        for (int block = 0; block < num_blocks; block++) {
+          BlockGateComputations(sequence_lengths, step, seq_start, num_rows, block, batched_output, output_sequence);
+        }
+
+        previous_state = batched_output + seq_start * hidden_size_;
+      }
+    };
+
+    if (batch_parallel_) {
+      double gemm_cost = num_seq_to_compute * 4 * hidden_size_ * hidden_size_;
+      double cost = max_sequence_length * (gemm_cost + num_seq_to_compute);
+      ExecuteLambdaInParallel(sequences_calculator, batch_size_, num_seq_to_compute, cost, thread_pool_);
+    } else {
+      sequences_calculator(0, nullptr);
+    }
+  }
+
+  // Ct isn't updated past the sequence length of a row, so it holds the final cell state
+  for (int lrow = 0; lrow < batch_size_; lrow++) {
+    gsl::span<T> dst = final_cell_state.subspan(lrow * hidden_size_, hidden_size_);
+    if (sequence_lengths[lrow] == 0) {
+      std::fill_n(dst.begin(), hidden_size_, T{});
+    } else {
+      gsl::copy(batched_internal_memory_prev_.subspan(lrow * hidden_size_, hidden_size_), dst);
+    }
+  }
+}
+
+template <typename T>
+void UniDirectionalLstm<T>::ComputeRecurrentBlock(const GemmWeights<T>& recurrent_weights, const T* previous_state,
+                                                  const int row, const int num_rows, const int block) {
+  const int hidden_size_x4 = 4 * hidden_size_;
+  const int block_start = block * kRecurrentBlockSize;
+  const int block_size = std::min(kRecurrentBlockSize, hidden_size_ - block_start);
+
+  float* gates = SafeRawPointer<T>(recurrent_gates_, row * hidden_size_x4 + 4 * block_start,
+                                   (num_rows - 1) * hidden_size_x4 + 4 * block_size);
+
+  // calculate Ht-1*R[iofc]^T for the block of hidden units.
+  // Do it sequentially to avoid nested parallelism
+  if (recurrent_weights.is_prepacked_) {
+    const void* packed_block = PackedRecurrentBlock(recurrent_weights.buffer_, 4, hidden_size_, block);
+
+    MlasGemm(CblasNoTrans, num_rows, 4 * block_size, hidden_size_, 1.0f,
+             previous_state, hidden_size_,
+             packed_block, 0.0f,
+             gates, hidden_size_x4, nullptr);
+  } else {
+    const gsl::span<const T> weights = recurrent_weights.GetUnpackedSpan();
+
+    for (int gate = 0; gate < 4; gate++) {
+      const T* gate_weights = SafeRawConstPointer<T>(weights.subspan((gate * hidden_size_ + block_start) * hidden_size_),
+                                                     0, block_size * hidden_size_);
+      MlasGemm(CblasNoTrans, CblasTrans, num_rows, block_size, hidden_size_, 1.0f,
+               previous_state, hidden_size_,
+               gate_weights, hidden_size_, 0.0f,
+               gates + gate * block_size, hidden_size_x4, nullptr);
+    }
+  }
+}
+
+// This function can't use session thread pool
+template <typename T>
+void UniDirectionalLstm<T>::BlockGateComputations(const gsl::span<const int>& seq_lengths, const int step,
+                                                  const int row, const int num_rows, const int block,
+                                                  T* batched_output, const bool output_sequence) {
+  const int hidden_size_x4 = 4 * hidden_size_;
+  const int block_start = block * kRecurrentBlockSize;
+  const int block_size = std::min(kRecurrentBlockSize, hidden_size_ - block_start);
+
+  const float* pBi = use_bias_ ? bias_WRi_.data() + block_start : nullptr;
+  const float* pBo = use_bias_ ? bias_WRo_.data() + block_start : nullptr;
+  const float* pBf = use_bias_ ? bias_WRf_.data() + block_start : nullptr;
+  const float* pBc = use_bias_ ? bias_WRc_.data() + block_start : nullptr;
+
+  for (int lrow = row; lrow < row + num_rows; lrow++) {
+    float* pH = batched_output + lrow * hidden_size_ + block_start;
+
+    if (step >= seq_lengths[lrow]) {
+      if (output_sequence) {
+        std::fill_n(pH, block_size, T{});
+      }
+
+      continue;
+    }
+
+    float* pi = SafeRawPointer<T>(recurrent_gates_, lrow * hidden_size_x4 + 4 * block_start, 4 * block_size);
+    float* po = pi + block_size;
+    float* pf = po + block_size;
+    float* pc = pf + block_size;
+
+    // add Xt*(W[iofc]^T)
+    const float* px = SafeRawPointer<T>(output_iofc_, (step * batch_size_ + lrow) * hidden_size_x4 + block_start,
+                                        3 * hidden_size_ + block_size);
+    deepcpu::elementwise_sum1(px, pi, block_size);
+    deepcpu::elementwise_sum1(px + hidden_size_, po, block_size);
+    deepcpu::elementwise_sum1(px + 2 * hidden_size_, pf, block_size);
+    deepcpu::elementwise_sum1(px + 3 * hidden_size_, pc, block_size);
+
+    float* pC = SafeRawPointer<T>(batched_internal_memory_prev_, lrow * hidden_size_ + block_start, block_size);
+
+    // Input Gate
+    if (use_peepholes_) {
+      deepcpu::elementwise_product(pC, peephole_i_.data() + block_start, pi, block_size);
+    }
+
+    clip_with_bias_ptr_(clip_, pBi, pi, block_size);
+    activation_f_.func(pi, block_size, activation_f_.alpha, activation_f_.beta);
+
+    // Forget Gate
+    if (input_forget_) {
+      for (int i = 0; i < block_size; i++) pf[i] = 1.0f - pi[i];
+    } else {
+      if (use_peepholes_) {
+        deepcpu::elementwise_product(pC, peephole_f_.data() + block_start, pf, block_size);
+      }
+
+      clip_with_bias_ptr_(clip_, pBf, pf, block_size);
+      activation_f_.func(pf, block_size, activation_f_.alpha, activation_f_.beta);
+    }
+
+    // Block Gate
+    clip_with_bias_ptr_(clip_, pBc, pc, block_size);
+    activation_g_.func(pc, block_size, activation_g_.alpha, activation_g_.beta);
+
+    // C_current. use previous C value as input, and update in-place
+    deepcpu::merge_lstm_gates_to_memory(pC, pi, pf, pc, pC, block_size);
+
+    // Output Gate
+    if (use_peepholes_) {
+      deepcpu::elementwise_product(pC, peephole_o_.data() + block_start, po, block_size);
+    }
+
+    clip_with_bias_ptr_(clip_, pBo, po, block_size);
+    activation_f_.func(po, block_size, activation_f_.alpha, activation_f_.beta);
+
+    // calculate 'Ht'. the clipped Ct is temporary storage for h()
+    float* pC_clipped =
+        SafeRawPointer<T>(batched_internal_memory_clipped_, lrow * hidden_size_ + block_start, block_size);
+    activation_h_.func(pC, pC_clipped, po, pH, block_size, activation_h_.alpha, activation_h_.beta);
+  }
+}
+
 // #define PREVIOUS_BROKEN_VERSION
 
 // This function can't use session thread pool
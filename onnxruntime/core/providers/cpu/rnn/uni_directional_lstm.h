@@ -44,6 +44,20 @@ class UniDirectionalLstm {
 
   void SetNumThreads();
 
+  // Runs the time loop for float weights, computing the recurrent GEMM and the gates block by block of hidden units.
+  void ComputeFusedSteps(const GemmWeights<T>& recurrent_weights, const gsl::span<const int>& sequence_lengths,
+                         int max_sequence_length, gsl::span<T>& outputs, int output_step_length,
+                         gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
+
+  // Computes Ht-1*R[iofc]^T for rows [row, row + num_rows) and the hidden units of block into recurrent_gates_.
+  void ComputeRecurrentBlock(const GemmWeights<T>& recurrent_weights, const T* previous_state, int row, int num_rows,
+                             int block);
+
+  // Adds Xt*W[iofc]^T to the recurrent_gates_ of rows [row, row + num_rows) and the hidden units of block, applies
+  // the gates and writes Ct and Ht of those units. batched_output points to Ht for row 0.
+  void BlockGateComputations(const gsl::span<const int>& seq_lengths, int step, int row, int num_rows, int block,
+                             T* batched_output, bool output_sequence);
+
   void GateComputations(span_T_iter& out, span_T_iter& out_end, span_T_iter& C_prev,
                         const span_T_iter& C_prev_end,  // Ct-1 value not 'ct'. using 'C' for clarity
                         span_T_iter& C_prev_clipped, const span_T_iter& C_prev_clipped_end, span_T_iter& batched_output,
@@ -92,6 +106,14 @@ class UniDirectionalLstm {
   gsl::span<T> bias_WRi_, bias_WRf_, bias_WRo_, bias_WRc_;
   gsl::span<T> inputs_reverse_, outputs_reverse_;
 
+  // [batch_size, 4*hidden_size] with the i, o, f and c gates of each block of hidden units next to each other
+  IAllocatorUniquePtr<T> recurrent_gates_ptr_;
+  gsl::span<T> recurrent_gates_;
+
+  // Ht of odd and even steps when threads owning different hidden units need Ht-1 while Ht is written
+  IAllocatorUniquePtr<T> hidden_steps_ptr_;
+  gsl::span<T> hidden_steps_;
+
 #if defined(LSTM_NO_PEEPHOLE_COPY)
   gsl::span<const T> peephole_i_, peephole_f_, peephole_o_;
 #else
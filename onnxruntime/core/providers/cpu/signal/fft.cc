@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/providers/cpu/signal/fft.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace onnxruntime {
+namespace signal {
+
+namespace {
+
+// exp(sign * 2 pi i * numerator / denominator), computed in double precision
+template <typename T>
+std::complex<T> unit_root(uint64_t numerator, uint64_t denominator, bool inverse) {
+  static const double tau = 2.0 * std::acos(-1.0);
+  const double angle = (inverse ? tau : -tau) * static_cast<double>(numerator % denominator) /
+                       static_cast<double>(denominator);
+  return std::complex<T>(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+}
+
+// multiplies by i, or by -i for the forward transform
+template <typename T>
+inline std::complex<T> rotate(const std::complex<T>& v, bool inverse) {
+  return inverse ? std::complex<T>(-v.imag(), v.real()) : std::complex<T>(v.imag(), -v.real());
+}
+
+template <typename T>
+inline void butterfly2(std::complex<T>* v) {
+  const auto t = v[0] - v[1];
+  v[0] += v[1];
+  v[1] = t;
+}
+
+template <typename T>
+inline void butterfly3(std::complex<T>* v, bool inverse) {
+  static const T sin_60 = static_cast<T>(std::sqrt(3.0) / 2);
+  const auto sum = v[1] + v[2];
+  const auto real_part = v[0] - sum * static_cast<T>(0.5);
+  const auto imag_part = rotate(v[1] - v[2], inverse) * sin_60;
+  v[0] += sum;
+  v[1] = real_part + imag_part;
+  v[2] = real_part - imag_part;
+}
+
+template <typename T>
+inline void butterfly4(std::complex<T>* v, bool inverse) {
+  const auto a = v[0] + v[2];
+  const auto b = v[0] - v[2];
+  const auto c = v[1] + v[3];
+  const auto d = rotate(v[1] - v[3], inverse);
+  v[0] = a + c;
+  v[1] = b + d;
+  v[2] = a - c;
+  v[3] = b - d;
+}
+
+template <typename T>
+inline void butterfly5(std::complex<T>* v, bool inverse) {
+  static const double tau = 2.0 * std::acos(-1.0);
+  static const T cos_1 = static_cast<T>(std::cos(tau / 5));
+  static const T cos_2 = static_cast<T>(std::cos(2 * tau / 5));
+  static const T sin_1 = static_cast<T>(std::sin(tau / 5));
+  static const T sin_2 = static_cast<T>(std::sin(2 * tau / 5));
+  const auto a1 = v[1] + v[4];
+  const auto a2 = v[2] + v[3];
+  const auto b1 = rotate(v[1] - v[4], inverse);
+  const auto b2 = rotate(v[2] - v[3], inverse);
+  const auto t1 = v[0] + a1 * cos_1 + a2 * cos_2;
+  const auto t2 = v[0] + a1 * cos_2 + a2 * cos_1;
+  const auto u1 = b1 * sin_1 + b2 * sin_2;
+  const auto u2 = b1 * sin_2 - b2 * sin_1;
+  v[0] += a1 + a2;
+  v[1] = t1 + u1;
+  v[4] = t1 - u1;
+  v[2] = t2 + u2;
+  v[3] = t2 - u2;
+}
+
+// splits length into radix 4, 2, 3 and 5 stages. returns false if length has any other prime factor.
+bool factorize(size_t length, std::vector<size_t>& radices) {
+  while (length % 4 == 0) {
+    radices.push_back(4);
+    length /= 4;
+  }
+  if (length % 2 == 0) {
+    radices.push_back(2);
+    length /= 2;
+  }
+  for (size_t radix : {3, 5}) {
+    while (length % radix == 0) {
+      radices.push_back(radix);
+      length /= radix;
+    }
+  }
+  return length == 1;
+}
+
+template <typename Plan>
+std::shared_ptr<const Plan> GetOrCreatePlan(std::map<std::pair<size_t, bool>, std::shared_ptr<const Plan>>& plans,
+                                            size_t length, bool inverse, size_t max_plans) {
+  const auto key = std::make_pair(length, inverse);
+  auto it = plans.find(key);
+  if (it != plans.end()) {
+    return it->second;
+  }
+  if (plans.size() >= max_plans) {
+    plans.clear();
+  }
+  auto plan = std::make_shared<const Plan>(length, inverse);
+  plans.emplace(key, plan);
+  return plan;
+}
+
+}  // namespace
+
+template <typename T>
+FFTPlan<T>::FFTPlan(size_t length, bool inverse) : length_(length), inverse_(inverse) {
+  ORT_ENFORCE(length > 0, "FFT length must be greater than zero.");
+
+  std::vector<size_t> radices;
+  if (factorize(length, radices)) {
+    size_t span = 1;
+    for (size_t radix : radices) {
+      Stage stage{radix, span, std::vector<std::complex<T>>(span * radix)};
+      for (size_t j = 0; j < span; ++j) {
+        for (size_t r = 0; r < radix; ++r) {
+          stage.twiddles[j * radix + r] = unit_root<T>(r * j, span * radix, inverse);
+        }
+      }
+      stages_.push_back(std::move(stage));
+      span *= radix;
+    }
+    return;
+  }
+
+  // Bluestein: X[k] = chirp[k] * sum_j (x[j] * chirp[j]) * conj(chirp[k - j]) with chirp[k] = exp(+/- pi i k^2 / n).
+  // The convolution is computed with a power-of-two transform of at least 2n - 1 values.
+  size_t convolution_length = 1;
+  while (convolution_length < 2 * length - 1) {
+    convolution_length <<= 1;
+  }
+  convolution_plan_ = std::make_unique<FFTPlan<T>>(convolution_length, false);
+
+  chirp_.resize(length);
+  for (size_t k = 0; k < length; ++k) {
+    // k^2 mod 2n keeps the angle small
+    const uint64_t k_squared = (static_cast<uint64_t>(k) * k) % (2 * static_cast<uint64_t>(length));
+    chirp_[k] = unit_root<T>(k_squared, 2 * length, inverse);
+  }
+
+  chirp_spectrum_.assign(convolution_length, std::complex<T>(0, 0));
+  const T scale = static_cast<T>(1) / static_cast<T>(convolution_length);
+  chirp_spectrum_[0] = std::conj(chirp_[0]) * scale;
+  for (size_t k = 1; k < length; ++k) {
+    chirp_spectrum_[k] = chirp_spectrum_[convolution_length - k] = std::conj(chirp_[k]) * scale;
+  }
+  std::vector<std::complex<T>> scratch(convolution_plan_->ScratchSize());
+  convolution_plan_->Transform(chirp_spectrum_.data(), scratch.data());
+}
+
+template <typename T>
+size_t FFTPlan<T>::ScratchSize() const {
+  if (convolution_plan_) {
+    return convolution_plan_->Length() + convolution_plan_->ScratchSize();
+  }
+  return length_;
+}
+
+template <typename T>
+void FFTPlan<T>::Transform(std::complex<T>* data, std::complex<T>* scratch) const {
+  if (convolution_plan_) {
+    BluesteinTransform(data, scratch);
+  } else {
+    MixedRadixTransform(data, scratch);
+  }
+}
+
+template <typename T>
+void FFTPlan<T>::MixedRadixTransform(std::complex<T>* data, std::complex<T>* scratch) const {
+  // Stockham autosort: every stage reads from one buffer and writes to the other in natural order, so no bit
+  // reversal pass is needed.
+  std::complex<T>* src = data;
+  std::complex<T>* dst = scratch;
+  std::complex<T> v[5];
+  for (const auto& stage : stages_) {
+    const size_t radix = stage.radix;
+    const size_t span = stage.span;
+    const size_t stride = length_ / radix;
+    for (size_t j = 0; j < stride; ++j) {
+      const size_t j_in_span = j % span;
+      const std::complex<T>* twiddles = stage.twiddles.data() + j_in_span * radix;
+      v[0] = src[j];
+      for (size_t r = 1; r < radix; ++r) {
+        v[r] = src[j + r * stride] * twiddles[r];
+      }
+
+      switch (radix) {
+        case 2:
+          butterfly2(v);
+          break;
+        case 3:
+          butterfly3(v, inverse_);
+          break;
+        case 4:
+          butterfly4(v, inverse_);
+          break;
+        default:
+          butterfly5(v, inverse_);
+          break;
+      }
+
+      std::complex<T>* out = dst + (j - j_in_span) * radix + j_in_span;
+      for (size_t r = 0; r < radix; ++r) {
+        out[r * span] = v[r];
+      }
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != data) {
+    std::copy(src, src + length_, data);
+  }
+}
+
+template <typename T>
+void FFTPlan<T>::BluesteinTransform(std::complex<T>* data, std::complex<T>* scratch) const {
+  const size_t convolution_length = convolution_plan_->Length();
+  std::complex<T>* buffer = scratch;
+  std::complex<T>* convolution_scratch = scratch + convolution_length;
+
+  for (size_t k = 0; k < length_; ++k) {
+    buffer[k] = data[k] * chirp_[k];
+  }
+  std::fill(buffer + length_, buffer + convolution_length, std::complex<T>(0, 0));
+
+  convolution_plan_->Transform(buffer, convolution_scratch);
+  // inverse transform of the product as conj(FFT(conj(.))). the 1 / convolution_length scale is in chirp_spectrum_.
+  for (size_t k = 0; k < convolution_length; ++k) {
+    buffer[k] = std::conj(buffer[k] * chirp_spectrum_[k]);
+  }
+  convolution_plan_->Transform(buffer, convolution_scratch);
+
+  for (size_t k = 0; k < length_; ++k) {
+    data[k] = std::conj(buffer[k]) * chirp_[k];
+  }
+}
+
+template <typename T>
+RealFFTPlan<T>::RealFFTPlan(size_t length, bool inverse)
+    : length_(length), half_plan_(length / 2, inverse) {
+  ORT_ENFORCE(length % 2 == 0, "Real FFT length must be even.");
+  twiddles_.resize(length / 2 + 1);
+  for (size_t k = 0; k <= length / 2; ++k) {
+    twiddles_[k] = unit_root<T>(k, length, inverse);
+  }
+}
+
+template <typename T>
+void RealFFTPlan<T>::Transform(std::complex<T>* data, std::complex<T>* output, std::complex<T>* scratch) const {
+  const size_t half = length_ / 2;
+  half_plan_.Transform(data, scratch);
+
+  // with z[m] = x[2m] + i x[2m + 1], Z = E + i O where E and O are the transforms of the even and odd samples.
+  // both are transforms of real input, so E[k] = (Z[k] + conj(Z[half - k])) / 2 and
+  // O[k] = (Z[k] - conj(Z[half - k])) / 2i, and X[k] = E[k] + twiddle[k] * O[k].
+  for (size_t k = 0; k <= half; ++k) {
+    const auto z = data[k == half ? 0 : k];
+    const auto z_mirror = std::conj(data[k == 0 ? 0 : half - k]);
+    const auto even = (z + z_mirror) * static_cast<T>(0.5);
+    const auto odd_times_2i = z - z_mirror;
+    const auto odd = std::complex<T>(odd_times_2i.imag(), -odd_times_2i.real()) * static_cast<T>(0.5);
+    output[k] = even + twiddles_[k] * odd;
+  }
+}
+
+template <>
+FFTPlanCache::Plans<float>& FFTPlanCache::GetPlans<float>() {
+  return float_plans_;
+}
+
+template <>
+FFTPlanCache::Plans<double>& FFTPlanCache::GetPlans<double>() {
+  return double_plans_;
+}
+
+template <typename T>
+std::shared_ptr<const FFTPlan<T>> FFTPlanCache::GetPlan(size_t length, bool inverse) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return GetOrCreatePlan(GetPlans<T>().complex_plans, length, inverse, kMaxCachedPlans);
+}
+
+template <typename T>
+std::shared_ptr<const RealFFTPlan<T>> FFTPlanCache::GetRealPlan(size_t length, bool inverse) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return GetOrCreatePlan(GetPlans<T>().real_plans, length, inverse, kMaxCachedPlans);
+}
+
+template class FFTPlan<float>;
+template class FFTPlan<double>;
+template class RealFFTPlan<float>;
+template class RealFFTPlan<double>;
+template std::shared_ptr<const FFTPlan<float>> FFTPlanCache::GetPlan<float>(size_t, bool);
+template std::shared_ptr<const FFTPlan<double>> FFTPlanCache::GetPlan<double>(size_t, bool);
+template std::shared_ptr<const RealFFTPlan<float>> FFTPlanCache::GetRealPlan<float>(size_t, bool);
+template std::shared_ptr<const RealFFTPlan<double>> FFTPlanCache::GetRealPlan<double>(size_t, bool);
+
+}  // namespace signal
+}  // namespace onnxruntime
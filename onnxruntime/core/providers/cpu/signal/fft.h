@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <complex>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+namespace signal {
+
+// Precomputed plan for the unnormalized complex DFT of a fixed length and direction.
+// Lengths whose prime factors are all 2, 3 or 5 are computed with a mixed-radix (4, 2, 3, 5) Stockham FFT.
+// Any other length is computed with Bluestein's algorithm as a convolution of power-of-two length, so every
+// length runs in O(n log n).
+template <typename T>
+class FFTPlan {
+ public:
+  FFTPlan(size_t length, bool inverse);
+
+  size_t Length() const { return length_; }
+
+  // Number of complex values of scratch memory Transform needs.
+  size_t ScratchSize() const;
+
+  // Transforms Length() contiguous values of data in place.
+  void Transform(std::complex<T>* data, std::complex<T>* scratch) const;
+
+ private:
+  struct Stage {
+    size_t radix;
+    // product of the radices of the previous stages
+    size_t span;
+    // twiddles_[j * radix + r] = exp(+/- 2 pi i * r * j / (span * radix)) for j < span
+    std::vector<std::complex<T>> twiddles;
+  };
+
+  void MixedRadixTransform(std::complex<T>* data, std::complex<T>* scratch) const;
+  void BluesteinTransform(std::complex<T>* data, std::complex<T>* scratch) const;
+
+  size_t length_;
+  bool inverse_;
+  std::vector<Stage> stages_;
+
+  // Bluestein's algorithm
+  std::unique_ptr<FFTPlan<T>> convolution_plan_;
+  std::vector<std::complex<T>> chirp_;
+  // transform of the conjugated chirp, scaled by 1 / convolution length
+  std::vector<std::complex<T>> chirp_spectrum_;
+};
+
+// Plan for the DFT of real input of even length.
+// The real values are transformed as Length() / 2 complex values and the spectrum is split afterwards, which halves
+// the work of the complex transform. Only the Length() / 2 + 1 leading outputs are produced; the rest follow from
+// conjugate symmetry.
+template <typename T>
+class RealFFTPlan {
+ public:
+  RealFFTPlan(size_t length, bool inverse);
+
+  size_t Length() const { return length_; }
+
+  size_t ScratchSize() const { return half_plan_.ScratchSize(); }
+
+  // data holds the Length() real inputs packed as Length() / 2 complex values and is overwritten.
+  // Writes Length() / 2 + 1 values to output.
+  void Transform(std::complex<T>* data, std::complex<T>* output, std::complex<T>* scratch) const;
+
+ private:
+  size_t length_;
+  FFTPlan<T> half_plan_;
+  // exp(+/- 2 pi i * k / length) for k <= length / 2
+  std::vector<std::complex<T>> twiddles_;
+};
+
+// Thread-safe cache of plans keyed by (length, inverse), owned by a kernel so the twiddle tables are computed once
+// and reused across frames, batches and runs.
+class FFTPlanCache {
+ public:
+  template <typename T>
+  std::shared_ptr<const FFTPlan<T>> GetPlan(size_t length, bool inverse);
+
+  template <typename T>
+  std::shared_ptr<const RealFFTPlan<T>> GetRealPlan(size_t length, bool inverse);
+
+ private:
+  // the number of distinct lengths is usually tiny. bound the memory if dft_length keeps changing.
+  static constexpr size_t kMaxCachedPlans = 16;
+
+  template <typename T>
+  struct Plans {
+    std::map<std::pair<size_t, bool>, std::shared_ptr<const FFTPlan<T>>> complex_plans;
+    std::map<std::pair<size_t, bool>, std::shared_ptr<const RealFFTPlan<T>>> real_plans;
+  };
+
+  template <typename T>
+  Plans<T>& GetPlans();
+
+  OrtMutex mutex_;
+  Plans<float> float_plans_;
+  Plans<double> double_plans_;
+};
+
+}  // namespace signal
+}  // namespace onnxruntime
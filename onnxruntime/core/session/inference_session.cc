@@ -4,7 +4,9 @@
 #include "core/graph/onnx_protobuf.h"
 #include "core/session/inference_session.h"
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <unordered_set>
 #include <list>
@@ -19,6 +21,7 @@
 #include "core/flatbuffers/ort_format_version.h"
 #include "core/framework/allocatormgr.h"
 #include "core/framework/bfc_arena.h"
+#include "core/framework/captured_run.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_frame.h"
 #include "core/framework/feeds_fetches_manager.h"
@@ -48,6 +51,7 @@
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/providers/cpu/cpu_provider_factory_creator.h"
 #ifdef USE_DML  // TODO: This is necessary for the workaround in TransformGraph
 #include "core/providers/dml/DmlExecutionProvider/src/DmlGraphFusionTransformer.h"
 #include "core/providers/dml/DmlExecutionProvider/src/GraphTransformer.h"
@@ -292,6 +296,8 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         to.allow_spinning = allow_intra_op_spinning;
         to.dynamic_block_base_ = std::stoi(session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDynamicBlockBase, "0"));
         LOGS(*session_logger_, INFO) << "Dynamic block base set to " << to.dynamic_block_base_;
+        to.adaptive_block_size_ =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAdaptiveBlockSize, "0") == "1";
 
         // Set custom threading functions
         to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
@@ -1270,8 +1276,7 @@ common::Status InferenceSession::Initialize() {
     // RegisterExecutionProvider locks the session_mutex_ so we can't be holding it when we call that
     if (!have_cpu_ep) {
       LOGS(*session_logger_, INFO) << "Adding default CPU execution provider.";
-      CPUExecutionProviderInfo epi{session_options_.enable_cpu_mem_arena};
-      auto p_cpu_exec_provider = std::make_unique<CPUExecutionProvider>(epi, true /* delay allocator registration to allow sharing */);
+      auto p_cpu_exec_provider = CPUProviderFactoryCreator::Create(session_options_)->CreateProvider();
       ORT_RETURN_IF_ERROR_SESSIONID_(RegisterExecutionProvider(std::move(p_cpu_exec_provider)));
       execution_providers_.SetCpuProviderWasImplicitlyAdded(true);
     }
@@ -1515,6 +1520,10 @@ common::Status InferenceSession::Initialize() {
     // Resolve memory pattern flags of the main graph and subgraph session states
     ResolveMemoryPatternFlags(*session_state_);
 
+    enable_cpu_run_capture_ =
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigEnableCpuRunCapture, "0") == "1" &&
+        CapturedRun::CanCapture(*session_state_);
+
     is_inited_ = true;
 
     if (!using_ort_model_bytes_for_initializers_) {
@@ -1916,6 +1925,9 @@ Status InferenceSession::Run(const RunOptions& run_options,
 
     InlinedVector<AllocatorPtr> arenas_to_shrink;
 
+    // a capture of an earlier run with the same arguments, reserved for this run to replay
+    std::shared_ptr<CapturedRun> captured_run;
+
     ORT_TRY {
       if (!is_inited_) {
         LOGS(*session_logger_, ERROR) << "Session was not initialized";
@@ -1925,28 +1937,42 @@ Status InferenceSession::Run(const RunOptions& run_options,
       // log evaluation start to trace logging provider
       env.GetTelemetryProvider().LogEvaluationStart();
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      const bool can_capture_run = enable_cpu_run_capture_ && p_fetches != nullptr &&
+                                   CanCaptureRun(run_options, p_fetches_device_info);
+      if (can_capture_run) {
+        captured_run = AcquireCapturedRun(feed_names, feeds, output_names, *p_fetches);
+      }
 
-      // shrink certain default memory arenas if the user has requested for it
-      const std::string& shrink_memory_arenas =
-          run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "");
+      // the feeds and fetches of a replay were validated and mapped by the captured run
+      std::optional<FeedsFetchesManager> feeds_fetches_manager;
+      bool fetches_preallocated = false;
+      if (!captured_run) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
 
-      if (!shrink_memory_arenas.empty()) {
-        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
-      }
+        // shrink certain default memory arenas if the user has requested for it
+        const std::string& shrink_memory_arenas =
+            run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "");
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+        if (!shrink_memory_arenas.empty()) {
+          ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
+        }
 
-      if (p_fetches_device_info) {
-        // populate the target device info. ignored if pre-allocated fetches are provided
-        const auto& fetch_device_info = *p_fetches_device_info;
-        auto& fetch_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
+        FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+        feeds_fetches_manager.emplace(std::move(info));
 
-        for (size_t i = 0, end = output_names.size(); i < end; ++i) {
-          fetch_info[i].target_device = fetch_device_info[i];
+        if (p_fetches_device_info) {
+          // populate the target device info. ignored if pre-allocated fetches are provided
+          const auto& fetch_device_info = *p_fetches_device_info;
+          auto& fetch_info = feeds_fetches_manager->GetMutableFetchesDeviceCopyInfo();
+
+          for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+            fetch_info[i].target_device = fetch_device_info[i];
+          }
         }
+
+        fetches_preallocated = std::any_of(p_fetches->cbegin(), p_fetches->cend(),
+                                           [](const OrtValue& fetch) { return fetch.IsAllocated(); });
       }
 
       if (!run_options.run_tag.empty()) {
@@ -1983,7 +2009,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
         // TODO: this method is not thread safe, if multiple Run happened in parallel we might hit race condition issue.
         // currently it only used in training, there is no parallel run execution in training so it is ok.
         // but it is better we can fix it with a better solution.
-        session_state_->UpdateToBeExecutedRange(feeds_fetches_manager.GetFeedsFetchesInfo().fetches_mlvalue_idxs);
+        session_state_->UpdateToBeExecutedRange(feeds_fetches_manager->GetFeedsFetchesInfo().fetches_mlvalue_idxs);
       }
 #endif
 
@@ -1992,9 +2018,21 @@ Status InferenceSession::Run(const RunOptions& run_options,
       session_state_->IncrementGraphExecutionCounter();
 #endif
 
-      ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(*session_state_, feeds_fetches_manager, feeds, *p_fetches,
-                                                   session_options_.execution_mode,
-                                                   run_options, run_logger));
+      if (captured_run) {
+        ORT_CHECK_AND_SET_RETVAL(utils::ReplayCapturedRun(*session_state_, *captured_run, feeds, *p_fetches,
+                                                          run_options, run_logger));
+        if (retval.IsOK()) {
+          captured_run->OnReplay();
+        }
+      } else {
+        ORT_CHECK_AND_SET_RETVAL(utils::ExecuteGraph(*session_state_, *feeds_fetches_manager, feeds, *p_fetches,
+                                                     session_options_.execution_mode,
+                                                     run_options, run_logger));
+
+        if (retval.IsOK() && can_capture_run && !fetches_preallocated) {
+          CaptureRun(*feeds_fetches_manager, feeds);
+        }
+      }
     }
     ORT_CATCH(const std::exception& e) {
       ORT_HANDLE_EXCEPTION([&]() {
@@ -2005,6 +2043,10 @@ Status InferenceSession::Run(const RunOptions& run_options,
       retval = Status(common::ONNXRUNTIME, common::RUNTIME_EXCEPTION, "Encountered unknown exception in Run()");
     }
 
+    if (captured_run) {
+      captured_run->Release();
+    }
+
     // info all execution providers InferenceSession:Run ended
     for (auto* xp : exec_providers_to_stop) {
       bool synchronize_execution_providers = run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigDisableSynchronizeExecutionProviders, "0") == "0";
@@ -2079,6 +2121,78 @@ common::Status InferenceSession::Run(const RunOptions& run_options, const NameML
   return Run(run_options, feed_names, feeds, output_names, p_fetches, nullptr);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions* run_options, gsl::span<const std::string> feed_names,
+                                          gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  ORT_RETURN_IF_NOT(callback, "RunAsync requires a callback.");
+  ORT_RETURN_IF_NOT(feed_names.size() == feeds.size(), "RunAsync: the number of feed names (", feed_names.size(),
+                    ") doesn't match the number of feeds (", feeds.size(), ").");
+  ORT_RETURN_IF_NOT(fetches.empty() || fetches.size() == output_names.size(),
+                    "RunAsync: the number of fetches (", fetches.size(), ") doesn't match the number of output names (",
+                    output_names.size(), ").");
+
+  // The inter-op pool only exists in the parallel execution mode, and a Run in that mode waits for its streams on
+  // the threads of that pool. The Runs are queued on the intra-op pool instead, the kernels of a Run running on one
+  // of its threads still split their work across the pool.
+  concurrency::ThreadPool* tp = GetIntraOpThreadPoolToUse();
+  ORT_RETURN_IF(tp == nullptr || concurrency::ThreadPool::DegreeOfParallelism(tp) < 2,
+                "RunAsync requires an intra-op thread pool with at least 2 threads.");
+
+  struct AsyncRun {
+    const RunOptions* run_options;
+    InlinedVector<std::string> feed_names;
+    InlinedVector<OrtValue> feeds;
+    InlinedVector<std::string> output_names;
+    std::vector<OrtValue> fetches;
+    RunAsyncCallback callback;
+  };
+
+  // shared so that the function copied by the thread pool doesn't copy the feeds
+  auto async_run = std::make_shared<AsyncRun>();
+  async_run->run_options = run_options;
+  async_run->feed_names.assign(feed_names.begin(), feed_names.end());
+  async_run->feeds.assign(feeds.begin(), feeds.end());
+  async_run->output_names.assign(output_names.begin(), output_names.end());
+  async_run->fetches = std::move(fetches);
+  async_run->callback = std::move(callback);
+
+  concurrency::ThreadPool::Schedule(tp, [this, async_run]() {
+    Status status;
+    ORT_TRY {
+      const RunOptions default_run_options;
+      status = Run(async_run->run_options ? *async_run->run_options : default_run_options, async_run->feed_names,
+                   async_run->feeds, async_run->output_names, &async_run->fetches, nullptr);
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception during RunAsync: ", e.what());
+      });
+    }
+    ORT_CATCH(...) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, "Unknown exception during RunAsync.");
+    }
+
+    if (!status.IsOK()) {
+      async_run->fetches.clear();
+    }
+
+    // an exception escaping a thread of the pool would terminate the process
+    ORT_TRY {
+      async_run->callback(status, async_run->fetches);
+    }
+    ORT_CATCH(const std::exception& e) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS(*session_logger_, ERROR) << "Exception in the RunAsync callback: " << e.what();
+      });
+    }
+    ORT_CATCH(...) {
+      LOGS(*session_logger_, ERROR) << "Unknown exception in the RunAsync callback.";
+    }
+  });
+
+  return Status::OK();
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -2417,6 +2531,61 @@ const logging::Logger& InferenceSession::CreateLoggerForRun(const RunOptions& ru
   return *run_logger;
 }
 
+bool InferenceSession::CanCaptureRun(const RunOptions& run_options,
+                                     const std::vector<OrtDevice>* p_fetches_device_info) const {
+#ifdef ENABLE_TRAINING
+  if (run_options.only_execute_path_to_fetches) {
+    return false;
+  }
+#endif
+
+  // the capture skips the device copies of the fetches and the shrinkage of the arenas
+  return p_fetches_device_info == nullptr &&
+         run_options.config_options.GetConfigOrDefault(kOrtRunOptionsConfigEnableMemoryArenaShrinkage, "").empty();
+}
+
+std::shared_ptr<CapturedRun> InferenceSession::AcquireCapturedRun(gsl::span<const std::string> feed_names,
+                                                                  gsl::span<const OrtValue> feeds,
+                                                                  gsl::span<const std::string> output_names,
+                                                                  const std::vector<OrtValue>& fetches) {
+  std::shared_ptr<CapturedRun> captured_run;
+  {
+    std::lock_guard<OrtMutex> lock(captured_run_mutex_);
+    captured_run = captured_run_;
+  }
+
+  if (captured_run && captured_run->Matches(feed_names, feeds, output_names, fetches) && captured_run->TryAcquire()) {
+    return captured_run;
+  }
+
+  return nullptr;
+}
+
+void InferenceSession::CaptureRun(const FeedsFetchesManager& feeds_fetches_manager, gsl::span<const OrtValue> feeds) {
+  // runs copying feeds or fetches across devices are not captured
+  if (feeds_fetches_manager.GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy) {
+    return;
+  }
+
+  const auto& info = feeds_fetches_manager.GetFeedsFetchesInfo();
+  {
+    std::lock_guard<OrtMutex> lock(captured_run_mutex_);
+    if (captured_run_ && captured_run_->Matches(info.feed_names, feeds, info.output_names, {})) {
+      return;
+    }
+  }
+
+  std::unique_ptr<CapturedRun> captured_run;
+  auto status = CapturedRun::Capture(*session_state_, info, feeds, captured_run);
+  if (!status.IsOK()) {
+    LOGS(*session_logger_, WARNING) << "Failed to capture the run: " << status.ErrorMessage();
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(captured_run_mutex_);
+  captured_run_ = std::move(captured_run);
+}
+
 void InferenceSession::InitLogger(logging::LoggingManager* logging_manager) {
   // create logger for session, using provided logging manager if possible
   if (logging_manager != nullptr) {
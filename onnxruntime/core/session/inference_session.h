@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -42,6 +43,7 @@ struct OrtCustomOpDomain {
 };
 
 namespace onnxruntime {  // forward declarations
+class CapturedRun;
 class CustomRegistry;
 class Environment;
 class GraphTransformer;
@@ -331,6 +333,26 @@ class InferenceSession {
                                    gsl::span<const std::string> output_names,
                                    std::vector<OrtValue>* p_fetches);
 
+  /**
+   * Called with the status of a RunAsync call and the fetches in the order of its output_names, or no fetches
+   * if the status is not OK. The fetches are only valid during the call, the callback must move or copy the values it keeps.
+   */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+   * Queues a Run of the model on the intra-op thread pool of the session and returns without waiting for it.
+   * callback is invoked on a thread of the pool with the result of the Run, including the errors of Run itself.
+   * This lets a caller serve many concurrent requests without blocking one of its threads per request.
+   * feed_names, feeds and output_names are copied. Preallocated fetches can be given in fetches, otherwise it
+   * may be empty.
+   * run_options, if not nullptr, and the session must stay alive until callback is invoked; keeping run_options
+   * allows terminating the Run with its terminate flag.
+   * @return OK if the Run was queued. Otherwise callback is not invoked.
+   */
+  [[nodiscard]] common::Status RunAsync(const RunOptions* run_options, gsl::span<const std::string> feed_names,
+                                        gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                        std::vector<OrtValue> fetches, RunAsyncCallback callback);
+
   /**
    * Creates a new binding object for binding inputs and outputs.
    * @param provider_type specifies the location where the inputs need to be potentially copied.
@@ -520,6 +542,12 @@ class InferenceSession {
 
   bool IsInitialized() const;
 
+  // The last run captured if kOrtSessionOptionsConfigEnableCpuRunCapture is enabled, or nullptr.
+  std::shared_ptr<const CapturedRun> GetCapturedRun() const {
+    std::lock_guard<OrtMutex> lock(captured_run_mutex_);
+    return captured_run_;
+  }
+
   // Use these 2 threadpool methods to get access to the threadpools since they rely on
   // specific flags in session options
   // These methods assume that session options have been finalized before the call.
@@ -614,6 +642,18 @@ class InferenceSession {
 
   void InitLogger(logging::LoggingManager* logging_manager);
 
+  // Returns true if a run with these arguments may replay or be captured, see kOrtSessionOptionsConfigEnableCpuRunCapture.
+  bool CanCaptureRun(const RunOptions& run_options, const std::vector<OrtDevice>* p_fetches_device_info) const;
+
+  // Returns the captured run if it matches the arguments and could be reserved for a replay, nullptr otherwise.
+  std::shared_ptr<CapturedRun> AcquireCapturedRun(gsl::span<const std::string> feed_names,
+                                                  gsl::span<const OrtValue> feeds,
+                                                  gsl::span<const std::string> output_names,
+                                                  const std::vector<OrtValue>& fetches);
+
+  // Replaces the captured run with a capture of a run that succeeded with these arguments.
+  void CaptureRun(const FeedsFetchesManager& feeds_fetches_manager, gsl::span<const OrtValue> feeds);
+
   [[nodiscard]] common::Status CheckShapes(const std::string& input_name, const TensorShape& input_shape,
                                            const TensorShape& expected_shape) const;
 
@@ -860,6 +900,12 @@ class InferenceSession {
   };
 
   CachedExecutionProviderForGraphReplay cached_execution_provider_for_graph_replay_;
+
+  // Set if kOrtSessionOptionsConfigEnableCpuRunCapture is enabled and the plan of the main graph can be captured.
+  bool enable_cpu_run_capture_ = false;
+  // The last captured run. Replays hold a reference to it, so it can be replaced while they run.
+  mutable OrtMutex captured_run_mutex_;
+  std::shared_ptr<CapturedRun> captured_run_;
 };
 
 struct SessionIOBinding {
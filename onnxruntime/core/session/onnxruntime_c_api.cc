@@ -816,17 +816,16 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
-ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
-                    _In_reads_(input_len) const char* const* input_names,
-                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
-                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
-                    _Inout_updates_all_(output_names_len) OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+namespace {
 
-  InlinedVector<std::string> feed_names;
+// Copies the names and values passed to Run and RunAsync, checking that none of them is missing.
+ORT_STATUS_PTR GetRunArguments(_In_reads_(input_len) const char* const* input_names,
+                               _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                               _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                               _In_reads_(output_names_len) OrtValue* const* output,
+                               InlinedVector<std::string>& feed_names, InlinedVector<OrtValue>& feeds,
+                               InlinedVector<std::string>& output_names, std::vector<OrtValue>& fetches) {
   feed_names.reserve(input_len);
-  InlinedVector<OrtValue> feeds;
   feeds.reserve(input_len);
 
   for (size_t i = 0; i != input_len; ++i) {
@@ -844,7 +843,6 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
   }
 
   // Create output feed
-  InlinedVector<std::string> output_names;
   output_names.reserve(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
@@ -853,7 +851,6 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
     output_names.emplace_back(output_names1[i]);
   }
 
-  std::vector<OrtValue> fetches;
   fetches.reserve(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output[i] != nullptr) {
@@ -863,17 +860,12 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
     }
   }
 
-  Status status;
-  if (run_options == nullptr) {
-    OrtRunOptions op;
-    status = session->Run(op, feed_names, feeds, output_names, &fetches, nullptr);
-  } else {
-    status = session->Run(*run_options, feed_names, feeds, output_names, &fetches, nullptr);
-  }
-
-  if (!status.IsOK())
-    return ToOrtStatus(status);
+  return nullptr;
+}
 
+// Sets the outputs that the caller left as nullptr to new OrtValues holding the fetches.
+void SetRunOutputs(const std::vector<OrtValue>& fetches, size_t output_names_len,
+                   _Inout_updates_all_(output_names_len) OrtValue** output) {
   // We do it in two loops to make sure copy __ctors does not throw
   InlinedVector<std::unique_ptr<OrtValue>> output_unique_ptrs;
   output_unique_ptrs.reserve(output_names_len);
@@ -893,10 +885,84 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
       output[i] = output_unique_ptrs[i].release();
     }
   }
+}
+
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> feed_names;
+  InlinedVector<OrtValue> feeds;
+  InlinedVector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  ORT_API_RETURN_IF_ERROR(GetRunArguments(input_names, input, input_len, output_names1, output_names_len, output,
+                                          feed_names, feeds, output_names, fetches));
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, feed_names, feeds, output_names, &fetches, nullptr);
+  } else {
+    status = session->Run(*run_options, feed_names, feeds, output_names, &fetches, nullptr);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  SetRunOutputs(fetches, output_names_len, output);
   return nullptr;
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output,
+                    _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  if (run_async_callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "run_async_callback cannot be null");
+  }
+
+  InlinedVector<std::string> feed_names;
+  InlinedVector<OrtValue> feeds;
+  InlinedVector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  ORT_API_RETURN_IF_ERROR(GetRunArguments(input_names, input, input_len, output_names1, output_names_len, output,
+                                          feed_names, feeds, output_names, fetches));
+
+  auto callback = [output, output_names_len, run_async_callback, user_data](const Status& status,
+                                                                            std::vector<OrtValue>& run_fetches) {
+    std::unique_ptr<OrtStatus, decltype(&OrtApis::ReleaseStatus)> ort_status(ToOrtStatus(status),
+                                                                             &OrtApis::ReleaseStatus);
+    if (ort_status == nullptr) {
+      ORT_TRY {
+        SetRunOutputs(run_fetches, output_names_len, output);
+      }
+      ORT_CATCH(const std::exception& e) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          ort_status.reset(OrtApis::CreateStatus(ORT_FAIL, e.what()));
+        });
+      }
+    }
+
+    run_async_callback(user_data, output, output_names_len, ort_status.get());
+  };
+
+  return ToOrtStatus(session->RunAsync(run_options, feed_names, feeds, output_names, std::move(fetches),
+                                       std::move(callback)));
+  API_IMPL_END
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -2235,6 +2301,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->max_dead_bytes_per_chunk = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "initial_growth_chunk_size_bytes") == 0) {
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_bytes") == 0) {
+      cfg->thread_cache_bytes = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2697,6 +2765,9 @@ static constexpr OrtApi ort_api_1_to_15 = {
     &OrtApis::UpdateDnnlProviderOptions,
     &OrtApis::GetDnnlProviderOptionsAsString,
     &OrtApis::ReleaseDnnlProviderOptions,
+    &OrtApis::RunAsync,
+    &OrtApis::SetGlobalAdaptiveBlockSize,
+    &OrtApis::RunOptionsSetGenerationStreamingCallback,
 };
 
 // Asserts to do a some checks to ensure older Versions of the OrtApi never change (will detect an addition or deletion but not if they cancel out each other)
@@ -442,4 +442,16 @@ ORT_API_STATUS_IMPL(GetDnnlProviderOptionsAsString, _In_ const OrtDnnlProviderOp
                     _Inout_ OrtAllocator* allocator, _Outptr_ char** ptr);
 ORT_API(void, ReleaseDnnlProviderOptions, _Frees_ptr_opt_ OrtDnnlProviderOptions*);
 
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output,
+                    _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+
+ORT_API_STATUS_IMPL(SetGlobalAdaptiveBlockSize, _Inout_ OrtThreadingOptions* tp_options, int adaptive_block_size);
+
+ORT_API_STATUS_IMPL(RunOptionsSetGenerationStreamingCallback, _Inout_ OrtRunOptions* options,
+                    _In_opt_ GenerationStreamingCallbackFn callback, _In_opt_ void* user_data);
+
 }  // namespace OrtApis
@@ -115,6 +115,7 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   to.custom_thread_creation_options = options.custom_thread_creation_options;
   to.custom_join_thread_fn = options.custom_join_thread_fn;
   to.dynamic_block_base_ = options.dynamic_block_base_;
+  to.adaptive_block_size_ = options.adaptive_block_size_;
   if (to.custom_create_thread_fn) {
     ORT_ENFORCE(to.custom_join_thread_fn, "custom join thread function not set");
   }
@@ -183,6 +184,18 @@ ORT_API_STATUS_IMPL(SetGlobalDenormalAsZero, _Inout_ OrtThreadingOptions* tp_opt
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(SetGlobalAdaptiveBlockSize, _Inout_ OrtThreadingOptions* tp_options, int adaptive_block_size) {
+  if (!tp_options) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions");
+  }
+  if (!(adaptive_block_size == 1 || adaptive_block_size == 0)) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received invalid value for adaptive_block_size. Valid values are 0 or 1");
+  }
+  // Only the intra-op pool runs the parallel loops of the operators.
+  tp_options->intra_op_thread_pool_params.adaptive_block_size_ = (adaptive_block_size != 0);
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(SetGlobalCustomCreateThreadFn, _Inout_ OrtThreadingOptions* tp_options, _In_ OrtCustomCreateThreadFn ort_custom_create_thread_fn) {
   if (!tp_options) {
     return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "Received null OrtThreadingOptions");
@@ -25,6 +25,10 @@ struct OrtThreadPoolParams {
   //of remaining_of_total_iterations / (num_of_threads * dynamic_block_base_)
   int dynamic_block_base_ = 0;
 
+  //If it is true, the thread pool measures the cost of the loops run by TryParallelFor
+  //and uses it instead of the cost given by the caller to split the next runs of the same loop.
+  bool adaptive_block_size_ = false;
+
   unsigned int stack_size = 0;
 
   // A utf-8 string of affinity settings, format be like:
@@ -335,9 +335,7 @@ std::unique_ptr<IExecutionProvider> CreateExecutionProviderInstance(
     const std::string& type,
     const ProviderOptionsMap& provider_options_map) {
   if (type == kCpuExecutionProvider) {
-    return onnxruntime::CPUProviderFactoryCreator::Create(
-               session_options.enable_cpu_mem_arena)
-        ->CreateProvider();
+    return onnxruntime::CPUProviderFactoryCreator::Create(session_options)->CreateProvider();
   } else if (type == kTensorrtExecutionProvider) {
 #ifdef USE_TENSORRT
     // If the environment variable 'ORT_TENSORRT_UNAVAILABLE' exists, then we do not load TensorRT. This is set by _ld_preload for the manylinux case
@@ -1085,6 +1083,8 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
         ort_arena_cfg->max_dead_bytes_per_chunk = kvp.second.cast<int>();
       } else if (key == "initial_growth_chunk_size_bytes") {
         ort_arena_cfg->initial_growth_chunk_size_bytes = kvp.second.cast<int>();
+      } else if (key == "thread_cache_bytes") {
+        ort_arena_cfg->thread_cache_bytes = kvp.second.cast<int>();
         } else {
         ORT_THROW("Invalid OrtArenaCfg option: ", key);
       }
@@ -1095,7 +1095,8 @@ void addObjectMethods(py::module& m, Environment& env, ExecutionProviderRegistra
       .def_readwrite("arena_extend_strategy", &OrtArenaCfg::arena_extend_strategy)
       .def_readwrite("initial_chunk_size_bytes", &OrtArenaCfg::initial_chunk_size_bytes)
       .def_readwrite("max_dead_bytes_per_chunk", &OrtArenaCfg::max_dead_bytes_per_chunk)
-      .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes);
+      .def_readwrite("initial_growth_chunk_size_bytes", &OrtArenaCfg::initial_growth_chunk_size_bytes)
+      .def_readwrite("thread_cache_bytes", &OrtArenaCfg::thread_cache_bytes);
 
   py::class_<OrtMemoryInfo> ort_memory_info_binding(m, "OrtMemoryInfo");
   ort_memory_info_binding.def(py::init([](const char* name, OrtAllocatorType type, int id, OrtMemType mem_type) {
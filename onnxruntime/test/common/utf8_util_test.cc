@@ -41,5 +41,18 @@ TEST(Utf8UtilTest, Validate) {
   }
 }
 
+TEST(Utf8UtilTest, Ascii) {
+  using namespace utf8_util;
+  const std::string mixed = "Hello, World! 0123456789 \xc3\xb1 ascii tail";
+  const size_t ascii_len = mixed.find('\xc3');
+  ASSERT_EQ(ascii_len, ascii_prefix_len(reinterpret_cast<const unsigned char*>(mixed.data()), mixed.size()));
+
+  std::string str = "Hello, World! [@`{] 0123456789 xyz";
+  ascii_change_case(str.data(), str.size(), false);
+  ASSERT_EQ("hello, world! [@`{] 0123456789 xyz", str);
+  ascii_change_case(str.data(), str.size(), true);
+  ASSERT_EQ("HELLO, WORLD! [@`{] 0123456789 XYZ", str);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -1,12 +1,17 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/contrib_ops/generation_test_helper.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
 
@@ -94,6 +99,102 @@ TEST(BeamSearchTest, GptBeamSearchFp32) {
   ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
 }
 
+// Inputs of GptBeamSearchFp32.
+static GptGenerationInputs GptBeamSearchFp32Inputs() {
+  GptGenerationInputs inputs;
+  inputs.input_ids_shape = {3, 12};
+  inputs.input_ids = {
+      0, 0, 0, 0, 0, 52, 195, 731, 321, 301, 734, 620,
+      41, 554, 74, 622, 206, 222, 75, 223, 221, 198, 224, 572,
+      0, 0, 0, 52, 328, 219, 328, 206, 288, 227, 896, 328};
+  inputs.max_length = 20;
+  inputs.num_beams = 4;
+  return inputs;
+}
+
+TEST(BeamSearchTest, GptBeamSearchFp32_CompactFinishedSequences) {
+  // The second batch entry generates 292 first in GptBeamSearchFp32. Using it as EOS finishes that entry
+  // early while the others are still searched, so its beams are evicted from the decoder batch.
+  // The output shall be the same as without compaction.
+  constexpr int32_t pad_token_id = 98;
+  const std::string model_data = LoadGenerationModel(ORT_TSTR("testdata/transformers/tiny_gpt2_beamsearch.onnx"),
+                                                     {{"eos_token_id", 292}});
+  const GptGenerationInputs inputs = GptBeamSearchFp32Inputs();
+
+  Ort::SessionOptions session_options;
+  const GptGenerationOutputs expected = RunGptGeneration(model_data, inputs, session_options, Ort::RunOptions{});
+
+  Ort::SessionOptions compact_session_options;
+  compact_session_options.AddConfigEntry(kOrtSessionOptionsConfigGenerationCompactFinishedSequences, "1");
+  const GptGenerationOutputs compacted = RunGptGeneration(model_data, inputs, compact_session_options,
+                                                          Ort::RunOptions{});
+
+  const std::vector<int64_t> expected_output_shape{inputs.input_ids_shape[0], inputs.num_return_sequences,
+                                                   inputs.max_length};
+  ASSERT_EQ(expected_output_shape, expected.sequences_shape);
+  ASSERT_EQ(expected.sequences_shape, compacted.sequences_shape);
+  ASSERT_EQ(expected.sequences, compacted.sequences);
+
+  const size_t finished = CountFinishedSequences(compacted, pad_token_id);
+  ASSERT_GT(finished, 0U);
+  ASSERT_LT(finished, static_cast<size_t>(inputs.input_ids_shape[0]));
+}
+
+TEST(BeamSearchTest, GptBeamSearchFp32_StreamingCallback) {
+  const GptGenerationInputs inputs = GptBeamSearchFp32Inputs();
+  const int64_t batch_size = inputs.input_ids_shape[0];
+  const int64_t prompt_length = inputs.input_ids_shape[1];
+
+  // Every beam is rebuilt from the streamed tokens: at each step, beam i continues the beam beam_indices[i]
+  // of the previous step with next_tokens[i].
+  struct StreamedBeams {
+    int32_t num_beams;
+    int32_t sequence_length;
+    std::vector<std::vector<int32_t>> beams;
+  };
+  StreamedBeams streamed{inputs.num_beams, static_cast<int32_t>(prompt_length),
+                         std::vector<std::vector<int32_t>>(static_cast<size_t>(batch_size * inputs.num_beams))};
+
+  GenerationStreamingCallbackFn callback = [](void* user_data, int32_t sequence_length, const int32_t* next_tokens,
+                                              const int32_t* beam_indices, int64_t batch_beam_size) {
+    auto* state = reinterpret_cast<StreamedBeams*>(user_data);
+    ASSERT_NE(beam_indices, nullptr);
+    ASSERT_EQ(static_cast<size_t>(batch_beam_size), state->beams.size());
+    EXPECT_EQ(sequence_length, state->sequence_length + 1);
+    state->sequence_length = sequence_length;
+
+    std::vector<std::vector<int32_t>> beams(state->beams.size());
+    for (int64_t i = 0; i < batch_beam_size; i++) {
+      // A beam can only continue a beam of the same batch entry.
+      ASSERT_EQ(beam_indices[i] / state->num_beams, i / state->num_beams);
+      beams[i] = state->beams[beam_indices[i]];
+      beams[i].push_back(next_tokens[i]);
+    }
+    state->beams = std::move(beams);
+  };
+
+  Ort::RunOptions run_options;
+  run_options.SetGenerationStreamingCallback(callback, &streamed);
+
+  const std::string model_data = LoadGenerationModel(ORT_TSTR("testdata/transformers/tiny_gpt2_beamsearch.onnx"), {});
+  Ort::SessionOptions session_options;
+  const GptGenerationOutputs outputs = RunGptGeneration(model_data, inputs, session_options, run_options);
+
+  // EOS is not generated by any beam, so there is one step for each token until max_length.
+  const std::vector<int64_t> expected_output_shape{batch_size, inputs.num_return_sequences, inputs.max_length};
+  ASSERT_EQ(expected_output_shape, outputs.sequences_shape);
+  ASSERT_EQ(streamed.sequence_length, inputs.max_length);
+
+  // The generated part of every returned sequence is one of the final beams of its batch entry.
+  for (int64_t b = 0; b < batch_size; b++) {
+    auto sequence_begin = outputs.sequences.cbegin() + b * inputs.max_length;
+    std::vector<int32_t> generated(sequence_begin + prompt_length, sequence_begin + inputs.max_length);
+    auto beams_begin = streamed.beams.cbegin() + b * inputs.num_beams;
+    EXPECT_NE(std::find(beams_begin, beams_begin + inputs.num_beams, generated), beams_begin + inputs.num_beams)
+        << "batch entry " << b;
+  }
+}
+
 TEST(BeamSearchTest, GptBeamSearchFp16) {
   std::vector<int64_t> input_ids_shape{3, 12};
   std::vector<int32_t> input_ids{
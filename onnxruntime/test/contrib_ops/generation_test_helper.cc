@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#include <memory>
+#include "test/contrib_ops/generation_test_helper.h"
+#include "core/graph/model.h"
+
+extern std::unique_ptr<Ort::Env> ort_env;
+
+namespace onnxruntime {
+namespace test {
+
+std::string LoadGenerationModel(const PathString& model_path,
+                                const std::vector<std::pair<std::string, int64_t>>& int_attributes) {
+  ONNX_NAMESPACE::ModelProto model_proto;
+  ORT_THROW_IF_ERROR(Model::Load(model_path, model_proto));
+
+  ONNX_NAMESPACE::NodeProto* generation_node = nullptr;
+  for (auto& node : *model_proto.mutable_graph()->mutable_node()) {
+    if (node.op_type() == "BeamSearch" || node.op_type() == "GreedySearch" || node.op_type() == "Sampling") {
+      generation_node = &node;
+      break;
+    }
+  }
+  ORT_ENFORCE(generation_node != nullptr, "No generation node in the model");
+
+  for (const auto& int_attribute : int_attributes) {
+    ONNX_NAMESPACE::AttributeProto* attribute = nullptr;
+    for (auto& node_attribute : *generation_node->mutable_attribute()) {
+      if (node_attribute.name() == int_attribute.first) {
+        attribute = &node_attribute;
+        break;
+      }
+    }
+    if (attribute == nullptr) {
+      attribute = generation_node->add_attribute();
+      attribute->set_name(int_attribute.first);
+      attribute->set_type(ONNX_NAMESPACE::AttributeProto_AttributeType_INT);
+    }
+    attribute->set_i(int_attribute.second);
+  }
+
+  std::string model_data;
+  ORT_ENFORCE(model_proto.SerializeToString(&model_data));
+  return model_data;
+}
+
+GptGenerationOutputs RunGptGeneration(const std::string& model_data,
+                                      const GptGenerationInputs& inputs,
+                                      const Ort::SessionOptions& session_options,
+                                      const Ort::RunOptions& run_options) {
+  // CreateTensor does not take const buffers.
+  std::vector<int32_t> input_ids = inputs.input_ids;
+  std::vector<int32_t> max_length{inputs.max_length};
+  std::vector<int32_t> min_length{inputs.min_length};
+  std::vector<float> repetition_penalty{inputs.repetition_penalty};
+  std::vector<int32_t> num_beams{inputs.num_beams};
+  std::vector<int32_t> num_return_sequences{inputs.num_return_sequences};
+  std::vector<float> length_penalty{inputs.length_penalty};
+  std::vector<int64_t> parameter_shape{1};
+
+  Ort::MemoryInfo info("Cpu", OrtDeviceAllocator, 0, OrtMemTypeDefault);
+  std::vector<Ort::Value> ort_inputs;
+  std::vector<const char*> input_names;
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, input_ids.data(), input_ids.size(), inputs.input_ids_shape.data(), inputs.input_ids_shape.size()));
+  input_names.push_back("input_ids");
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, max_length.data(), max_length.size(), parameter_shape.data(), parameter_shape.size()));
+  input_names.push_back("max_length");
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, min_length.data(), min_length.size(), parameter_shape.data(), parameter_shape.size()));
+  input_names.push_back("min_length");
+  if (inputs.num_beams > 0) {
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, num_beams.data(), num_beams.size(), parameter_shape.data(), parameter_shape.size()));
+    input_names.push_back("num_beams");
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, num_return_sequences.data(), num_return_sequences.size(), parameter_shape.data(), parameter_shape.size()));
+    input_names.push_back("num_return_sequences");
+    ort_inputs.push_back(Ort::Value::CreateTensor(
+        info, length_penalty.data(), length_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+    input_names.push_back("length_penalty");
+  }
+  ort_inputs.push_back(Ort::Value::CreateTensor(
+      info, repetition_penalty.data(), repetition_penalty.size(), parameter_shape.data(), parameter_shape.size()));
+  input_names.push_back("repetition_penalty");
+  const char* const output_names[] = {"sequences"};
+
+  Ort::Session session(*ort_env, model_data.data(), model_data.size(), session_options);
+  auto ort_outputs = session.Run(run_options, input_names.data(), ort_inputs.data(), ort_inputs.size(),
+                                 output_names, 1);
+  ORT_ENFORCE(ort_outputs.size() == 1U && ort_outputs[0].IsTensor());
+
+  auto result_ts = ort_outputs[0].GetTensorTypeAndShapeInfo();
+  ORT_ENFORCE(result_ts.GetElementType() == ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32);
+
+  GptGenerationOutputs outputs;
+  outputs.sequences_shape = result_ts.GetShape();
+  const auto* result_vals = ort_outputs[0].GetTensorData<int32_t>();
+  outputs.sequences.assign(result_vals, result_vals + result_ts.GetElementCount());
+  return outputs;
+}
+
+size_t CountFinishedSequences(const GptGenerationOutputs& outputs, int32_t pad_token_id) {
+  const size_t sequence_length = static_cast<size_t>(outputs.sequences_shape.back());
+  size_t finished = 0;
+  for (size_t end = sequence_length; end <= outputs.sequences.size(); end += sequence_length) {
+    if (outputs.sequences[end - 1] == pad_token_id) {
+      finished++;
+    }
+  }
+  return finished;
+}
+
+}  // namespace test
+}  // namespace onnxruntime
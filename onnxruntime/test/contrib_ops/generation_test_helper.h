@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+#include "core/common/path_string.h"
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Inputs of a BeamSearch, GreedySearch or Sampling node with a GPT decoder.
+// The BeamSearch only inputs are fed when num_beams is positive.
+struct GptGenerationInputs {
+  std::vector<int64_t> input_ids_shape;
+  std::vector<int32_t> input_ids;
+  int32_t max_length = 0;
+  int32_t min_length = 1;
+  float repetition_penalty = 1.0f;
+  int32_t num_beams = 0;
+  int32_t num_return_sequences = 1;
+  float length_penalty = 1.0f;
+};
+
+// Output of a generation run.
+struct GptGenerationOutputs {
+  std::vector<int64_t> sequences_shape;
+  std::vector<int32_t> sequences;
+};
+
+// Loads a model and overrides integer attributes (like eos_token_id) of its generation node.
+// Returns the serialized model.
+std::string LoadGenerationModel(const PathString& model_path,
+                                const std::vector<std::pair<std::string, int64_t>>& int_attributes);
+
+// Runs the serialized model on the CPU execution provider, and returns its sequences output.
+GptGenerationOutputs RunGptGeneration(const std::string& model_data,
+                                      const GptGenerationInputs& inputs,
+                                      const Ort::SessionOptions& session_options,
+                                      const Ort::RunOptions& run_options);
+
+// Counts the sequences that end with pad_token_id, i.e. those that have met EOS before max_length.
+size_t CountFinishedSequences(const GptGenerationOutputs& outputs, int32_t pad_token_id);
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -2,11 +2,14 @@
 // Licensed under the MIT License.
 
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/contrib_ops/generation_test_helper.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
 
@@ -143,5 +146,83 @@ TEST(GreedySearchTest, GptGreedySearchFp32) {
   }
 }
 
+TEST(GreedySearchTest, GptGreedySearchFp32_CompactFinishedSequences) {
+  // The first batch entry generates 204 first in GptGreedySearchFp32. Using it as EOS finishes that entry
+  // early while the other one is still generating, so it is evicted from the decoder batch.
+  // The output shall be the same as without compaction.
+  constexpr int32_t pad_token_id = 98;
+  const std::string model_data = LoadGenerationModel(
+      ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"), {{"eos_token_id", 204}});
+  GptGenerationInputs inputs;
+  inputs.input_ids_shape = {2, 4};
+  inputs.input_ids = {0, 0, 0, 52, 0, 0, 195, 731};
+  inputs.max_length = 10;
+
+  Ort::SessionOptions session_options;
+  const GptGenerationOutputs expected = RunGptGeneration(model_data, inputs, session_options, Ort::RunOptions{});
+
+  Ort::SessionOptions compact_session_options;
+  compact_session_options.AddConfigEntry(kOrtSessionOptionsConfigGenerationCompactFinishedSequences, "1");
+  const GptGenerationOutputs compacted = RunGptGeneration(model_data, inputs, compact_session_options,
+                                                          Ort::RunOptions{});
+
+  const std::vector<int64_t> expected_output_shape{inputs.input_ids_shape[0], inputs.max_length};
+  ASSERT_EQ(expected_output_shape, expected.sequences_shape);
+  ASSERT_EQ(expected.sequences_shape, compacted.sequences_shape);
+  ASSERT_EQ(expected.sequences, compacted.sequences);
+
+  const size_t finished = CountFinishedSequences(compacted, pad_token_id);
+  ASSERT_GT(finished, 0U);
+  ASSERT_LT(finished, static_cast<size_t>(inputs.input_ids_shape[0]));
+}
+
+TEST(GreedySearchTest, GptGreedySearchFp32_StreamingCallback) {
+  GptGenerationInputs inputs;
+  inputs.input_ids_shape = {2, 4};
+  inputs.input_ids = {0, 0, 0, 52, 0, 0, 195, 731};
+  inputs.max_length = 10;
+  const int64_t batch_size = inputs.input_ids_shape[0];
+  const int64_t prompt_length = inputs.input_ids_shape[1];
+
+  struct StreamedTokens {
+    int32_t sequence_length;
+    std::vector<std::vector<int32_t>> tokens;
+  };
+  StreamedTokens streamed{static_cast<int32_t>(prompt_length),
+                          std::vector<std::vector<int32_t>>(static_cast<size_t>(batch_size))};
+
+  GenerationStreamingCallbackFn callback = [](void* user_data, int32_t sequence_length, const int32_t* next_tokens,
+                                              const int32_t* beam_indices, int64_t batch_beam_size) {
+    auto* state = reinterpret_cast<StreamedTokens*>(user_data);
+    // Greedy search does not reorder sequences.
+    ASSERT_EQ(beam_indices, nullptr);
+    ASSERT_EQ(static_cast<size_t>(batch_beam_size), state->tokens.size());
+    EXPECT_EQ(sequence_length, state->sequence_length + 1);
+    state->sequence_length = sequence_length;
+    for (int64_t i = 0; i < batch_beam_size; i++) {
+      state->tokens[i].push_back(next_tokens[i]);
+    }
+  };
+
+  Ort::RunOptions run_options;
+  run_options.SetGenerationStreamingCallback(callback, &streamed);
+
+  const std::string model_data = LoadGenerationModel(
+      ORT_TSTR("testdata/transformers/tiny_gpt2_greedysearch_with_init_decoder.onnx"), {});
+  Ort::SessionOptions session_options;
+  const GptGenerationOutputs outputs = RunGptGeneration(model_data, inputs, session_options, run_options);
+
+  const std::vector<int64_t> expected_output_shape{batch_size, inputs.max_length};
+  ASSERT_EQ(expected_output_shape, outputs.sequences_shape);
+  ASSERT_EQ(streamed.sequence_length, inputs.max_length);
+
+  // The streamed tokens are the generated part of the sequences.
+  for (int64_t b = 0; b < batch_size; b++) {
+    auto sequence_begin = outputs.sequences.cbegin() + b * inputs.max_length;
+    std::vector<int32_t> generated(sequence_begin + prompt_length, sequence_begin + inputs.max_length);
+    EXPECT_EQ(streamed.tokens[b], generated) << "batch entry " << b;
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
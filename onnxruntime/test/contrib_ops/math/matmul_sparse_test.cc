@@ -5,6 +5,9 @@
 #include "test/providers/provider_test_utils.h"
 #include "core/framework/sparse_utils.h"
 
+#include <numeric>
+#include <random>
+
 namespace onnxruntime {
 namespace test {
 
@@ -142,7 +145,6 @@ void resize(Index size, double reserveSizeFactor = 0) {
 }
 */
 #if !defined(DISABLE_SPARSE_TENSORS)
-#if !defined(__i386__) && !defined(_M_IX86) && !defined(__wasm__) && !defined(__ANDROID__)
 TEST(SparseToDenseMatMul, TestCsr) {
   constexpr int64_t rows = 9;
   constexpr int64_t cols = 9;
@@ -264,7 +266,6 @@ TEST(SparseToDenseMatMul, TestCsr) {
     tester.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 }
-#endif // //!defined(__i386__) && !defined(_M_IX86) && !defined(__wasm__) && !defined(__ANDROID__)
 
 TEST(SparseToDenseMatMul, TestCoo) {
   constexpr int64_t rows = 9;
@@ -383,6 +384,167 @@ TEST(SparseToDenseMatMul, TestCoo) {
     tester.Run(OpTester::ExpectResult::kExpectSuccess);
   }
 }
+
+// Y = op(A) * op(B) on dense row-major inputs
+template <typename T>
+std::vector<T> ReferenceMatMul(const std::vector<T>& A, const std::vector<int64_t>& A_shape,
+                               const std::vector<T>& B, const std::vector<int64_t>& B_shape,
+                               bool trans_a, bool trans_b) {
+  const int64_t M = trans_a ? A_shape[1] : A_shape[0];
+  const int64_t K = trans_a ? A_shape[0] : A_shape[1];
+  const int64_t N = trans_b ? B_shape[0] : B_shape[1];
+  std::vector<T> Y(M * N);
+  for (int64_t m = 0; m < M; ++m) {
+    for (int64_t n = 0; n < N; ++n) {
+      T sum{};
+      for (int64_t k = 0; k < K; ++k) {
+        const T a = trans_a ? A[k * A_shape[1] + m] : A[m * A_shape[1] + k];
+        const T b = trans_b ? B[n * B_shape[1] + k] : B[k * B_shape[1] + n];
+        sum += a * b;
+      }
+      Y[m * N + n] = sum;
+    }
+  }
+  return Y;
+}
+
+// Large enough to be split across threads. The leading rows are dense and the rest is 90% sparse so a
+// split by row count would be unbalanced.
+TEST(SparseToDenseMatMul, TestCsrCooSkewed) {
+  constexpr int64_t rows = 192;
+  constexpr int64_t cols = 160;
+  const std::vector<int64_t> A_shape = {rows, cols};
+  std::vector<float> input_data(rows * cols);
+  std::default_random_engine generator(7);
+  std::uniform_int_distribution<int> value_distribution(-4, 4);
+  std::uniform_int_distribution<int> percent_distribution(0, 99);
+  for (int64_t r = 0; r < rows; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      if (percent_distribution(generator) < (r < 8 ? 100 : 10)) {
+        input_data[r * cols + c] = static_cast<float>(value_distribution(generator));
+      }
+    }
+  }
+
+  std::vector<float> A_values;
+  std::vector<int64_t> A_inner_indices;
+  std::vector<int64_t> A_outer_indices;
+  ConvertToCsr(gsl::span<const float>(input_data), A_shape, A_values, A_inner_indices, A_outer_indices);
+
+  std::vector<float> A_coo_values;
+  std::vector<int64_t> A_coo_indices;
+  ConvertToCoo(gsl::span<const float>(input_data), A_shape, A_coo_values, A_coo_indices);
+
+  for (bool trans_a : {false, true}) {
+    for (bool trans_b : {false, true}) {
+      constexpr int64_t n = 96;
+      const std::vector<int64_t> B_shape = trans_b ? std::vector<int64_t>{n, trans_a ? rows : cols}
+                                                   : std::vector<int64_t>{trans_a ? rows : cols, n};
+      std::vector<float> B_data(B_shape[0] * B_shape[1]);
+      for (auto& v : B_data) {
+        v = static_cast<float>(value_distribution(generator));
+      }
+      const auto expected = ReferenceMatMul(input_data, A_shape, B_data, B_shape, trans_a, trans_b);
+      const std::vector<int64_t> X_shape = {trans_a ? cols : rows, n};
+
+      {
+        OpTester tester("SparseToDenseMatMul", 1, onnxruntime::kMSDomain);
+        tester.AddAttribute("transA", static_cast<int64_t>(trans_a));
+        tester.AddAttribute("transB", static_cast<int64_t>(trans_b));
+        tester.AddSparseCsrInput("A", A_shape, A_values, A_inner_indices, A_outer_indices);
+        tester.AddInput("B", B_shape, B_data);
+        tester.AddOutput("X", X_shape, expected);
+        tester.Run(OpTester::ExpectResult::kExpectSuccess);
+      }
+
+      {
+        OpTester tester("SparseToDenseMatMul", 1, onnxruntime::kMSDomain);
+        tester.AddAttribute("transA", static_cast<int64_t>(trans_a));
+        tester.AddAttribute("transB", static_cast<int64_t>(trans_b));
+        tester.AddSparseCooInput("A", A_shape, A_coo_values, A_coo_indices);
+        tester.AddInput("B", B_shape, B_data);
+        tester.AddOutput("X", X_shape, expected);
+        tester.Run(OpTester::ExpectResult::kExpectSuccess);
+      }
+    }
+  }
+}
+
+TEST(SparseToDenseMatMul, TestCsrInvalidOuterIndices) {
+  // the middle outer entry points past NNZ
+  const std::vector<int64_t> A_shape = {2, 5};
+  const std::vector<float> A_values = {1.f, 2.f, 3.f, 4.f, 5.f};
+  const std::vector<int64_t> A_inner_indices = {0, 1, 2, 3, 4};
+  const std::vector<int64_t> A_outer_indices = {0, 100, 5};
+
+  for (bool trans_a : {false, true}) {
+    const int64_t k = trans_a ? A_shape[0] : A_shape[1];
+    const int64_t m = trans_a ? A_shape[1] : A_shape[0];
+    OpTester tester("SparseToDenseMatMul", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute("transA", static_cast<int64_t>(trans_a));
+    tester.AddSparseCsrInput("A", A_shape, A_values, A_inner_indices, A_outer_indices);
+    tester.AddInput("B", {k, 2}, std::vector<float>(static_cast<size_t>(k * 2), 1.f));
+    tester.AddOutput("X", {m, 2}, std::vector<float>(static_cast<size_t>(m * 2), 0.f));
+    tester.Run(OpTester::ExpectResult::kExpectFailure, "CSR outer indices must be non-decreasing and not exceed NNZ");
+  }
+}
+
+TEST(SparseToDenseMatMul, TestBlockSparse) {
+  constexpr int64_t block_size = 3;
+  const std::vector<int64_t> A_shape = {9, 9};
+  // 3x3 blocks at (0, 0), (0, 2), (1, 1), (1, 2), (2, 0), (2, 1)
+  const std::vector<int32_t> block_rows = {0, 0, 1, 1, 2, 2};
+  const std::vector<int32_t> block_cols = {0, 2, 1, 2, 0, 1};
+  const int64_t num_blocks = static_cast<int64_t>(block_rows.size());
+
+  std::vector<float> input_data(81);
+  std::vector<float> A_values;
+  for (int64_t b = 0; b < num_blocks; ++b) {
+    for (int64_t r = 0; r < block_size; ++r) {
+      for (int64_t c = 0; c < block_size; ++c) {
+        const float v = static_cast<float>(b * 9 + r * 3 + c + 1);
+        A_values.push_back(v);
+        input_data[(block_rows[b] * block_size + r) * 9 + block_cols[b] * block_size + c] = v;
+      }
+    }
+  }
+  std::vector<int32_t> A_indices = block_rows;
+  A_indices.insert(A_indices.end(), block_cols.begin(), block_cols.end());
+
+  const std::vector<int64_t> B_shape = {9, 5};
+  std::vector<float> B_data(45);
+  std::iota(B_data.begin(), B_data.end(), -20.f);
+
+  for (bool trans_a : {false, true}) {
+    const auto expected = ReferenceMatMul(input_data, A_shape, B_data, B_shape, trans_a, false);
+    std::vector<float> expected_alpha(expected);
+    for (auto& v : expected_alpha) {
+      v *= 0.5f;
+    }
+
+    OpTester tester("SparseToDenseMatMul", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute("transA", static_cast<int64_t>(trans_a));
+    tester.AddAttribute("alpha", 0.5f);
+    tester.AddSparseBlockSparseInput("A", A_shape, {num_blocks, block_size, block_size}, A_values,
+                                     {2, num_blocks}, A_indices);
+    tester.AddInput("B", B_shape, B_data);
+    tester.AddOutput("X", {9, 5}, expected_alpha);
+    tester.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+
+  // integer types go through the generic block kernel, alpha applies to float only
+  {
+    std::vector<int64_t> A_int_values(A_values.begin(), A_values.end());
+    std::vector<int64_t> input_int_data(input_data.begin(), input_data.end());
+    std::vector<int64_t> B_int_data(B_data.begin(), B_data.end());
+    OpTester tester("SparseToDenseMatMul", 1, onnxruntime::kMSDomain);
+    tester.AddSparseBlockSparseInput("A", A_shape, {num_blocks, block_size, block_size}, A_int_values,
+                                     {2, num_blocks}, A_indices);
+    tester.AddInput("B", B_shape, B_int_data);
+    tester.AddOutput("X", {9, 5}, ReferenceMatMul(input_int_data, A_shape, B_int_data, B_shape, false, false));
+    tester.Run(OpTester::ExpectResult::kExpectSuccess);
+  }
+}
 #endif // !defined(DISABLE_SPARSE_TENSORS)
 
 }  // namespace test
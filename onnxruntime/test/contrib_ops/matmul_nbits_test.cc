@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <functional>
+#include <numeric>
+
+#include "core/common/span_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+void RunMatMulNBitsTest(const std::vector<int64_t>& a_leading_dims, int64_t N, int64_t K, int64_t block_size,
+                        bool has_zero_point, bool is_constant) {
+  RandomValueGenerator random{1234};
+
+  const int64_t M = std::accumulate(a_leading_dims.begin(), a_leading_dims.end(), int64_t{1},
+                                    std::multiplies<int64_t>());
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size / 2;
+  const int64_t zp_size = N * ((k_blocks + 1) / 2);
+
+  std::vector<int64_t> a_dims = a_leading_dims;
+  a_dims.push_back(K);
+  std::vector<float> a_data = random.Uniform<float>(a_dims, -1.0f, 1.0f);
+
+  std::vector<uint8_t> b_data;
+  for (int32_t v : random.Uniform<int32_t>(AsSpan({N * k_blocks * blob_size}), 0, 256)) {
+    b_data.push_back(static_cast<uint8_t>(v));
+  }
+  std::vector<float> scales = random.Uniform<float>(AsSpan({N * k_blocks}), 0.01f, 0.1f);
+  std::vector<uint8_t> zero_points;
+  for (int32_t v : random.Uniform<int32_t>(AsSpan({zp_size}), 0, 256)) {
+    zero_points.push_back(static_cast<uint8_t>(v));
+  }
+
+  // reference: dequantize B to [K, N] and multiply
+  std::vector<float> y_data(M * N);
+  for (int64_t m = 0; m < M; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      float sum = 0.0f;
+      for (int64_t k = 0; k < K; k++) {
+        const int64_t block = k / block_size;
+        const int64_t index = k % block_size;
+        const uint8_t packed = b_data[(n * k_blocks + block) * blob_size + index / 2];
+        const int value = (index % 2 == 0) ? (packed & 0x0F) : (packed >> 4);
+        int zero_point = 8;
+        if (has_zero_point) {
+          const uint8_t packed_zp = zero_points[n * ((k_blocks + 1) / 2) + block / 2];
+          zero_point = (block % 2 == 0) ? (packed_zp & 0x0F) : (packed_zp >> 4);
+        }
+        sum += a_data[m * K + k] * (value - zero_point) * scales[n * k_blocks + block];
+      }
+      y_data[m * N + n] = sum;
+    }
+  }
+
+  std::vector<int64_t> y_dims = a_leading_dims;
+  y_dims.push_back(N);
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", 4);
+  test.AddInput<float>("A", a_dims, a_data);
+  test.AddInput<uint8_t>("B", {N, k_blocks, blob_size}, b_data, is_constant);
+  test.AddInput<float>("scales", {N * k_blocks}, scales, is_constant);
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {zp_size}, zero_points, is_constant);
+  } else {
+    test.AddOptionalInputEdge<uint8_t>();
+  }
+  test.AddOutput<float>("Y", y_dims, y_data, false, 1e-4f, 1e-3f);
+  test.Run();
+}
+
+}  // namespace
+
+TEST(MatMulNBits, Float32_SingleRow) {
+  for (int64_t block_size : {32, 64, 128}) {
+    RunMatMulNBitsTest({1}, 64, 256, block_size, false, true);
+    RunMatMulNBitsTest({1}, 64, 256, block_size, true, true);
+    RunMatMulNBitsTest({1}, 64, 256, block_size, true, false);
+  }
+}
+
+TEST(MatMulNBits, Float32_Batched) {
+  for (int64_t block_size : {32, 64, 128}) {
+    RunMatMulNBitsTest({2, 3}, 48, 128, block_size, true, true);
+    RunMatMulNBitsTest({2, 17}, 96, 256, block_size, false, false);
+  }
+}
+
+TEST(MatMulNBits, Float32_PartialBlock) {
+  // K is not a multiple of the block size, the last block of each column is padded
+  RunMatMulNBitsTest({1}, 19, 100, 32, true, true);
+  RunMatMulNBitsTest({5}, 19, 200, 64, false, true);
+  RunMatMulNBitsTest({9}, 33, 257, 128, true, false);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
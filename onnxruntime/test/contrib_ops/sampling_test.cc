@@ -2,11 +2,14 @@
 // Licensed under the MIT License.
 
 #include <memory>
+#include <string>
 #include <vector>
 #include "gtest/gtest.h"
 #include "core/common/gsl.h"
 #include "core/session/onnxruntime_cxx_api.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "test/common/cuda_op_test_utils.h"
+#include "test/contrib_ops/generation_test_helper.h"
 
 extern std::unique_ptr<Ort::Env> ort_env;
 
@@ -155,6 +158,39 @@ TEST(SamplingTest, Gpt2Sampling_CPU) {
 
   ASSERT_TRUE(std::equal(expected_output.cbegin(), expected_output.cend(), result_span.begin(), result_span.end()));
 }
+
+TEST(SamplingTest, Gpt2Sampling_CPU_CompactFinishedSequences) {
+  // The first batch entry samples 125 first in Gpt2Sampling_CPU. Using it as EOS finishes that entry
+  // early while the others are still generating, so it is evicted from the decoder batch.
+  // The seed input is not fed, so both runs use the same default seed and the outputs shall be the same.
+  constexpr int32_t pad_token_id = 98;
+  const std::string model_data = LoadGenerationModel(ORT_TSTR("testdata/transformers/tiny_gpt2_sampling.onnx"),
+                                                     {{"eos_token_id", 125}});
+  GptGenerationInputs inputs;
+  inputs.input_ids_shape = {3, 12};
+  inputs.input_ids = {
+      0, 0, 0, 0, 0, 52, 195, 731, 321, 301, 734, 620,
+      41, 554, 74, 622, 206, 222, 75, 223, 221, 198, 224, 572,
+      0, 0, 0, 52, 328, 219, 328, 206, 288, 227, 896, 328};
+  inputs.max_length = 15;
+
+  Ort::SessionOptions session_options;
+  const GptGenerationOutputs expected = RunGptGeneration(model_data, inputs, session_options, Ort::RunOptions{});
+
+  Ort::SessionOptions compact_session_options;
+  compact_session_options.AddConfigEntry(kOrtSessionOptionsConfigGenerationCompactFinishedSequences, "1");
+  const GptGenerationOutputs compacted = RunGptGeneration(model_data, inputs, compact_session_options,
+                                                          Ort::RunOptions{});
+
+  const std::vector<int64_t> expected_output_shape{inputs.input_ids_shape[0], inputs.max_length};
+  ASSERT_EQ(expected_output_shape, expected.sequences_shape);
+  ASSERT_EQ(expected.sequences_shape, compacted.sequences_shape);
+  ASSERT_EQ(expected.sequences, compacted.sequences);
+
+  const size_t finished = CountFinishedSequences(compacted, pad_token_id);
+  ASSERT_GT(finished, 0U);
+  ASSERT_LT(finished, static_cast<size_t>(inputs.input_ids_shape[0]));
+}
 #endif
 }  // namespace test
 }  // namespace onnxruntime
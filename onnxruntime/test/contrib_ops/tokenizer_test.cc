@@ -677,6 +677,34 @@ TEST(ContribOpTest, TokenizerWithSeparators_MixCharCommonPrefixC) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }  // namespace test
 
+TEST(ContribOpTest, TokenizerWithSeparators_LatinCharsLiteralSeparatorsNC) {
+  // Separators without regex metacharacters are searched for directly,
+  // the first separator is applied first and short tokens are dropped.
+  std::vector<std::string> separators = {u8", ", u8" "};
+
+  OpTester test("Tokenizer", opset_ver, domain);
+  InitTestAttr(test, false, separators, 2);
+
+  std::vector<int64_t> dims{2, 1};
+  std::vector<std::string> input{u8"the quick, brown fox", u8"a bb, ccc"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<int64_t> output_dims(dims);
+  output_dims.push_back(int64_t(4));
+  std::vector<std::string> output{
+      u8"the",
+      u8"quick",
+      u8"brown",
+      u8"fox",
+      u8"bb",
+      u8"ccc",
+      padval,
+      padval};
+
+  test.AddOutput<std::string>("Y", output_dims, output);
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 TEST(ContribOpTest, TokenizerExpression_RegEx) {
   OpTester test("Tokenizer", opset_ver, domain);
   const std::string tokenexp(u8"a.");
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -1947,6 +1948,77 @@ TEST_F(PlannerTest, TestMultiStreamMismatchDevice) {
   ASSERT_TRUE(!status.IsOK());
 }
 
+// Partition three towers of 1, 2 and 3 nodes forking from a stem node and joined by two Add nodes:
+//   stem -> t0_0 ------------------> add1 -> add2
+//   stem -> t1_0 -> t1_1 ----------> add1
+//   stem -> t2_0 -> t2_1 -> t2_2 ----------> add2
+// The stem and the longest tower, the critical path, are in the first stream, the other towers in their own.
+TEST_F(PlannerTest, CriticalPathPartitionTowers) {
+  std::unique_ptr<::onnxruntime::KernelDef> add_kernel =
+      KernelDefBuilder().SetName("Add").Provider(kCpuExecutionProvider).SinceVersion(7, 12).Build();
+
+  std::string graph_input("Graph_input"), stem_name("stem"), stem_output("stem_out");
+  std::vector<onnxruntime::NodeArg*> stem_inputs{Arg(graph_input)}, stem_outputs{Arg(stem_output)};
+  const NodeIndex stem = AddNode(*GetStdKernel(), stem_name, stem_inputs, stem_outputs)->Index();
+
+  std::vector<std::vector<NodeIndex>> towers(3);
+  std::vector<std::string> tower_outputs;
+  for (size_t tower = 0; tower < towers.size(); ++tower) {
+    std::string input = stem_output;
+    for (size_t i = 0; i <= tower; ++i) {
+      std::string name = "t" + std::to_string(tower) + "_" + std::to_string(i);
+      std::string output = name + "_out";
+      std::vector<onnxruntime::NodeArg*> inputs{Arg(input)}, outputs{Arg(output)};
+      towers[tower].push_back(AddNode(*GetStdKernel(), name, inputs, outputs)->Index());
+      input = output;
+    }
+    tower_outputs.push_back(input);
+  }
+
+  std::string add1_name("add1"), add1_output("add1_out"), add2_name("add2"), add2_output("add2_out");
+  std::vector<onnxruntime::NodeArg*> add1_inputs{Arg(tower_outputs[0]), Arg(tower_outputs[1])}, add1_outputs{Arg(add1_output)};
+  std::vector<onnxruntime::NodeArg*> add2_inputs{Arg(add1_output), Arg(tower_outputs[2])}, add2_outputs{Arg(add2_output)};
+  AddNode(*add_kernel, add1_name, add1_inputs, add1_outputs);
+  AddNode(*add_kernel, add2_name, add2_inputs, add2_outputs);
+
+  CreatePlan({}, false);
+
+  auto partitioner = IGraphPartitioner::CreateGraphPartitioner(
+      DefaultLoggingManager().DefaultLogger(), ORT_TSTR(""),
+      IGraphPartitioner::GraphPartitioningStrategy::CriticalPathPartition);
+  ASSERT_STREQ(partitioner->Type(), "CriticalPathPartitioner");
+
+  onnxruntime::GraphViewer graph_viewer{GetGraph()};
+  std::vector<InlinedVector<NodeIndex>> stream_nodes;
+  ASSERT_STATUS_OK(partitioner->PartitionGraph(graph_viewer, GetExecutionProviders(), stream_nodes,
+                                               ExecutionOrder::DEFAULT));
+  ASSERT_EQ(stream_nodes.size(), 3u);
+  EXPECT_EQ(partitioner->Streams(), 3u);
+
+  auto stream_of = [&stream_nodes](NodeIndex node_index) {
+    for (size_t stream = 0; stream < stream_nodes.size(); ++stream) {
+      if (std::find(stream_nodes[stream].begin(), stream_nodes[stream].end(), node_index) != stream_nodes[stream].end()) {
+        return stream;
+      }
+    }
+    return stream_nodes.size();
+  };
+
+  // streams are ordered by the cost of the path from their first node to the outputs
+  EXPECT_EQ(stream_nodes[0].front(), stem);
+  for (size_t tower = 0; tower < towers.size(); ++tower) {
+    for (auto node_index : towers[tower]) {
+      EXPECT_EQ(stream_of(node_index), 2 - tower) << "tower " << tower;
+    }
+  }
+
+  size_t num_nodes = 0;
+  for (const auto& nodes : stream_nodes) {
+    num_nodes += nodes.size();
+  }
+  EXPECT_EQ(num_nodes, static_cast<size_t>(graph_viewer.NumberOfNodes()));
+}
+
 #endif
 
 }  // namespace test
@@ -5,6 +5,7 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -302,6 +303,108 @@ TEST(BFCArenaTest, TestShrink) {
   EXPECT_EQ(stats.total_allocated_bytes, 10 * 1024 * 1024) << "Expect 10M bytes but actually " << stats.total_allocated_bytes << " bytes";
 }
 
+TEST(BFCArenaTest, ThreadCache) {
+  AllocatorStats stats;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, 256 * 1024);
+
+  // The first allocation fills the cache of this thread, the following ones are served by it.
+  for (int i = 0; i < 100; ++i) {
+    void* p = a.Alloc(1000);
+    ASSERT_NE(p, nullptr);
+    a.Free(p);
+  }
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_misses, 1);
+  EXPECT_EQ(stats.num_thread_cache_hits, 99);
+  EXPECT_GT(stats.thread_cache_bytes, 0);
+  EXPECT_GE(stats.bytes_in_use, stats.thread_cache_bytes) << "Cached chunks are in use for the bins";
+
+  // Large allocations bypass the caches.
+  void* p1M = a.Alloc(1024 * 1024);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_thread_cache_hits + stats.num_thread_cache_misses, 100);
+  a.Free(p1M);
+
+  // Allocations of different classes are live at the same time and do not overlap.
+  std::vector<void*> ptrs;
+  for (size_t s = 1; s <= 64 * 1024; s += 97) {
+    ptrs.push_back(a.Alloc(s));
+  }
+  std::sort(ptrs.begin(), ptrs.end());
+  for (size_t i = 1; i < ptrs.size(); i++) {
+    ASSERT_NE(ptrs[i], ptrs[i - 1]);
+    ASSERT_GE(static_cast<size_t>(static_cast<char*>(ptrs[i]) - static_cast<char*>(ptrs[i - 1])),
+              a.RequestedSize(ptrs[i - 1]));
+  }
+  for (void* p : ptrs) {
+    a.Free(p);
+  }
+
+  // Shrink gives the cached chunks back to the bins before releasing the regions.
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheMultipleThreads) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kNextPowerOfTwo,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES, BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES, 64 * 1024);
+
+  // Each thread fills its buffers with its own pattern and checks it before freeing them,
+  // buffers are freed by another thread than the one that allocated them every other round.
+  constexpr int kNumThreads = 4;
+  constexpr int kNumRounds = 200;
+  constexpr size_t kNumBuffers = 64;
+  std::vector<std::vector<std::pair<unsigned char*, size_t>>> buffers(kNumThreads);
+  std::atomic<int> num_corrupted{0};
+  auto fill = [&](int t, int round) {
+    auto& mine = buffers[t];
+    for (size_t i = 0; i < kNumBuffers; ++i) {
+      size_t size = 1 + (i * 577 + static_cast<size_t>(round) * 131) % (i % 8 == 0 ? 100000 : 10000);
+      auto* p = static_cast<unsigned char*>(a.Alloc(size));
+      memset(p, t + 1, size);
+      mine.emplace_back(p, size);
+    }
+  };
+  auto check_and_free = [&](int t) {
+    for (auto& [p, size] : buffers[t]) {
+      if (p[0] != t + 1 || p[size / 2] != t + 1 || p[size - 1] != t + 1) {
+        ++num_corrupted;
+      }
+      a.Free(p);
+    }
+    buffers[t].clear();
+  };
+
+  for (int round = 0; round < kNumRounds; ++round) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t]() { fill(t, round); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    threads.clear();
+    for (int t = 0; t < kNumThreads; ++t) {
+      threads.emplace_back([&, t]() { check_and_free(round % 2 == 0 ? t : (t + 1) % kNumThreads); });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  EXPECT_EQ(num_corrupted, 0);
+
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.thread_cache_bytes, 0);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
 class BadAllocator : public IAllocator {
  public:
   BadAllocator() : IAllocator(OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator)) {}
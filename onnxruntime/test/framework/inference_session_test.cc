@@ -16,6 +16,7 @@
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/clog_sink.h"
 #include "core/common/profiler.h"
+#include "core/framework/captured_run.h"
 #include "core/framework/compute_capability.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_provider.h"
@@ -837,6 +838,38 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+TEST(InferenceSessionTests, CaptureCpuRun) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.CaptureCpuRun";
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigEnableCpuRunCapture, "1"));
+
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  run_options.run_tag = "InferenceSessionTests.CaptureCpuRun";
+
+  // runs with preallocated outputs are not captured
+  RunModel(session_object, run_options, /*is_preallocate_output_vec*/ true);
+  ASSERT_EQ(session_object.GetCapturedRun(), nullptr);
+
+  // the first run is captured and the next ones replay it
+  RunModel(session_object, run_options);
+  auto captured_run = session_object.GetCapturedRun();
+  ASSERT_NE(captured_run, nullptr);
+  EXPECT_EQ(captured_run->NumReplays(), 0u);
+
+  RunModel(session_object, run_options);
+  RunModel(session_object, run_options);
+  EXPECT_EQ(session_object.GetCapturedRun(), captured_run);
+  EXPECT_EQ(captured_run->NumReplays(), 2u);
+
+  // preallocated outputs don't replay the capture
+  RunModel(session_object, run_options, /*is_preallocate_output_vec*/ true);
+  EXPECT_EQ(captured_run->NumReplays(), 2u);
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   SessionOptions so;
 
@@ -2061,6 +2094,21 @@ TEST(InferenceSessionTests, TestStrictShapeInference) {
              excluded_provider_types);
 }
 
+TEST(InferenceSessionTests, InvalidMemoryPatternCacheConfig) {
+  for (const char* config_key : {kOrtSessionOptionsConfigMemoryPatternCacheCapacity,
+                                 kOrtSessionOptionsConfigMemoryPatternDimBucketSize}) {
+    for (const char* config_value : {"-1", "abc", "12x", ""}) {
+      SessionOptions so;
+      ASSERT_STATUS_OK(so.config_options.AddConfigEntry(config_key, config_value));
+      InferenceSession session_object{so, GetEnvironment()};
+      ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+
+      const auto status = session_object.Initialize();
+      EXPECT_EQ(status.Code(), common::INVALID_ARGUMENT) << config_key << "=" << config_value;
+    }
+  }
+}
+
 #ifdef USE_CUDA
 // disable it, since we are going to enable parallel execution with cuda ep
 TEST(InferenceSessionTests, DISABLED_TestParallelExecutionWithCudaProvider) {
@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/mem_pattern_planner.h"
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// A pattern with one block of the given size on the CPU
+MemoryPatternGroup MakePatterns(size_t size) {
+  MemPatternPlanner planner{/*using_counters*/ false};
+  planner.TraceAllocation(0, size);
+
+  MemoryPatternGroup patterns;
+  patterns.locations.push_back(OrtMemoryInfo());
+  patterns.patterns.push_back(planner.GenerateMemPattern());
+  return patterns;
+}
+}  // namespace
+
+TEST(MemoryPatternGroupCacheTest, ExactShapes) {
+  MemoryPatternGroupCache cache(/*capacity*/ 0, /*dim_bucket_size*/ 0);
+
+  // one input of shape [2, 3]
+  const InlinedVector<int64_t> dims{2, 2, 3};
+  EXPECT_EQ(cache.Find(dims), nullptr);
+  cache.Insert(dims, MakePatterns(64));
+  ASSERT_NE(cache.Find(dims), nullptr);
+
+  // shapes with the same product or permuted dims are distinct
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{2, 3, 2}), nullptr);
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{1, 6}), nullptr);
+  // smaller shapes are not served without buckets
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{2, 2, 2}), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 4u);
+  EXPECT_EQ(stats.evictions, 0u);
+  EXPECT_EQ(stats.size, 1u);
+}
+
+TEST(MemoryPatternGroupCacheTest, ShapeBuckets) {
+  MemoryPatternGroupCache cache(/*capacity*/ 0, /*dim_bucket_size*/ 64);
+
+  // [1, 70] and [1, 100] are in the bucket [64, 128]
+  cache.Insert(InlinedVector<int64_t>{2, 1, 70}, MakePatterns(70));
+  auto entry = cache.Find(InlinedVector<int64_t>{2, 1, 65});
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->patterns.patterns[0].PeakSize(), 70u);
+
+  // a bigger shape of the bucket is not served and replaces the entry when planned
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{2, 1, 100}), nullptr);
+  cache.Insert(InlinedVector<int64_t>{2, 1, 100}, MakePatterns(100));
+  entry = cache.Find(InlinedVector<int64_t>{2, 1, 70});
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->patterns.patterns[0].PeakSize(), 100u);
+
+  // planning a smaller shape of the bucket keeps the bigger entry
+  cache.Insert(InlinedVector<int64_t>{2, 1, 80}, MakePatterns(80));
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{2, 1, 90})->patterns.patterns[0].PeakSize(), 100u);
+
+  // other buckets and ranks are distinct
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{2, 1, 129}), nullptr);
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{3, 1, 1, 70}), nullptr);
+  EXPECT_EQ(cache.GetStats().size, 1u);
+}
+
+TEST(MemoryPatternGroupCacheTest, ShapesBiggerInDifferentDims) {
+  MemoryPatternGroupCache cache(/*capacity*/ 0, /*dim_bucket_size*/ 64);
+
+  // [70, 100] and [100, 70] are in the bucket [128, 128] and neither is bigger than the other in every dim
+  const InlinedVector<int64_t> dims_a{2, 70, 100};
+  const InlinedVector<int64_t> dims_b{2, 100, 70};
+  cache.Insert(dims_a, MakePatterns(70));
+  EXPECT_EQ(cache.Find(dims_b), nullptr);
+
+  // planning for the max of both dims gives patterns that replace the entry
+  EXPECT_EQ(cache.GetPlanDims(dims_b), (InlinedVector<int64_t>{2, 100, 100}));
+  EXPECT_EQ(cache.GetPlanDims(InlinedVector<int64_t>{2, 1, 1}), (InlinedVector<int64_t>{2, 1, 1}));
+
+  // patterns traced for the exact shapes are merged with the entry instead
+  auto entry = cache.Insert(dims_b, MakePatterns(100));
+  EXPECT_EQ(entry->input_dims, (InlinedVector<int64_t>{2, 100, 100}));
+  EXPECT_EQ(entry->patterns.patterns[0].PeakSize(), 100u);
+  EXPECT_EQ(cache.Find(dims_a), entry);
+  EXPECT_EQ(cache.Find(dims_b), entry);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.size, 1u);
+}
+
+TEST(MemoryPatternGroupCacheTest, MergedPatternsReuseMemory) {
+  // values 0 and 1 are never used at the same time, value 2 is used with both
+  auto trace = [](size_t size_0, size_t size_1, size_t size_2) {
+    MemPatternPlanner planner{/*using_counters*/ false};
+    planner.TraceAllocation(2, size_2);
+    planner.TraceAllocation(0, size_0);
+    planner.TraceFree(0);
+    planner.TraceAllocation(1, size_1);
+
+    MemoryPatternGroup patterns;
+    patterns.locations.push_back(OrtMemoryInfo());
+    patterns.patterns.push_back(planner.GenerateMemPattern());
+    return patterns;
+  };
+
+  MemoryPatternGroupCache cache(/*capacity*/ 0, /*dim_bucket_size*/ 64);
+  cache.Insert(InlinedVector<int64_t>{2, 70, 100}, trace(64, 128, 64));
+  auto entry = cache.Insert(InlinedVector<int64_t>{2, 100, 70}, trace(128, 64, 192));
+
+  const auto& pattern = entry->patterns.patterns[0];
+  const auto* block_0 = pattern.GetBlock(0);
+  const auto* block_1 = pattern.GetBlock(1);
+  const auto* block_2 = pattern.GetBlock(2);
+  ASSERT_TRUE(block_0 && block_1 && block_2);
+  EXPECT_EQ(block_0->size_, 128u);
+  EXPECT_EQ(block_1->size_, 128u);
+  EXPECT_EQ(block_2->size_, 192u);
+
+  // 0 and 1 still share their memory, 2 doesn't overlap either of them
+  EXPECT_EQ(block_0->offset_, block_1->offset_);
+  EXPECT_TRUE(block_2->offset_ + block_2->size_ <= block_0->offset_ ||
+              block_0->offset_ + block_0->size_ <= block_2->offset_);
+  EXPECT_EQ(pattern.PeakSize(), 192u + 128u);
+}
+
+TEST(MemoryPatternGroupCacheTest, LruEviction) {
+  MemoryPatternGroupCache cache(/*capacity*/ 2, /*dim_bucket_size*/ 0);
+
+  cache.Insert(InlinedVector<int64_t>{1, 1}, MakePatterns(1));
+  auto entry2 = cache.Insert(InlinedVector<int64_t>{1, 2}, MakePatterns(2));
+  // 1 becomes the most recently used
+  ASSERT_NE(cache.Find(InlinedVector<int64_t>{1, 1}), nullptr);
+  cache.Insert(InlinedVector<int64_t>{1, 3}, MakePatterns(3));
+
+  EXPECT_NE(cache.Find(InlinedVector<int64_t>{1, 1}), nullptr);
+  EXPECT_EQ(cache.Find(InlinedVector<int64_t>{1, 2}), nullptr);
+  EXPECT_NE(cache.Find(InlinedVector<int64_t>{1, 3}), nullptr);
+
+  // users of an evicted entry keep it alive
+  EXPECT_EQ(entry2->patterns.patterns[0].PeakSize(), 2u);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.size, 2u);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 
 #include "asserts.h"
@@ -20,6 +22,7 @@
 #include "gtest/gtest.h"
 #include "test/test_environment.h"
 #include "test/util/include/default_providers.h"
+#include "test/util/include/file_util.h"
 #include "core/optimizer/transpose_optimizer/optimizer_utils.h"
 
 using namespace ONNX_NAMESPACE;
@@ -349,8 +352,24 @@ class PrePackingTestOpKernel : public OpKernel {
     return Status::OK();
   }
 
+  Status UsePersistedPrePackedBuffers(const Tensor& tensor, std::vector<BufferUniquePtr>& prepacked_buffers,
+                                      int input_idx, /*out*/ bool& used_persisted_buffers) override {
+    ORT_UNUSED_PARAMETER(tensor);
+    ORT_UNUSED_PARAMETER(input_idx);
+
+    weight_packed_ = std::move(prepacked_buffers[0]);
+    used_persisted_buffers = true;
+    ++use_persisted_pre_packed_weight_calls_count;
+    return Status::OK();
+  }
+
+  bool CanUsePersistedPrePackedBuffers(int /*input_idx*/) const override {
+    return true;
+  }
+
   int prepack_calls_count = 0;
   int store_pre_packed_weight_calls_count = 0;
+  int use_persisted_pre_packed_weight_calls_count = 0;
   BufferUniquePtr weight_packed_;
 };
 
@@ -808,6 +827,74 @@ TEST_F(SessionStateTestSharedInitalizersWithPrePacking, test3) {
   ASSERT_EQ(session_state_2.GetUsedSharedPrePackedWeightCounter(), static_cast<size_t>(1));
 }
 
+// Pre-packing enabled + pre-packed weights cache file = pre-packed weights persisted across sessions
+TEST_F(SessionStateTestSharedInitalizersWithPrePacking, PersistedPrePackedWeights) {
+  std::basic_string<ORTCHAR_T> cache_file(ORT_TSTR("prepacked_weights_cache_test.bin"));
+  std::filesystem::remove(cache_file);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> file_deleter(const_cast<ORTCHAR_T*>(cache_file.c_str()),
+                                                                         DeleteFileFromDisk);
+
+  SessionOptions sess_options;
+  sess_options.enable_mem_pattern = true;
+  sess_options.execution_mode = ExecutionMode::ORT_SEQUENTIAL;
+  sess_options.use_deterministic_compute = false;
+  sess_options.enable_mem_reuse = true;
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigDisablePrepacking] = "0";
+  sess_options.config_options.configurations[kOrtSessionOptionsConfigPrepackedWeightsCacheFile] =
+      ToUTF8String(cache_file);
+
+  auto finalize_session_state = [&](int expected_prepack_calls, size_t expected_persisted_weights) {
+    Model model("graph_main", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                domain_to_version, std::vector<ONNX_NAMESPACE::FunctionProto>(),
+                DefaultLoggingManager().DefaultLogger());
+
+    CreateSimpleGraph(model.MainGraph());
+    PlaceAllNodesToCPUEP(model.MainGraph());
+    SessionState session_state(model.MainGraph(),
+                               execution_providers,
+                               tp.get(),
+                               nullptr, /*inter_op_thread_pool*/
+                               dtm,
+                               DefaultLoggingManager().DefaultLogger(),
+                               profiler,
+                               sess_options);
+
+    ASSERT_STATUS_OK(session_state.FinalizeSessionState(std::basic_string<PATH_CHAR_TYPE>(),
+                                                        kernel_registry_manager));
+
+    const auto* kernel = reinterpret_cast<const PrePackingTestOpKernel*>(session_state.GetKernel(0));
+
+    // The kernel always restores itself through UsePersistedPrePackedBuffers(), PrePack() is skipped
+    // when the weight is read from the file
+    ASSERT_EQ(session_state.GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+    ASSERT_EQ(kernel->prepack_calls_count, expected_prepack_calls);
+    ASSERT_EQ(kernel->use_persisted_pre_packed_weight_calls_count, 1);
+    ASSERT_EQ(kernel->store_pre_packed_weight_calls_count, 0);
+    ASSERT_EQ(session_state.GetUsedPersistedPrePackedWeightCounter(), expected_persisted_weights);
+
+    const float* data_weights_packed = reinterpret_cast<const float*>(kernel->weight_packed_.get());
+    ASSERT_EQ(data_weights_packed[0], 1.2345f);
+    ASSERT_EQ(data_weights_packed[1], 1.2345f * 2.f);
+
+    // the constant initializer is released as it was pre-packed
+    ASSERT_TRUE(session_state.GetConstantInitializedTensors().empty());
+  };
+
+  // The first session packs the weight and writes the file, the second one reads it back
+  finalize_session_state(1, 0);
+  finalize_session_state(0, 1);
+
+  // A file that wasn't written for this CPU and MLAS version is ignored and rewritten
+  {
+    std::fstream file(cache_file, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(8);
+    const uint32_t file_format_version = 0;
+    file.write(reinterpret_cast<const char*>(&file_format_version), sizeof(file_format_version));
+  }
+  finalize_session_state(1, 0);
+  finalize_session_state(0, 1);
+}
+
 INSTANTIATE_TEST_SUITE_P(SessionStateTests,
                          SessionStatePrepackingTest,
                          testing::Values(PrepackingTestParam{false, false},
@@ -58,6 +58,7 @@ class MlasConv2DTest : public MlasTestBase {
                     &Activation,
                     &WorkingBufferSize,
                     0.0f,
+                    false,
                     threadpool_);
 
     MlasConv(&Parameters,
@@ -147,6 +148,10 @@ class MlasConv2DTest : public MlasTestBase {
     }
   }
 
+  virtual bool CompareOutput(const float* Output, const float* OutputReference, size_t OutputElements) {
+    return memcmp(Output, OutputReference, OutputElements * sizeof(float)) == 0;
+  }
+
   MatrixGuardBuffer<float> BufferInput;
   MatrixGuardBuffer<float> BufferFilter;
   MatrixGuardBuffer<float> BufferBias;
@@ -246,7 +251,7 @@ class MlasConv2DTest : public MlasTestBase {
                     Bias,
                     OutputReference);
 
-    ASSERT_EQ(memcmp(Output, OutputReference, OutputElements * sizeof(float)), 0)
+    ASSERT_TRUE(CompareOutput(Output, OutputReference, OutputElements))
         << "B" << BatchCount << "/"
         << "G" << GroupCount << "/"
         << "Cpg" << InputChannels << "/"
@@ -0,0 +1,174 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_conv2d.h"
+#include "test_conv2d_fixture.h"
+
+template <bool Threaded>
+class MlasWinogradConv2DTest : public MlasConv2DTest<Threaded> {
+ protected:
+  void MlasConv2D(size_t BatchCount,
+                  size_t GroupCount,
+                  size_t InputChannels,
+                  size_t InputHeight,
+                  size_t InputWidth,
+                  size_t FilterCount,
+                  size_t KernelHeight,
+                  size_t KernelWidth,
+                  size_t PaddingLeftHeight,
+                  size_t PaddingLeftWidth,
+                  size_t PaddingRightHeight,
+                  size_t PaddingRightWidth,
+                  size_t DilationHeight,
+                  size_t DilationWidth,
+                  size_t StrideHeight,
+                  size_t StrideWidth,
+                  size_t OutputHeight,
+                  size_t OutputWidth,
+                  const float* Input,
+                  const float* Filter,
+                  const float* Bias,
+                  float* Output) override {
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {int64_t(KernelHeight), int64_t(KernelWidth)};
+    int64_t DilationShape[] = {int64_t(DilationHeight), int64_t(DilationWidth)};
+    int64_t Padding[] = {int64_t(PaddingLeftHeight), int64_t(PaddingLeftWidth), int64_t(PaddingRightHeight), int64_t(PaddingRightWidth)};
+    int64_t StrideShape[] = {int64_t(StrideHeight), int64_t(StrideWidth)};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    //
+    // Transform the filter if the convolution can use the Winograd algorithm.
+    //
+
+    const bool HasWinogradFilter = MlasConvWinogradIsSupported(2, KernelShape, DilationShape, StrideShape,
+                                                               InputChannels, FilterCount);
+
+    const float* ConvFilter = Filter;
+
+    if (HasWinogradFilter) {
+      float* PackedFilter = BufferPackedFilter.GetBuffer(
+          MlasConvWinogradPackWSize(GroupCount, InputChannels, FilterCount));
+      MlasConvWinogradPackW(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+      ConvFilter = PackedFilter;
+    }
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters,
+                    2,
+                    BatchCount,
+                    GroupCount,
+                    InputChannels,
+                    InputShape,
+                    KernelShape,
+                    DilationShape,
+                    Padding,
+                    StrideShape,
+                    OutputShape,
+                    FilterCount,
+                    &Activation,
+                    &WorkingBufferSize,
+                    0.0f,
+                    HasWinogradFilter,
+                    this->threadpool_);
+
+    ASSERT_EQ(Parameters.Algorithm == MlasConvAlgorithmWinograd, HasWinogradFilter);
+
+    MlasConv(&Parameters,
+             Input,
+             ConvFilter,
+             Bias,
+             this->BufferWorking.GetBuffer(WorkingBufferSize),
+             Output,
+             this->threadpool_);
+  }
+
+  bool CompareOutput(const float* Output, const float* OutputReference, size_t OutputElements) override {
+    //
+    // The transforms round differently than the reference GEMM, so compare
+    // relative to the largest output.
+    //
+
+    float MaximumOutput = 0.0f;
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      MaximumOutput = std::max(MaximumOutput, std::fabs(OutputReference[i]));
+    }
+
+    for (size_t i = 0; i < OutputElements; i++) {
+      if (std::fabs(Output[i] - OutputReference[i]) > MaximumOutput * 1e-4f) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  MatrixGuardBuffer<float> BufferPackedFilter;
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Conv2dWinograd_Threaded" : "Conv2dWinograd_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteLong(void) override {
+    static const unsigned cs[] = {8, 17, 64};
+    static const unsigned is[] = {1, 4, 7, 13, 28};
+
+    for (unsigned ic = 0; ic < _countof(cs); ic++) {
+      for (unsigned fc = 0; fc < _countof(cs); fc++) {
+        for (unsigned ih = 0; ih < _countof(is); ih++) {
+          for (unsigned iw = 0; iw < _countof(is); iw++) {
+            for (unsigned p = 0; p < 2; p++) {
+              this->Test(2, 2, cs[ic], is[ih], is[iw], cs[fc], 3, 3, p, p, p, p, 1, 1, 1, 1);
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+template <> MlasWinogradConv2DTest<false>* MlasTestFixture<MlasWinogradConv2DTest<false>>::mlas_tester(nullptr);
+template <> MlasWinogradConv2DTest<true>* MlasTestFixture<MlasWinogradConv2DTest<true>>::mlas_tester(nullptr);
+
+template <typename Conv2dTester>
+static size_t RegisterWinogradShortExecuteTests() {
+  using ShortExecuteTest = Conv2dShortExecuteTest<Conv2dTester>;
+
+  size_t test_registered = 0;
+  for (unsigned i = 1; i < 256; i <<= 1) {
+    test_registered += ShortExecuteTest::RegisterSingleTest(1, 1, 16, i, i, 32, 3, 3, 0, 0, 0, 0, 1, 1, 1, 1);
+    test_registered += ShortExecuteTest::RegisterSingleTest(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    test_registered += ShortExecuteTest::RegisterSingleTest(2, 2, 8, i, i + 3, 9, 3, 3, 1, 0, 0, 1, 1, 1, 1, 1);
+    // not supported by the Winograd algorithm
+    test_registered += ShortExecuteTest::RegisterSingleTest(1, 1, 4, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1);
+    test_registered += ShortExecuteTest::RegisterSingleTest(1, 1, 16, i, i, 32, 3, 3, 1, 1, 1, 1, 1, 1, 2, 2);
+  }
+  return test_registered;
+}
+
+static size_t Conv2dWinogradRegistLongExecute() {
+  size_t count = MlasLongExecuteTests<MlasWinogradConv2DTest<false>>::RegisterLongExecute();
+  if (GetMlasThreadPool() != nullptr) {
+    count += MlasLongExecuteTests<MlasWinogradConv2DTest<true>>::RegisterLongExecute();
+  }
+  return count;
+}
+
+static size_t Conv2dWinogradRegistShortExecute() {
+  size_t count = RegisterWinogradShortExecuteTests<MlasWinogradConv2DTest<false>>();
+  if (GetMlasThreadPool() != nullptr) {
+    count += RegisterWinogradShortExecuteTests<MlasWinogradConv2DTest<true>>();
+  }
+  return count;
+}
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  return is_short_execute ? Conv2dWinogradRegistShortExecute() : Conv2dWinogradRegistLongExecute();
+});
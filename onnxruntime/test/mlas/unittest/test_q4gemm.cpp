@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test_util.h"
+
+#include <cmath>
+#include <vector>
+
+template <bool Threaded>
+class MlasQ4GemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint8_t> BufferQuantData;
+  MatrixGuardBuffer<float> BufferScales;
+  MatrixGuardBuffer<uint8_t> BufferZeroPoints;
+  MatrixGuardBuffer<uint8_t> BufferPackedB;
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<float> BufferTolerance;
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t BlockSize, size_t M, size_t N, size_t K, size_t BatchN, bool WithZeroPoints, bool WithBias) {
+    const size_t BlockCountK = (K + BlockSize - 1) / BlockSize;
+    const size_t ZeroPointStride = (BlockCountK + 1) / 2;
+
+    uint8_t* QuantData = BufferQuantData.GetBuffer(N * BlockCountK * BlockSize / 2);
+    float* Scales = BufferScales.GetBuffer(N * BlockCountK);
+    uint8_t* ZeroPoints = WithZeroPoints ? BufferZeroPoints.GetBuffer(N * ZeroPointStride) : nullptr;
+    const float* A = BufferA.GetBuffer(K * M * BatchN);
+    const float* Bias = WithBias ? BufferBias.GetBuffer(N) : nullptr;
+    float* C = BufferC.GetBuffer(N * M * BatchN, true);
+    float* CReference = BufferCReference.GetBuffer(N * M * BatchN, true);
+    float* Tolerance = BufferTolerance.GetBuffer(N * M * BatchN, true);
+
+    std::default_random_engine generator(static_cast<unsigned>(M * N * K + BlockSize));
+    std::uniform_int_distribution<int> byte_distribution(0, 255);
+    std::uniform_real_distribution<float> scale_distribution(0.001f, 0.1f);
+
+    for (size_t i = 0; i < N * BlockCountK * BlockSize / 2; i++) {
+      QuantData[i] = static_cast<uint8_t>(byte_distribution(generator));
+    }
+    for (size_t i = 0; i < N * BlockCountK; i++) {
+      Scales[i] = scale_distribution(generator);
+    }
+    if (ZeroPoints != nullptr) {
+      for (size_t i = 0; i < N * ZeroPointStride; i++) {
+        ZeroPoints[i] = static_cast<uint8_t>(byte_distribution(generator));
+      }
+    }
+
+    const size_t PackedBSize = MlasQ4GemmPackBSize(BlockSize, N, K);
+    ASSERT_GT(PackedBSize, size_t(0));
+    uint8_t* PackedB = BufferPackedB.GetBuffer(PackedBSize, true);
+    MlasQ4GemmPackB(BlockSize, N, K, QuantData, Scales, ZeroPoints, PackedB);
+
+    std::vector<MLAS_Q4GEMM_DATA_PARAMS> Params(BatchN);
+    for (size_t b = 0; b < BatchN; b++) {
+      Params[b].A = A + K * M * b;
+      Params[b].lda = K;
+      Params[b].B = PackedB;
+      Params[b].Bias = Bias;
+      Params[b].C = C + N * M * b;
+      Params[b].ldc = N;
+    }
+    MlasQ4GemmBatch(BlockSize, M, N, K, BatchN, Params.data(), threadpool_);
+
+    for (size_t b = 0; b < BatchN; b++) {
+      for (size_t m = 0; m < M; m++) {
+        for (size_t n = 0; n < N; n++) {
+          double sum = Bias != nullptr ? Bias[n] : 0.0;
+          double magnitude = std::fabs(sum);
+          for (size_t k = 0; k < K; k++) {
+            const size_t block = n * BlockCountK + k / BlockSize;
+            const size_t index = k % BlockSize;
+            const int value = (QuantData[block * BlockSize / 2 + index / 2] >> ((index % 2) * 4)) & 0x0F;
+            int zero_point = 8;
+            if (ZeroPoints != nullptr) {
+              const size_t zp_block = k / BlockSize;
+              zero_point = (ZeroPoints[n * ZeroPointStride + zp_block / 2] >> ((zp_block % 2) * 4)) & 0x0F;
+            }
+            const double product = A[K * M * b + m * K + k] * (double(value - zero_point) * Scales[block]);
+            sum += product;
+            magnitude += std::fabs(product);
+          }
+          // the kernels accumulate in a different order, bound the rounding error by the sum of magnitudes
+          CReference[N * M * b + m * N + n] = static_cast<float>(sum);
+          Tolerance[N * M * b + m * N + n] = static_cast<float>(magnitude * 1e-4 + 1e-5);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < N * M * BatchN; i++) {
+      ASSERT_LE(std::fabs(C[i] - CReference[i]), Tolerance[i])
+          << "Expected: " << CReference[i] << " Actual: " << C[i] << "@[" << i << "], "
+          << "BlockSize=" << BlockSize << ", M=" << M << ", N=" << N << ", K=" << K << ", BatchN=" << BatchN
+          << ", ZeroPoints=" << WithZeroPoints << ", Bias=" << WithBias;
+    }
+  }
+
+ public:
+  MlasQ4GemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Q4Gemm_Threaded" : "Q4Gemm_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t BlockSize : {32, 64, 128}) {
+      for (size_t M : {1, 2, 3, 4, 5, 16}) {
+        for (size_t K : {16, 32, 48, 96, 200, 257}) {
+          Test(BlockSize, M, 1, K, 1, false, false);
+          Test(BlockSize, M, 19, K, 1, true, true);
+          Test(BlockSize, M, 160, K, 2, true, false);
+          Test(BlockSize, M, 33, K, 3, false, true);
+        }
+      }
+    }
+  }
+};
+
+template <>
+MlasQ4GemmTest<false>* MlasTestFixture<MlasQ4GemmTest<false>>::mlas_tester(nullptr);
+template <>
+MlasQ4GemmTest<true>* MlasTestFixture<MlasQ4GemmTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasQ4GemmTest<false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQ4GemmTest<true>>::RegisterShortExecute();
+  }
+  return count;
+});
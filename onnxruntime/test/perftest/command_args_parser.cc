@@ -104,6 +104,11 @@ namespace perftest {
       "\t\t The number of affinities must be equal to intra_op_num_threads - 1\n\n"
       "\t-D [Disable thread spinning]: disable spinning entirely for thread owned by onnxruntime intra-op thread pool.\n"
       "\t-Z [Force thread to stop spinning between runs]: disallow thread from spinning during runs to reduce cpu usage.\n"
+      "\t-Q [target_qps]: Open-loop load generation. Requests arrive as a Poisson process at the given rate for 'duration' mode seconds or "
+      "until 'times' mode requests were issued, independent of how fast earlier requests finished. "
+      "The -c parallel runs serve the queued requests. Latency is measured from the scheduled arrival and includes queueing delay.\n"
+      "\t-N [num_sessions]: Number of sessions to create. Parallel runs are spread round robin across them. Default:1.\n"
+      "\t-j [json_result_file]: Write the latency distribution (p50/p90/p99/p99.9), queueing delay and CPU usage as JSON to the file.\n"
       "\t-h: help\n");
 }
 #ifdef _WIN32
@@ -133,7 +138,7 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:AMPIDZvhsqz"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:Q:N:j:AMPIDZvhsqz"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -308,6 +313,24 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
       case 'Z':
         test_config.run_config.disable_spinning_between_run = true;
         break;
+      case 'Q':
+        test_config.run_config.target_qps = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
+      case 'N': {
+        PATH_CHAR_TYPE* end = nullptr;
+        const long num_sessions = OrtStrtol<PATH_CHAR_TYPE>(optarg, &end);
+        if (end == optarg || *end != 0 || num_sessions <= 0) {
+          return false;
+        }
+        test_config.run_config.num_sessions = static_cast<size_t>(num_sessions);
+        break;
+      }
+      case 'j':
+        test_config.run_config.json_result_file = optarg;
+        break;
       case '?':
       case 'h':
       default:
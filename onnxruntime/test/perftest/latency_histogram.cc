@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace onnxruntime {
+namespace perftest {
+
+LatencyHistogram::LatencyHistogram() : counts_(IndexOf(kMaxTrackableValue) + 1, 0) {
+}
+
+size_t LatencyHistogram::IndexOf(int64_t value) {
+  int bit_length = 0;
+  for (int64_t v = value; v != 0; v >>= 1) {
+    ++bit_length;
+  }
+  // the first bucket covers [0, kSubBucketCount) with unit resolution, every following bucket covers the next
+  // power-of-two range with kSubBucketHalfCount sub-buckets.
+  const int bucket = std::max(0, bit_length - kSubBucketBits);
+  const int64_t sub_bucket = value >> bucket;
+  return static_cast<size_t>((static_cast<int64_t>(bucket) << (kSubBucketBits - 1)) + sub_bucket);
+}
+
+int64_t LatencyHistogram::HighestEquivalentValue(size_t index) {
+  const int64_t idx = static_cast<int64_t>(index);
+  const int bucket = idx < kSubBucketCount ? 0 : static_cast<int>((idx >> (kSubBucketBits - 1)) - 1);
+  const int64_t sub_bucket = idx - (static_cast<int64_t>(bucket) << (kSubBucketBits - 1));
+  return (sub_bucket << bucket) + (int64_t{1} << bucket) - 1;
+}
+
+void LatencyHistogram::Record(int64_t value) {
+  value = std::min(std::max(value, int64_t{0}), kMaxTrackableValue);
+  ++counts_[IndexOf(value)];
+  min_ = total_count_ == 0 ? value : std::min(min_, value);
+  max_ = std::max(max_, value);
+  sum_ += value;
+  ++total_count_;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.total_count_ == 0) {
+    return;
+  }
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    counts_[i] += other.counts_[i];
+  }
+  min_ = total_count_ == 0 ? other.min_ : std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  sum_ += other.sum_;
+  total_count_ += other.total_count_;
+}
+
+int64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (total_count_ == 0) {
+    return 0;
+  }
+  percentile = std::min(std::max(percentile, 0.0), 100.0);
+  const int64_t target = std::max(int64_t{1}, static_cast<int64_t>(std::ceil(percentile / 100.0 * total_count_)));
+  int64_t seen = 0;
+  for (size_t i = 0; i < counts_.size(); ++i) {
+    seen += counts_[i];
+    if (seen >= target) {
+      return std::min(HighestEquivalentValue(i), max_);
+    }
+  }
+  return max_;
+}
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace onnxruntime {
+namespace perftest {
+
+// Log-linear latency histogram in the style of HdrHistogram.
+// Values are recorded in microseconds. Each power-of-two range is split into kSubBucketHalfCount linear
+// sub-buckets, so any recorded value is reported with a relative error below 0.1% while the memory needed to
+// cover the whole trackable range stays fixed. Values above kMaxTrackableValue are clamped.
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 11;
+  static constexpr int64_t kSubBucketCount = int64_t{1} << kSubBucketBits;
+  static constexpr int64_t kSubBucketHalfCount = kSubBucketCount / 2;
+  // one hour
+  static constexpr int64_t kMaxTrackableValue = int64_t{3600} * 1000 * 1000;
+
+  LatencyHistogram();
+
+  void Record(int64_t value);
+  void Merge(const LatencyHistogram& other);
+
+  int64_t TotalCount() const { return total_count_; }
+  int64_t Min() const { return total_count_ == 0 ? 0 : min_; }
+  int64_t Max() const { return max_; }
+  double Mean() const { return total_count_ == 0 ? 0.0 : static_cast<double>(sum_) / total_count_; }
+
+  // Returns the highest value equivalent to the bucket holding the given percentile, in [0, 100].
+  int64_t ValueAtPercentile(double percentile) const;
+
+ private:
+  static size_t IndexOf(int64_t value);
+  static int64_t HighestEquivalentValue(size_t index);
+
+  std::vector<int64_t> counts_;
+  int64_t total_count_{0};
+  int64_t sum_{0};
+  int64_t min_{0};
+  int64_t max_{0};
+};
+
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -7,7 +7,11 @@
 #endif
 
 #include "performance_runner.h"
+#include <deque>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -108,28 +112,115 @@ void PerformanceResult::DumpToFile(const std::basic_string<ORTCHAR_T>& path, boo
   }
 }
 
+static std::string EscapeJsonString(const std::string& str) {
+  std::ostringstream ss;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        ss << "\\\"";
+        break;
+      case '\\':
+        ss << "\\\\";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        } else {
+          ss << c;
+        }
+    }
+  }
+  return ss.str();
+}
+
+static void WriteJsonDistribution(std::ostream& os, const char* name, const LatencyHistogram& histogram) {
+  os << "  \"" << name << "\": {"
+     << "\"count\": " << histogram.TotalCount()
+     << ", \"min\": " << histogram.Min()
+     << ", \"mean\": " << histogram.Mean()
+     << ", \"p50\": " << histogram.ValueAtPercentile(50.0)
+     << ", \"p90\": " << histogram.ValueAtPercentile(90.0)
+     << ", \"p99\": " << histogram.ValueAtPercentile(99.0)
+     << ", \"p99.9\": " << histogram.ValueAtPercentile(99.9)
+     << ", \"max\": " << histogram.Max() << "}";
+}
+
+void PerformanceResult::DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const {
+  std::ofstream outfile(path, std::ofstream::out | std::ofstream::trunc);
+  if (!outfile.good()) {
+    std::cerr << "failed to open json result file '" << ToUTF8String(path.c_str()) << "'.\n";
+    return;
+  }
+
+  const std::chrono::duration<double> run_time = end - start;
+  const size_t requests = time_costs.size();
+  outfile << "{\n"
+          << "  \"model_name\": \"" << EscapeJsonString(model_name) << "\",\n"
+          << "  \"mode\": \"" << (run_config.target_qps > 0 ? "open_loop" : "closed_loop") << "\",\n"
+          << "  \"target_qps\": " << run_config.target_qps << ",\n"
+          << "  \"num_sessions\": " << run_config.num_sessions << ",\n"
+          << "  \"concurrent_runs\": " << run_config.concurrent_session_runs << ",\n"
+          << "  \"requests\": " << requests << ",\n"
+          << "  \"failed_requests\": " << failed_requests << ",\n"
+          << "  \"run_time_s\": " << run_time.count() << ",\n"
+          << "  \"achieved_qps\": " << (run_time.count() > 0 ? requests / run_time.count() : 0.0) << ",\n"
+          << "  \"avg_cpu_usage_percent\": " << average_CPU_usage << ",\n"
+          << "  \"peak_working_set_bytes\": " << peak_workingset_size << ",\n";
+  WriteJsonDistribution(outfile, "latency_us", latency_us);
+  outfile << ",\n";
+  WriteJsonDistribution(outfile, "queueing_delay_us", queueing_delay_us);
+  outfile << ",\n";
+  WriteJsonDistribution(outfile, "service_time_us", service_time_us);
+  outfile << "\n}" << std::endl;
+}
+
+static int64_t ToMicroseconds(std::chrono::duration<double> duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void PerformanceRunner::RecordResult(std::chrono::duration<double> service_time,
+                                     std::chrono::duration<double> queueing_delay,
+                                     std::chrono::duration<double> latency) {
+  std::lock_guard<OrtMutex> guard(results_mutex_);
+  performance_result_.time_costs.emplace_back(service_time.count());
+  performance_result_.total_time_cost += service_time.count();
+  performance_result_.service_time_us.Record(ToMicroseconds(service_time));
+  performance_result_.queueing_delay_us.Record(ToMicroseconds(queueing_delay));
+  performance_result_.latency_us.Record(ToMicroseconds(latency));
+  if (performance_test_config_.run_config.f_verbose) {
+    std::cout << "iteration:" << performance_result_.time_costs.size() << ","
+              << "time_cost:" << performance_result_.time_costs.back() << std::endl;
+  }
+}
+
 Status PerformanceRunner::Run() {
   if (!Initialize()) {
     return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "failed to initialize.");
   }
 
-  // warm up
-  ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+  // warm up each session
+  for (size_t i = 0; i != sessions_.size(); ++i) {
+    ORT_RETURN_IF_ERROR(RunOneIteration<true>());
+  }
 
   // TODO: start profiling
   // if (!performance_test_config_.run_config.profile_file.empty())
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -152,6 +243,21 @@ Status PerformanceRunner::Run() {
             << "Peak working set size: " << performance_result_.peak_workingset_size << " bytes"
             << std::endl;
 
+  if (performance_test_config_.run_config.target_qps > 0) {
+    const auto& latency = performance_result_.latency_us;
+    const auto& queueing_delay = performance_result_.queueing_delay_us;
+    std::cout << "Target inferences per second: " << performance_test_config_.run_config.target_qps << "\n"
+              << "Failed inference requests: " << performance_result_.failed_requests << "\n"
+              << "Latency (us) P50: " << latency.ValueAtPercentile(50.0)
+              << " P90: " << latency.ValueAtPercentile(90.0)
+              << " P99: " << latency.ValueAtPercentile(99.0)
+              << " P99.9: " << latency.ValueAtPercentile(99.9) << "\n"
+              << "Queueing delay (us) P50: " << queueing_delay.ValueAtPercentile(50.0)
+              << " P90: " << queueing_delay.ValueAtPercentile(90.0)
+              << " P99: " << queueing_delay.ValueAtPercentile(99.0)
+              << " P99.9: " << queueing_delay.ValueAtPercentile(99.9) << std::endl;
+  }
+
   return Status::OK();
 }
 
@@ -242,6 +348,87 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  using Clock = std::chrono::steady_clock;
+  const auto& run_config = performance_test_config_.run_config;
+
+  std::mt19937 rand_engine(run_config.random_seed_for_input_data >= 0
+                               ? static_cast<std::mt19937::result_type>(run_config.random_seed_for_input_data)
+                               : std::random_device{}());
+  std::exponential_distribution<double> inter_arrival_seconds(run_config.target_qps);
+
+  std::deque<Clock::time_point> pending;
+  bool done = false;
+  OrtMutex m;
+  OrtCondVar cv;
+
+  // one worker per concurrent run, each bound to a session. requests wait in the queue while all workers are busy.
+  std::vector<std::thread> workers;
+  workers.reserve(run_config.concurrent_session_runs);
+  for (size_t i = 0; i != run_config.concurrent_session_runs; ++i) {
+    TestSession* session = sessions_[i % sessions_.size()].get();
+    workers.emplace_back([this, session, &pending, &done, &m, &cv]() {
+      for (;;) {
+        Clock::time_point arrival;
+        {
+          std::unique_lock<OrtMutex> lock(m);
+          cv.wait(lock, [&pending, &done]() { return done || !pending.empty(); });
+          if (pending.empty()) {
+            return;
+          }
+          arrival = pending.front();
+          pending.pop_front();
+        }
+
+        const auto start = Clock::now();
+        std::chrono::duration<double> service_time(std::chrono::seconds(0));
+        auto status = RunSession(*session, service_time);
+        const auto end = Clock::now();
+        if (!status.IsOK()) {
+          std::cerr << status.ErrorMessage() << std::endl;
+          std::lock_guard<OrtMutex> guard(results_mutex_);
+          ++performance_result_.failed_requests;
+          continue;
+        }
+        RecordResult(service_time, start - arrival, end - arrival);
+      }
+    });
+  }
+
+  // Requests are issued at their scheduled arrival time whether or not earlier ones have finished, and latency is
+  // measured from that time. A closed loop would instead slow down the offered load when the model falls behind and
+  // hide the queueing delay.
+  const auto begin = Clock::now();
+  const auto deadline = begin + std::chrono::seconds(run_config.duration_in_seconds);
+  auto arrival = begin;
+  for (size_t issued = 0;; ++issued) {
+    arrival += std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(inter_arrival_seconds(rand_engine)));
+    if (run_config.test_mode == TestMode::kFixDurationMode ? arrival >= deadline
+                                                           : issued >= run_config.repeated_times) {
+      break;
+    }
+
+    std::this_thread::sleep_until(arrival);
+    {
+      std::lock_guard<OrtMutex> lock(m);
+      pending.push_back(arrival);
+    }
+    cv.notify_one();
+  }
+
+  {
+    std::lock_guard<OrtMutex> lock(m);
+    done = true;
+  }
+  cv.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+
+  return Status::OK();
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     const auto& file_path = performance_test_config_.model_info.model_file_path;
@@ -283,7 +470,9 @@ PerformanceRunner::PerformanceRunner(Ort::Env& env, const PerformanceTestConfig&
     : performance_test_config_(test_config),
       test_model_info_(CreateModelInfo(test_config)) {
   session_create_start_ = std::chrono::high_resolution_clock::now();
-  session_ = CreateSession(env, rd, test_config, *test_model_info_);
+  for (size_t i = 0; i != test_config.run_config.num_sessions; ++i) {
+    sessions_.push_back(CreateSession(env, rd, test_config, *test_model_info_));
+  }
   session_create_end_ = std::chrono::high_resolution_clock::now();
 }
 
@@ -309,9 +498,13 @@ bool PerformanceRunner::Initialize() {
   test_case_ = CreateOnnxTestCase(narrow_model_name, std::move(test_model_info_), 0.0, 0.0);
 
   if (performance_test_config_.run_config.generate_model_input_binding) {
-    return static_cast<OnnxRuntimeTestSession*>(
-               session_.get())
-        ->PopulateGeneratedInputTestData(performance_test_config_.run_config.random_seed_for_input_data);
+    for (auto& session : sessions_) {
+      if (!static_cast<OnnxRuntimeTestSession*>(session.get())
+               ->PopulateGeneratedInputTestData(performance_test_config_.run_config.random_seed_for_input_data)) {
+        return false;
+      }
+    }
+    return true;
   }
 
   // TODO: Place input tensor on cpu memory if dnnl provider type to avoid CopyTensor logic in CopyInputAcrossDevices
@@ -320,19 +513,22 @@ bool PerformanceRunner::Initialize() {
     std::cout << "there is no test data for model " << test_case_->GetTestCaseName() << std::endl;
     return false;
   }
-  for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
-    std::unordered_map<std::string, Ort::Value> feeds;
-    test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
-    // Discard the names in feeds
-    int input_count = test_model_info->GetInputCount();
-    for (int i = 0; i != input_count; ++i) {
-      auto iter = feeds.find(test_model_info->GetInputName(i));
-      if (iter == feeds.end()) {
-        std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
-                  << test_case_->GetTestCaseName() << std::endl;
-        return false;
+  // each session owns its copy of the inputs
+  for (auto& session : sessions_) {
+    for (size_t test_data_id = 0; test_data_id != test_data_count; ++test_data_id) {
+      std::unordered_map<std::string, Ort::Value> feeds;
+      test_case_->LoadTestData(test_data_id /* id */, b_, feeds, true);
+      // Discard the names in feeds
+      int input_count = test_model_info->GetInputCount();
+      for (int i = 0; i != input_count; ++i) {
+        auto iter = feeds.find(test_model_info->GetInputName(i));
+        if (iter == feeds.end()) {
+          std::cout << "there is no test input data for input " << test_model_info->GetInputName(i) << " and model "
+                    << test_case_->GetTestCaseName() << std::endl;
+          return false;
+        }
+        session->PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
       }
-      session_->PreLoadTestData(test_data_id, static_cast<size_t>(i), std::move(iter->second));
     }
   }
 
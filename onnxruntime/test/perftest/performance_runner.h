@@ -10,6 +10,7 @@
 #include <iostream>
 #include <random>
 #include <chrono>
+#include <atomic>
 // onnxruntime dependencies
 #include <core/common/common.h>
 #include <core/common/status.h>
@@ -18,6 +19,7 @@
 #include <core/session/onnxruntime_cxx_api.h>
 #include "test_configuration.h"
 #include "heap_buffer.h"
+#include "latency_histogram.h"
 #include "test_session.h"
 #include "OrtValueList.h"
 
@@ -35,8 +37,15 @@ struct PerformanceResult {
   double total_time_cost{0};
   std::vector<double> time_costs;
   std::string model_name;
+  // distributions in microseconds. latency is measured from the scheduled arrival of a request in open-loop mode,
+  // and equals the service time otherwise.
+  LatencyHistogram latency_us;
+  LatencyHistogram queueing_delay_us;
+  LatencyHistogram service_time_us;
+  size_t failed_requests{0};
 
   void DumpToFile(const std::basic_string<ORTCHAR_T>& path, bool f_include_statistics = false) const;
+  void DumpToJson(const std::basic_string<ORTCHAR_T>& path, const RunConfig& run_config) const;
 };
 
 class PerformanceRunner {
@@ -51,35 +60,41 @@ class PerformanceRunner {
   inline void SerializeResult() const {
     performance_result_.DumpToFile(performance_test_config_.model_info.result_file_path,
                                    performance_test_config_.run_config.f_dump_statistics);
+    if (!performance_test_config_.run_config.json_result_file.empty()) {
+      performance_result_.DumpToJson(performance_test_config_.run_config.json_result_file,
+                                     performance_test_config_.run_config);
+    }
   }
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PerformanceRunner);
 
  private:
   bool Initialize();
 
-  template <bool isWarmup>
-  Status RunOneIteration() {
-    std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
-
+  static Status RunSession(TestSession& session, std::chrono::duration<double>& duration_seconds) {
     auto status = Status::OK();
     ORT_TRY {
-      duration_seconds = session_->Run();
+      duration_seconds = session.Run();
     }
     ORT_CATCH(const std::exception& ex) {
       ORT_HANDLE_EXCEPTION([&]() {
         status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PerformanceRunner::RunOneIteration caught exception: ", ex.what());
       });
     }
-    ORT_RETURN_IF_ERROR(status);
+    return status;
+  }
+
+  void RecordResult(std::chrono::duration<double> service_time, std::chrono::duration<double> queueing_delay,
+                    std::chrono::duration<double> latency);
+
+  template <bool isWarmup>
+  Status RunOneIteration() {
+    // spread the runs round robin across the sessions
+    TestSession& session = *sessions_[next_session_++ % sessions_.size()];
+    std::chrono::duration<double> duration_seconds(std::chrono::seconds(0));
+    ORT_RETURN_IF_ERROR(RunSession(session, duration_seconds));
 
     if (!isWarmup) {
-      std::lock_guard<OrtMutex> guard(results_mutex_);
-      performance_result_.time_costs.emplace_back(duration_seconds.count());
-      performance_result_.total_time_cost += duration_seconds.count();
-      if (performance_test_config_.run_config.f_verbose) {
-        std::cout << "iteration:" << performance_result_.time_costs.size() << ","
-                  << "time_cost:" << performance_result_.time_costs.back() << std::endl;
-      }
+      RecordResult(duration_seconds, std::chrono::duration<double>::zero(), duration_seconds);
     }
     return Status::OK();
   }
@@ -88,6 +103,7 @@ class PerformanceRunner {
   Status RepeatedTimesTest();
   Status ForkJoinRepeat();
   Status RunParallelDuration();
+  Status RunOpenLoop();
 
   inline Status RunFixDuration() {
     while (performance_result_.total_time_cost < performance_test_config_.run_config.duration_in_seconds) {
@@ -109,7 +125,8 @@ class PerformanceRunner {
   PerformanceResult performance_result_;
   PerformanceTestConfig performance_test_config_;
   std::unique_ptr<TestModelInfo> test_model_info_;
-  std::unique_ptr<TestSession> session_;
+  std::vector<std::unique_ptr<TestSession>> sessions_;
+  std::atomic<size_t> next_session_{0};
   onnxruntime::test::HeapBuffer b_;
   std::unique_ptr<ITestCase> test_case_;
 
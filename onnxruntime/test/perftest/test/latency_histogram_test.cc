@@ -0,0 +1,100 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "test/perftest/latency_histogram.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace perftest {
+namespace test {
+
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.TotalCount(), 0);
+  EXPECT_EQ(histogram.Min(), 0);
+  EXPECT_EQ(histogram.Max(), 0);
+  EXPECT_EQ(histogram.Mean(), 0.0);
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 0);
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  // values below kSubBucketCount have unit resolution
+  LatencyHistogram histogram;
+  for (int64_t value = 1; value <= 1000; ++value) {
+    histogram.Record(value);
+  }
+
+  EXPECT_EQ(histogram.TotalCount(), 1000);
+  EXPECT_EQ(histogram.Min(), 1);
+  EXPECT_EQ(histogram.Max(), 1000);
+  EXPECT_DOUBLE_EQ(histogram.Mean(), 500.5);
+  EXPECT_EQ(histogram.ValueAtPercentile(0), 1);
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 500);
+  EXPECT_EQ(histogram.ValueAtPercentile(90), 900);
+  EXPECT_EQ(histogram.ValueAtPercentile(99), 990);
+  EXPECT_EQ(histogram.ValueAtPercentile(100), 1000);
+}
+
+TEST(LatencyHistogramTest, Bucketing) {
+  LatencyHistogram histogram;
+  // the first bucket covers [0, 2048) one by one, the next one covers [2048, 4096) two by two
+  histogram.Record(2047);
+  histogram.Record(2048);
+  histogram.Record(2049);
+  histogram.Record(4095);
+
+  EXPECT_EQ(histogram.ValueAtPercentile(25), 2047);
+  // 2048 and 2049 share a sub-bucket, which reports its highest value
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 2049);
+  EXPECT_EQ(histogram.ValueAtPercentile(75), 2049);
+  EXPECT_EQ(histogram.ValueAtPercentile(100), 4095);
+}
+
+TEST(LatencyHistogramTest, RelativeError) {
+  for (int64_t value : {int64_t{3001}, int64_t{123457}, int64_t{1000003}, int64_t{987654321}}) {
+    LatencyHistogram histogram;
+    histogram.Record(value);
+    histogram.Record(LatencyHistogram::kMaxTrackableValue);
+
+    const int64_t reported = histogram.ValueAtPercentile(50);
+    EXPECT_GE(reported, value);
+    EXPECT_LT(static_cast<double>(reported - value) / value, 0.001) << "value: " << value;
+  }
+}
+
+TEST(LatencyHistogramTest, ClampsValues) {
+  LatencyHistogram histogram;
+  histogram.Record(-5);
+  histogram.Record(LatencyHistogram::kMaxTrackableValue * 2);
+
+  EXPECT_EQ(histogram.Min(), 0);
+  EXPECT_EQ(histogram.Max(), LatencyHistogram::kMaxTrackableValue);
+  EXPECT_EQ(histogram.ValueAtPercentile(50), 0);
+  EXPECT_EQ(histogram.ValueAtPercentile(100), LatencyHistogram::kMaxTrackableValue);
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram first;
+  LatencyHistogram second;
+  for (int64_t value = 1; value <= 500; ++value) {
+    first.Record(value);
+    second.Record(value + 500);
+  }
+
+  LatencyHistogram merged;
+  merged.Merge(first);
+  merged.Merge(second);
+  merged.Merge(LatencyHistogram());
+
+  EXPECT_EQ(merged.TotalCount(), 1000);
+  EXPECT_EQ(merged.Min(), 1);
+  EXPECT_EQ(merged.Max(), 1000);
+  EXPECT_DOUBLE_EQ(merged.Mean(), 500.5);
+  EXPECT_EQ(merged.ValueAtPercentile(50), 500);
+  EXPECT_EQ(merged.ValueAtPercentile(99), 990);
+}
+
+}  // namespace test
+}  // namespace perftest
+}  // namespace onnxruntime
@@ -61,6 +61,10 @@ struct RunConfig {
   std::string intra_op_thread_affinities;
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
+  // open-loop load generation. 0 keeps the closed-loop behavior of running the next request when one finishes.
+  double target_qps{0};
+  size_t num_sessions{1};
+  std::basic_string<ORTCHAR_T> json_result_file;
 };
 
 struct PerformanceTestConfig {
@@ -13,6 +13,8 @@
 #include "gtest/gtest.h"
 #include <algorithm>
 #include <memory>
+#include <atomic>
+#include <chrono>
 #include <functional>
 
 #ifdef _WIN32
@@ -181,6 +183,130 @@ void TestPoolCreation(const std::string&, int iter) {
   ASSERT_EQ(ctr, iter * per_iter);
 }
 
+// Test a pool measuring the cost of its loops.  The same loop runs several times, the first run
+// uses the cost given by the caller and the next ones the measured cost, each iteration must
+// still be run exactly once per loop, also when loops run concurrently.
+void TestAdaptiveParallelFor(const std::string&, int num_threads, int num_concurrent, int num_tasks,
+                             double cost_per_unit) {
+  constexpr int num_loops = 10;
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.adaptive_block_size_ = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, num_threads, true);
+  std::vector<std::unique_ptr<TestData>> td;
+  for (int c = 0; c < num_concurrent; c++) {
+    td.push_back(CreateTestData(num_tasks));
+  }
+  auto run_loops = [&](int c) {
+    for (int l = 0; l < num_loops; l++) {
+      ThreadPool::TryParallelFor(tp.get(), num_tasks, cost_per_unit, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; i++) {
+          IncrementElement(*td[c], i);
+        }
+      });
+    }
+  };
+
+  onnxruntime::Barrier b(num_concurrent - 1);
+  for (int c = 0; c < num_concurrent - 1; c++) {
+    ThreadPool::Schedule(tp.get(), [&, c]() {
+      run_loops(c);
+      b.Notify();
+    });
+  }
+  run_loops(num_concurrent - 1);
+  b.Wait();
+  for (int c = 0; c < num_concurrent; c++) {
+    ValidateTestData(*td[c], num_loops);
+  }
+}
+
+// Test that a pool measuring the cost of its loops splits a loop differently once the cost given by
+// the caller is known to be wrong, and that the cost measured for a call site is not used for
+// another call site running the same callable with the same static cost.
+void TestAdaptiveBlockSize() {
+  constexpr std::ptrdiff_t num_tasks = 16;
+  constexpr int num_runs = 5;
+  onnxruntime::ThreadOptions thread_options;
+  thread_options.adaptive_block_size_ = true;
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), thread_options, nullptr, 4, true);
+  std::atomic<int> num_blocks{0};
+  bool heavy = false;
+  std::function<void(std::ptrdiff_t, std::ptrdiff_t)> fn = [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    num_blocks++;
+    if (heavy) {
+      // Spins about 50us per iteration.
+      auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(50 * (last - first));
+      while (std::chrono::steady_clock::now() < end) {
+      }
+    }
+  };
+
+  // Overestimated cost: the first run is split, the next ones run directly in the caller.
+  std::vector<int> blocks_per_run;
+  for (int run = 0; run < num_runs; run++) {
+    num_blocks = 0;
+    ThreadPool::TryParallelFor(tp.get(), num_tasks, 1e7, fn);
+    blocks_per_run.push_back(num_blocks);
+  }
+  ASSERT_GT(blocks_per_run.front(), 1);
+  ASSERT_EQ(blocks_per_run.back(), 1);
+
+  // Underestimated cost: the first run is done by the caller, the next ones are split.
+  heavy = true;
+  blocks_per_run.clear();
+  for (int run = 0; run < num_runs; run++) {
+    num_blocks = 0;
+    ThreadPool::TryParallelFor(tp.get(), num_tasks, 1.0, fn);
+    blocks_per_run.push_back(num_blocks);
+  }
+  ASSERT_EQ(blocks_per_run.front(), 1);
+  ASSERT_GT(blocks_per_run.back(), 1);
+
+  // Same callable and cost from another call site, which has not been measured yet.
+  num_blocks = 0;
+  ThreadPool::TryParallelFor(tp.get(), num_tasks, 1.0, fn);
+  ASSERT_EQ(num_blocks, 1);
+}
+
+// Test loops run by concurrent callers sharing the threads of the pool: each caller's loops see
+// its share of the degree of parallelism, and each iteration must still be run exactly once.
+void TestThreadShare(int num_threads, int num_concurrent, int num_tasks) {
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), onnxruntime::ThreadOptions(), nullptr,
+                                         num_threads, true);
+  const int full_dop = ThreadPool::DegreeOfParallelism(tp.get());
+  std::vector<std::unique_ptr<TestData>> td;
+  for (int c = 0; c < num_concurrent; c++) {
+    td.push_back(CreateTestData(num_tasks));
+  }
+  std::vector<int> dops(num_concurrent, 0);
+  auto run_loop = [&](int c) {
+    ThreadPool::ThreadShareScope share(num_concurrent);
+    dops[c] = ThreadPool::DegreeOfParallelism(tp.get());
+    ThreadPool::TryParallelFor(tp.get(), num_tasks, 10.0, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; i++) {
+        IncrementElement(*td[c], i);
+      }
+    });
+  };
+
+  onnxruntime::Barrier b(num_concurrent - 1);
+  for (int c = 0; c < num_concurrent - 1; c++) {
+    ThreadPool::Schedule(tp.get(), [&, c]() {
+      run_loop(c);
+      b.Notify();
+    });
+  }
+  run_loop(num_concurrent - 1);
+  b.Wait();
+
+  for (int c = 0; c < num_concurrent; c++) {
+    ValidateTestData(*td[c]);
+    ASSERT_EQ(dops[c] * std::min(num_concurrent, num_threads), full_dop);
+  }
+  // the share is restored when the scope is exited
+  ASSERT_EQ(ThreadPool::DegreeOfParallelism(tp.get()), full_dop);
+}
+
 // Test multi-loop parallel sections, with a series of fixed-size loops
 void TestMultiLoopSections(const std::string& name, int num_threads, int num_loops) {
   for (int rep = 0; rep < 5; rep++) {
@@ -416,6 +542,46 @@ TEST(ThreadPoolTest, TestConcurrentParallelFor_4Thread_4Conc_1MTasks_dynamic_blo
   TestConcurrentParallelFor("TestConcurrentParallelFor_4Thread_4Conc_1MTasks_dynamic_block_base_128", 4, 4, 1000000, 128, true);
 }
 
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_1Conc_0Tasks) {
+  TestAdaptiveParallelFor("TestAdaptiveParallelFor_4Thread_1Conc_0Tasks", 4, 1, 0, 1.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_1Conc_1Tasks) {
+  TestAdaptiveParallelFor("TestAdaptiveParallelFor_4Thread_1Conc_1Tasks", 4, 1, 1, 1.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_1Thread_1Conc_1MTasks) {
+  TestAdaptiveParallelFor("TestAdaptiveParallelFor_1Thread_1Conc_1MTasks", 1, 1, 1000000, 1.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_1Conc_1MTasks_Underestimated) {
+  TestAdaptiveParallelFor("TestAdaptiveParallelFor_4Thread_1Conc_1MTasks_Underestimated", 4, 1, 1000000, 0.01);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_1Conc_1MTasks_Overestimated) {
+  TestAdaptiveParallelFor("TestAdaptiveParallelFor_4Thread_1Conc_1MTasks_Overestimated", 4, 1, 1000000, 1e6);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_4Thread_4Conc_1MTasks) {
+  TestAdaptiveParallelFor("TestAdaptiveParallelFor_4Thread_4Conc_1MTasks", 4, 4, 1000000, 10.0);
+}
+
+TEST(ThreadPoolTest, TestAdaptiveParallelFor_BlockSizeAdapts) {
+  TestAdaptiveBlockSize();
+}
+
+TEST(ThreadPoolTest, TestThreadShare_4Thread_1Conc_1MTasks) {
+  TestThreadShare(4, 1, 1000000);
+}
+
+TEST(ThreadPoolTest, TestThreadShare_4Thread_2Conc_1MTasks) {
+  TestThreadShare(4, 2, 1000000);
+}
+
+TEST(ThreadPoolTest, TestThreadShare_4Thread_8Conc_1KTasks) {
+  TestThreadShare(4, 8, 1000);
+}
+
 TEST(ThreadPoolTest, TestBurstScheduling_0Tasks) {
   TestBurstScheduling("TestBurstScheduling_0Tasks", 0);
 }
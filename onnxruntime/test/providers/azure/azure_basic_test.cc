@@ -7,6 +7,21 @@
 #include "test/util/include/test_allocator.h"
 #include "gtest/gtest.h"
 
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <mutex>
+#include <thread>
+
+#include "nlohmann/json.hpp"
+#endif
+
 // defined in test_main.cc
 extern std::unique_ptr<Ort::Env> ort_env;
 
@@ -90,5 +105,209 @@ TEST(AzureEP, TestSessionRunWrongUri) {
   EXPECT_THROW(sess.Run(run_options, input_names, input_values.data(), 1UL, output_names, 1UL), Ort::Exception);
 }
 
+#ifndef _WIN32
+// Serves triton inference requests on a local port by sending the inputs back as outputs,
+// the i-th requested output being the i-th input.
+class TritonEchoServer {
+ public:
+  TritonEchoServer() {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    ORT_ENFORCE(bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), addr_len) == 0 &&
+                listen(listen_fd_, 16) == 0 &&
+                getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0);
+    port_ = ntohs(addr.sin_port);
+    accept_thread_ = std::thread([this]() { Accept(); });
+  }
+
+  ~TritonEchoServer() {
+    shutdown(listen_fd_, SHUT_RDWR);
+    accept_thread_.join();
+    close(listen_fd_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (int fd : connection_fds_) {
+        shutdown(fd, SHUT_RDWR);
+      }
+    }
+    for (auto& thread : connection_threads_) {
+      thread.join();
+    }
+  }
+
+  std::string Uri() const { return "127.0.0.1:" + std::to_string(port_); }
+  int NumConnections() const { return num_connections_; }
+  int NumRequests() const { return num_requests_; }
+
+ private:
+  void Accept() {
+    for (;;) {
+      int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0) {
+        return;
+      }
+      ++num_connections_;
+      std::lock_guard<std::mutex> lock(mutex_);
+      connection_fds_.push_back(fd);
+      connection_threads_.emplace_back([this, fd]() {
+        while (Serve(fd)) {
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection_fds_.erase(std::find(connection_fds_.begin(), connection_fds_.end(), fd));
+        close(fd);
+      });
+    }
+  }
+
+  static bool ReadExactly(int fd, std::string& buffer, size_t size) {
+    char chunk[4096];
+    while (buffer.size() < size) {
+      ssize_t n = recv(fd, chunk, std::min(sizeof(chunk), size - buffer.size()), 0);
+      if (n <= 0) {
+        return false;
+      }
+      buffer.append(chunk, static_cast<size_t>(n));
+    }
+    return true;
+  }
+
+  static bool WriteAll(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+      ssize_t n = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+      if (n <= 0) {
+        return false;
+      }
+      offset += static_cast<size_t>(n);
+    }
+    return true;
+  }
+
+  static size_t HeaderValue(const std::string& headers, const std::string& name) {
+    auto pos = headers.find(name + ":");
+    return pos == std::string::npos ? 0 : std::stoul(headers.substr(pos + name.size() + 1));
+  }
+
+  // Returns false when the connection is closed.
+  bool Serve(int fd) {
+    std::string headers;
+    char c;
+    while (headers.size() < 4 || headers.compare(headers.size() - 4, 4, "\r\n\r\n") != 0) {
+      if (recv(fd, &c, 1, 0) != 1) {
+        return false;
+      }
+      headers.push_back(static_cast<char>(std::tolower(c)));
+    }
+    if (headers.find("expect: 100-continue") != std::string::npos &&
+        !WriteAll(fd, "HTTP/1.1 100 Continue\r\n\r\n")) {
+      return false;
+    }
+
+    std::string body;
+    if (!ReadExactly(fd, body, HeaderValue(headers, "content-length"))) {
+      return false;
+    }
+    const size_t json_size = HeaderValue(headers, "inference-header-content-length");
+    auto request = nlohmann::json::parse(body.substr(0, json_size), nullptr, false);
+    ++num_requests_;
+
+    nlohmann::json response;
+    response["model_name"] = "echo";
+    response["outputs"] = nlohmann::json::array();
+    std::string data;
+    size_t offset = json_size;
+    for (size_t i = 0; i < request["inputs"].size(); ++i) {
+      const auto& input = request["inputs"][i];
+      const size_t size = input["parameters"]["binary_data_size"].get<size_t>();
+      response["outputs"].push_back({{"name", request["outputs"][i]["name"]},
+                                     {"datatype", input["datatype"]},
+                                     {"shape", input["shape"]},
+                                     {"parameters", {{"binary_data_size", size}}}});
+      data.append(body, offset, size);
+      offset += size;
+    }
+    const std::string json = response.dump();
+    return WriteAll(fd, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\n"
+                        "Inference-Header-Content-Length: " + std::to_string(json.size()) +
+                            "\r\nContent-Length: " + std::to_string(json.size() + data.size()) +
+                            "\r\n\r\n" + json + data);
+  }
+
+  int listen_fd_ = -1;
+  int port_ = 0;
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<int> connection_fds_;
+  std::vector<std::thread> connection_threads_;
+  std::atomic<int> num_connections_{0};
+  std::atomic<int> num_requests_{0};
+};
+
+static void RunEchoModel(Ort::Session& sess, float first_value) {
+  float raw_inputs[6];
+  for (int i = 0; i < 6; ++i) {
+    raw_inputs[i] = first_value + i;
+  }
+  std::vector<int64_t> input_dims = {3, 2};
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  auto default_allocator = std::make_unique<MockedOrtAllocator>();
+  auto input_value = Ort::Value::CreateTensor<float>(default_allocator->Info(), raw_inputs, 6, input_dims.data(), 2);
+
+  Ort::RunOptions run_options;
+  run_options.AddConfigEntry("use_azure", "1");
+  run_options.AddConfigEntry("azure.auth_key", "key");
+  auto outputs = sess.Run(run_options, input_names, &input_value, 1UL, output_names, 1UL);
+  ASSERT_EQ(outputs.size(), 1u);
+  ASSERT_EQ(outputs[0].GetTensorTypeAndShapeInfo().GetShape(), input_dims);
+  const float* y = outputs[0].GetTensorData<float>();
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(y[i], raw_inputs[i]);
+  }
+}
+
+TEST(AzureEP, TestSessionRunReusesConnection) {
+  TritonEchoServer server;
+  Ort::SessionOptions so;
+  so.AddConfigEntry("azure.endpoint_type", "triton");
+  so.AddConfigEntry("azure.uri", server.Uri().c_str());
+  so.AddConfigEntry("azure.model_name", "echo");
+  Ort::Session sess(*ort_env, ORT_TSTR("testdata/mul_1.onnx"), so);
+
+  constexpr int kNumRuns = 10;
+  for (int i = 0; i < kNumRuns; ++i) {
+    RunEchoModel(sess, static_cast<float>(i * 10));
+  }
+  EXPECT_EQ(server.NumRequests(), kNumRuns);
+  EXPECT_EQ(server.NumConnections(), 1) << "the invoker should be kept by the session with its connection";
+}
+
+TEST(AzureEP, TestSessionRunBatching) {
+  TritonEchoServer server;
+  constexpr int kNumThreads = 4;
+  Ort::SessionOptions so;
+  so.AddConfigEntry("azure.endpoint_type", "triton");
+  so.AddConfigEntry("azure.uri", server.Uri().c_str());
+  so.AddConfigEntry("azure.model_name", "echo");
+  // each run sends 3 rows, the batch is sent once the runs of all the threads joined it
+  so.AddConfigEntry("azure.max_batch_size", std::to_string(3 * kNumThreads).c_str());
+  so.AddConfigEntry("azure.max_batch_delay_us", "60000000");
+  Ort::Session sess(*ort_env, ORT_TSTR("testdata/mul_1.onnx"), so);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&sess, t]() { RunEchoModel(sess, static_cast<float>(t * 100)); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(server.NumRequests(), 1);
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
\ No newline at end of file
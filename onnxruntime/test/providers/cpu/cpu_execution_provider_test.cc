@@ -2,7 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/cpu_execution_provider.h"
+#include "core/framework/session_options.h"
+#include "core/providers/cpu/cpu_provider_factory_creator.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 #include "gtest/gtest.h"
+#include "test/util/include/asserts.h"
 
 namespace onnxruntime {
 namespace test {
@@ -12,5 +16,22 @@ TEST(CPUExecutionProviderTest, MetadataTest) {
   EXPECT_TRUE(provider != nullptr);
   ASSERT_STREQ(provider->GetAllocator(OrtMemTypeDefault)->Info().name, CPU);
 }
+
+TEST(CPUExecutionProviderTest, InfoFromSessionOptions) {
+  SessionOptions so;
+  so.enable_cpu_mem_arena = false;
+  auto provider = CPUProviderFactoryCreator::Create(so)->CreateProvider();
+  const auto& default_info = static_cast<const CPUExecutionProvider*>(provider.get())->GetInfo();
+  EXPECT_FALSE(default_info.create_arena);
+  EXPECT_FALSE(default_info.tree_ensemble_compact_layout);
+  EXPECT_FALSE(default_info.generation_compact_finished_sequences);
+
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigTreeEnsembleCompactLayout, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigGenerationCompactFinishedSequences, "1"));
+  provider = CPUProviderFactoryCreator::Create(so)->CreateProvider();
+  const auto& info = static_cast<const CPUExecutionProvider*>(provider.get())->GetInfo();
+  EXPECT_TRUE(info.tree_ensemble_compact_layout);
+  EXPECT_TRUE(info.generation_compact_finished_sequences);
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -43,5 +43,38 @@ TEST(CategoryMapper, IntToString) {
 
   RunTest(dims, input, output);
 }
+
+TEST(CategoryMapper, ManyCategories) {
+  constexpr int64_t num_categories = 1000;
+  constexpr int64_t num_inputs = 20000;
+
+  std::vector<std::string> categories;
+  std::vector<int64_t> indexes;
+  for (int64_t i = 0; i < num_categories; ++i) {
+    categories.push_back("category_" + std::to_string(i));
+    indexes.push_back(i * 3);
+  }
+
+  std::vector<std::string> input;
+  std::vector<int64_t> output;
+  for (int64_t i = 0; i < num_inputs; ++i) {
+    const int64_t category = (i * 31) % (num_categories + 100);
+    input.push_back("category_" + std::to_string(category));
+    output.push_back(category < num_categories ? category * 3 : 99);
+  }
+
+  OpTester test("CategoryMapper", 1, onnxruntime::kMLDomain);
+
+  test.AddAttribute("cats_strings", categories);
+  test.AddAttribute("cats_int64s", indexes);
+
+  test.AddAttribute("default_string", "default");
+  test.AddAttribute<int64_t>("default_int64", 99);
+
+  test.AddInput<std::string>("X", {num_inputs}, input);
+  test.AddOutput<int64_t>("Y", {num_inputs}, output);
+
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
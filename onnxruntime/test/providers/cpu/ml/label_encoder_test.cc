@@ -189,5 +189,67 @@ TEST(LabelEncoder, Int64ToInt64Opset2) {
   test.Run();
 }
 
+// enough keys and input for the lookup table to use a perfect hash for sparse keys, a flat table for dense keys,
+// and to split the input between threads
+TEST(LabelEncoder, ManyKeysOpset2) {
+  constexpr int64_t num_keys = 1000;
+  constexpr int64_t num_inputs = 20000;
+
+  for (int64_t key_step : {int64_t{1}, int64_t{7919}}) {
+    std::vector<std::int64_t> keys;
+    std::vector<std::string> values;
+    for (int64_t i = 0; i < num_keys; ++i) {
+      keys.push_back((i - num_keys / 2) * key_step);
+      values.push_back("value_" + std::to_string(i));
+    }
+
+    std::vector<std::int64_t> input;
+    std::vector<std::string> output;
+    for (int64_t i = 0; i < num_inputs; ++i) {
+      // every other input isn't a key
+      const int64_t key_index = (i * 31) % (2 * num_keys);
+      if (key_index < num_keys) {
+        input.push_back(keys[key_index]);
+        output.push_back(values[key_index]);
+      } else {
+        input.push_back(keys.back() + key_index);
+        output.push_back("missing");
+      }
+    }
+
+    OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+    test.AddAttribute("keys_int64s", keys);
+    test.AddAttribute("values_strings", values);
+    test.AddAttribute<std::string>("default_string", "missing");
+
+    test.AddInput<std::int64_t>("X", {num_inputs}, input);
+    test.AddOutput<std::string>("Y", {num_inputs}, output);
+
+    test.Run();
+  }
+}
+
+TEST(LabelEncoder, FloatSignedZeroToInt64Opset2) {
+  std::vector<std::int64_t> dims{4};
+
+  std::vector<float> input{-0.0f, 0.0f, 2.5f, std::numeric_limits<float>::quiet_NaN()};
+  std::vector<std::int64_t> output{7, 7, 8, -1};
+
+  OpTester test("LabelEncoder", 2, onnxruntime::kMLDomain);
+
+  const std::vector<float> keys{0.0f, 2.5f};
+  const std::vector<std::int64_t> values{7, 8};
+
+  test.AddAttribute("keys_floats", keys);
+  test.AddAttribute("values_int64s", values);
+  test.AddAttribute("default_int64", (std::int64_t)-1);
+
+  test.AddInput<float>("X", dims, input);
+  test.AddOutput<std::int64_t>("Y", dims, output);
+
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
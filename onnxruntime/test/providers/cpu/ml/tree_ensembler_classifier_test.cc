@@ -167,6 +167,59 @@ TEST(MLOpTest, TreeEnsembleClassifier_N1) {
   test.Run();
 }
 
+void TreeEnsembleClassifierNaNTest(const std::vector<float>& X, const std::vector<int64_t>& results,
+                                   const std::vector<float>& scores) {
+  OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, -1, 3, -1, -1, 1, -1, 3, 4, -1, -1, -1, 1, 2, -1, 4, -1, -1, -1};
+  std::vector<int64_t> rights = {2, -1, 4, -1, -1, 2, -1, 6, 5, -1, -1, -1, 6, 3, -1, 5, -1, -1, -1};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4, 0, 1, 2, 3, 4, 5, 6, 0, 1, 2, 3, 4, 5, 6};
+  std::vector<int64_t> featureids = {2, -2, 0, -2, -2, 0, -2, 2, 1, -2, -2, -2, 0, 2, -2, 1, -2, -2, -2};
+  std::vector<float> thresholds = {-172.f, -2.f, 2.5f, -2.f, -2.f, 1.5f, -2.f, -62.5f, 213.09999084f,
+                                   -2.f, -2.f, -2.f, 27.5f, -172.f, -2.f, 8.10000038f, -2.f, -2.f, -2.f};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "BRANCH_LEQ",
+                                    "LEAF", "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF",
+                                    "BRANCH_LEQ", "BRANCH_LEQ", "LEAF", "BRANCH_LEQ", "LEAF", "LEAF", "LEAF"};
+  std::vector<int64_t> class_treeids = {0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2};
+  std::vector<int64_t> class_nodeids = {1, 3, 4, 1, 4, 5, 6, 2, 4, 5, 6};
+  std::vector<int64_t> class_classids = {2, 0, 1, 0, 2, 3, 1, 2, 0, 1, 3};
+  std::vector<float> class_weights = {1.f, 4.f, 1.f, 2.f, 1.f, 1.f, 2.f, 1.f, 1.f, 1.f, 3.f};
+  std::vector<int64_t> classes = {0, 1, 2, 3};
+
+  int64_t N = static_cast<int64_t>(results.size());
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("class_treeids", class_treeids);
+  test.AddAttribute("class_nodeids", class_nodeids);
+  test.AddAttribute("class_ids", class_classids);
+  test.AddAttribute("class_weights", class_weights);
+  test.AddAttribute("classlabels_int64s", classes);
+
+  test.AddInput<float>("X", {N, 3}, X);
+  test.AddOutput<int64_t>("Y", {N}, results);
+  test.AddOutput<float>("Z", {N, static_cast<int64_t>(classes.size())}, scores);
+  test.Run();
+}
+
+TEST(MLOpTest, TreeEnsembleClassifierNaN) {
+  // A missing value never satisfies BRANCH_LEQ and follows the false branch.
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {1.f, nan, -100.f, 2.f, nan, -100.f, nan, 1.f, -200.f, 3.f, 5.f, nan, 1.f, 0.f, 0.4f};
+  std::vector<int64_t> results = {0, 0, 3, 1, 0};
+  std::vector<float> scores{6, 1, 0, 0, 4, 1, 0, 1, 0, 0, 2, 3, 1, 3, 0, 0, 7, 0, 0, 0};
+  TreeEnsembleClassifierNaNTest(X, results, scores);
+  for (size_t i = 0; i < results.size(); ++i) {
+    TreeEnsembleClassifierNaNTest(std::vector<float>(X.begin() + 3 * i, X.begin() + 3 * (i + 1)), {results[i]},
+                                  std::vector<float>(scores.begin() + 4 * i, scores.begin() + 4 * (i + 1)));
+  }
+}
+
 TEST(MLOpTest, TreeEnsembleClassifierFailShape) {
   OpTester test("TreeEnsembleClassifier", 1, onnxruntime::kMLDomain);
 
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "gtest/gtest.h"
+#include "core/providers/cpu/cpu_execution_provider.h"
 #include "test/providers/provider_test_utils.h"
 
 namespace onnxruntime {
@@ -617,6 +618,87 @@ TEST(MLOpTest, TreeRegressorSingleTargetMax) {
   GenTreeAndRunTest1(3, "MAX", true);
 }
 
+void GenTreeAndRunTestNaN(const std::string& mode, bool missing_tracks, const std::vector<float>& results, int n_repeat = 1,
+                          bool compact_layout = false) {
+  // Two trees, the first one has 4 leaves and a depth of 2. TreeEnsemble uses the
+  // bit-vector evaluation when all nodes are BRANCH_LEQ or BRANCH_LT and no missing value is tracked,
+  // the batched evaluation by blocks of rows for the other rules, or the compact layout if requested.
+  OpTester test("TreeEnsembleRegressor", 3, onnxruntime::kMLDomain);
+
+  std::vector<int64_t> lefts = {1, 3, 5, 0, 0, 0, 0, 1, 0, 0};
+  std::vector<int64_t> rights = {2, 4, 6, 0, 0, 0, 0, 2, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0, 0, 0, 0, 0, 1, 1, 1};
+  std::vector<int64_t> nodeids = {0, 1, 2, 3, 4, 5, 6, 0, 1, 2};
+  std::vector<int64_t> featureids = {0, 1, 1, 0, 0, 0, 0, 1, 0, 0};
+  std::vector<float> thresholds = {1, 2, 0, 0, 0, 0, 0, 2, 0, 0};
+  std::vector<std::string> modes = {mode, mode, mode, "LEAF", "LEAF", "LEAF", "LEAF", mode, "LEAF", "LEAF"};
+  std::vector<int64_t> missing_tracks = {1, 1, 1, 0, 0, 0, 0, 1, 0, 0};
+
+  std::vector<int64_t> target_treeids = {0, 0, 0, 0, 1, 1};
+  std::vector<int64_t> target_nodeids = {3, 4, 5, 6, 1, 2};
+  std::vector<int64_t> target_classids = {0, 0, 0, 0, 0, 0};
+  std::vector<float> target_weights = {1, 10, 100, 1000, 10000, 100000};
+
+  float nan = std::numeric_limits<float>::quiet_NaN();
+  std::vector<float> X = {0, 0, 1, 3, 2, 0, 2, 1, nan, 2, 0, nan};
+  std::vector<float> Y = results;
+  _multiply_update_array(X, n_repeat);
+  _multiply_update_array(Y, n_repeat);
+
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  if (missing_tracks) {
+    test.AddAttribute("nodes_missing_value_tracks_true", missing_tracks);
+  }
+  if (compact_layout) {
+    // The false branch of the first tree root is the most frequent one and is stored first.
+    test.AddAttribute("nodes_hitrates", std::vector<float>{10, 1, 9, 1, 0, 2, 7, 5, 1, 4});
+  }
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("n_targets", (int64_t)1);
+
+  int64_t n_obs = static_cast<int64_t>(Y.size());
+  test.AddInput<float>("X", {n_obs, 2}, X);
+  test.AddOutput<float>("Y", {n_obs, 1}, Y);
+  if (compact_layout) {
+    CPUExecutionProviderInfo info;
+    info.tree_ensemble_compact_layout = true;
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(std::make_unique<CPUExecutionProvider>(info));
+    test.ConfigEps(std::move(execution_providers)).RunWithConfig();
+  } else {
+    test.Run();
+  }
+}
+
+TEST(MLOpTest, TreeRegressorSingleTargetNaN) {
+  GenTreeAndRunTestNaN("BRANCH_LEQ", false, {10001, 100010, 10100, 11000, 11000, 100010});
+  GenTreeAndRunTestNaN("BRANCH_LEQ", false, {10001, 100010, 10100, 11000, 11000, 100010}, 100);
+  GenTreeAndRunTestNaN("BRANCH_LT", false, {10001, 101000, 11000, 11000, 101000, 100010});
+  GenTreeAndRunTestNaN("BRANCH_LT", false, {10001, 101000, 11000, 11000, 101000, 100010}, 100);
+  GenTreeAndRunTestNaN("BRANCH_LEQ", true, {10001, 100010, 10100, 11000, 10001, 10001});
+  GenTreeAndRunTestNaN("BRANCH_LEQ", true, {10001, 100010, 10100, 11000, 10001, 10001}, 100);
+  GenTreeAndRunTestNaN("BRANCH_GTE", false, {100100, 10001, 100010, 100010, 10100, 101000});
+  GenTreeAndRunTestNaN("BRANCH_GTE", false, {100100, 10001, 100010, 100010, 10100, 101000}, 100);
+}
+
+TEST(MLOpTest, TreeRegressorSingleTargetCompactLayout) {
+  GenTreeAndRunTestNaN("BRANCH_LEQ", true, {10001, 100010, 10100, 11000, 10001, 10001}, 1, true);
+  GenTreeAndRunTestNaN("BRANCH_LEQ", true, {10001, 100010, 10100, 11000, 10001, 10001}, 100, true);
+  GenTreeAndRunTestNaN("BRANCH_GTE", false, {100100, 10001, 100010, 100010, 10100, 101000}, 1, true);
+  GenTreeAndRunTestNaN("BRANCH_GTE", false, {100100, 10001, 100010, 100010, 10100, 101000}, 100, true);
+  // Eligible to the bit-vector evaluation which takes precedence over the compact layout.
+  GenTreeAndRunTestNaN("BRANCH_LEQ", false, {10001, 100010, 10100, 11000, 11000, 100010}, 1, true);
+}
+
 void GenTreeAndRunTest1_as_tensor_precision(int opsetml) {
   OpTester test("TreeEnsembleRegressor", opsetml, onnxruntime::kMLDomain);
 
@@ -3,6 +3,7 @@
 
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "default_providers.h"
 using namespace std;
 namespace onnxruntime {
 namespace test {
@@ -646,6 +647,76 @@ TEST(ConvTest, Conv2D_group) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+// 3x3 convolution with enough channels for the Winograd algorithm of the CPU EP, which is used when the weight
+// is an initializer.
+TEST(ConvTest, Conv2D_Winograd) {
+  ConvOpAndTestAttributes attrs = {
+      "",                           // auto_pad
+      vector<int64_t>{1, 1},        // dilations
+      1,                            // group
+      vector<int64_t>{3, 3},        // kernel_shape
+      vector<int64_t>{1, 1, 1, 1},  // pads
+      vector<int64_t>{1, 1},        // strides
+      {}                            // excluded EPs
+  };
+
+  vector<int64_t> X_shape = {1, 8, 5, 6};
+  vector<float> X(8 * 5 * 6);
+  for (size_t i = 0; i < X.size(); ++i) {
+    X[i] = static_cast<float>(static_cast<int>(i % 7) - 3) * 0.5f;
+  }
+  vector<int64_t> W_shape = {8, 8, 3, 3};
+  vector<float> W(8 * 8 * 3 * 3);
+  for (size_t i = 0; i < W.size(); ++i) {
+    W[i] = static_cast<float>(static_cast<int>(i % 5) - 2) * 0.25f;
+  }
+  vector<int64_t> Y_shape = {1, 8, 5, 6};
+  auto expected_vals = {
+      -1.25f, 1.125f, -1.5f, 1.125f, 1.125f, -1.875f,
+      0.0f, -2.25f, 3.5f, -3.0f, 0.125f, 3.5f,
+      1.25f, -0.125f, -2.25f, 3.5f, -3.0f, -2.5f,
+      -0.125f, -0.625f, -0.125f, -2.25f, 3.5f, -2.375f,
+      1.5f, 0.75f, 0.0f, 1.0f, -1.5f, 1.125f,
+      0.625f, -1.5f, 1.25f, -2.125f, 0.625f, 2.25f,
+      0.0f, 2.5f, -1.75f, 1.0f, -2.375f, -0.125f,
+      -3.0f, -1.125f, 2.5f, -1.75f, 1.0f, -0.125f,
+      2.75f, -0.375f, -1.125f, 2.5f, -1.75f, 1.625f,
+      -1.875f, 0.5f, 0.125f, -0.25f, 0.25f, -0.875f,
+      1.25f, 0.25f, -1.0f, 2.125f, -1.75f, -1.125f,
+      -1.25f, 1.0f, -0.75f, -2.5f, 4.5f, -2.5f,
+      1.5f, 1.0f, 1.0f, -0.75f, -2.5f, 3.5f,
+      -1.875f, -0.75f, 1.0f, 1.0f, -0.75f, -1.875f,
+      2.25f, -1.0f, 0.25f, -0.25f, 0.125f, 1.5f,
+      -1.875f, 0.125f, 0.5f, -1.75f, 2.125f, -0.75f,
+      2.5f, -1.125f, -0.375f, 2.125f, -2.375f, 2.0f,
+      -2.75f, 2.5f, -1.125f, -0.375f, 2.125f, -2.875f,
+      1.625f, -1.75f, 2.5f, -1.125f, -0.375f, 2.75f,
+      -1.125f, 1.25f, -1.5f, 1.0f, 0.0f, -1.125f,
+      1.25f, 0.0f, 0.75f, 0.625f, -2.125f, 1.5f,
+      -1.25f, -0.125f, -0.625f, 2.375f, 0.125f, -2.875f,
+      3.0f, -2.25f, -0.125f, -0.625f, 2.375f, 2.0f,
+      -2.375f, 3.5f, -2.25f, -0.125f, -0.625f, -0.125f,
+      -0.75f, -1.5f, 1.125f, -1.5f, 1.125f, -0.625f,
+      -1.25f, 1.125f, -1.5f, 1.125f, 1.125f, -1.875f,
+      0.0f, -2.25f, 3.5f, -3.0f, 0.125f, 3.5f,
+      1.25f, -0.125f, -2.25f, 3.5f, -3.0f, -2.5f,
+      -0.125f, -0.625f, -0.125f, -2.25f, 3.5f, -2.375f,
+      1.5f, 0.75f, 0.0f, 1.0f, -1.5f, 1.125f,
+      0.625f, -1.5f, 1.25f, -2.125f, 0.625f, 2.25f,
+      0.0f, 2.5f, -1.75f, 1.0f, -2.375f, -0.125f,
+      -3.0f, -1.125f, 2.5f, -1.75f, 1.0f, -0.125f,
+      2.75f, -0.375f, -1.125f, 2.5f, -1.75f, 1.625f,
+      -1.875f, 0.5f, 0.125f, -0.25f, 0.25f, -0.875f,
+      1.25f, 0.25f, -1.0f, 2.125f, -1.75f, -1.125f,
+      -1.25f, 1.0f, -0.75f, -2.5f, 4.5f, -2.5f,
+      1.5f, 1.0f, 1.0f, -0.75f, -2.5f, 3.5f,
+      -1.875f, -0.75f, 1.0f, 1.0f, -0.75f, -1.875f,
+      2.25f, -1.0f, 0.25f, -0.25f, 0.125f, 1.5f};
+
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape);
+  TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
+}
+
 TEST(ConvTest, ConvDimWithZero) {
   ConvOpAndTestAttributes attrs = {
       "",                           // auto_pad
@@ -729,5 +800,80 @@ TEST(ConvTest, Conv_AutoPad_with_non_default_strides) {
   TestConvOp(attrs, {X, W}, {X_shape, W_shape}, expected_vals, Y_shape, true);
 }
 
+#ifndef ENABLE_TRAINING
+// Prepacking is disabled in full training build so no need to test the feature in a training build.
+TEST(ConvTest, SharedPrepackedWeights) {
+  // the filter has enough channels to be transformed for the Winograd algorithm by PrePack
+  OpTester test("Conv", 11);
+  test.AddAttribute("kernel_shape", vector<int64_t>{3, 3});
+  test.AddAttribute("pads", vector<int64_t>{0, 0, 0, 0});
+
+  vector<float> X(8 * 4 * 4, 1.0f);
+  test.AddInput<float>("X", {1, 8, 4, 4}, X);
+
+  vector<float> W(8 * 8 * 3 * 3, 1.0f);
+  test.AddInput<float>("W", {8, 8, 3, 3}, W, true);  // Trigger pre-packing
+
+  vector<float> expected_vals(8 * 2 * 2, 72.0f);
+  test.AddOutput<float>("Y", {1, 8, 2, 2}, expected_vals);
+
+  OrtValue w;
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({8, 8, 3, 3}),
+                       W.data(), OrtMemoryInfo(CPU, OrtAllocatorType::OrtDeviceAllocator), w);
+
+  SessionOptions so;
+  // Set up W as a shared initializer to be shared between sessions
+  ASSERT_EQ(so.AddInitializer("W", &w), Status::OK());
+
+  // We want all sessions running using this OpTester to be able to share pre-packed weights if applicable
+  test.EnableSharingOfPrePackedWeightsAcrossSessions();
+
+  // Pre-packing is limited just to the CPU EP for now and we will only test the CPU EP
+  // and we want to ensure that it is available in this build
+  auto cpu_ep = []() -> std::vector<std::unique_ptr<IExecutionProvider>> {
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    return execution_providers;
+  };
+
+  size_t number_of_pre_packed_weights_counter_session_1 = 0;
+  size_t number_of_shared_pre_packed_weights_counter = 0;
+
+  // Session 1
+  {
+    auto ep_vec = cpu_ep();
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr,
+             &ep_vec, {}, &number_of_pre_packed_weights_counter_session_1, &number_of_shared_pre_packed_weights_counter);
+    // Assert that no pre-packed weights have been shared thus far
+    ASSERT_EQ(number_of_shared_pre_packed_weights_counter, static_cast<size_t>(0));
+  }
+
+  auto number_of_elements_in_shared_prepacked_buffers_container =
+      test.GetNumPrePackedWeightsShared();
+  // Assert that the number of elements in the shared container
+  // is the same as the number of weights that have been pre-packed
+  ASSERT_EQ(number_of_pre_packed_weights_counter_session_1, number_of_elements_in_shared_prepacked_buffers_container);
+
+  // The filter transformed for the Winograd algorithm replaces the filter input
+  ASSERT_EQ(number_of_pre_packed_weights_counter_session_1, static_cast<size_t>(1));
+
+  // Session 2
+  {
+    size_t number_of_pre_packed_weights_counter_session_2 = 0;
+    auto ep_vec = cpu_ep();
+    test.Run(so, OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr,
+             &ep_vec, {}, &number_of_pre_packed_weights_counter_session_2, &number_of_shared_pre_packed_weights_counter);
+
+    // Assert that the same number of weights were pre-packed in both sessions
+    ASSERT_EQ(number_of_pre_packed_weights_counter_session_1, number_of_pre_packed_weights_counter_session_2);
+
+    // Assert that the number of pre-packed weights that were shared equals
+    // the number of pre-packed weights in the second session
+    ASSERT_EQ(number_of_pre_packed_weights_counter_session_2,
+              static_cast<size_t>(number_of_shared_pre_packed_weights_counter));
+  }
+}
+#endif
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -690,6 +690,30 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5_2rows) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+TEST(TfIdfVectorizerTest, Int64_TF_UniBiAndTrigrams_SharedPrefixes_Batch) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=0, Min=1, Max=3, weights empty, int64
+  // n-grams share their prefixes: 1 -> (1,2) -> (1,2,3)
+  InitTestAttr(test, "TF", 1, 3, 0,
+               {0, 3, 7},
+               {0, 1, 2, 3, 4, 5},  //6 output indexes
+               {},
+               {1, 2, 3,     //1-grams
+                1, 2, 2, 3,  //bi-grams
+                1, 2, 3},    //tri-grams
+               {});
+
+  test.AddInput<int64_t>("T", {3, 4}, {1, 2, 3, 4,
+                                       3, 2, 1, 2,
+                                       5, 5, 5, 5});
+
+  test.AddOutput<float>("Y", {3, 6}, {1.f, 1.f, 1.f, 1.f, 1.f, 1.f,
+                                      1.f, 2.f, 1.f, 1.f, 0.f, 0.f,
+                                      0.f, 0.f, 0.f, 0.f, 0.f, 0.f});  // No n-grams in the last row
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // This test runs the inference 100 times to test the improvement
 // It enables profiling while running inference multiple times.
 // So we can manually inspect the profiling output
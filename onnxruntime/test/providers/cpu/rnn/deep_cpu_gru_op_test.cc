@@ -1155,6 +1155,70 @@ TEST(GRUTest, ONNXRuntime_TestGRUOpSingleBatchMultipleHiddenThreads) {
   ctx.RunTest(X, batch_size, seq_length, sequence_length, &initial_h, expected_Y, expected_Y_h);
 }
 
+// hidden_size is larger than the blocks of hidden units the recurrence weights are packed and computed in, and not a
+// multiple of them. make sure every block gets the right rows of R, Ht-1 and the recurrence bias in both modes.
+TEST(GRUTest, HiddenSizeSpanningRecurrentBlocks) {
+  int64_t seq_length = 2;
+  int batch_size = 2;
+  int64_t input_size = 2;
+  int64_t hidden_size = 40;
+
+  std::vector<float> X_data(seq_length * batch_size * input_size);
+  for (size_t i = 0; i < X_data.size(); ++i) X_data[i] = 0.1f * (i + 1);
+
+  std::vector<float> W_data(3 * hidden_size * input_size);
+  for (size_t i = 0; i < W_data.size(); ++i) W_data[i] = 0.01f * (static_cast<int>(i % 13) - 6);
+
+  std::vector<float> R_data(3 * hidden_size * hidden_size);
+  for (size_t i = 0; i < R_data.size(); ++i) R_data[i] = 0.01f * (static_cast<int>(i % 11) - 5);
+
+  std::vector<float> B_data(6 * hidden_size);
+  for (size_t i = 0; i < B_data.size(); ++i) B_data[i] = 0.01f * (static_cast<int>(i % 7) - 3);
+
+  std::vector<int> sequence_length{2, 1};
+
+  std::vector<float> Y_h_data{
+      -0.0025496085f, 0.026861874f, 0.053737087f, 0.028216451f, -0.040915685f,
+      -0.048082687f, -0.022301748f, 0.0043217151f, 0.03272935f, 0.060559384f,
+      0.0337137f, -0.070358495f, -0.041872664f, -0.016941678f, 0.011203297f,
+      0.03942313f, 0.066260369f, -0.0039706754f, -0.063798919f, -0.037136361f,
+      -0.0096874168f, 0.017060497f, 0.044458554f, 0.072226896f, -0.033432717f,
+      -0.057332631f, -0.031034678f, -0.0036935871f, 0.024601022f, 0.050898578f,
+      0.032818738f, -0.026378557f, -0.052856414f, -0.025896575f, 0.0026874149f,
+      0.030293934f, 0.057429334f, 0.004055615f, -0.020576147f, -0.046139747f,
+      -1.5556389e-10f, 0.017452164f, 0.034287156f, 0.015882581f, -0.027299597f,
+      -0.029213974f, -0.01353721f, 0.0036416129f, 0.020969912f, 0.037673135f,
+      0.019285481f, -0.04268019f, -0.025774245f, -0.010188619f, 0.0072584075f,
+      0.024461152f, 0.041031076f, -0.002957967f, -0.039159298f, -0.022966175f,
+      -0.00660037f, 0.010850023f, 0.027925556f, 0.044360685f, -0.018658554f,
+      -0.03565894f, -0.019869405f, -0.0030359617f, 0.014416107f, 0.031362801f,
+      0.021897871f, -0.015169689f, -0.033048582f, -0.016337324f, 0.00050424984f,
+      0.01795631f, 0.034772574f, 0.005954714f, -0.011703812f, -0.030083907f};
+
+  std::vector<float> Y_h_data_linear_before_reset{
+      -0.0061748534f, 0.019042823f, 0.042067972f, 0.039351968f, -0.033713654f,
+      -0.044570856f, -0.022441587f, 0.00074293375f, 0.025278014f, 0.049090529f,
+      0.044979096f, -0.063023f, -0.038330757f, -0.017076137f, 0.0073373874f,
+      0.031809646f, 0.054810688f, 0.0070114391f, -0.05624843f, -0.033256001f,
+      -0.0097106159f, 0.013444876f, 0.037123929f, 0.060824572f, -0.022552531f,
+      -0.049908712f, -0.027337421f, -0.0038019116f, 0.020757819f, 0.043652335f,
+      0.021708466f, -0.01513867f, -0.045111231f, -0.021965746f, 0.0025431354f,
+      0.02645301f, 0.049926881f, -0.0072109462f, -0.0092290484f, -0.038639263f,
+      -0.0025759811f, 0.012295896f, 0.026566249f, 0.023362921f, -0.02248585f,
+      -0.026829388f, -0.01353721f, 0.001083392f, 0.015851434f, 0.030012159f,
+      0.026709071f, -0.037921113f, -0.023358389f, -0.010188619f, 0.004718136f,
+      0.019380812f, 0.033430499f, 0.00442949f, -0.0343036f, -0.02050038f,
+      -0.00660037f, 0.0083278848f, 0.022883687f, 0.036820956f, -0.011329921f,
+      -0.030738955f, -0.017370528f, -0.0030359617f, 0.011912279f, 0.026359728f,
+      0.014370781f, -0.0076992391f, -0.028026632f, -0.013854721f, 0.00050424984f,
+      0.015470965f, 0.029808606f, -0.0015296864f, -0.0041410148f, -0.024993984f};
+
+  RunGruTest(X_data, W_data, R_data, {}, Y_h_data, input_size, batch_size, hidden_size, seq_length,
+             &B_data, nullptr, &sequence_length, "forward", 9999.0, /* output_sequence*/ false, false);
+  RunGruTest(X_data, W_data, R_data, {}, Y_h_data_linear_before_reset, input_size, batch_size, hidden_size,
+             seq_length, &B_data, nullptr, &sequence_length, "forward", 9999.0, /* output_sequence*/ false, true);
+}
+
 TEST(GRUTest, ONNXRuntime_TestGRUPositiveActivationClipping) {
   // TODO: Unskip when fixed #41968513
   if (DefaultDmlExecutionProvider().get() != nullptr) {
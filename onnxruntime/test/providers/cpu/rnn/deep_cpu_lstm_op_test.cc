@@ -527,6 +527,70 @@ TEST(LSTMTest, LargeBatchWithClip) {
   LargeBatchWithClip(Y_h_data, 4.f);
 }
 
+// hidden_size is larger than the blocks of hidden units the recurrence weights are packed and computed in, and not a
+// multiple of them. make sure every block gets the right rows of R and Ht-1 for both packed and unpacked weights.
+TEST(LSTMTest, HiddenSizeSpanningRecurrentBlocks) {
+  int64_t seq_length = 2;
+  int64_t batch_size = 2;
+  int64_t input_size = 2;
+  int64_t hidden_size = 40;
+
+  std::vector<float> X_data(seq_length * batch_size * input_size);
+  for (size_t i = 0; i < X_data.size(); ++i) X_data[i] = 0.1f * (i + 1);
+
+  std::vector<float> W_data(4 * hidden_size * input_size);
+  for (size_t i = 0; i < W_data.size(); ++i) W_data[i] = 0.01f * (static_cast<int>(i % 13) - 6);
+
+  std::vector<float> R_data(4 * hidden_size * hidden_size);
+  for (size_t i = 0; i < R_data.size(); ++i) R_data[i] = 0.01f * (static_cast<int>(i % 11) - 5);
+
+  std::vector<int> sequence_length{2, 1};
+
+  std::vector<float> Y_h_data{
+      0.001635105f, 0.0077494537f, 0.014267098f, -0.0023981772f, -0.014339907f,
+      -0.0077365066f, -0.0014451389f, 0.00473305f, 0.010919408f, 0.017490915f,
+      -0.017307603f, -0.011265002f, -0.0045305251f, 0.0017315402f, 0.0077114649f,
+      0.014240062f, -0.0022902179f, -0.014500884f, -0.0077178916f, -0.0013818148f,
+      0.0046914083f, 0.011153408f, 0.017460591f, -0.017558692f, -0.011163458f,
+      -0.0045684818f, 0.0017089593f, 0.0078139312f, 0.014086366f, -0.0022712591f,
+      -0.014434356f, -0.0077637356f, -0.0011498778f, 0.0046659176f, 0.010915641f,
+      0.017567819f, -0.017596471f, -0.011184751f, -0.0044621687f, 0.0015613236f,
+      0.0009692244f, 0.0044231785f, 0.0079725261f, -0.0015165037f, -0.0079416625f,
+      -0.0043045186f, -0.00073615807f, 0.0026842318f, 0.0061859756f, 0.0097827243f,
+      -0.0096658192f, -0.0061919501f, -0.0025002185f, 0.0009692244f, 0.0044231785f,
+      0.0079725261f, -0.0015165037f, -0.0079416625f, -0.0043045186f, -0.00073615807f,
+      0.0026842318f, 0.0061859756f, 0.0097827243f, -0.0096658192f, -0.0061919501f,
+      -0.0025002185f, 0.0009692244f, 0.0044231785f, 0.0079725261f, -0.0015165037f,
+      -0.0079416625f, -0.0043045186f, -0.00073615807f, 0.0026842318f, 0.0061859756f,
+      0.0097827243f, -0.0096658192f, -0.0061919501f, -0.0025002185f, 0.0009692244f};
+
+  std::vector<float> Y_c_data{
+      0.0033338746f, 0.015625482f, 0.028445689f, -0.0047304986f, -0.027990618f,
+      -0.015518773f, -0.0029634132f, 0.0095951013f, 0.021896379f, 0.034708685f,
+      -0.033963995f, -0.021868876f, -0.0093416662f, 0.0035287863f, 0.015549656f,
+      0.028405545f, -0.0045166448f, -0.02830712f, -0.015482147f, -0.0028329438f,
+      0.0095136708f, 0.022364929f, 0.034643974f, -0.034460084f, -0.021661666f,
+      -0.0094204204f, 0.0034844951f, 0.015753108f, 0.028100947f, -0.0044794597f,
+      -0.028171351f, -0.015578976f, -0.0023573432f, 0.0094607237f, 0.02188993f,
+      0.03484041f, -0.034535983f, -0.021713244f, -0.009199277f, 0.0031837192f,
+      0.0019619941f, 0.008891045f, 0.015914569f, -0.0030059637f, -0.015634489f,
+      -0.0086351566f, -0.0014954956f, 0.0054145384f, 0.012391171f, 0.019460885f,
+      -0.019095309f, -0.01214766f, -0.0050973178f, 0.0019619941f, 0.008891045f,
+      0.015914569f, -0.0030059637f, -0.015634489f, -0.0086351566f, -0.0014954956f,
+      0.0054145384f, 0.012391171f, 0.019460885f, -0.019095309f, -0.01214766f,
+      -0.0050973178f, 0.0019619941f, 0.008891045f, 0.015914569f, -0.0030059637f,
+      -0.015634489f, -0.0086351566f, -0.0014954956f, 0.0054145384f, 0.012391171f,
+      0.019460885f, -0.019095309f, -0.01214766f, -0.0050973178f, 0.0019619941f};
+
+  for (bool is_initializer_W : std::initializer_list<bool>{false, true}) {
+    for (bool is_initializer_R : std::initializer_list<bool>{false, true}) {
+      RunLstmTest(X_data, W_data, is_initializer_W, R_data, is_initializer_R, {}, Y_h_data, Y_c_data,
+                  input_size, batch_size, hidden_size, seq_length,
+                  nullptr, nullptr, nullptr, nullptr, &sequence_length);
+    }
+  }
+}
+
 // ONNXRuntime tests
 class LstmOpContext2x1x2x2 {
  public:
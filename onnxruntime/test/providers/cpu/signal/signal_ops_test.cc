@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cmath>
 #include <functional>
 #include <vector>
 
@@ -98,6 +99,74 @@ TEST(SignalOpsTest, DFTFloat_inverse) {
   test.Run();
 }
 
+// Compares against a direct evaluation of the DFT for lengths that are not a power of 2.
+// Lengths with factors 2, 3 and 5 use the mixed-radix kernels, any other length uses Bluestein's algorithm.
+static void TestDFTMatchesNaive(int64_t length, bool complex, bool onesided, bool inverse) {
+  OpTester test("DFT", kMinOpsetVersion);
+
+  RandomValueGenerator random(GetTestRandomSeed());
+  vector<int64_t> shape = {2, length, complex ? 2 : 1};
+  vector<float> input = random.Uniform<float>(shape, -1.f, 1.f);
+
+  const int64_t output_length = onesided ? (length >> 1) + 1 : length;
+  vector<int64_t> output_shape = {2, output_length, 2};
+  vector<float> expected_output;
+  const double pi = std::acos(-1.0);
+  for (int64_t b = 0; b < shape[0]; b++) {
+    const float* x = input.data() + b * length * shape[2];
+    for (int64_t k = 0; k < output_length; k++) {
+      double real = 0, imag = 0;
+      for (int64_t j = 0; j < length; j++) {
+        const double angle = (inverse ? 2 : -2) * pi * static_cast<double>((j * k) % length) / length;
+        const double x_real = x[j * shape[2]];
+        const double x_imag = complex ? x[j * shape[2] + 1] : 0;
+        real += x_real * std::cos(angle) - x_imag * std::sin(angle);
+        imag += x_real * std::sin(angle) + x_imag * std::cos(angle);
+      }
+      if (inverse) {
+        real /= length;
+        imag /= length;
+      }
+      expected_output.push_back(static_cast<float>(real));
+      expected_output.push_back(static_cast<float>(imag));
+    }
+  }
+
+  test.AddInput<float>("input", shape, input);
+  test.AddAttribute<int64_t>("onesided", static_cast<int64_t>(onesided));
+  test.AddAttribute<int64_t>("inverse", static_cast<int64_t>(inverse));
+  test.AddOutput<float>("output", output_shape, expected_output, false, 1e-4f, 1e-4f);
+  test.Run();
+}
+
+TEST(SignalOpsTest, DFTFloat_mixed_radix) {
+  // TODO: Unskip when fixed #41968513
+  if (DefaultDmlExecutionProvider().get() != nullptr) {
+    GTEST_SKIP() << "Skipping because of the following error: MLOperatorAuthorImpl.cpp(1988): Not implemented";
+  }
+
+  for (int64_t length : {6, 12, 15, 30, 400}) {
+    TestDFTMatchesNaive(length, false, false, false);
+    TestDFTMatchesNaive(length, false, true, false);
+    TestDFTMatchesNaive(length, true, false, false);
+    TestDFTMatchesNaive(length, true, false, true);
+  }
+}
+
+TEST(SignalOpsTest, DFTFloat_bluestein) {
+  // TODO: Unskip when fixed #41968513
+  if (DefaultDmlExecutionProvider().get() != nullptr) {
+    GTEST_SKIP() << "Skipping because of the following error: MLOperatorAuthorImpl.cpp(1988): Not implemented";
+  }
+
+  for (int64_t length : {7, 14, 257, 513}) {
+    TestDFTMatchesNaive(length, false, false, false);
+    TestDFTMatchesNaive(length, false, true, false);
+    TestDFTMatchesNaive(length, true, false, false);
+    TestDFTMatchesNaive(length, true, false, true);
+  }
+}
+
 // Tests that FFT(FFT(x), inverse=true) == x
 static void TestDFTInvertible(bool complex) {
   // TODO: test dft_length
@@ -727,6 +727,28 @@ void OpTester::AddSparseCsrTensorData(std::vector<Data>& data,
   AddSparseTensorData(data, std::move(node_arg), std::move(p_tensor), check_params);
 }
 
+void OpTester::AddSparseBlockSparseTensorData(std::vector<Data>& data,
+                                              MLDataType data_type,
+                                              const char* name,
+                                              gsl::span<const int64_t> dims,
+                                              gsl::span<const int64_t> values_dims,
+                                              gsl::span<const gsl::byte> values,
+                                              gsl::span<const int64_t> indices_dims,
+                                              gsl::span<const int32_t> indices,
+                                              const CheckParams& check_params,
+                                              const std::vector<std::string>* dim_params) {
+  const auto dtype = data_type->AsPrimitiveDataType()->GetDataType();
+  ORT_ENFORCE(dims.size() == 2U, "Expecting a 2-D dense shape");
+  auto p_tensor = MakeSparseTensor(data_type, dims);
+
+  auto mutator = p_tensor->MakeBlockSparseData(TensorShape(values_dims), TensorShape(indices_dims));
+  CopyDataToTensor(values, mutator.Values());
+  CopyDataToTensor(gsl::as_bytes(indices), mutator.Indices());
+
+  NodeArg node_arg = MakeSparseNodeArg(dtype, name, dims, dim_params);
+  AddSparseTensorData(data, std::move(node_arg), std::move(p_tensor), check_params);
+}
+
 void OpTester::AddSparseCsrTensorStrings(std::vector<Data>& data,
                                          const char* name,
                                          gsl::span<const int64_t> dims,
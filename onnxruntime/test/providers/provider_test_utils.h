@@ -359,6 +359,20 @@ class OpTester {
                            CheckParams(), dim_params);
   }
 
+  template <typename T>
+  void AddSparseBlockSparseInput(const char* name, const std::vector<int64_t>& dims,
+                                 const std::vector<int64_t>& values_dims,
+                                 const std::vector<T>& values,
+                                 const std::vector<int64_t>& indices_dims,
+                                 const std::vector<int32_t>& indices,
+                                 const std::vector<std::string>* dim_params = nullptr) {
+    auto ml_type = DataTypeImpl::GetType<T>();
+    AddSparseBlockSparseTensorData(input_data_, ml_type, name, dims,
+                                   values_dims, gsl::as_bytes(gsl::make_span(values)),
+                                   indices_dims, gsl::make_span(indices),
+                                   CheckParams(), dim_params);
+  }
+
   void AddSparseCsrInput(const char* name, const std::vector<int64_t>& dims,
                          const std::vector<std::string>& values,
                          const std::vector<int64_t>& inner_indices,
@@ -1122,6 +1136,17 @@ class OpTester {
                                  gsl::span<const int64_t> outer_indices,
                                  const std::vector<std::string>* dim_params = nullptr);
 
+  void AddSparseBlockSparseTensorData(std::vector<Data>& data,
+                                      MLDataType data_type,
+                                      const char* name,
+                                      gsl::span<const int64_t> dims,
+                                      gsl::span<const int64_t> values_dims,
+                                      gsl::span<const gsl::byte> values,
+                                      gsl::span<const int64_t> indices_dims,
+                                      gsl::span<const int32_t> indices,
+                                      const CheckParams& check_params,
+                                      const std::vector<std::string>* dim_params = nullptr);
+
   void AddSparseTensorData(std::vector<Data>& data, NodeArg node_arg,
                            std::unique_ptr<SparseTensor> p_tensor,
                            const CheckParams& check_params);
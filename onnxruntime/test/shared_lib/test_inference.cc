@@ -10,6 +10,7 @@
 #include <mutex>
 #include <algorithm>
 #include <thread>
+#include <future>
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -2719,3 +2720,59 @@ TEST(CApiTest, TestMultiStreamInferenceSimpleSSD) {
   ASSERT_TRUE(output_dims == expected_output_dims);
 }
 #endif
+
+namespace {
+struct RunAsyncResult {
+  std::promise<void> done;
+  Ort::Value* outputs = nullptr;
+  size_t num_outputs = 0;
+  bool ok = false;
+};
+
+void ORT_API_CALL RunAsyncCallback(void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+  auto* result = static_cast<RunAsyncResult*>(user_data);
+  // the outputs array is the one passed to RunAsync
+  result->ok = status == nullptr && outputs == reinterpret_cast<OrtValue**>(result->outputs);
+  result->num_outputs = num_outputs;
+  result->done.set_value();
+}
+}  // namespace
+
+TEST(CApiTest, RunAsync) {
+  Ort::SessionOptions session_options;
+  session_options.SetIntraOpNumThreads(2);
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  std::vector<float> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> x_dims = {3, 2};
+  Ort::MemoryInfo info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault);
+  Ort::Value x = Ort::Value::CreateTensor<float>(info, x_values.data(), x_values.size(), x_dims.data(), x_dims.size());
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::Value y{nullptr};
+
+  RunAsyncResult result;
+  result.outputs = &y;
+  auto done = result.done.get_future();
+  session.RunAsync(Ort::RunOptions{nullptr}, input_names, &x, 1, output_names, &y, 1, RunAsyncCallback, &result);
+  done.wait();
+
+  ASSERT_TRUE(result.ok);
+  ASSERT_EQ(result.num_outputs, 1u);
+  ASSERT_TRUE(y.IsTensor());
+  ASSERT_EQ(y.GetTensorTypeAndShapeInfo().GetShape(), x_dims);
+  const float* y_values = y.GetTensorData<float>();
+  for (size_t i = 0; i < x_values.size(); ++i) {
+    ASSERT_EQ(y_values[i], x_values[i] * x_values[i]);
+  }
+
+  // a session without an intra-op thread to run on can't run asynchronously
+  Ort::SessionOptions sequential_options;
+  sequential_options.SetIntraOpNumThreads(1);
+  Ort::Session sequential_session(*ort_env, MODEL_URI, sequential_options);
+  Ort::Value z{nullptr};
+  EXPECT_THROW(sequential_session.RunAsync(Ort::RunOptions{nullptr}, input_names, &x, 1, output_names, &z, 1,
+                                           RunAsyncCallback, &result),
+               Ort::Exception);
+}
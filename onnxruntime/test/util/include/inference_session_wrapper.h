@@ -31,6 +31,10 @@ class InferenceSessionWrapper : public InferenceSession {
   const Model& GetModel() const {
     return *model_;
   }
+
+  std::shared_ptr<const CapturedRun> GetCapturedRun() const {
+    return InferenceSession::GetCapturedRun();
+  }
 };
 
 }  // namespace test
@@ -1487,7 +1487,7 @@ void RegisterTrainingOpSchemas() {
       .Input(2, "weights", "Sequence of weights to optimize.", "S_WEIGHT")
       .Input(3, "gradients", "Sequence of gradients computed in this iteration.", "S_GRAD")
       .Input(4, "momentums_1", "Sequence of exponentially averaged historical gradients.", "S_MOMENT")
-      .Input(5, "momentums_2", "Sequence of exponentially averaged historical squared gradients.", "S_MOMENT")
+      .Input(5, "momentums_2", "Sequence of exponentially averaged historical squared gradients.", "S_MOMENT_2")
       .Input(6, "update_signal",
              "This signal indicates if weight updates are skipped, applicable to gradient infinity check"
              " in mixed precision training. ",
@@ -1495,7 +1495,7 @@ void RegisterTrainingOpSchemas() {
       .Output(0, "updated_flag", "Whether gradient is applied or not.", "T2")
       .Output(1, "updated_weights", "Sequence of weights after optimize.", "S_WEIGHT", OpSchema::Optional)
       .Output(2, "updated_momentums_1", "Sequence of momentum_1 after optimize.", "S_MOMENT", OpSchema::Optional)
-      .Output(3, "updated_momentums_2", "Sequence of momentum_2 after optimize.", "S_MOMENT", OpSchema::Optional)
+      .Output(3, "updated_momentums_2", "Sequence of momentum_2 after optimize.", "S_MOMENT_2", OpSchema::Optional)
       .Attr(
           "alpha",
           "Coefficient of previously accumulated gradient in running average.",
@@ -1550,7 +1550,12 @@ void RegisterTrainingOpSchemas() {
       .TypeConstraint(
           "S_MOMENT",
           {"seq(tensor(float16))", "seq(tensor(float))", "seq(tensor(double))"},
-          "Constrain momentums' types.")
+          "Constrain momentums_1's types.")
+      .TypeConstraint(
+          "S_MOMENT_2",
+          {"seq(tensor(float16))", "seq(tensor(float))", "seq(tensor(double))"},
+          "Constrain momentums_2's types. They may differ from momentums_1's, e.g. float16 momentums_1 with "
+          "float momentums_2.")
       .TypeConstraint(
           "T_BOOL",
           {"tensor(bool)"},
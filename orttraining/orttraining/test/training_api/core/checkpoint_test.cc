@@ -1,6 +1,9 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <fstream>
+#include <iterator>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -23,8 +26,10 @@
 #include "orttraining/training_api/optimizer.h"
 #include "orttraining/training_api/checkpoint_property.h"
 #include "orttraining/training_api/checkpoint.h"
+#include "orttraining/training_api/checkpoint_flat_file.h"
 #include "orttraining/training_api/lr_scheduler.h"
 
+#include "test/framework/test_utils.h"
 #include "test/test_environment.h"
 #include "test/util/include/asserts.h"
 #include "test/util/include/temp_dir.h"
@@ -160,6 +165,192 @@ TEST(CheckpointApiTest, SaveOnnxModelAsCheckpoint_ThenLoad_CPU) {
   }
 }
 
+/**
+ * Save parameters of a CheckpointState into ORT checkpoint files, load them mapped into memory,
+ * Then update one of them and save the loaded state again, only the updated tensor is written.
+ */
+TEST(CheckpointApiTest, SaveParametersAsFlatCheckpoint_ThenLoad_CPU) {
+  /// Phase 1 - Test Preparation
+  /// Prepare the parameters and dest folder for saving checkpoint.
+  AllocatorPtr cpu_allocator = onnxruntime::test::TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  const std::unordered_map<std::string, std::pair<std::vector<int64_t>, std::vector<float>>> param_values{
+      {"fc1.weight", {{2, 3}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}}},
+      {"fc1.bias", {{3}, {-1.f, -2.f, -3.f}}},
+      {"embedding.weight", {{4}, {0.5f, 0.25f, 0.125f, 0.0625f}}},
+  };
+
+  DataTransferManager data_transfer_manager;
+  CheckpointState checkpoint_state;
+  checkpoint_state.module_checkpoint_state.train_session_data_transfer_mgr = &data_transfer_manager;
+  for (const auto& [name, shape_and_values] : param_values) {
+    OrtValue param_value;
+    onnxruntime::test::CreateMLValue<float>(cpu_allocator, shape_and_values.first, shape_and_values.second,
+                                            &param_value);
+    const bool is_trainable = name != "embedding.weight";
+    checkpoint_state.module_checkpoint_state.named_parameters.insert(
+        {name, std::make_shared<Parameter>(name, param_value, is_trainable)});
+  }
+
+  // Remove the temporary directory if it already exists.
+  auto ckpt_test_root_dir = ORT_TSTR("checkpointing_api_test_dir");
+  if (Env::Default().FolderExists(ckpt_test_root_dir)) {
+    ORT_ENFORCE(Env::Default().DeleteFolder(ckpt_test_root_dir).IsOK());
+  }
+  TemporaryDirectory tmp_dir{ckpt_test_root_dir};
+
+  /// Phase 2 - Call save checkpoint APIs.
+  /// And check the result checkpoint files.
+  PathString checkpoint_path{
+      ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("e2e_ckpt_save_cpu"))};
+  ASSERT_STATUS_OK(SaveCheckpoint(checkpoint_state, checkpoint_path));
+
+  std::set<PathString> expected_file_names{ORT_TSTR("paramfrozen_tensors.flat"), ORT_TSTR("paramtrain_tensors.flat")};
+  std::set<PathString> valid_file_names;
+  LoopDir(checkpoint_path,
+          [&valid_file_names](const PathChar* filename, OrtFileType file_type) -> bool {
+            PathString filename_str = filename;
+            if (filename_str[0] == '.' || file_type == OrtFileType::TYPE_DIR) {
+              return true;
+            }
+            valid_file_names.emplace(filename_str);
+            return true;
+          });
+  ASSERT_EQ(expected_file_names, valid_file_names);
+
+  /// Phase 3 - Run load checkpoint APIs.
+  /// Validate the parameters are restored in place in the mapped files.
+  CheckpointState checkpoint_state_to_load;
+  ASSERT_STATUS_OK(LoadCheckpoint(checkpoint_path, checkpoint_state_to_load));
+  auto& restored_params = checkpoint_state_to_load.module_checkpoint_state.named_parameters;
+  ASSERT_EQ(restored_params.size(), param_values.size());
+  for (const auto& [name, shape_and_values] : param_values) {
+    auto it = restored_params.find(name);
+    ASSERT_TRUE(it != restored_params.end());
+    ASSERT_EQ(it->second->RequiresGrad(), name != "embedding.weight");
+
+    const Tensor& restored_tensor = it->second->Data().Get<Tensor>();
+    ASSERT_EQ(restored_tensor.Shape(), TensorShape(shape_and_values.first));
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(restored_tensor.DataRaw()) % 64, 0u);
+
+    std::vector<float> restored_values;
+    OrtValueToVec(it->second->Data(), restored_values);
+    ASSERT_EQ(restored_values, shape_and_values.second);
+  }
+
+  /// Phase 4 - Update a parameter and save the loaded state into the same directory.
+  /// The file mapped by the loaded state is replaced, the later saves only write the updated tensors.
+  float* bias_data = restored_params["fc1.bias"]->Data().GetMutable<Tensor>()->MutableData<float>();
+  bias_data[1] = 42.f;
+
+  NameMLValMap trainable_params;
+  for (const auto& [name, param] : restored_params) {
+    if (param->RequiresGrad()) {
+      trainable_params.insert({name, param->Data()});
+    }
+  }
+
+  const PathString trainable_file_path =
+      ConcatPathComponent<PathChar>(checkpoint_path, ORT_TSTR("paramtrain_tensors.flat"));
+  size_t num_written_tensors = 0;
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(trainable_file_path, trainable_params, data_transfer_manager,
+                                         num_written_tensors));
+  ASSERT_EQ(num_written_tensors, 2u);
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(trainable_file_path, trainable_params, data_transfer_manager,
+                                         num_written_tensors));
+  ASSERT_EQ(num_written_tensors, 0u);
+  bias_data[2] = 43.f;
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(trainable_file_path, trainable_params, data_transfer_manager,
+                                         num_written_tensors));
+  ASSERT_EQ(num_written_tensors, 1u);
+
+  /// Phase 5 - Load the checkpoint again and save the first state into the same directory.
+  /// The file mapped by the second state is replaced instead of being updated in place.
+  CheckpointState checkpoint_state_to_reload;
+  ASSERT_STATUS_OK(LoadCheckpoint(checkpoint_path, checkpoint_state_to_reload));
+  auto& reloaded_params = checkpoint_state_to_reload.module_checkpoint_state.named_parameters;
+  const OrtValue& reloaded_bias = reloaded_params["fc1.bias"]->Data();
+  std::vector<float> restored_values;
+  OrtValueToVec(reloaded_bias, restored_values);
+  ASSERT_EQ(restored_values, (std::vector<float>{-1.f, 42.f, 43.f}));
+
+  bias_data[0] = 44.f;
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(trainable_file_path, trainable_params, data_transfer_manager,
+                                         num_written_tensors));
+  ASSERT_EQ(num_written_tensors, 2u);
+  OrtValueToVec(reloaded_bias, restored_values);
+  ASSERT_EQ(restored_values, (std::vector<float>{-1.f, 42.f, 43.f}));
+  OrtValueToVec(restored_params["fc1.weight"]->Data(), restored_values);
+  ASSERT_EQ(restored_values, param_values.at("fc1.weight").second);
+}
+
+/**
+ * Load a flat checkpoint file with an invalid element type.
+ */
+TEST(CheckpointApiTest, LoadFlatCheckpointWithInvalidElementType) {
+  AllocatorPtr cpu_allocator = onnxruntime::test::TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  OrtValue value;
+  onnxruntime::test::CreateMLValue<float>(cpu_allocator, {2}, {1.f, 2.f}, &value);
+
+  auto ckpt_test_root_dir = ORT_TSTR("checkpointing_api_test_dir");
+  if (Env::Default().FolderExists(ckpt_test_root_dir)) {
+    ORT_ENFORCE(Env::Default().DeleteFolder(ckpt_test_root_dir).IsOK());
+  }
+  TemporaryDirectory tmp_dir{ckpt_test_root_dir};
+  const PathString file_path = ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("a_tensors.flat"));
+  DataTransferManager data_transfer_manager;
+  size_t num_written_tensors = 0;
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(file_path, {{"a", value}}, data_transfer_manager, num_written_tensors));
+
+  // The element type follows the 40 bytes of the header, the name length and the name of the tensor.
+  {
+    std::fstream file(file_path, std::ios::in | std::ios::out | std::ios::binary);
+    const int32_t element_type = 1000;
+    file.seekp(40 + sizeof(uint64_t) + 1);
+    file.write(reinterpret_cast<const char*>(&element_type), sizeof(element_type));
+    ASSERT_TRUE(file.flush());
+  }
+
+  std::unordered_map<std::string, OrtValue> name_to_ort_value;
+  Status status = LoadTensorsFromFlatFile(file_path, name_to_ort_value);
+  ASSERT_FALSE(status.IsOK());
+  ASSERT_NE(status.ErrorMessage().find("Invalid element type 1000"), std::string::npos);
+}
+
+/**
+ * Load a flat checkpoint file, which doesn't write it, then save into it.
+ * The first save replaces the loaded file, the following saves update it in place.
+ */
+TEST(CheckpointApiTest, LoadFlatCheckpointDoesNotWriteFile) {
+  AllocatorPtr cpu_allocator = onnxruntime::test::TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  OrtValue value;
+  onnxruntime::test::CreateMLValue<float>(cpu_allocator, {2}, {1.f, 2.f}, &value);
+
+  auto ckpt_test_root_dir = ORT_TSTR("checkpointing_api_test_dir");
+  if (Env::Default().FolderExists(ckpt_test_root_dir)) {
+    ORT_ENFORCE(Env::Default().DeleteFolder(ckpt_test_root_dir).IsOK());
+  }
+  TemporaryDirectory tmp_dir{ckpt_test_root_dir};
+  const PathString file_path = ConcatPathComponent<PathChar>(tmp_dir.Path(), ORT_TSTR("a_tensors.flat"));
+  DataTransferManager data_transfer_manager;
+  size_t num_written_tensors = 0;
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(file_path, {{"a", value}}, data_transfer_manager, num_written_tensors));
+
+  auto read_file = [&file_path]() {
+    std::ifstream file(file_path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  };
+  const std::string saved_file = read_file();
+
+  std::unordered_map<std::string, OrtValue> name_to_ort_value;
+  ASSERT_STATUS_OK(LoadTensorsFromFlatFile(file_path, name_to_ort_value));
+  ASSERT_EQ(read_file(), saved_file);
+
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(file_path, {{"a", value}}, data_transfer_manager, num_written_tensors));
+  ASSERT_EQ(num_written_tensors, 1u);
+  ASSERT_STATUS_OK(SaveTensorsToFlatFile(file_path, {{"a", value}}, data_transfer_manager, num_written_tensors));
+  ASSERT_EQ(num_written_tensors, 0u);
+}
+
 /**
  * Load ONNX model with parameters set to 0 from file path, Load Checkpoint weights into the Model,
  * Then compare the new weights to 0 to make sure they were changed after loading checkpoint to model.
@@ -266,8 +457,8 @@ TEST(CheckpointApiTest, SaveOptimizerStateAsCheckpoint_ThenLoad_CUDA) {
 
   // Check the ckpt files in the directory.
   std::set<PathString> expected_file_names{
-      ORT_TSTR("optim_group0_momentum0_tensors.pbseq"),
-      ORT_TSTR("optim_group0_momentum1_tensors.pbseq"),
+      ORT_TSTR("optim_group0_momentum0_tensors.flat"),
+      ORT_TSTR("optim_group0_momentum1_tensors.flat"),
       ORT_TSTR("optim_group0_properties.pbseq"),
   };
 
@@ -275,8 +466,9 @@ TEST(CheckpointApiTest, SaveOptimizerStateAsCheckpoint_ThenLoad_CUDA) {
   LoopDir(checkpoint_path,
           [&valid_file_names, &checkpoint_path](const PathChar* filename, OrtFileType file_type) -> bool {
             PathString filename_str = filename;
-            bool is_valid_ckpt_file_exts =
-                HasExtensionOf(filename_str, ORT_TSTR("pbseq")) || HasExtensionOf(filename_str, ORT_TSTR("bin"));
+            bool is_valid_ckpt_file_exts = HasExtensionOf(filename_str, ORT_TSTR("pbseq")) ||
+                                           HasExtensionOf(filename_str, ORT_TSTR("flat")) ||
+                                           HasExtensionOf(filename_str, ORT_TSTR("bin"));
             if (filename_str[0] == '.' || file_type == OrtFileType::TYPE_DIR || !is_valid_ckpt_file_exts) {
               return true;
             }
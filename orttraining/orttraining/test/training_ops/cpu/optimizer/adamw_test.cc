@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "core/framework/TensorSeq.h"
+#include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
+
+namespace onnxruntime {
+namespace test {
+namespace optimizer {
+namespace {
+
+constexpr float kLr = 1e-03f;
+constexpr float kAlpha = 0.9f;
+constexpr float kBeta = 0.999f;
+constexpr float kEpsilon = 1e-8f;
+constexpr float kWeightDecay = 1e-2f;
+
+// Reference AdamW update of one element, with the momentums in float.
+void AdamWReferenceUpdate(int64_t adam_mode, int64_t step, float g, float& w, float& m1, float& m2) {
+  const float alpha_correction = 1.f - static_cast<float>(std::pow(kAlpha, step));
+  const float beta_correction = 1.f - static_cast<float>(std::pow(kBeta, step));
+  const float lr_corrected = kLr * std::sqrt(beta_correction) / alpha_correction;
+
+  m1 = kAlpha * m1 + (1.f - kAlpha) * g;
+  m2 = kBeta * m2 + (1.f - kBeta) * g * g;
+  if (adam_mode == 0) {
+    w -= w * kLr * kWeightDecay;
+    w -= (kLr * m1) / (alpha_correction * (std::sqrt(m2 / beta_correction) + kEpsilon));
+  } else {
+    w -= lr_corrected * m1 / (std::sqrt(m2) + kEpsilon);
+    w -= kLr * kWeightDecay * w;
+  }
+}
+
+void AddAdamWAttributes(OpTester& test, int64_t adam_mode) {
+  test.AddAttribute("alpha", kAlpha);
+  test.AddAttribute("beta", kBeta);
+  test.AddAttribute("epsilon", kEpsilon);
+  test.AddAttribute("weight_decay", kWeightDecay);
+  test.AddAttribute("adam_mode", adam_mode);
+  test.AddAttribute("correct_bias", static_cast<int64_t>(1));
+}
+
+std::vector<MLFloat16> ToFloat16(const std::vector<float>& values) {
+  std::vector<MLFloat16> fp16_values;
+  fp16_values.reserve(values.size());
+  for (float value : values) {
+    fp16_values.push_back(MLFloat16(value));
+  }
+  return fp16_values;
+}
+
+void AdamWFloat16Momentum1Test(int64_t adam_mode) {
+  const int64_t step = 3;
+
+  const std::vector<VectorInt64> shapes{{2, 3}, {3}, {3, 2}};
+  const std::vector<std::vector<float>> weights{{-0.1f, 0.2f, 0.3f, -0.4f, 0.5f, 0.6f},
+                                                {0.7f, -0.8f, 0.9f},
+                                                {1.0f, 1.1f, -1.2f, 1.3f, 1.4f, -1.5f}};
+  const std::vector<std::vector<float>> gradients{{0.5f, -0.4f, 0.3f, 0.2f, -0.1f, 0.05f},
+                                                  {-0.6f, 0.7f, 0.8f},
+                                                  {0.01f, -0.02f, 0.03f, 0.04f, -0.05f, 0.06f}};
+
+  SeqTensors<float> weight_seq, gradient_seq, momentum_2_seq;
+  SeqTensors<float> updated_weight_seq, updated_momentum_2_seq;
+  SeqTensors<MLFloat16> momentum_1_seq, updated_momentum_1_seq;
+  for (size_t t = 0; t < shapes.size(); ++t) {
+    std::vector<MLFloat16> m1;
+    std::vector<float> m2, updated_w, updated_m1, updated_m2;
+    for (size_t i = 0; i < weights[t].size(); ++i) {
+      const float g = gradients[t][i];
+      const MLFloat16 m1_half(0.1f * g);
+      m1.push_back(m1_half);
+      m2.push_back(0.01f * g * g);
+
+      // The kernel updates momentums_1 from its float16 value.
+      float w = weights[t][i];
+      float new_m1 = m1_half.ToFloat();
+      float new_m2 = m2.back();
+      AdamWReferenceUpdate(adam_mode, step, g, w, new_m1, new_m2);
+      updated_w.push_back(w);
+      updated_m1.push_back(new_m1);
+      updated_m2.push_back(new_m2);
+    }
+
+    weight_seq.AddTensor(shapes[t], weights[t]);
+    gradient_seq.AddTensor(shapes[t], gradients[t]);
+    momentum_1_seq.AddTensor(shapes[t], m1);
+    momentum_2_seq.AddTensor(shapes[t], m2);
+    updated_weight_seq.AddTensor(shapes[t], updated_w);
+    updated_momentum_1_seq.AddTensor(shapes[t], ToFloat16(updated_m1));
+    updated_momentum_2_seq.AddTensor(shapes[t], updated_m2);
+  }
+
+  OpTester test("AdamWOptimizer", 1, onnxruntime::kMSDomain);
+  AddAdamWAttributes(test, adam_mode);
+
+  test.AddInput<float>("lr", {}, {kLr});
+  test.AddInput<int64_t>("step", {}, {step});
+  test.AddSeqInput("weights", weight_seq);
+  test.AddSeqInput("gradients", gradient_seq);
+  test.AddSeqInput("momentums_1", momentum_1_seq);
+  test.AddSeqInput("momentums_2", momentum_2_seq);
+
+  test.AddOutput<int64_t>("updated_flag", {}, {1});
+  test.AddSeqOutput("updated_weights", updated_weight_seq, 1e-4f, 1e-5f);
+  test.AddSeqOutput("updated_momentums_1", updated_momentum_1_seq, 1e-3f, 1e-6f);
+  test.AddSeqOutput("updated_momentums_2", updated_momentum_2_seq, 1e-3f, 1e-7f);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(AdamWTest, TorchAdamWFloat16Momentum1Test) {
+  AdamWFloat16Momentum1Test(0);
+}
+
+TEST(AdamWTest, HFAdamWFloat16Momentum1Test) {
+  AdamWFloat16Momentum1Test(1);
+}
+
+// Runs several steps with gradients around 1e-4, whose (1 - beta) * g * g is below the float16 range, feeding the
+// updated weight and momentums of each step to the next one. The results are compared against a reference that
+// keeps both momentums in float.
+void AdamWFloat16Momentum1SmallGradientsTest(int64_t adam_mode) {
+  const int64_t total_steps = 5;
+  const VectorInt64 shape{2, 3};
+  const std::vector<float> initial_weights{-0.1f, 0.2f, 0.3f, -0.4f, 0.5f, 0.6f};
+  const std::vector<float> base_gradients{1e-4f, -2e-4f, 3e-4f, -1.5e-4f, 2.5e-4f, 4e-4f};
+
+  std::vector<float> weights = initial_weights;
+  std::vector<MLFloat16> momentums_1(initial_weights.size(), MLFloat16(0.f));
+  std::vector<float> momentums_2(initial_weights.size(), 0.f);
+
+  std::vector<float> reference_weights = initial_weights;
+  std::vector<float> reference_momentums_1(initial_weights.size(), 0.f);
+  std::vector<float> reference_momentums_2(initial_weights.size(), 0.f);
+
+  for (int64_t step = 1; step <= total_steps; ++step) {
+    std::vector<float> gradients;
+    for (size_t i = 0; i < base_gradients.size(); ++i) {
+      gradients.push_back(base_gradients[i] * (step % 2 == 0 ? -0.5f : 1.f));
+      AdamWReferenceUpdate(adam_mode, step, gradients[i], reference_weights[i], reference_momentums_1[i],
+                           reference_momentums_2[i]);
+    }
+
+    SeqTensors<float> weight_seq, gradient_seq, momentum_2_seq, updated_weight_seq, updated_momentum_2_seq;
+    SeqTensors<MLFloat16> momentum_1_seq, updated_momentum_1_seq;
+    weight_seq.AddTensor(shape, weights);
+    gradient_seq.AddTensor(shape, gradients);
+    momentum_1_seq.AddTensor(shape, momentums_1);
+    momentum_2_seq.AddTensor(shape, momentums_2);
+    updated_weight_seq.AddTensor(shape, reference_weights);
+    updated_momentum_1_seq.AddTensor(shape, ToFloat16(reference_momentums_1));
+    updated_momentum_2_seq.AddTensor(shape, reference_momentums_2);
+
+    OpTester test("AdamWOptimizer", 1, onnxruntime::kMSDomain);
+    AddAdamWAttributes(test, adam_mode);
+
+    test.AddInput<float>("lr", {}, {kLr});
+    test.AddInput<int64_t>("step", {}, {step});
+    test.AddSeqInput("weights", weight_seq);
+    test.AddSeqInput("gradients", gradient_seq);
+    test.AddSeqInput("momentums_1", momentum_1_seq);
+    test.AddSeqInput("momentums_2", momentum_2_seq);
+
+    // The rounding of momentums_1 to float16 accumulates over the steps.
+    test.AddOutput<int64_t>("updated_flag", {}, {1});
+    test.AddSeqOutput("updated_weights", updated_weight_seq, 1e-4f, 1e-5f);
+    test.AddSeqOutput("updated_momentums_1", updated_momentum_1_seq, 1e-2f, 1e-7f);
+    test.AddSeqOutput("updated_momentums_2", updated_momentum_2_seq, 1e-2f, 1e-12f);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.emplace_back(DefaultCpuExecutionProvider());
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+
+    // Continue from the state computed by the kernel.
+    const auto& fetches = test.GetFetches();
+    ASSERT_EQ(fetches.size(), 4U);
+    const Tensor& updated_weights = fetches[1].Get<TensorSeq>().Get(0);
+    const Tensor& updated_momentums_1 = fetches[2].Get<TensorSeq>().Get(0);
+    const Tensor& updated_momentums_2 = fetches[3].Get<TensorSeq>().Get(0);
+    weights.assign(updated_weights.Data<float>(), updated_weights.Data<float>() + weights.size());
+    momentums_1.assign(updated_momentums_1.Data<MLFloat16>(),
+                       updated_momentums_1.Data<MLFloat16>() + momentums_1.size());
+    momentums_2.assign(updated_momentums_2.Data<float>(), updated_momentums_2.Data<float>() + momentums_2.size());
+  }
+}
+
+TEST(AdamWTest, TorchAdamWFloat16Momentum1SmallGradientsTest) {
+  AdamWFloat16Momentum1SmallGradientsTest(0);
+}
+
+TEST(AdamWTest, HFAdamWFloat16Momentum1SmallGradientsTest) {
+  AdamWFloat16Momentum1SmallGradientsTest(1);
+}
+
+TEST(AdamWTest, Float16Momentum2NotSupported) {
+  const VectorInt64 shape{3};
+  SeqTensors<float> weight_seq, gradient_seq;
+  SeqTensors<MLFloat16> momentum_seq;
+  weight_seq.AddTensor(shape, {0.1f, 0.2f, 0.3f});
+  gradient_seq.AddTensor(shape, {1e-4f, 2e-4f, 3e-4f});
+  momentum_seq.AddTensor(shape, ToFloat16({0.f, 0.f, 0.f}));
+
+  OpTester test("AdamWOptimizer", 1, onnxruntime::kMSDomain);
+  AddAdamWAttributes(test, 0);
+
+  test.AddInput<float>("lr", {}, {kLr});
+  test.AddInput<int64_t>("step", {}, {1});
+  test.AddSeqInput("weights", weight_seq);
+  test.AddSeqInput("gradients", gradient_seq);
+  test.AddSeqInput("momentums_1", momentum_seq);
+  test.AddSeqInput("momentums_2", momentum_seq);
+
+  test.AddOutput<int64_t>("updated_flag", {}, {1});
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.emplace_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectFailure, "momentums_2 must be float tensors.", {}, nullptr,
+           &execution_providers);
+}
+
+}  // namespace
+}  // namespace optimizer
+}  // namespace test
+}  // namespace onnxruntime
@@ -1,6 +1,8 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <filesystem>
+
 #include "core/common/inlined_containers.h"
 #include "core/common/logging/logging.h"
 #include "core/common/logging/sinks/clog_sink.h"
@@ -15,6 +17,7 @@
 #include "orttraining/core/framework/checkpoint_common.h"
 #include "orttraining/core/framework/protobuf_message_sequence.h"
 #include "orttraining/training_api/checkpoint.h"
+#include "orttraining/training_api/checkpoint_flat_file.h"
 #include "orttraining/training_api/utils.h"
 
 namespace onnxruntime {
@@ -24,6 +27,7 @@ namespace api {
 namespace {
 
 const PathString k_tensor_proto_file_name = ORT_TSTR("tensors.pbseq");
+const PathString k_flat_tensor_file_name = ORT_TSTR("tensors.flat");
 const PathString k_tensor_proto_properties_file_name = ORT_TSTR("properties.pbseq");
 const PathString k_trainable_param_root_prefix = ORT_TSTR("paramtrain");
 const PathString k_non_trainable_param_root_prefix = ORT_TSTR("paramfrozen");
@@ -34,54 +38,18 @@ const PathString k_name_separator = ORT_TSTR("_");
 const char builtin_lr_property_name[] = "builtin.initial_learning_rate";
 const char builtin_step_property_name[] = "builtin.step";
 
-/**
- * @brief Create TensorProtos From OrtValue objects
- *
- * @param name_to_ort_value name to OrtValue mapping.
- * @param data_transfer_manager data transfer manager to copy the tensor in OrtValue.
- * @param saved_tensor_protos saved results.
- * @return Status
- */
-Status CreateTensorProtosFromOrtValues(
-    const NameMLValMap& name_to_ort_value,
-    const DataTransferManager& data_transfer_manager,
-    std::vector<ONNX_NAMESPACE::TensorProto>& saved_tensor_protos) {
-  // Order the tensors by name.
-  InlinedVector<std::string> ordered_tensor_names{};
-  ordered_tensor_names.reserve(name_to_ort_value.size());
-  std::transform(name_to_ort_value.begin(), name_to_ort_value.end(), std::back_inserter(ordered_tensor_names),
-                 [](const NameMLValMap::value_type& v) { return v.first; });
-  std::sort(ordered_tensor_names.begin(), ordered_tensor_names.end());
-
-  saved_tensor_protos.reserve(ordered_tensor_names.size());
-
-  uint64_t total_bytes = 0;
-  constexpr uint64_t PROTOBUF_UPPER_LIMIT = 2 * 1000 * 1000 * 1000;
-  for (const auto& tensor_name : ordered_tensor_names) {
-    const OrtValue& ort_value = name_to_ort_value.at(tensor_name);
-    ORT_RETURN_IF_NOT(ort_value.IsTensor(), "ort_value.IsTensor() was false");
-    const Tensor& src_tensor = ort_value.Get<Tensor>();
-
-    // Currently large model size not considered, so exception thrown here
-    // when protobuf upper limit hit.
-    total_bytes += static_cast<uint64_t>(src_tensor.SizeInBytes());
-    if (total_bytes >= PROTOBUF_UPPER_LIMIT) {
-      ORT_THROW("checkpoint file size hit upper limit.");
-    }
-
-    saved_tensor_protos.emplace_back(utils::CopyTensorToTensorProto(
-        src_tensor, tensor_name, data_transfer_manager));
-  }
-
-  return Status::OK();
-}
-
 PathString GetTensorProtoFilePath(const PathString& checkpoint_directory, const PathString& filename_prefix) {
   std::basic_ostringstream<PathChar> oss;
   oss << filename_prefix << k_name_separator << k_tensor_proto_file_name;
   return ConcatPathComponent<PathChar>(checkpoint_directory, oss.str());
 }
 
+PathString GetFlatTensorFilePath(const PathString& checkpoint_directory, const PathString& filename_prefix) {
+  std::basic_ostringstream<PathChar> oss;
+  oss << filename_prefix << k_name_separator << k_flat_tensor_file_name;
+  return ConcatPathComponent<PathChar>(checkpoint_directory, oss.str());
+}
+
 PathString GetTensorProtoPropertiesFilePath(
     const PathString& checkpoint_directory, const PathString& filename_prefix) {
   std::basic_ostringstream<PathChar> oss;
@@ -119,6 +87,13 @@ bool StringEndsWith(PathString const& s, PathString const& p) {
   return std::equal(p.rbegin(), p.rend(), s.rbegin());
 }
 
+// Remove a file of an older checkpoint in the directory.
+void RemoveStaleFile(const PathString& file_path, const std::string& caller_context) {
+  std::error_code error;
+  std::filesystem::remove(file_path, error);
+  ORT_ENFORCE(!error, caller_context, " delete file failed: ", ToUTF8String(file_path), " ", error.message());
+}
+
 void WriteTensorProtoToFile(const PathString& file_path,
                             const std::vector<ONNX_NAMESPACE::TensorProto>& tensor_protos,
                             std::string caller_context) {
@@ -147,6 +122,38 @@ void LoadTensorProtoFromFile(const PathString& file_path,
   ORT_ENFORCE(file_read_status.IsOK(), caller_context, " load file failed: ", ToUTF8String(file_path));
 }
 
+void WriteTensorsToFlatFile(const PathString& checkpoint_directory, const PathString& filename_prefix,
+                            const NameMLValMap& name_to_ort_value,
+                            const DataTransferManager& data_transfer_manager,
+                            std::string caller_context) {
+  const PathString file_path = GetFlatTensorFilePath(checkpoint_directory, filename_prefix);
+  size_t num_written_tensors = 0;
+  auto file_write_status = SaveTensorsToFlatFile(file_path, name_to_ort_value, data_transfer_manager,
+                                                 num_written_tensors);
+  ORT_ENFORCE(file_write_status.IsOK(), caller_context, " write file failed: ", ToUTF8String(file_path), " ",
+              file_write_status.ErrorMessage());
+  LOGS_DEFAULT(VERBOSE) << caller_context << " wrote " << num_written_tensors << " of " << name_to_ort_value.size()
+                        << " tensors to " << ToUTF8String(file_path);
+
+  // Remove the protobuf file of the same tensors left by an older checkpoint in the directory.
+  RemoveStaleFile(GetTensorProtoFilePath(checkpoint_directory, filename_prefix), caller_context);
+}
+
+void LoadTensorsFromFile(const PathString& file_path,
+                         std::unordered_map<std::string, OrtValue>& name_to_ort_values,
+                         std::string caller_context) {
+  if (StringEndsWith(file_path, k_flat_tensor_file_name)) {
+    auto file_read_status = LoadTensorsFromFlatFile(file_path, name_to_ort_values);
+    ORT_ENFORCE(file_read_status.IsOK(), caller_context, " load file failed: ", ToUTF8String(file_path), " ",
+                file_read_status.ErrorMessage());
+    return;
+  }
+
+  std::vector<ONNX_NAMESPACE::TensorProto> tensor_protos{};
+  LoadTensorProtoFromFile(file_path, tensor_protos, caller_context);
+  ORT_THROW_IF_ERROR(CreateOrtValuesFromTensorProtos(tensor_protos, name_to_ort_values));
+}
+
 template <typename Func>
 void FilterFilesFromDirectory(const PathString& folder_path, Func func) {
   LoopDir(folder_path, [&func](const PathChar* filename, OrtFileType file_type) -> bool {
@@ -193,12 +200,15 @@ Status OrtSaveInternal(
     WriteTensorProtoToFile(
         GetTensorProtoFilePath(checkpoint_path, k_trainable_param_root_prefix),
         trainable_tensor_protos, "[trainable_param]");
+    RemoveStaleFile(GetFlatTensorFilePath(checkpoint_path, k_trainable_param_root_prefix), "[trainable_param]");
   }
 
   if (non_trainable_tensor_protos.size() > 0) {
     WriteTensorProtoToFile(
         GetTensorProtoFilePath(checkpoint_path, k_non_trainable_param_root_prefix),
         non_trainable_tensor_protos, "[non_trainable_param]");
+    RemoveStaleFile(GetFlatTensorFilePath(checkpoint_path, k_non_trainable_param_root_prefix),
+                    "[non_trainable_param]");
   }
 
   return Status::OK();
@@ -224,16 +234,8 @@ Status OrtSaveModuleStatesInternal(ModuleCheckpointState& module_state,
 
     // Parameters saving.
     for (auto& pair : parameter_ort_values) {
-      std::vector<ONNX_NAMESPACE::TensorProto> param_tensor_protos;
-      ORT_RETURN_IF_ERROR(CreateTensorProtosFromOrtValues(
-          pair.second,
-          *module_state.train_session_data_transfer_mgr,
-          param_tensor_protos));
-
-      // Save TensorProto to file.
-      WriteTensorProtoToFile(
-          GetTensorProtoFilePath(parameter_folder_path, pair.first),
-          param_tensor_protos, "[param]");
+      WriteTensorsToFlatFile(parameter_folder_path, pair.first, pair.second,
+                             *module_state.train_session_data_transfer_mgr, "[param]");
     }
   }
 
@@ -278,16 +280,8 @@ Status OrtSaveOptimizerStatesInternal(OptimizerCheckpointState& optimizer_state,
       const PathString& cur_state_filename_prefix =
           StringConcat(cur_group_filename_prefix, momentum_name);
 
-      std::vector<ONNX_NAMESPACE::TensorProto> saved_tensor_protos;
-      ORT_RETURN_IF_ERROR(CreateTensorProtosFromOrtValues(
-          param_name_to_ortvalue,
-          *optimizer_state.optimizer_session_data_transfer_mgr,
-          saved_tensor_protos));
-
-      // Save TensorProto to file.
-      WriteTensorProtoToFile(
-          GetTensorProtoFilePath(checkpoint_path, cur_state_filename_prefix),
-          saved_tensor_protos, "[optimizer_state]");
+      WriteTensorsToFlatFile(checkpoint_path, cur_state_filename_prefix, param_name_to_ortvalue,
+                             *optimizer_state.optimizer_session_data_transfer_mgr, "[optimizer_state]");
     }
 
     // Storing group-wise properties.
@@ -357,12 +351,8 @@ Status OrtLoadModuleStatesInternal(
   auto& named_parameters = module_state.named_parameters;
   auto load_model_proto_into_module =
       [&named_parameters](const PathString module_state_file_path, bool is_trainable) -> Status {
-    std::vector<ONNX_NAMESPACE::TensorProto> param_tensor_protos{};
-
-    LoadTensorProtoFromFile(module_state_file_path, param_tensor_protos, "[params]");
-
     std::unordered_map<std::string, OrtValue> name_to_ort_values;
-    ORT_RETURN_IF_ERROR(CreateOrtValuesFromTensorProtos(param_tensor_protos, name_to_ort_values));
+    LoadTensorsFromFile(module_state_file_path, name_to_ort_values, "[params]");
     for (auto it = name_to_ort_values.begin(); it != name_to_ort_values.end(); ++it) {
       auto param = std::make_shared<Parameter>(it->first, it->second, is_trainable);
       named_parameters.insert({it->first, param});
@@ -388,7 +378,8 @@ Status OrtLoadOptimizerStatesInternal(const PathString& optimizer_folder_path,
       [&optim_state_filenames, &optim_property_filenames](const PathChar* filename) -> bool {
         PathString filename_str = filename;
         if (StringStartsWith(filename_str, k_optimizer_root_prefix)) {
-          if (StringEndsWith(filename_str, k_tensor_proto_file_name)) {
+          if (StringEndsWith(filename_str, k_tensor_proto_file_name) ||
+              StringEndsWith(filename_str, k_flat_tensor_file_name)) {
             optim_state_filenames.push_back(filename_str);
           } else if (StringEndsWith(filename_str, k_tensor_proto_properties_file_name)) {
             optim_property_filenames.push_back(filename_str);
@@ -412,7 +403,8 @@ Status OrtLoadOptimizerStatesInternal(const PathString& optimizer_folder_path,
         StringConcat(k_optimizer_root_prefix, results[1]);
     PathString cur_momentum_state_filename_prefix =
         StringConcat(cur_group_filename_prefix, results[2]);
-    ORT_ENFORCE(filename.compare(StringConcat(cur_momentum_state_filename_prefix, k_tensor_proto_file_name)) == 0);
+    ORT_ENFORCE(filename.compare(StringConcat(cur_momentum_state_filename_prefix, k_tensor_proto_file_name)) == 0 ||
+                filename.compare(StringConcat(cur_momentum_state_filename_prefix, k_flat_tensor_file_name)) == 0);
 
     if (grouped_optimizer_states.find(group_name) == grouped_optimizer_states.end()) {
       grouped_optimizer_states.insert({group_name, std::make_shared<GroupOptimizerState>()});
@@ -422,13 +414,9 @@ Status OrtLoadOptimizerStatesInternal(const PathString& optimizer_folder_path,
     std::unordered_map<std::string, ParameterOptimizerState>&
         param_optimizer_states = group_optimizer_state->param_named_optimizer_states;
 
-    const PathString& tensor_file_path = GetTensorProtoFilePath(optimizer_folder_path,
-                                                                cur_momentum_state_filename_prefix);
-    std::vector<ONNX_NAMESPACE::TensorProto> param_optimizer_state_tensor_protos{};
-    LoadTensorProtoFromFile(tensor_file_path, param_optimizer_state_tensor_protos, "[optimizer_state]");
-
+    const PathString tensor_file_path = ConcatPathComponent<PathChar>(optimizer_folder_path, filename);
     std::unordered_map<std::string, OrtValue> name_to_ort_values;
-    ORT_RETURN_IF_ERROR(CreateOrtValuesFromTensorProtos(param_optimizer_state_tensor_protos, name_to_ort_values));
+    LoadTensorsFromFile(tensor_file_path, name_to_ort_values, "[optimizer_state]");
     for (auto& pair : name_to_ort_values) {
       auto& param_name = pair.first;
       if (param_optimizer_states.find(param_name) == param_optimizer_states.end()) {
@@ -513,7 +501,8 @@ Status OrtLoadInternal(const PathString& checkpoint_path,
       checkpoint_path,
       [&tensor_proto_filenames](const PathChar* filename) -> bool {
         PathString filename_str = filename;
-        if (StringEndsWith(filename_str, k_tensor_proto_file_name)) {
+        if (StringEndsWith(filename_str, k_tensor_proto_file_name) ||
+            StringEndsWith(filename_str, k_flat_tensor_file_name)) {
           tensor_proto_filenames.push_back(filename_str);
         }
         return true;
@@ -523,7 +512,15 @@ Status OrtLoadInternal(const PathString& checkpoint_path,
   for (const auto& tensor_file_path : tensor_proto_filenames) {
     std::vector<ONNX_NAMESPACE::TensorProto> tensor_protos{};
     const auto tensor_file_full_path = ConcatPathComponent<PathChar>(checkpoint_path, tensor_file_path);
-    LoadTensorProtoFromFile(tensor_file_full_path, tensor_protos, "[params]");
+    if (StringEndsWith(tensor_file_path, k_flat_tensor_file_name)) {
+      std::unordered_map<std::string, OrtValue> name_to_ort_values;
+      LoadTensorsFromFile(tensor_file_full_path, name_to_ort_values, "[params]");
+      for (const auto& [name, ort_value] : name_to_ort_values) {
+        tensor_protos.push_back(onnxruntime::utils::TensorToTensorProto(ort_value.Get<Tensor>(), name));
+      }
+    } else {
+      LoadTensorProtoFromFile(tensor_file_full_path, tensor_protos, "[params]");
+    }
 
     for (auto& tensor_proto : tensor_protos) {
       auto tensor_proto_name = tensor_proto.name();
@@ -27,13 +27,21 @@
  *
  * 2. A directory of files:
  *    checkpoint/
- *       paramtrain_tensors.pbseq - trainable parameter tensor protobuf messages
- *       paramfrozen_tensors.pbseq - non_trainable parameter tensor protobuf messages
- *       optim_group0_momentum0_tensors.pbseq - optimizer momentum state tensor protobuf messages
- *       optim_group0_momentum1_tensors.pbseq - optimizer momentum state tensor protobuf messages
+ *       paramtrain_tensors.flat - trainable parameter tensors
+ *       paramfrozen_tensors.flat - non_trainable parameter tensors
+ *       optim_group0_momentum0_tensors.flat - optimizer momentum state tensors
+ *       optim_group0_momentum1_tensors.flat - optimizer momentum state tensors
  *       optim_group0_properties.pbseq - group-wise optimizer property tensor protobuf messages
  *       custom_properties.pbseq - custom property protobuf messages
  *
+ *    The tensor files are flat files (see checkpoint_flat_file.h) that LoadCheckpoint maps into memory instead of
+ *    copying their data, without writing them. SaveCheckpoint only writes the tensors that changed when the
+ *    directory holds a checkpoint of the same tensors that this process saved and didn't load since. Otherwise it
+ *    writes new files and replaces the old ones, so the checkpoint states loaded from them are unaffected. Another
+ *    process shouldn't load a directory that this process keeps saving into: the tensors it maps may be rewritten.
+ *    The parameters saved from TensorProtos, e.g. by the offline tooling, are written as *_tensors.pbseq protobuf
+ *    messages, which are loaded by copying.
+ *
  *    LoadCheckpoint takes CheckpointState as outputs, loading from a directory of checkpoint.
  *    SaveCheckpoint takes CheckpointState as inputs, saving checkpoint files into a directory.
  */
@@ -0,0 +1,494 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "orttraining/training_api/checkpoint_flat_file.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+#include "core/common/inlined_containers.h"
+#include "core/common/logging/logging.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/graph/onnx_protobuf.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+namespace training {
+namespace api {
+
+namespace {
+
+constexpr char kMagic[8] = {'O', 'R', 'T', 'C', 'K', 'P', 'T', '\0'};
+constexpr uint32_t kFileFormatVersion = 1;
+
+// The mapping is page aligned, keep the tensors aligned for the SIMD loads of the kernels
+constexpr size_t kTensorAlignment = 64;
+
+struct FlatFileHeader {
+  char magic[sizeof(kMagic)];
+  uint32_t file_format_version;
+  uint32_t reserved;
+  // Replaced by every full write of the file, see OwnerTokens
+  uint64_t owner_token;
+  uint64_t tensor_count;
+  uint64_t index_length;
+};
+
+/**
+ * The owner tokens of the files written and of the files mapped by this process.
+ *
+ * Loads don't write the file, they record the token of the file they map. A file holding a token that this process
+ * owns and hasn't mapped isn't mapped by any checkpoint state of this process, so its tensors can be rewritten in
+ * place. Otherwise the first save writes the file aside under a new owned token, claiming it for the in place
+ * writes of the following saves. The mutex keeps the loads and the in place writes of this process apart. Another
+ * process mapping the file isn't detected.
+ */
+struct OwnerTokens {
+  std::mutex mutex;
+  std::mt19937_64 generator;
+  std::unordered_set<uint64_t> owned;
+  std::unordered_set<uint64_t> mapped;
+
+  static OwnerTokens& Instance() {
+    static OwnerTokens owner_tokens;
+    return owner_tokens;
+  }
+
+  // Requires the lock of mutex.
+  uint64_t Create() {
+    uint64_t token = 0;
+    while (token == 0 || owned.count(token) != 0 || mapped.count(token) != 0) {
+      token = generator();
+    }
+    return token;
+  }
+
+ private:
+  OwnerTokens() {
+    std::random_device device;
+    std::seed_seq seed{device(), device(), device(), device()};
+    generator.seed(seed);
+  }
+};
+
+bool ReadOwnerToken(const PathString& file_path, uint64_t& owner_token) {
+  std::ifstream file(file_path, std::ios::binary);
+  FlatFileHeader header;
+  if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+      memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    return false;
+  }
+
+  owner_token = header.owner_token;
+  return true;
+}
+
+struct IndexEntry {
+  const std::string* name;
+  const Tensor* tensor;
+  uint64_t offset;
+};
+
+size_t AlignTensorOffset(size_t offset) {
+  return (offset + kTensorAlignment - 1) / kTensorAlignment * kTensorAlignment;
+}
+
+template <typename T>
+void AppendValue(std::string& buffer, T value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Serialize the header and index of the file holding the tensors of entries.
+ *
+ * @param entries tensors sorted by name, their offsets in the file are set.
+ * @param file_length length of the file.
+ * @return the header and index, the owner token is 0.
+ */
+std::string CreateHeaderAndIndex(gsl::span<IndexEntry> entries, size_t& file_length) {
+  size_t index_length = 0;
+  for (const auto& entry : entries) {
+    index_length += sizeof(uint64_t) + entry.name->size() + sizeof(int32_t) + sizeof(uint32_t) +
+                    entry.tensor->Shape().NumDimensions() * sizeof(int64_t) + 2 * sizeof(uint64_t);
+  }
+
+  size_t offset = AlignTensorOffset(sizeof(FlatFileHeader) + index_length);
+  for (auto& entry : entries) {
+    entry.offset = offset;
+    offset = AlignTensorOffset(offset + entry.tensor->SizeInBytes());
+  }
+  file_length = entries.empty() ? sizeof(FlatFileHeader) + index_length
+                                : static_cast<size_t>(entries.back().offset) + entries.back().tensor->SizeInBytes();
+
+  FlatFileHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.file_format_version = kFileFormatVersion;
+  header.tensor_count = entries.size();
+  header.index_length = index_length;
+
+  std::string header_and_index;
+  header_and_index.reserve(sizeof(header) + index_length);
+  header_and_index.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& entry : entries) {
+    const auto dims = entry.tensor->Shape().GetDims();
+    AppendValue<uint64_t>(header_and_index, entry.name->size());
+    header_and_index.append(*entry.name);
+    AppendValue<int32_t>(header_and_index, entry.tensor->GetElementType());
+    AppendValue<uint32_t>(header_and_index, static_cast<uint32_t>(dims.size()));
+    for (int64_t dim : dims) {
+      AppendValue<int64_t>(header_and_index, dim);
+    }
+    AppendValue<uint64_t>(header_and_index, entry.offset);
+    AppendValue<uint64_t>(header_and_index, entry.tensor->SizeInBytes());
+  }
+
+  return header_and_index;
+}
+
+void SetOwnerToken(std::string& header_and_index, uint64_t owner_token) {
+  memcpy(header_and_index.data() + offsetof(FlatFileHeader, owner_token), &owner_token, sizeof(owner_token));
+}
+
+/**
+ * @brief Get the data of a tensor on CPU.
+ *
+ * @param tensor tensor placed on any device.
+ * @param data_transfer_manager data transfer manager to copy the tensor if it is not on CPU.
+ * @param cpu_buffer buffer holding the copy of the tensor if it is not on CPU.
+ * @return the data of the tensor.
+ */
+const void* GetCpuTensorData(const Tensor& tensor, const DataTransferManager& data_transfer_manager,
+                             std::vector<char>& cpu_buffer) {
+  const auto& tensor_location = tensor.Location();
+  if (tensor_location.device.Type() == OrtDevice::CPU ||
+      tensor_location.mem_type == OrtMemTypeCPUInput ||
+      tensor_location.mem_type == OrtMemTypeCPUOutput) {
+    return tensor.DataRaw();
+  }
+
+  ORT_ENFORCE(tensor_location.device.Type() == OrtDevice::GPU, "Unsupported device type for saving tensors");
+
+  static const OrtMemoryInfo cpu_alloc_info{onnxruntime::CPU, OrtDeviceAllocator};
+  cpu_buffer.resize(tensor.SizeInBytes());
+  Tensor cpu_tensor{tensor.DataType(), tensor.Shape(), cpu_buffer.data(), cpu_alloc_info};
+  ORT_THROW_IF_ERROR(data_transfer_manager.CopyTensor(tensor, cpu_tensor));
+  return cpu_buffer.data();
+}
+
+/**
+ * @brief Get a hidden file next to file_path, the loaders of the checkpoint directory skip it.
+ *
+ * @param file_path checkpoint file.
+ * @param owner_token token making the name unique.
+ * @param extension extension of the hidden file.
+ * @return path of the hidden file.
+ */
+PathString GetHiddenSiblingPath(const PathString& file_path, uint64_t owner_token, const PathString& extension) {
+  std::ostringstream token;
+  token << std::hex << std::setw(16) << std::setfill('0') << owner_token;
+  const std::filesystem::path path{file_path};
+  return (path.parent_path() /
+          (ORT_TSTR(".") + path.filename().native() + ORT_TSTR(".") + ToPathString(token.str()) + extension))
+      .native();
+}
+
+// Remove the files moved aside by ReplaceFile() that are no longer mapped.
+void RemoveReplacedFiles(const PathString& file_path) {
+  const std::filesystem::path path{file_path};
+  const PathString prefix = ORT_TSTR(".") + path.filename().native() + ORT_TSTR(".");
+  const PathString suffix = ORT_TSTR(".old");
+
+  std::error_code error;
+  std::filesystem::directory_iterator it{path.parent_path().empty() ? std::filesystem::path{ORT_TSTR(".")}
+                                                                     : path.parent_path(),
+                                         error};
+  for (; !error && it != std::filesystem::directory_iterator{}; it.increment(error)) {
+    const PathString name = it->path().filename().native();
+    if (name.size() > prefix.size() + suffix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+      std::error_code remove_error;
+      std::filesystem::remove(it->path(), remove_error);
+    }
+  }
+}
+
+/**
+ * @brief Replace file_path with temp_file_path.
+ *
+ * Windows doesn't replace a file that is still mapped, e.g. by a checkpoint state loaded from it, but it renames
+ * it. The file is then moved aside under a hidden name and removed by a later save once it isn't mapped.
+ */
+Status ReplaceFile(const PathString& temp_file_path, const PathString& file_path, uint64_t owner_token) {
+  std::error_code error;
+  std::filesystem::rename(temp_file_path, file_path, error);
+  if (error) {
+    const PathString replaced_file_path = GetHiddenSiblingPath(file_path, owner_token, ORT_TSTR(".old"));
+    std::error_code aside_error;
+    std::filesystem::rename(file_path, replaced_file_path, aside_error);
+    if (!aside_error) {
+      std::error_code replace_error;
+      std::filesystem::rename(temp_file_path, file_path, replace_error);
+      if (replace_error) {
+        std::filesystem::rename(replaced_file_path, file_path, aside_error);
+      } else {
+        error.clear();
+        std::filesystem::remove(replaced_file_path, aside_error);
+      }
+    }
+  }
+
+  if (error) {
+    const std::string message = error.message();
+    std::filesystem::remove(temp_file_path, error);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to replace checkpoint file ", ToUTF8String(file_path), ": ",
+                           message);
+  }
+
+  return Status::OK();
+}
+
+// The element type of tensors that can be stored in the file, nullptr for anything else.
+MLDataType ElementTypeFromONNXEnum(int32_t element_type) {
+  switch (element_type) {
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT:
+    case ONNX_NAMESPACE::TensorProto_DataType_BOOL:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_DOUBLE:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT8:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_INT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT32:
+    case ONNX_NAMESPACE::TensorProto_DataType_UINT64:
+    case ONNX_NAMESPACE::TensorProto_DataType_FLOAT16:
+    case ONNX_NAMESPACE::TensorProto_DataType_BFLOAT16:
+      return DataTypeImpl::TensorTypeFromONNXEnum(element_type)->GetElementType();
+    default:
+      return nullptr;
+  }
+}
+
+}  // namespace
+
+Status SaveTensorsToFlatFile(const PathString& file_path,
+                             const NameMLValMap& name_to_ort_value,
+                             const DataTransferManager& data_transfer_manager,
+                             size_t& num_written_tensors) {
+  num_written_tensors = 0;
+
+  // Order the tensors by name.
+  InlinedVector<IndexEntry> entries;
+  entries.reserve(name_to_ort_value.size());
+  for (const auto& [name, ort_value] : name_to_ort_value) {
+    ORT_RETURN_IF_NOT(ort_value.IsTensor(), "ort_value.IsTensor() was false");
+    const Tensor& tensor = ort_value.Get<Tensor>();
+    ORT_RETURN_IF(tensor.IsDataTypeString(), "String tensors can't be saved into checkpoint: ", name);
+    entries.push_back({&name, &tensor, 0});
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const IndexEntry& lhs, const IndexEntry& rhs) { return *lhs.name < *rhs.name; });
+
+  size_t file_length = 0;
+  std::string header_and_index = CreateHeaderAndIndex(entries, file_length);
+
+  std::vector<char> cpu_buffer;
+  const auto& env = Env::Default();
+  auto& owner_tokens = OwnerTokens::Instance();
+
+  // When the file holds the same tensors and nothing maps it, e.g. it was written by the previous save of this
+  // process, only the tensors that changed since are written.
+  uint64_t existing_owner_token = 0;
+  size_t existing_file_length = 0;
+  if (ReadOwnerToken(file_path, existing_owner_token) &&
+      env.GetFileLength(file_path.c_str(), existing_file_length).IsOK() && existing_file_length == file_length) {
+    std::lock_guard<std::mutex> lock(owner_tokens.mutex);
+    SetOwnerToken(header_and_index, existing_owner_token);
+
+    Env::MappedMemoryPtr existing_file;
+    if (owner_tokens.owned.count(existing_owner_token) != 0 && owner_tokens.mapped.count(existing_owner_token) == 0 &&
+        env.MapFileIntoMemory(file_path.c_str(), 0, file_length, existing_file).IsOK() &&
+        memcmp(existing_file.get(), header_and_index.data(), header_and_index.size()) == 0) {
+      std::fstream file(file_path, std::ios::in | std::ios::out | std::ios::binary);
+      ORT_RETURN_IF_NOT(file, "Failed to open checkpoint file: ", ToUTF8String(file_path));
+
+      for (const auto& entry : entries) {
+        const size_t size = entry.tensor->SizeInBytes();
+        const void* data = GetCpuTensorData(*entry.tensor, data_transfer_manager, cpu_buffer);
+        if (size != 0 && memcmp(existing_file.get() + entry.offset, data, size) != 0) {
+          file.seekp(static_cast<std::streamoff>(entry.offset));
+          file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+          ++num_written_tensors;
+        }
+      }
+
+      ORT_RETURN_IF_NOT(file.flush(), "Failed to write checkpoint file: ", ToUTF8String(file_path));
+      return Status::OK();
+    }
+  }
+
+  // Otherwise write the file aside under a new owner token and replace it, a checkpoint state loaded from it keeps
+  // the mapping of the old one.
+  uint64_t owner_token = 0;
+  {
+    std::lock_guard<std::mutex> lock(owner_tokens.mutex);
+    owner_token = owner_tokens.Create();
+  }
+  SetOwnerToken(header_and_index, owner_token);
+
+  RemoveReplacedFiles(file_path);
+  const PathString temp_file_path = GetHiddenSiblingPath(file_path, owner_token, ORT_TSTR(".tmp"));
+  {
+    std::ofstream file(temp_file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file, "Failed to open checkpoint file: ", ToUTF8String(temp_file_path));
+
+    auto write = [&file](const void* data, size_t length) {
+      file.write(static_cast<const char*>(data), static_cast<std::streamsize>(length));
+    };
+
+    write(header_and_index.data(), header_and_index.size());
+
+    static const char padding[kTensorAlignment] = {};
+    size_t offset = header_and_index.size();
+    for (const auto& entry : entries) {
+      write(padding, static_cast<size_t>(entry.offset) - offset);
+      const size_t size = entry.tensor->SizeInBytes();
+      if (size != 0) {
+        write(GetCpuTensorData(*entry.tensor, data_transfer_manager, cpu_buffer), size);
+      }
+      offset = static_cast<size_t>(entry.offset) + size;
+    }
+
+    if (!file.flush()) {
+      file.close();
+      std::error_code error;
+      std::filesystem::remove(temp_file_path, error);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write checkpoint file: ", ToUTF8String(temp_file_path));
+    }
+  }
+
+  ORT_RETURN_IF_ERROR(ReplaceFile(temp_file_path, file_path, owner_token));
+
+  {
+    std::lock_guard<std::mutex> lock(owner_tokens.mutex);
+    owner_tokens.owned.erase(existing_owner_token);
+    owner_tokens.owned.insert(owner_token);
+  }
+
+  num_written_tensors = entries.size();
+  return Status::OK();
+}
+
+Status LoadTensorsFromFlatFile(const PathString& file_path,
+                               std::unordered_map<std::string, OrtValue>& name_to_ort_value) {
+  const auto& env = Env::Default();
+  size_t file_length = 0;
+  ORT_RETURN_IF_ERROR(env.GetFileLength(file_path.c_str(), file_length));
+  ORT_RETURN_IF_NOT(file_length >= sizeof(FlatFileHeader), "Invalid checkpoint file: ", ToUTF8String(file_path));
+
+  // The tensors share the ownership of the file data, the mapping of the file or a copy of it when the file can't
+  // be mapped. The token of a mapped file is recorded, under the lock so that no save of this process rewrites it in
+  // place from then on.
+  std::shared_ptr<void> file_data;
+  char* base = nullptr;
+  {
+    auto& owner_tokens = OwnerTokens::Instance();
+    std::lock_guard<std::mutex> lock(owner_tokens.mutex);
+    Env::MappedMemoryPtr mapped_memory;
+    if (env.MapFileIntoMemoryCopyOnWrite(file_path.c_str(), 0, file_length, mapped_memory).IsOK()) {
+      FlatFileHeader header;
+      memcpy(&header, mapped_memory.get(), sizeof(header));
+      owner_tokens.mapped.insert(header.owner_token);
+
+      auto mapped_file = std::make_shared<Env::MappedMemoryPtr>(std::move(mapped_memory));
+      base = mapped_file->get();
+      file_data = std::move(mapped_file);
+    }
+  }
+
+  if (base == nullptr) {
+    std::shared_ptr<char> buffer{static_cast<char*>(::operator new(file_length, std::align_val_t{kTensorAlignment})),
+                                 [](char* p) { ::operator delete(p, std::align_val_t{kTensorAlignment}); }};
+    ORT_RETURN_IF_ERROR(env.ReadFileIntoBuffer(file_path.c_str(), 0, file_length,
+                                               gsl::make_span(buffer.get(), file_length)));
+    base = buffer.get();
+    file_data = std::move(buffer);
+  }
+
+  size_t offset = 0;
+
+  auto read = [&](void* dst, size_t length) {
+    if (file_length - offset < length) {
+      return false;
+    }
+    memcpy(dst, base + offset, length);
+    offset += length;
+    return true;
+  };
+
+  FlatFileHeader header;
+  ORT_RETURN_IF_NOT(read(&header, sizeof(header)) && memcmp(header.magic, kMagic, sizeof(kMagic)) == 0,
+                    "Invalid checkpoint file: ", ToUTF8String(file_path));
+  ORT_RETURN_IF_NOT(header.file_format_version == kFileFormatVersion,
+                    "Unsupported version ", header.file_format_version, " of checkpoint file: ",
+                    ToUTF8String(file_path));
+
+  static const OrtMemoryInfo cpu_alloc_info{onnxruntime::CPU, OrtDeviceAllocator};
+  const auto ml_tensor_type = DataTypeImpl::GetType<Tensor>();
+  for (uint64_t i = 0; i < header.tensor_count; i++) {
+    uint64_t name_length = 0;
+    ORT_RETURN_IF_NOT(read(&name_length, sizeof(name_length)) && name_length <= file_length - offset,
+                      "Invalid index in checkpoint file: ", ToUTF8String(file_path));
+    std::string name(base + offset, static_cast<size_t>(name_length));
+    offset += static_cast<size_t>(name_length);
+
+    int32_t element_type = 0;
+    uint32_t rank = 0;
+    ORT_RETURN_IF_NOT(read(&element_type, sizeof(element_type)) && read(&rank, sizeof(rank)) &&
+                          rank <= (file_length - offset) / sizeof(int64_t),
+                      "Invalid index in checkpoint file: ", ToUTF8String(file_path));
+    TensorShapeVector dims(rank);
+    uint64_t tensor_offset = 0;
+    uint64_t tensor_size = 0;
+    ORT_RETURN_IF_NOT(read(dims.data(), rank * sizeof(int64_t)) && read(&tensor_offset, sizeof(tensor_offset)) &&
+                          read(&tensor_size, sizeof(tensor_size)) && tensor_offset % kTensorAlignment == 0 &&
+                          tensor_offset <= file_length && tensor_size <= file_length - tensor_offset,
+                      "Invalid index in checkpoint file: ", ToUTF8String(file_path));
+
+    const auto element_data_type = ElementTypeFromONNXEnum(element_type);
+    ORT_RETURN_IF(element_data_type == nullptr, "Invalid element type ", element_type, " of tensor ", name,
+                  " in checkpoint file: ", ToUTF8String(file_path));
+    const TensorShape shape(dims);
+    ORT_RETURN_IF_NOT(shape.Size() >= 0 &&
+                          static_cast<uint64_t>(shape.Size()) * element_data_type->Size() == tensor_size,
+                      "Invalid size of tensor ", name, " in checkpoint file: ", ToUTF8String(file_path));
+
+    void* data = tensor_size != 0 ? base + tensor_offset : nullptr;
+    auto tensor = std::make_unique<Tensor>(element_data_type, shape, data, cpu_alloc_info);
+
+    OrtValue ort_value;
+    ort_value.Init(tensor.release(), ml_tensor_type,
+                   [file_data](void* p) { delete static_cast<Tensor*>(p); });
+    ORT_RETURN_IF_NOT(name_to_ort_value.emplace(name, std::move(ort_value)).second,
+                      "Duplicated tensor ", name, " in checkpoint file: ", ToUTF8String(file_path));
+  }
+
+  return Status::OK();
+}
+
+}  // namespace api
+}  // namespace training
+}  // namespace onnxruntime
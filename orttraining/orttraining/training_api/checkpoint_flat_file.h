@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "core/common/common.h"
+#include "core/common/path_string.h"
+#include "core/framework/data_transfer_manager.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ort_value.h"
+
+/**
+ * A flat file of named tensors that is mapped into memory when loaded, used by the checkpoint files of
+ * parameters and optimizer states:
+ *
+ *   FlatFileHeader, with the owner token replaced by every full write of the file
+ *   index, for each tensor sorted by name:
+ *       uint64_t name_length, char name[name_length], int32_t element_type (TensorProto_DataType),
+ *       uint32_t rank, int64_t dims[rank], uint64_t offset, uint64_t size
+ *   tensor data, each starting at an offset aligned to 64 bytes
+ *
+ * Numbers are stored in the byte order of the machine writing the file.
+ */
+
+namespace onnxruntime {
+namespace training {
+namespace api {
+
+/**
+ * @brief Save tensors into a flat checkpoint file.
+ *
+ * If file_path holds the same names, types and shapes and wasn't loaded since this process wrote it, only the
+ * tensors whose data changed are written into it in place. Otherwise the file is written aside and replaces
+ * file_path, so a checkpoint state loaded from it keeps its mapping, and the following saves update it in place.
+ *
+ * @param file_path file to write.
+ * @param name_to_ort_value tensors to save, they can be placed on any device.
+ * @param data_transfer_manager data transfer manager to copy the tensors that are not on CPU.
+ * @param num_written_tensors number of tensors written into the file.
+ * @return Status
+ */
+Status SaveTensorsToFlatFile(const PathString& file_path,
+                             const NameMLValMap& name_to_ort_value,
+                             const DataTransferManager& data_transfer_manager,
+                             size_t& num_written_tensors);
+
+/**
+ * @brief Load tensors from a flat checkpoint file without copying their data.
+ *
+ * The file is mapped copy-on-write: the tensors are CPU tensors pointing into the mapping, which lives as long as
+ * any of them. Updating them doesn't change the file, which isn't written by the load either. The saves of this
+ * process replace the file instead of updating it under the mapping, a save from another process isn't detected.
+ * The file is copied into memory when it can't be mapped.
+ *
+ * @param file_path file to load.
+ * @param name_to_ort_value loaded tensors.
+ * @return Status
+ */
+Status LoadTensorsFromFlatFile(const PathString& file_path,
+                               std::unordered_map<std::string, OrtValue>& name_to_ort_value);
+
+}  // namespace api
+}  // namespace training
+}  // namespace onnxruntime
@@ -2,13 +2,19 @@
 // Licensed under the MIT License.
 
 #include "orttraining/training_ops/cpu/optimizer/adamw/adamw.h"
+
+#include <algorithm>
+#include <cmath>
+
 #include "orttraining/training_ops/cpu/optimizer/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/TensorSeq.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/common.h"
 #include "core/providers/cpu/math/element_wise_ops.h"
 #include "core/providers/cpu/tensor/utils.h"
+#include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -32,6 +38,15 @@ Status AdamWOptimizerBase::PrepareForCompute(OpKernelContext* ctx, AdamWOptimize
   ORT_RETURN_IF_NOT(num_of_gradients == num_of_momentums_1, "Number of gradients and momentums_1 mismatch.");
   ORT_RETURN_IF_NOT(num_of_momentums_1 == num_of_momentums_2, "Number of momentums_1 and momentums_2 mismatch.");
 
+  // momentums_1 can be stored in float16 to cut the optimizer state, it is updated in float. momentums_2 is kept in
+  // float: (1 - beta) * g * g underflows float16 for small gradients, which would blow up the update.
+  const MLDataType momentum_1_type = prepare.momentums_1->DataType();
+  ORT_RETURN_IF_NOT(momentum_1_type == DataTypeImpl::GetType<float>() ||
+                        momentum_1_type == DataTypeImpl::GetType<MLFloat16>(),
+                    "momentums_1 must be float or float16 tensors.");
+  ORT_RETURN_IF_NOT(prepare.momentums_2->DataType() == DataTypeImpl::GetType<float>(),
+                    "momentums_2 must be float tensors.");
+
   prepare.grouped_tensor_sizes.resize(prepare.num_of_weights);
   prepare.grouped_tensor_pointers.resize(prepare.num_of_weights);
 
@@ -60,8 +75,8 @@ Status AdamWOptimizerBase::PrepareForCompute(OpKernelContext* ctx, AdamWOptimize
           prepare.grouped_tensor_pointers[i] = {
               const_cast<float*>(weight_tensor.Data<float>()),
               const_cast<float*>(gradient_tensor.Data<float>()),
-              const_cast<float*>(momentum_1_tensor.Data<float>()),
-              const_cast<float*>(momentum_2_tensor.Data<float>())};
+              const_cast<void*>(momentum_1_tensor.DataRaw()),
+              const_cast<void*>(momentum_2_tensor.DataRaw())};
         }
       });
 
@@ -86,50 +101,144 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T2", DataTypeImpl::GetTensorType<int64_t>())
         .TypeConstraint("S_WEIGHT", DataTypeImpl::AllFixedSizeSequenceTensorTypes())
         .TypeConstraint("S_GRAD", DataTypeImpl::AllFixedSizeSequenceTensorTypes())
-        .TypeConstraint("S_MOMENT", DataTypeImpl::AllFixedSizeSequenceTensorTypes()),
+        .TypeConstraint("S_MOMENT", DataTypeImpl::AllFixedSizeSequenceTensorTypes())
+        .TypeConstraint("S_MOMENT_2", DataTypeImpl::AllFixedSizeSequenceTensorTypes()),
     AdamWOptimizer<float>);
 
+namespace {
+
+// The elements of a weight are updated by chunks small enough for the weight, gradient, momentums and the float
+// buffer of momentums_1 to stay in L1 cache while each step of the update is evaluated over the chunk.
+constexpr std::ptrdiff_t kAdamWChunkSize = 1024;
+
+// Returns momentums_1 of a chunk as float. Float momentums are updated in place, float16 ones are widened into the
+// buffer.
+inline float* LoadMomentums(float* momentums, float* /*buffer*/, std::ptrdiff_t /*count*/) { return momentums; }
+
+inline float* LoadMomentums(MLFloat16* momentums, float* buffer, std::ptrdiff_t count) {
+#if defined(_M_AMD64) && !defined(_M_ARM64EC)
+  MlasConvertHalfToFloatBuffer(&momentums[0].val, buffer, static_cast<size_t>(count));
+#else
+  EigenVectorArrayMap<float>(buffer, count) =
+      ConstEigenVectorArrayMap<Eigen::half>(reinterpret_cast<const Eigen::half*>(momentums), count).cast<float>();
+#endif
+  return buffer;
+}
+
+// Stores the updated momentums_1 of a chunk back, if they were widened by LoadMomentums.
+inline void StoreMomentums(const float* /*buffer*/, float* /*momentums*/, std::ptrdiff_t /*count*/) {}
+
+inline void StoreMomentums(const float* buffer, MLFloat16* momentums, std::ptrdiff_t count) {
+  EigenVectorArrayMap<Eigen::half>(reinterpret_cast<Eigen::half*>(momentums), count) =
+      ConstEigenVectorArrayMap<float>(buffer, count).cast<Eigen::half>();
+}
+
+}  // namespace
+
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float alpha_correction, float beta_correction) const {
-  // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (MakeEigenArrayMap<T>(weight) * lr * weight_decay_);
+template <typename TMomentum>
+void AdamWOptimizer<T>::AdamWComputeMode0(T* weight, const T* gradient, TMomentum* momentums_1, float* momentums_2,
+                                          std::ptrdiff_t count, float lr, float alpha_correction,
+                                          float beta_correction) const {
+  float momentums_1_buffer[kAdamWChunkSize];
 
-  // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+  for (std::ptrdiff_t begin = 0; begin < count; begin += kAdamWChunkSize) {
+    const std::ptrdiff_t chunk_size = std::min(kAdamWChunkSize, count - begin);
+    EigenVectorArrayMap<T> w(weight + begin, chunk_size);
+    ConstEigenVectorArrayMap<T> g(gradient + begin, chunk_size);
+    EigenVectorArrayMap<float> m1(LoadMomentums(momentums_1 + begin, momentums_1_buffer, chunk_size), chunk_size);
+    EigenVectorArrayMap<float> m2(momentums_2 + begin, chunk_size);
 
-  // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+    // Perform weight decay.
+    w = w - (w * lr * weight_decay_);
 
-  // Compute the new weight.
-  auto denom = (MakeEigenArrayMap<T>(momentums_2) / beta_correction).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr * MakeEigenArrayMap<T>(momentums_1)) / (alpha_correction * denom);
+    // Compute exponentially-averaged historical gradient.
+    m1 = alpha_ * m1 + (1.f - alpha_) * g;
 
-  return Status::OK();
+    // Compute exponentially-averaged historical squared gradient.
+    m2 = beta_ * m2 + (1.f - beta_) * g * g;
+
+    // Compute the new weight.
+    auto denom = (m2 / beta_correction).sqrt() + epsilon_;
+    w = w - (lr * m1) / (alpha_correction * denom);
+
+    StoreMomentums(m1.data(), momentums_1 + begin, chunk_size);
+  }
 }
 
 template <typename T>
-Status AdamWOptimizer<T>::AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2,
-                                            float lr, float lr_corrected) const {
-  // Compute exponentially-averaged historical gradient.
-  MakeEigenArrayMap<T>(momentums_1) = alpha_ * MakeEigenArrayMap<T>(momentums_1) +
-                                      (1.f - alpha_) * MakeEigenArrayMap<T>(gradient);
+template <typename TMomentum>
+void AdamWOptimizer<T>::AdamWComputeMode1(T* weight, const T* gradient, TMomentum* momentums_1, float* momentums_2,
+                                          std::ptrdiff_t count, float lr, float lr_corrected) const {
+  float momentums_1_buffer[kAdamWChunkSize];
 
-  // Compute exponentially-averaged historical squared gradient.
-  MakeEigenArrayMap<T>(momentums_2) = beta_ * MakeEigenArrayMap<T>(momentums_2) +
-                                      (1.f - beta_) * MakeEigenArrayMap<T>(gradient) * MakeEigenArrayMap<T>(gradient);
+  for (std::ptrdiff_t begin = 0; begin < count; begin += kAdamWChunkSize) {
+    const std::ptrdiff_t chunk_size = std::min(kAdamWChunkSize, count - begin);
+    EigenVectorArrayMap<T> w(weight + begin, chunk_size);
+    ConstEigenVectorArrayMap<T> g(gradient + begin, chunk_size);
+    EigenVectorArrayMap<float> m1(LoadMomentums(momentums_1 + begin, momentums_1_buffer, chunk_size), chunk_size);
+    EigenVectorArrayMap<float> m2(momentums_2 + begin, chunk_size);
 
-  auto denom = MakeEigenArrayMap<T>(momentums_2).sqrt() + epsilon_;
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) -
-                                 (lr_corrected * MakeEigenArrayMap<T>(momentums_1) / denom);
+    // Compute exponentially-averaged historical gradient.
+    m1 = alpha_ * m1 + (1.f - alpha_) * g;
 
-  // Perform weight decay.
-  MakeEigenArrayMap<T>(weight) = MakeEigenArrayMap<T>(weight) - (lr * weight_decay_ * MakeEigenArrayMap<T>(weight));
+    // Compute exponentially-averaged historical squared gradient.
+    m2 = beta_ * m2 + (1.f - beta_) * g * g;
 
-  return Status::OK();
+    auto denom = m2.sqrt() + epsilon_;
+    w = w - (lr_corrected * m1 / denom);
+
+    // Perform weight decay.
+    w = w - (lr * weight_decay_ * w);
+
+    StoreMomentums(m1.data(), momentums_1 + begin, chunk_size);
+  }
+}
+
+template <typename T>
+template <typename TMomentum>
+void AdamWOptimizer<T>::AdamWComputeMultiTensor(OpKernelContext* ctx, const AdamWOptimizerBase::Prepare& p,
+                                                float lr, float alpha_correction, float beta_correction,
+                                                float lr_corrected) const {
+  // All the weights are updated as one flattened range of elements, so that the work is split evenly across the
+  // threads regardless of how the elements are distributed among the weights.
+  InlinedVector<std::ptrdiff_t> offsets(p.num_of_weights + 1, 0);
+  for (size_t i = 0; i < p.num_of_weights; ++i) {
+    offsets[i + 1] = offsets[i] + p.grouped_tensor_sizes[i];
+  }
+
+  // The weight, gradient and momentums are loaded, the weight and momentums are stored.
+  const TensorOpCost cost{static_cast<double>(2 * sizeof(T) + sizeof(TMomentum) + sizeof(float)),
+                          static_cast<double>(sizeof(T) + sizeof(TMomentum) + sizeof(float)),
+                          24.0};
+
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), offsets.back(), cost,
+      [this, &p, &offsets, lr, alpha_correction, beta_correction, lr_corrected](std::ptrdiff_t begin,
+                                                                                 std::ptrdiff_t end) {
+        // The last weight starting at or before begin.
+        size_t i = static_cast<size_t>(std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin()) - 1;
+
+        for (; begin < end; ++i) {
+          const std::ptrdiff_t offset = begin - offsets[i];
+          const std::ptrdiff_t count = std::min(end, offsets[i + 1]) - begin;
+
+          const auto& pointers = p.grouped_tensor_pointers[i];
+          T* weight = static_cast<T*>(pointers[0]) + offset;
+          const T* gradient = static_cast<const T*>(pointers[1]) + offset;
+          TMomentum* momentums_1 = static_cast<TMomentum*>(pointers[2]) + offset;
+          float* momentums_2 = static_cast<float*>(pointers[3]) + offset;
+
+          if (adam_mode_ == 0) {
+            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, count, lr, alpha_correction,
+                              beta_correction);
+          } else {
+            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, count, lr, lr_corrected);
+          }
+
+          begin += count;
+        }
+      });
 }
 
 template <typename T>
@@ -165,21 +274,14 @@ Status AdamWOptimizer<T>::Compute(OpKernelContext* ctx) const {
     //         bias correction is applied on learning rate, then use lr_corrected for subsequent computations.
     //         weight decay is applied after weight is updated.
 
-    for (size_t weight_index = 0; weight_index < p.num_of_weights; ++weight_index) {
-      Tensor& weight = const_cast<Tensor&>(p.weights->Get(weight_index));
-      Tensor& gradient = const_cast<Tensor&>(p.gradients->Get(weight_index));
-      Tensor& momentums_1 = const_cast<Tensor&>(p.momentums_1->Get(weight_index));
-      Tensor& momentums_2 = const_cast<Tensor&>(p.momentums_2->Get(weight_index));
-
-      if (adam_mode_ == 0) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode0(weight, gradient, momentums_1, momentums_2, lr, alpha_correction, beta_correction));
-      } else if (adam_mode_ == 1) {
-        ORT_RETURN_IF_ERROR(
-            AdamWComputeMode1(weight, gradient, momentums_1, momentums_2, lr, lr_corrected));
-      } else {
-        ORT_THROW("Unsupported Adamw optimizer mode.");
-      }
+    if (adam_mode_ != 0 && adam_mode_ != 1) {
+      ORT_THROW("Unsupported Adamw optimizer mode.");
+    }
+
+    if (p.momentums_1->DataType() == DataTypeImpl::GetType<MLFloat16>()) {
+      AdamWComputeMultiTensor<MLFloat16>(ctx, p, lr, alpha_correction, beta_correction, lr_corrected);
+    } else {
+      AdamWComputeMultiTensor<float>(ctx, p, lr, alpha_correction, beta_correction, lr_corrected);
     }
 
     *updated_flag_ptr = 1;
@@ -21,11 +21,15 @@ class AdamWOptimizer final : public OpKernel, public AdamWOptimizerBase {
   Status Compute(OpKernelContext* context) const override;
 
  private:
-  Status AdamWComputeMode0(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2, float lr,
-                           float alpha_correction,
-                           float beta_correction) const;
-  Status AdamWComputeMode1(Tensor& weight, Tensor& gradient, Tensor& momentums_1, Tensor& momentums_2, float lr,
-                           float lr_corrected) const;
+  template <typename TMomentum>
+  void AdamWComputeMode0(T* weight, const T* gradient, TMomentum* momentums_1, float* momentums_2,
+                         std::ptrdiff_t count, float lr, float alpha_correction, float beta_correction) const;
+  template <typename TMomentum>
+  void AdamWComputeMode1(T* weight, const T* gradient, TMomentum* momentums_1, float* momentums_2,
+                         std::ptrdiff_t count, float lr, float lr_corrected) const;
+  template <typename TMomentum>
+  void AdamWComputeMultiTensor(OpKernelContext* ctx, const AdamWOptimizerBase::Prepare& p, float lr,
+                               float alpha_correction, float beta_correction, float lr_corrected) const;
 };
 
 }  // namespace contrib
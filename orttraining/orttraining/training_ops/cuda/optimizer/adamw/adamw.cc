@@ -28,12 +28,16 @@ ONNX_OPERATOR_KERNEL_EX(
         .TypeConstraint("T2", DataTypeImpl::GetTensorType<int64_t>())
         .TypeConstraint("S_WEIGHT", DataTypeImpl::AllFixedSizeSequenceTensorTypes())
         .TypeConstraint("S_GRAD", DataTypeImpl::AllFixedSizeSequenceTensorTypes())
-        .TypeConstraint("S_MOMENT", DataTypeImpl::AllFixedSizeSequenceTensorTypes()),
+        .TypeConstraint("S_MOMENT", DataTypeImpl::AllFixedSizeSequenceTensorTypes())
+        .TypeConstraint("S_MOMENT_2", DataTypeImpl::AllFixedSizeSequenceTensorTypes()),
     AdamWOptimizer);
 
 Status AdamWOptimizer::ComputeInternal(OpKernelContext* ctx) const {
   AdamWOptimizerBase::Prepare p;
   ORT_RETURN_IF_ERROR(PrepareForCompute(ctx, p));
+  ORT_RETURN_IF_NOT(p.momentums_1->DataType() == DataTypeImpl::GetType<float>() &&
+                        p.momentums_2->DataType() == DataTypeImpl::GetType<float>(),
+                    "Only float momentums are supported by the CUDA AdamWOptimizer.");
 
   int64_t* updated_flag_ptr = p.updated_flag->template MutableData<int64_t>();
 